@@ -0,0 +1,67 @@
+"""
+WuYun parallel agents
+
+ClosedLoopAgent.run / agent_steps release the GIL, so plain Python threads
+drive independent agents on separate cores. Every noise source (sensory
+encoders, cortical REM/PGO, hippocampal SWR/theta, sleep cycle) is a
+per-instance stream seeded from its config, so agents share no mutable
+state and each thread reproduces the agent's single-threaded run. State is
+read through zero-copy numpy views (population v_soma, BG cortical->MSN
+weights).
+
+    python python/experiments/parallel_agents.py [n_agents] [n_steps]
+"""
+
+import sys, os
+import time
+import threading
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', '..', 'build', 'lib', 'Release'))
+
+import numpy as np
+import pywuyun
+
+
+def make_agent(seed):
+    wcfg = pywuyun.GridWorldConfig()
+    wcfg.seed = seed
+    return pywuyun.ClosedLoopAgent(wcfg, pywuyun.AgentConfig())
+
+
+def main(argv):
+    n_agents = int(argv[1]) if len(argv) > 1 else 4
+    n_steps = int(argv[2]) if len(argv) > 2 else 500
+
+    agents = [None] * n_agents
+
+    def build(i):
+        agents[i] = make_agent(42 + i)
+
+    threads = [threading.Thread(target=build, args=(i,)) for i in range(n_agents)]
+    for th in threads: th.start()
+    for th in threads: th.join()
+
+    rewards = [None] * n_agents
+
+    def drive(i):
+        rewards[i] = agents[i].agent_steps(n_steps)
+
+    t0 = time.perf_counter()
+    threads = [threading.Thread(target=drive, args=(i,)) for i in range(n_agents)]
+    for th in threads: th.start()
+    for th in threads: th.join()
+    wall = time.perf_counter() - t0
+
+    print(f"{n_agents} agents x {n_steps} steps in {wall:.1f}s "
+          f"({n_agents * n_steps / wall:.0f} agent steps/s)")
+    for i, agent in enumerate(agents):
+        bg = agent.bg()
+        d1 = [bg.d1_weights(s) for s in range(bg.d1_weight_count())]   # views, no copy
+        w_mean = float(np.mean(np.concatenate(d1))) if d1 else 0.0
+        v_soma = agent.v1().column().l23().v_soma()
+        print(f"  agent {i}: reward {rewards[i].sum():+.2f}  food_rate {agent.food_rate():.3f}  "
+              f"BG D1 w {w_mean:.3f}  V1 L2/3 <V> {v_soma.mean():.1f} mV")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
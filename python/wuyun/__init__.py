@@ -9,4 +9,6 @@ if os.path.isdir(_LIB_DIR):
     sys.path.insert(0, os.path.abspath(_LIB_DIR))
 
 from pywuyun import *
-from .viz import plot_raster, plot_connectivity, plot_activity_bars, plot_neuromod_timeline, run_demo
+from .viz import plot_raster, plot_connectivity, plot_activity_bars, plot_neuromod_timeline, plot_telemetry, run_demo
+from .telemetry import TelemetryReader
+from .raster import SpikeRaster
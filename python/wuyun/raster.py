@@ -0,0 +1,185 @@
+"""
+WuYun spike raster reader (numpy)
+
+Memory-mapped reader for the chunked, delta/varint-compressed spike files
+written by SpikeRasterWriter (format: src/engine/spike_raster.h). Needs
+only numpy -- works without pywuyun, on files of any size: only the
+chunks overlapping the requested time window are touched.
+
+    r = SpikeRaster('run.wyr')
+    times, ids = r.read('V1', 10_000, 12_000)
+    python python/wuyun/raster.py run.wyr        # summary
+"""
+
+import struct
+import sys
+
+import numpy as np
+
+VERSION = 1
+_CHUNK_HEADER = 16
+
+
+class SpikeRaster:
+    """Random access by region and time window.
+
+    read(region, t0, t1) -> (times int32, neuron_ids uint32), sorted by time
+    then id; `region` is a name or an index into `region_names`.
+    """
+
+    def __init__(self, path):
+        self.path = path
+        self._mm = np.memmap(path, dtype=np.uint8, mode='r')
+        self._parse()
+
+    # -------------------------------------------------------------------------
+    def _u32(self, pos):
+        return int(self._mm[pos:pos + 4].view('<u4')[0])
+
+    def _parse(self):
+        mm = self._mm
+        if len(mm) < 16 or bytes(mm[:4]) != b'WYSR':
+            raise ValueError(f"{self.path}: not a WuYun spike raster")
+        if self._u32(4) != VERSION:
+            raise ValueError(f"{self.path}: unsupported version {self._u32(4)}")
+        self.chunk_steps = self._u32(8)
+        n = self._u32(12)
+        pos = 16
+        self.region_names, self.region_sizes = [], []
+        for _ in range(n):
+            (length,) = struct.unpack_from('<H', mm, pos)
+            pos += 2
+            self.region_names.append(bytes(mm[pos:pos + length]).decode('utf-8'))
+            pos += length
+            self.region_sizes.append(self._u32(pos))
+            pos += 4
+
+        # chunk table: (t0, n_steps, offset)
+        self.indexed = False
+        chunks = []
+        size = len(mm)
+        if size >= pos + 12 and bytes(mm[size - 4:]) == b'WYSE':
+            (ix,) = struct.unpack_from('<Q', mm, size - 12)
+            if bytes(mm[ix:ix + 4]) == b'WYIX':
+                nc = self._u32(ix + 4)
+                entries = np.frombuffer(mm[ix + 8:ix + 8 + 16 * nc],
+                                        dtype=[('t0', '<i4'), ('n', '<u4'), ('off', '<u8')])
+                chunks = [(int(e['t0']), int(e['n']), int(e['off'])) for e in entries]
+                self.indexed = True
+        if not self.indexed:
+            chunks = self._scan(pos, size)
+        self._t0 = np.array([c[0] for c in chunks], dtype=np.int64)
+        self._chunks = chunks
+
+    def _scan(self, pos, end):
+        n = len(self.region_names)
+        chunks = []
+        while pos + _CHUNK_HEADER + 8 * n <= end:
+            if bytes(self._mm[pos:pos + 4]) != b'WYCK' or self._u32(pos + 12) != n:
+                break
+            table = self._mm[pos + 16:pos + 16 + 8 * n].view('<u4')
+            total = _CHUNK_HEADER + 8 * n + int(table[0::2].sum())
+            if pos + total > end:
+                break                               # truncated tail chunk
+            t0 = int(self._mm[pos + 4:pos + 8].view('<i4')[0])
+            chunks.append((t0, self._u32(pos + 8), pos))
+            pos += total
+        return chunks
+
+    # -------------------------------------------------------------------------
+    @property
+    def t_begin(self):
+        return self._chunks[0][0] if self._chunks else 0
+
+    @property
+    def t_end(self):
+        return self._chunks[-1][0] + self._chunks[-1][1] if self._chunks else 0
+
+    def region_index(self, region):
+        return self.region_names.index(region) if isinstance(region, str) else int(region)
+
+    def _span(self, chunk, r):
+        n = len(self.region_names)
+        off = chunk[2]
+        table = self._mm[off + 16:off + 16 + 8 * n].view('<u4')
+        start = off + _CHUNK_HEADER + 8 * n + int(table[0:2 * r:2].sum())
+        return self._mm[start:start + int(table[2 * r])], int(table[2 * r + 1])
+
+    @staticmethod
+    def _varints(b):
+        """Vectorised LEB128 decode of a byte span."""
+        if len(b) == 0:
+            return np.zeros(0, dtype=np.int64)
+        b = np.asarray(b)
+        ends = (b & 0x80) == 0
+        group = np.concatenate(([0], np.cumsum(ends)[:-1]))
+        starts = np.flatnonzero(np.concatenate(([True], ends[:-1])))
+        shift = 7 * (np.arange(len(b)) - starts[group])
+        parts = (b & 0x7F).astype(np.int64) << shift
+        return np.bincount(group, weights=parts).astype(np.int64)
+
+    def _chunk_range(self, t0, t1):
+        first = max(int(np.searchsorted(self._t0, t0, side='right')) - 1, 0)
+        last = int(np.searchsorted(self._t0, t1, side='left'))
+        return range(first, last)
+
+    def read(self, region, t0=None, t1=None):
+        """Spikes of `region` in [t0, t1) as (times, neuron_ids)."""
+        r = self.region_index(region)
+        t0 = self.t_begin if t0 is None else t0
+        t1 = self.t_end if t1 is None else t1
+        times, ids = [], []
+        for ci in self._chunk_range(t0, t1):
+            chunk = self._chunks[ci]
+            span, _ = self._span(chunk, r)
+            v = self._varints(span)
+            i, off = 0, 0
+            while i < len(v):
+                off += int(v[i])
+                count = int(v[i + 1])
+                t = chunk[0] + off
+                if t0 <= t < t1:
+                    seg = v[i + 2:i + 2 + count]
+                    ids.append(np.cumsum(seg) + np.arange(count))
+                    times.append(np.full(count, t, dtype=np.int32))
+                i += 2 + count
+        if not times:
+            return np.zeros(0, dtype=np.int32), np.zeros(0, dtype=np.uint32)
+        return np.concatenate(times), np.concatenate(ids).astype(np.uint32)
+
+    def count(self, region, t0=None, t1=None):
+        """Number of spikes of `region` in [t0, t1); whole chunks read from the table only."""
+        r = self.region_index(region)
+        t0 = self.t_begin if t0 is None else t0
+        t1 = self.t_end if t1 is None else t1
+        total = 0
+        for ci in self._chunk_range(t0, t1):
+            c0, n, _ = self._chunks[ci]
+            if c0 >= t0 and c0 + n <= t1:
+                total += self._span(self._chunks[ci], r)[1]
+            else:
+                total += len(self.read(r, max(t0, c0), min(t1, c0 + n))[0])
+        return total
+
+    def to_raster(self, region, t0=None, t1=None):
+        """Alias of read() matching pywuyun.SpikeRecorder.to_raster (for viz.plot_raster)."""
+        return self.read(region, t0, t1)
+
+
+def main(argv):
+    if len(argv) < 2:
+        print('usage: raster.py FILE.wyr')
+        return 2
+    r = SpikeRaster(argv[1])
+    print(f"{argv[1]}: t=[{r.t_begin}, {r.t_end}), {len(r._chunks)} chunks of "
+          f"{r.chunk_steps} steps{'' if r.indexed else ' (no index, rebuilt)'}")
+    for name, size in zip(r.region_names, r.region_sizes):
+        n = r.count(name)
+        dur = max(r.t_end - r.t_begin, 1)
+        print(f"  {name:<16} {size:>7} neurons  {n:>10} spikes  "
+              f"{1000.0 * n / (size * dur) if size else 0.0:8.2f} Hz")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,166 @@
+"""
+WuYun live telemetry reader
+
+Attach to the shared-memory telemetry ring published by
+SimulationEngine.enable_telemetry() / ClosedLoopAgent.enable_telemetry()
+(layout: src/core/telemetry.h). Pure standard library -- works without
+pywuyun, from any process, while the simulation keeps running.
+
+The mapping is read-only: readers never write to the segment, so any
+number of them can attach/detach without slowing the writer. Frames
+overwritten before they were read are counted in `lost`.
+
+    python python/wuyun/telemetry.py NAME        # tail frames
+"""
+
+import mmap
+import os
+import struct
+import sys
+import time
+
+MAGIC = 0x4D545957          # "WYTM"
+VERSION = 1
+MAX_REGIONS = 128
+NAME_LEN = 32
+
+_HEADER = struct.Struct('<8I')              # magic .. publish_every
+_PUBLISHED_OFFSET = 64
+_NAMES_OFFSET = 128
+_SEQ = struct.Struct('<Q')
+_FRAME = struct.Struct('<QqqdffIIffffffffff%dI' % MAX_REGIONS)
+_FIELDS = ('seq', 'step', 'agent_steps', 'wall_s',
+           'step_us_mean', 'step_us_max', 'window_steps', 'n_regions',
+           'da', 'ne', 'sht', 'ach',
+           'reward_rate', 'last_reward', 'bg_da', 'bg_w_d1_norm', 'bg_w_d2_norm', 'reserved')
+
+assert _FRAME.size == 600
+
+
+def _shm_path(name):
+    return os.path.join('/dev/shm', name.lstrip('/'))
+
+
+class TelemetryReader:
+    """Read-only view of a telemetry segment.
+
+    Frames are dicts with the TelemetryFrame fields plus 'spikes':
+    {region_name: count} for the publish window.
+    """
+
+    def __init__(self, name):
+        self.name = name
+        self.lost = 0
+        self._mm = None
+        self._attach()
+
+    def _attach(self):
+        with open(_shm_path(self.name), 'rb') as f:
+            self._mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        (magic, version, header_bytes, slot_bytes, frame_bytes,
+         capacity, n_regions, publish_every) = _HEADER.unpack_from(self._mm, 0)
+        if magic != MAGIC or version != VERSION or frame_bytes != _FRAME.size:
+            self.close()
+            raise ValueError(f"'{self.name}' is not a WuYun telemetry segment (v{VERSION})")
+        self.header_bytes = header_bytes
+        self.slot_bytes = slot_bytes
+        self.capacity = capacity
+        self.publish_every = publish_every
+        self.region_names = []
+        for i in range(min(n_regions, MAX_REGIONS)):
+            raw = self._mm[_NAMES_OFFSET + i * NAME_LEN:_NAMES_OFFSET + (i + 1) * NAME_LEN]
+            self.region_names.append(raw.split(b'\0', 1)[0].decode('utf-8', 'replace'))
+        pub = self.published()
+        self._next = pub - capacity if pub > capacity else 0
+
+    def close(self):
+        """Detach (the simulation is unaffected)."""
+        if self._mm is not None:
+            self._mm.close()
+            self._mm = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def published(self):
+        """Number of frames the writer has completed."""
+        return _SEQ.unpack_from(self._mm, _PUBLISHED_OFFSET)[0]
+
+    def _read(self, k):
+        off = self.header_bytes + (k % self.capacity) * self.slot_bytes
+        want = 2 * k + 2
+        if _SEQ.unpack_from(self._mm, off)[0] != want:
+            return None
+        raw = self._mm[off + 8:off + 8 + _FRAME.size]
+        if _SEQ.unpack_from(self._mm, off)[0] != want:
+            return None                                  # overwritten while copying
+        values = _FRAME.unpack(raw)
+        frame = dict(zip(_FIELDS, values))
+        counts = values[len(_FIELDS):]
+        frame['spikes'] = {self.region_names[i]: counts[i]
+                           for i in range(min(frame['n_regions'], len(self.region_names)))}
+        return frame
+
+    def poll(self):
+        """New frames since the last poll (oldest retained frame first on attach)."""
+        pub = self.published()
+        if pub > self._next + self.capacity:
+            self.lost += pub - self.capacity - self._next
+            self._next = pub - self.capacity
+        frames = []
+        while self._next < pub:
+            f = self._read(self._next)
+            if f is None:
+                self.lost += 1
+            else:
+                frames.append(f)
+            self._next += 1
+        return frames
+
+    def latest(self):
+        """Most recent frame, or None before the first publish."""
+        for _ in range(4):
+            pub = self.published()
+            if pub == 0:
+                return None
+            f = self._read(pub - 1)
+            if f is not None:
+                return f
+        return None
+
+    def skip_to_latest(self):
+        self._next = self.published()
+
+    def follow(self, interval=0.2, idle=10.0):
+        """Yield frames as they are published; stop after `idle` seconds without one."""
+        last = time.monotonic()
+        while idle <= 0 or time.monotonic() - last < idle:
+            frames = self.poll()
+            if frames:
+                last = time.monotonic()
+            yield from frames
+            time.sleep(interval)
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__.strip().splitlines()[-1].strip())
+        return 2
+    with TelemetryReader(argv[1]) as reader:
+        print(f"attached '{reader.name}': {len(reader.region_names)} regions, "
+              f"capacity {reader.capacity}, every {reader.publish_every} steps")
+        for f in reader.follow():
+            total = sum(f['spikes'].values())
+            line = (f"#{f['seq']:<6} t={f['step']:<8} {f['step_us_mean']:8.1f} us/step  "
+                    f"spikes {total:<8} DA {f['da']:.3f} NE {f['ne']:.3f}")
+            if f['reward_rate'] == f['reward_rate']:     # not NaN
+                line += f"  | reward {f['reward_rate']:+.3f} BG DA {f['bg_da']:.3f}"
+            print(line, flush=True)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
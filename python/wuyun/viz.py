@@ -313,6 +313,76 @@ def plot_neuromod_timeline(nm_history, figsize=(12, 4), save_path=None):
     return fig
 
 
+# =============================================================================
+# Live Telemetry
+# =============================================================================
+def plot_telemetry(frames, top=8, figsize=(12, 9), save_path=None):
+    """
+    Plot telemetry frames (see wuyun.telemetry): step latency, per-region
+    spike rates, neuromodulators and, for agents, reward rate / BG weights.
+
+    Args:
+        frames: list of frame dicts from TelemetryReader.poll(), or a segment
+                name to read everything currently retained in the ring
+        top: number of most active regions to draw
+    """
+    if isinstance(frames, str):
+        from .telemetry import TelemetryReader
+        with TelemetryReader(frames) as reader:
+            frames = reader.poll()
+    if not frames:
+        raise ValueError('no telemetry frames')
+
+    t = np.array([f['step'] for f in frames])
+    has_agent = not np.isnan(frames[-1]['reward_rate'])
+    fig, axes = plt.subplots(4 if has_agent else 3, 1, figsize=figsize, sharex=True)
+
+    ax = axes[0]
+    ax.plot(t, [f['step_us_mean'] for f in frames], label='mean', color='#3F51B5')
+    ax.plot(t, [f['step_us_max'] for f in frames], label='max', color='#9FA8DA', linewidth=0.8)
+    ax.set_ylabel('us / step')
+    ax.set_title('Live Telemetry', fontweight='bold')
+    ax.legend(loc='upper right', fontsize=8)
+
+    ax = axes[1]
+    totals = {}
+    for f in frames:
+        for name, n in f['spikes'].items():
+            totals[name] = totals.get(name, 0) + n
+    for name in sorted(totals, key=totals.get, reverse=True)[:top]:
+        rate = [f['spikes'].get(name, 0) / max(f['window_steps'], 1) for f in frames]
+        ax.plot(t, rate, label=name, color=_get_color(name), linewidth=1.2)
+    ax.set_ylabel('spikes / step')
+    ax.legend(loc='upper right', fontsize=7, ncol=2)
+
+    ax = axes[2]
+    for key, label, color in (('da', 'DA', '#FF9800'), ('ne', 'NE', '#2196F3'),
+                              ('sht', '5-HT', '#9C27B0'), ('ach', 'ACh', '#4CAF50')):
+        ax.plot(t, [f[key] for f in frames], label=label, color=color, linewidth=1.5)
+    ax.set_ylabel('Level')
+    ax.set_ylim(0, 1)
+    ax.legend(loc='upper right', fontsize=8)
+
+    if has_agent:
+        ax = axes[3]
+        ax.plot(t, [f['reward_rate'] for f in frames], label='reward rate', color='#F44336')
+        ax.set_ylabel('Reward / step')
+        ax2 = ax.twinx()
+        ax2.plot(t, [f['bg_w_d1_norm'] for f in frames], label='|W D1|', color='#FF9800',
+                 linestyle='--')
+        ax2.plot(t, [f['bg_w_d2_norm'] for f in frames], label='|W D2|', color='#795548',
+                 linestyle='--')
+        ax2.set_ylabel('BG weight norm')
+        ax2.legend(loc='upper right', fontsize=8)
+
+    axes[-1].set_xlabel('Time (ms)')
+    plt.tight_layout()
+
+    if save_path:
+        fig.savefig(save_path, dpi=150, bbox_inches='tight')
+    return fig
+
+
 # =============================================================================
 # Quick Demo
 # =============================================================================
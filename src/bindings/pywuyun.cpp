@@ -8,9 +8,11 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <pybind11/functional.h>
 
 #include "core/neuromodulator.h"
 #include "engine/simulation_engine.h"
+#include "engine/spike_raster.h"
 #include "region/cortical_region.h"
 #include "region/subcortical/thalamic_relay.h"
 #include "region/subcortical/basal_ganglia.h"
@@ -29,8 +31,13 @@
 #include "engine/grid_world.h"
 #include "engine/grid_world_env.h"
 #include "engine/closed_loop_agent.h"
+#include "engine/vec_env.h"
 #include "plasticity/homeostatic.h"
+#include "plasticity/structural.h"
 #include "region/subcortical/cerebellum.h"
+#include "genome/evolution.h"
+#include "genome/dev_evolution.h"
+#include "development/developer.h"
 
 namespace py = pybind11;
 using namespace wuyun;
@@ -43,6 +50,35 @@ static py::array_t<uint8_t> fired_to_numpy(const std::vector<uint8_t>& fired) {
     );
 }
 
+// Helper: zero-copy numpy view of a vector owned by the C++ object behind `owner`
+// (owner 作为 numpy base 保持存活; 容器重新分配 (如 compact_synapses) 后视图失效, 需重新获取)
+template <typename T>
+static py::array_t<T> vector_view(const std::vector<T>& v, py::handle owner, bool writable = false) {
+    py::array_t<T> a({static_cast<py::ssize_t>(v.size())},
+                     {static_cast<py::ssize_t>(sizeof(T))},
+                     const_cast<T*>(v.data()), owner);
+    if (!writable) a.attr("flags").attr("writeable") = false;
+    return a;
+}
+
+// Helper: method returning a read-only view of a const vector accessor
+template <typename C, typename T>
+static auto view_of(const std::vector<T>& (C::*getter)() const) {
+    return [getter](py::object self) {
+        return vector_view((self.cast<const C&>().*getter)(), self);
+    };
+}
+
+// Helper: per-agent noise streams for VisualInput.encode_batch (stream i seeded seed + i)
+struct NoiseStreams {
+    std::vector<std::mt19937> rngs;
+
+    NoiseStreams(size_t n, uint32_t seed) {
+        rngs.reserve(n);
+        for (size_t i = 0; i < n; ++i) rngs.emplace_back(seed + static_cast<uint32_t>(i));
+    }
+};
+
 // Helper: collect spike raster for a region over multiple steps
 struct SpikeRecorder {
     std::vector<std::vector<uint32_t>> timesteps;  // per-step: list of neuron IDs that fired
@@ -103,6 +139,43 @@ PYBIND11_MODULE(pywuyun, m) {
         .def("clear", &SpikeRecorder::clear)
         .def("__len__", [](const SpikeRecorder& r) { return r.timesteps.size(); });
 
+    // =========================================================================
+    // SpikeRasterWriter / SpikeRasterReader (streaming, on-disk)
+    // =========================================================================
+    py::class_<SpikeRasterWriter>(m, "SpikeRasterWriter",
+        "Stream per-region spikes to a chunked, delta/varint-compressed file "
+        "(attach with engine.set_spike_recorder)")
+        .def(py::init<>())
+        .def("open", &SpikeRasterWriter::open, py::arg("path"), py::arg("engine"),
+             py::arg("chunk_steps") = 1000, py::arg("regions") = std::vector<std::string>{})
+        .def("close", &SpikeRasterWriter::close)
+        .def("is_open", &SpikeRasterWriter::is_open)
+        .def("spikes", &SpikeRasterWriter::spikes)
+        .def("chunks", &SpikeRasterWriter::chunks)
+        .def("bytes_written", &SpikeRasterWriter::bytes_written);
+
+    py::class_<SpikeRasterReader>(m, "SpikeRasterReader",
+        "Memory-mapped random access to a spike raster file by region and time window")
+        .def(py::init<>())
+        .def("open", &SpikeRasterReader::open, py::arg("path"))
+        .def("close", &SpikeRasterReader::close)
+        .def("num_regions", &SpikeRasterReader::num_regions)
+        .def("region_name", &SpikeRasterReader::region_name)
+        .def("find_region", &SpikeRasterReader::find_region, py::arg("name"))
+        .def("num_chunks", &SpikeRasterReader::num_chunks)
+        .def("t_begin", &SpikeRasterReader::t_begin)
+        .def("t_end", &SpikeRasterReader::t_end)
+        .def("read", [](const SpikeRasterReader& r, size_t region, int32_t t0, int32_t t1) {
+            std::vector<int32_t> times;
+            std::vector<uint32_t> ids;
+            r.read(region, t0, t1, times, ids);
+            return std::make_pair(
+                py::array_t<int32_t>({static_cast<py::ssize_t>(times.size())}, times.data()),
+                py::array_t<uint32_t>({static_cast<py::ssize_t>(ids.size())}, ids.data()));
+        }, py::arg("region"), py::arg("t0"), py::arg("t1"),
+           "Return (times, neuron_ids) numpy arrays for [t0, t1)")
+        .def("count", &SpikeRasterReader::count, py::arg("region"), py::arg("t0"), py::arg("t1"));
+
     // =========================================================================
     // NeuromodulatorLevels
     // =========================================================================
@@ -127,6 +200,50 @@ PYBIND11_MODULE(pywuyun, m) {
         .def("current", &NeuromodulatorSystem::current)
         .def("compute_effect", &NeuromodulatorSystem::compute_effect);
 
+    // =========================================================================
+    // NeuronPopulation / SynapseGroup (zero-copy state views)
+    // =========================================================================
+    py::class_<NeuronPopulation>(m, "NeuronPopulation",
+        "Neuron population; state accessors are zero-copy read-only numpy views")
+        .def("size", &NeuronPopulation::size)
+        .def("has_apical", &NeuronPopulation::has_apical)
+        .def("v_soma",     view_of(&NeuronPopulation::v_soma))
+        .def("v_apical",   view_of(&NeuronPopulation::v_apical))
+        .def("w_adapt",    view_of(&NeuronPopulation::w_adapt))
+        .def("spike_type", view_of(&NeuronPopulation::spike_type))
+        .def("fired",      view_of(&NeuronPopulation::fired));
+
+    py::class_<SynapseGroup>(m, "SynapseGroup", "CSR synapse group")
+        .def("n_pre", &SynapseGroup::n_pre)
+        .def("n_post", &SynapseGroup::n_post)
+        .def("n_synapses", &SynapseGroup::n_synapses)
+        .def("weight_format", &SynapseGroup::weight_format)
+        .def("weights", [](py::object self) -> py::array_t<float> {
+            auto& sg = self.cast<SynapseGroup&>();
+            if (sg.weight_format() == WeightFormat::FP32)
+                return vector_view(sg.fp32_weights(), self, true);
+            auto w = sg.weights();
+            return py::array_t<float>({static_cast<py::ssize_t>(w.size())}, w.data());
+        }, "FP32: writable zero-copy view of the weights; BF16: decoded copy (writes are not stored back)")
+        .def("row_ptr", view_of(&SynapseGroup::row_ptr))
+        .def("col_idx", view_of(&SynapseGroup::col_idx))
+        .def("delays",  view_of(&SynapseGroup::delays));
+
+    py::class_<CorticalColumn>(m, "CorticalColumn", "Cortical column internals")
+        .def("l4",  static_cast<NeuronPopulation& (CorticalColumn::*)()>(&CorticalColumn::l4),
+             py::return_value_policy::reference_internal)
+        .def("l23", static_cast<NeuronPopulation& (CorticalColumn::*)()>(&CorticalColumn::l23),
+             py::return_value_policy::reference_internal)
+        .def("l5",  static_cast<NeuronPopulation& (CorticalColumn::*)()>(&CorticalColumn::l5),
+             py::return_value_policy::reference_internal)
+        .def("l6",  static_cast<NeuronPopulation& (CorticalColumn::*)()>(&CorticalColumn::l6),
+             py::return_value_policy::reference_internal)
+        .def("synapse", &CorticalColumn::find_synapse, py::arg("name"),
+             py::return_value_policy::reference_internal,
+             "Internal synapse group by name (see synapse_names()), None if absent")
+        .def("synapse_names", &CorticalColumn::synapse_names)
+        .def("total_synapses", &CorticalColumn::total_synapses);
+
     // =========================================================================
     // BrainRegion (base)
     // =========================================================================
@@ -137,6 +254,8 @@ PYBIND11_MODULE(pywuyun, m) {
         .def("region_id", &BrainRegion::region_id)
         .def("fired", [](const BrainRegion& r) { return fired_to_numpy(r.fired()); },
              "Return fired state as numpy uint8 array")
+        .def("fired_view", view_of(&BrainRegion::fired),
+             "Zero-copy read-only view of the fire flags (overwritten every step)")
         .def("spike_count", [](const BrainRegion& r) {
             size_t n = 0;
             for (auto f : r.fired()) if (f) n++;
@@ -144,6 +263,8 @@ PYBIND11_MODULE(pywuyun, m) {
         }, "Number of neurons that fired this step")
         .def("inject_external", &BrainRegion::inject_external,
              "Inject external current", py::arg("currents"))
+        .def("skipped_total", &BrainRegion::skipped_total,
+             "Steps skipped while quiescent (quiescence skipping)")
         .def("neuromod", static_cast<NeuromodulatorSystem& (BrainRegion::*)()>(&BrainRegion::neuromod),
              py::return_value_policy::reference);
 
@@ -162,7 +283,8 @@ PYBIND11_MODULE(pywuyun, m) {
         .def_readwrite("n_vip", &ColumnConfig::n_vip)
         .def_readwrite("input_psp_regular", &ColumnConfig::input_psp_regular)
         .def_readwrite("input_psp_burst", &ColumnConfig::input_psp_burst)
-        .def_readwrite("stdp_enabled", &ColumnConfig::stdp_enabled);
+        .def_readwrite("stdp_enabled", &ColumnConfig::stdp_enabled)
+        .def_readwrite("sleep_noise_seed", &ColumnConfig::sleep_noise_seed);
 
     // =========================================================================
     // CorticalRegion
@@ -200,10 +322,16 @@ PYBIND11_MODULE(pywuyun, m) {
              py::arg("params") = HomeostaticParams{},
              "Enable homeostatic plasticity (synaptic scaling for E/I balance)")
         .def("homeostatic_enabled", &CorticalRegion::homeostatic_enabled)
+        .def("enable_structural_plasticity", &CorticalRegion::enable_structural_plasticity,
+             py::arg("params") = StructuralParams{},
+             "Prune persistently weak STDP synapses (compacted by compact_synapses)")
+        .def("compact_synapses", &CorticalRegion::compact_synapses)
         .def("l4_mean_rate", &CorticalRegion::l4_mean_rate)
         .def("l23_mean_rate", &CorticalRegion::l23_mean_rate)
         .def("l5_mean_rate", &CorticalRegion::l5_mean_rate)
-        .def("l6_mean_rate", &CorticalRegion::l6_mean_rate);
+        .def("l6_mean_rate", &CorticalRegion::l6_mean_rate)
+        .def("column", static_cast<CorticalColumn& (CorticalRegion::*)()>(&CorticalRegion::column),
+             py::return_value_policy::reference_internal);
 
     // =========================================================================
     // ThalamicConfig + ThalamicRelay
@@ -216,7 +344,9 @@ PYBIND11_MODULE(pywuyun, m) {
 
     py::class_<ThalamicRelay, BrainRegion>(m, "ThalamicRelay", "Thalamic relay")
         .def(py::init<const ThalamicConfig&>(), py::arg("config"))
-        .def("inject_external", &ThalamicRelay::inject_external);
+        .def("inject_external", &ThalamicRelay::inject_external)
+        .def("relay", &ThalamicRelay::relay, py::return_value_policy::reference_internal)
+        .def("trn",   &ThalamicRelay::trn,   py::return_value_policy::reference_internal);
 
     // =========================================================================
     // BasalGangliaConfig + BasalGanglia
@@ -233,7 +363,35 @@ PYBIND11_MODULE(pywuyun, m) {
     py::class_<BasalGanglia, BrainRegion>(m, "BasalGanglia", "Basal ganglia")
         .def(py::init<const BasalGangliaConfig&>(), py::arg("config"))
         .def("set_da_level", &BasalGanglia::set_da_level)
-        .def("set_da_source_region", &BasalGanglia::set_da_source_region);
+        .def("set_da_source_region", &BasalGanglia::set_da_source_region)
+        .def("da_level", &BasalGanglia::da_level)
+        .def("d1",  &BasalGanglia::d1,  py::return_value_policy::reference_internal)
+        .def("d2",  &BasalGanglia::d2,  py::return_value_policy::reference_internal)
+        .def("stn", &BasalGanglia::stn, py::return_value_policy::reference_internal)
+        .def("gpi", &BasalGanglia::gpi, py::return_value_policy::reference_internal)
+        // Cortical→MSN DA-STDP matrices: one ragged row per input slot, zero-copy read-only
+        .def("d1_weight_count", &BasalGanglia::d1_weight_count)
+        .def("d2_weight_count", &BasalGanglia::d2_weight_count)
+        .def("d1_weights", [](py::object self, size_t src) {
+            const auto& bg = self.cast<const BasalGanglia&>();
+            if (src >= bg.d1_weight_count()) throw py::index_error("input slot out of range");
+            return vector_view(bg.d1_weights_for(src), self);
+        }, py::arg("src"))
+        .def("d2_weights", [](py::object self, size_t src) {
+            const auto& bg = self.cast<const BasalGanglia&>();
+            if (src >= bg.d2_weight_count()) throw py::index_error("input slot out of range");
+            return vector_view(bg.d2_weights_for(src), self);
+        }, py::arg("src"))
+        .def("d1_targets", [](py::object self, size_t src) {
+            const auto& bg = self.cast<const BasalGanglia&>();
+            if (src >= bg.d1_weight_count()) throw py::index_error("input slot out of range");
+            return vector_view(bg.d1_targets_for(src), self);
+        }, py::arg("src"), "D1 MSN indices parallel to d1_weights(src)")
+        .def("d2_targets", [](py::object self, size_t src) {
+            const auto& bg = self.cast<const BasalGanglia&>();
+            if (src >= bg.d2_weight_count()) throw py::index_error("input slot out of range");
+            return vector_view(bg.d2_targets_for(src), self);
+        }, py::arg("src"), "D2 MSN indices parallel to d2_weights(src)");
 
     // =========================================================================
     // VTA_DA
@@ -243,7 +401,8 @@ PYBIND11_MODULE(pywuyun, m) {
         .def_readwrite("name", &VTAConfig::name);
 
     py::class_<VTA_DA, BrainRegion>(m, "VTA_DA", "VTA dopamine region")
-        .def(py::init<const VTAConfig&>(), py::arg("config"));
+        .def(py::init<const VTAConfig&>(), py::arg("config"))
+        .def("neurons", &VTA_DA::neurons, py::return_value_policy::reference_internal);
 
     // =========================================================================
     // LC_NE / DRN_5HT / NBM_ACh
@@ -269,12 +428,16 @@ PYBIND11_MODULE(pywuyun, m) {
     // =========================================================================
     py::class_<HippocampusConfig>(m, "HippocampusConfig")
         .def(py::init<>())
-        .def_readwrite("name", &HippocampusConfig::name);
+        .def_readwrite("name", &HippocampusConfig::name)
+        .def_readwrite("sleep_noise_seed", &HippocampusConfig::sleep_noise_seed);
 
     py::class_<Hippocampus, BrainRegion>(m, "Hippocampus", "Hippocampus")
         .def(py::init<const HippocampusConfig&>(), py::arg("config"))
         .def("enable_sleep_replay", &Hippocampus::enable_sleep_replay)
         .def("disable_sleep_replay", &Hippocampus::disable_sleep_replay)
+        .def("dg",  &Hippocampus::dg,  py::return_value_policy::reference_internal)
+        .def("ca3", &Hippocampus::ca3, py::return_value_policy::reference_internal)
+        .def("ca1", &Hippocampus::ca1, py::return_value_policy::reference_internal)
         .def("sleep_replay_enabled", &Hippocampus::sleep_replay_enabled)
         .def("is_swr", &Hippocampus::is_swr)
         .def("swr_count", &Hippocampus::swr_count)
@@ -407,20 +570,46 @@ PYBIND11_MODULE(pywuyun, m) {
         .def_readwrite("gain", &VisualInputConfig::gain)
         .def_readwrite("baseline", &VisualInputConfig::baseline)
         .def_readwrite("noise_amp", &VisualInputConfig::noise_amp)
+        .def_readwrite("noise_seed", &VisualInputConfig::noise_seed)
         .def_readwrite("on_off_channels", &VisualInputConfig::on_off_channels);
 
+    py::class_<NoiseStreams>(m, "NoiseStreams",
+        "Independent encoder noise streams for encode_batch (stream i seeded seed + i)")
+        .def(py::init<size_t, uint32_t>(), py::arg("n"), py::arg("seed") = 12345)
+        .def("__len__", [](const NoiseStreams& s) { return s.rngs.size(); });
+
     py::class_<VisualInput>(m, "VisualInput",
         "Visual input encoder: pixels -> LGN currents via center-surround RFs")
         .def(py::init<const VisualInputConfig&>(), py::arg("config") = VisualInputConfig{})
         .def("encode", &VisualInput::encode, py::arg("pixels"),
              "Encode grayscale pixels [0,1] to LGN current vector")
+        .def("encode_batch", [](const VisualInput& enc,
+                                py::array_t<float, py::array::c_style | py::array::forcecast> frames,
+                                NoiseStreams* streams) {
+            if (frames.ndim() < 1 || frames.size() % static_cast<py::ssize_t>(enc.n_pixels()) != 0)
+                throw py::value_error("frames must hold n_frames * n_pixels values");
+            size_t n = static_cast<size_t>(frames.size()) / enc.n_pixels();
+            if (streams && streams->rngs.size() != n)
+                throw py::value_error("need one noise stream per frame");
+            py::array_t<float> out({static_cast<py::ssize_t>(n), static_cast<py::ssize_t>(enc.n_lgn())});
+            float* dst = out.mutable_data();
+            {
+                py::gil_scoped_release nogil;
+                enc.encode_batch(frames.data(), n, dst, streams ? streams->rngs.data() : nullptr);
+            }
+            return out;
+        }, py::arg("frames"), py::arg("streams") = nullptr,
+             "Encode [n, pixels] (or [n, h, w], e.g. VecEnv.observe()) to [n, n_lgn] currents; "
+             "frame i draws noise from streams[i] if given, else from the encoder's own stream")
         .def("encode_and_inject", &VisualInput::encode_and_inject,
              py::arg("pixels"), py::arg("lgn"),
              "Encode and inject into LGN region")
         .def("input_width", &VisualInput::input_width)
         .def("input_height", &VisualInput::input_height)
         .def("n_pixels", &VisualInput::n_pixels)
-        .def("n_lgn", &VisualInput::n_lgn);
+        .def("n_lgn", &VisualInput::n_lgn)
+        .def("rf_width", &VisualInput::rf_width)
+        .def("n_connections", &VisualInput::n_connections);
 
     // =========================================================================
     // AuditoryInput
@@ -432,7 +621,8 @@ PYBIND11_MODULE(pywuyun, m) {
         .def_readwrite("gain", &AuditoryInputConfig::gain)
         .def_readwrite("baseline", &AuditoryInputConfig::baseline)
         .def_readwrite("noise_amp", &AuditoryInputConfig::noise_amp)
-        .def_readwrite("temporal_decay", &AuditoryInputConfig::temporal_decay);
+        .def_readwrite("temporal_decay", &AuditoryInputConfig::temporal_decay)
+        .def_readwrite("noise_seed", &AuditoryInputConfig::noise_seed);
 
     py::class_<AuditoryInput>(m, "AuditoryInput",
         "Auditory input encoder: spectrum -> MGN currents via tonotopic mapping")
@@ -451,6 +641,27 @@ PYBIND11_MODULE(pywuyun, m) {
     py::class_<SpikeBus>(m, "SpikeBus")
         .def("num_projections", &SpikeBus::num_projections);
 
+    // =========================================================================
+    // Profiler (hot-path instrumentation, compiled in with WUYUN_PROFILE)
+    // =========================================================================
+    py::class_<RegionCounters>(m, "RegionCounters")
+        .def_readonly("steps",              &RegionCounters::steps)
+        .def_readonly("spikes_in",          &RegionCounters::spikes_in)
+        .def_readonly("spikes_out",         &RegionCounters::spikes_out)
+        .def_readonly("synaptic_events",    &RegionCounters::synaptic_events)
+        .def_readonly("plasticity_updates", &RegionCounters::plasticity_updates);
+
+    py::class_<Profiler>(m, "Profiler")
+        .def("enable", &Profiler::enable, py::arg("max_trace_events") = size_t(1u << 20))
+        .def("disable", &Profiler::disable)
+        .def("enabled", &Profiler::enabled)
+        .def("reset", &Profiler::reset)
+        .def("region", static_cast<const RegionCounters& (Profiler::*)(size_t) const>(&Profiler::region),
+             py::return_value_policy::reference_internal)
+        .def("summary", &Profiler::summary)
+        .def("chrome_trace", &Profiler::chrome_trace)
+        .def("write_chrome_trace", &Profiler::write_chrome_trace, py::arg("path"));
+
     // =========================================================================
     // SimulationEngine
     // =========================================================================
@@ -509,8 +720,43 @@ PYBIND11_MODULE(pywuyun, m) {
         .def("add_projection", &SimulationEngine::add_projection,
              py::arg("src"), py::arg("dst"), py::arg("delay"),
              py::arg("proj_name") = std::string(""))
-        .def("step", &SimulationEngine::step, py::arg("dt") = 1.0f)
-        .def("run", &SimulationEngine::run, py::arg("steps"), py::arg("dt") = 1.0f)
+        .def("step", &SimulationEngine::step, py::arg("dt") = 1.0f,
+             py::call_guard<py::gil_scoped_release>())
+        .def("run", &SimulationEngine::run, py::arg("steps"), py::arg("dt") = 1.0f,
+             py::call_guard<py::gil_scoped_release>(),
+             "Run N steps (releases the GIL: other Python threads keep running)")
+        .def("run_windowed", &SimulationEngine::run_windowed, py::arg("steps"),
+             py::arg("dt") = 1.0f, py::arg("window") = 0,
+             py::call_guard<py::gil_scoped_release>(),
+             "Run with conservative sync windows (window=0: min projection delay)")
+        .def("min_projection_delay", &SimulationEngine::min_projection_delay)
+        .def("use_worker_pool", &SimulationEngine::use_worker_pool, py::arg("n_threads"),
+             py::arg("rebalance_interval") = 1000, py::arg("pin") = false,
+             "Step regions on a persistent thread pool (n_threads<=0: OpenMP; "
+             "pin=True binds worker k to core k, only for one pool per process)")
+        .def("worker_threads", &SimulationEngine::worker_threads)
+        .def("set_quiescence_skipping", &SimulationEngine::set_quiescence_skipping,
+             py::arg("enable"), "Skip quiescent regions and catch them up analytically on wake-up")
+        .def("quiescence_skipping", &SimulationEngine::quiescence_skipping)
+        .def("define_mask", &SimulationEngine::define_mask, py::arg("name"), py::arg("regions"),
+             py::arg("projections") = std::vector<std::string>{},
+             "Named execution mask: only listed regions step, the rest are frozen")
+        .def("use_mask", &SimulationEngine::use_mask, py::arg("name"),
+             "Switch to a named execution mask ('' = whole brain)")
+        .def("active_mask", &SimulationEngine::active_mask)
+        .def("profiler", static_cast<Profiler& (SimulationEngine::*)()>(&SimulationEngine::profiler),
+             py::return_value_policy::reference_internal,
+             "Hot-path profiler: enable(), summary(), write_chrome_trace(path)")
+        .def("enable_telemetry", &SimulationEngine::enable_telemetry, py::arg("name"),
+             py::arg("every") = 100, py::arg("capacity") = 1024,
+             "Publish a telemetry frame to shared memory every N steps (read with wuyun.telemetry)")
+        .def("disable_telemetry", &SimulationEngine::disable_telemetry)
+        .def("set_spike_recorder", &SimulationEngine::set_spike_recorder, py::arg("writer"),
+             py::keep_alive<1, 2>(), "Stream spikes through an open SpikeRasterWriter (None stops)")
+        .def("set_weight_format", &SimulationEngine::set_weight_format, py::arg("fmt"),
+             "Synaptic weight storage for all regions (BF16: half the weight traffic)")
+        .def("compact_synapses", &SimulationEngine::compact_synapses,
+             "Remove pruned synapses and rebuild CSR in all regions; returns count removed")
         .def("current_time", &SimulationEngine::current_time)
         .def("num_regions", &SimulationEngine::num_regions)
         .def("find_region", &SimulationEngine::find_region,
@@ -525,6 +771,10 @@ PYBIND11_MODULE(pywuyun, m) {
                 static_cast<SimulationEngine::NeuromodType>(type));
         }, py::arg("name"), py::arg("type"),
            "Register neuromod source (type: 0=DA, 1=NE, 2=5HT, 3=ACh)")
+        .def("set_clock_period", &SimulationEngine::set_clock_period,
+             py::arg("name"), py::arg("period"),
+             "Set slow clock period in steps ('oscillation', 'neuromod', or user clock)")
+        .def("clock_period", &SimulationEngine::clock_period, py::arg("name"))
         // Convenience: build standard 21-region brain
         .def("build_standard_brain", [](SimulationEngine& eng, int scale) {
             size_t s = static_cast<size_t>(std::max(1, scale));
@@ -861,6 +1111,13 @@ PYBIND11_MODULE(pywuyun, m) {
         .value("SHT", SimulationEngine::NeuromodType::SHT)
         .value("ACh", SimulationEngine::NeuromodType::ACh);
 
+    // =========================================================================
+    // WeightFormat enum
+    // =========================================================================
+    py::enum_<WeightFormat>(m, "WeightFormat")
+        .value("FP32", WeightFormat::FP32)
+        .value("BF16", WeightFormat::BF16);
+
     // =========================================================================
     // HomeostaticParams
     // =========================================================================
@@ -874,6 +1131,21 @@ PYBIND11_MODULE(pywuyun, m) {
         .def_readwrite("w_max",          &HomeostaticParams::w_max)
         .def_readwrite("scale_interval", &HomeostaticParams::scale_interval);
 
+    // =========================================================================
+    // StructuralParams
+    // =========================================================================
+    py::class_<StructuralParams>(m, "StructuralParams",
+        "Parameters for structural plasticity (pruning + activity-dependent growth)")
+        .def(py::init<>())
+        .def_readwrite("prune_threshold", &StructuralParams::prune_threshold)
+        .def_readwrite("prune_window",    &StructuralParams::prune_window)
+        .def_readwrite("check_interval",  &StructuralParams::check_interval)
+        .def_readwrite("grow_enabled",    &StructuralParams::grow_enabled)
+        .def_readwrite("grow_threshold",  &StructuralParams::grow_threshold)
+        .def_readwrite("grow_w_init",     &StructuralParams::grow_w_init)
+        .def_readwrite("grow_samples",    &StructuralParams::grow_samples)
+        .def_readwrite("rate_tau",        &StructuralParams::rate_tau);
+
     // =========================================================================
     // SleepStage enum
     // =========================================================================
@@ -898,7 +1170,8 @@ PYBIND11_MODULE(pywuyun, m) {
         .def_readwrite("rem_pgo_amplitude", &SleepCycleConfig::rem_pgo_amplitude)
         .def_readwrite("rem_motor_inhibit", &SleepCycleConfig::rem_motor_inhibit)
         .def_readwrite("rem_cortex_noise",  &SleepCycleConfig::rem_cortex_noise)
-        .def_readwrite("rem_theta_amp",     &SleepCycleConfig::rem_theta_amp);
+        .def_readwrite("rem_theta_amp",     &SleepCycleConfig::rem_theta_amp)
+        .def_readwrite("pgo_seed",          &SleepCycleConfig::pgo_seed);
 
     // =========================================================================
     // SleepCycleManager
@@ -990,7 +1263,11 @@ PYBIND11_MODULE(pywuyun, m) {
         .def_readwrite("reward_scale",           &AgentConfig::reward_scale)
         .def_readwrite("enable_da_stdp",         &AgentConfig::enable_da_stdp)
         .def_readwrite("da_stdp_lr",             &AgentConfig::da_stdp_lr)
-        .def_readwrite("enable_homeostatic",     &AgentConfig::enable_homeostatic);
+        .def_readwrite("enable_homeostatic",     &AgentConfig::enable_homeostatic)
+        .def_readwrite("enable_structural_plasticity", &AgentConfig::enable_structural_plasticity)
+        .def_readwrite("async_consolidation",     &AgentConfig::async_consolidation)
+        .def_readwrite("async_consolidation_lag", &AgentConfig::async_consolidation_lag)
+        .def_readwrite("sleep_region_masks",      &AgentConfig::sleep_region_masks);
 
     py::class_<Environment::Result>(m, "EnvResult",
         "Result of an environment step")
@@ -1003,16 +1280,38 @@ PYBIND11_MODULE(pywuyun, m) {
     py::class_<ClosedLoopAgent, std::unique_ptr<ClosedLoopAgent>>(m, "ClosedLoopAgent",
         "Closed-loop agent: Environment \u2194 WuYun brain")
         .def(py::init([](const GridWorldConfig& wcfg, const AgentConfig& cfg) {
+            py::gil_scoped_release nogil;   // 建脑耗时, 多线程并行构造
             return std::make_unique<ClosedLoopAgent>(
                 std::make_unique<GridWorldEnv>(wcfg), cfg);
         }), py::arg("world_config") = GridWorldConfig{},
             py::arg("config") = AgentConfig{})
         .def("reset_world",  &ClosedLoopAgent::reset_world)
-        .def("agent_step",   &ClosedLoopAgent::agent_step)
-        .def("run",          &ClosedLoopAgent::run, py::arg("n_steps"))
+        .def("reset_world_with_seed", &ClosedLoopAgent::reset_world_with_seed, py::arg("seed"))
+        .def("agent_step",   &ClosedLoopAgent::agent_step,
+             py::call_guard<py::gil_scoped_release>())
+        .def("agent_steps", [](ClosedLoopAgent& a, int n_steps) {
+            std::vector<float> rewards(static_cast<size_t>(std::max(0, n_steps)));
+            {
+                py::gil_scoped_release nogil;
+                for (auto& r : rewards) r = a.agent_step().reward;
+            }
+            return py::array_t<float>({static_cast<py::ssize_t>(rewards.size())}, rewards.data());
+        }, py::arg("n_steps"), "Batch of agent steps without the GIL; returns per-step rewards")
+        .def("run",          &ClosedLoopAgent::run, py::arg("n_steps"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Run N agent steps (releases the GIL: agents in other threads run in parallel)")
+        .def("enable_telemetry", &ClosedLoopAgent::enable_telemetry, py::arg("name"),
+             py::arg("every") = 1000, py::arg("capacity") = 1024,
+             "Shared-memory telemetry incl. reward rate, BG DA and D1/D2 weight norms")
         .def("env",          static_cast<Environment& (ClosedLoopAgent::*)()>(&ClosedLoopAgent::env),
              py::return_value_policy::reference)
-        .def("brain",        &ClosedLoopAgent::brain, py::return_value_policy::reference)
+        .def("brain",        &ClosedLoopAgent::brain, py::return_value_policy::reference_internal)
+        .def("bg",   &ClosedLoopAgent::bg,    py::return_value_policy::reference_internal)
+        .def("vta",  &ClosedLoopAgent::vta,   py::return_value_policy::reference_internal)
+        .def("hipp", &ClosedLoopAgent::hipp,  py::return_value_policy::reference_internal)
+        .def("v1",   &ClosedLoopAgent::v1,    py::return_value_policy::reference_internal)
+        .def("dlpfc", &ClosedLoopAgent::dlpfc, py::return_value_policy::reference_internal)
+        .def("m1",   &ClosedLoopAgent::m1,    py::return_value_policy::reference_internal)
         .def("agent_step_count", &ClosedLoopAgent::agent_step_count)
         .def("last_action",  &ClosedLoopAgent::last_action)
         .def("last_reward",  &ClosedLoopAgent::last_reward)
@@ -1021,5 +1320,140 @@ PYBIND11_MODULE(pywuyun, m) {
         .def("food_rate",    &ClosedLoopAgent::food_rate,
              py::arg("window") = 100);
 
+    // =========================================================================
+    // VecEnv (batched GridWorld / MultiRoom)
+    // =========================================================================
+    py::class_<MultiRoomConfig>(m, "MultiRoomConfig")
+        .def(py::init<>())
+        .def_readwrite("n_rooms_x",     &MultiRoomConfig::n_rooms_x)
+        .def_readwrite("n_rooms_y",     &MultiRoomConfig::n_rooms_y)
+        .def_readwrite("room_w",        &MultiRoomConfig::room_w)
+        .def_readwrite("room_h",        &MultiRoomConfig::room_h)
+        .def_readwrite("n_food",        &MultiRoomConfig::n_food)
+        .def_readwrite("n_danger",      &MultiRoomConfig::n_danger)
+        .def_readwrite("vision_radius", &MultiRoomConfig::vision_radius)
+        .def_readwrite("seed",          &MultiRoomConfig::seed);
+
+    using FloatIn = py::array_t<float, py::array::c_style | py::array::forcecast>;
+    py::class_<VecEnv>(m, "VecEnv", "N worlds stepped/observed in one call (world i: seed + i)")
+        .def_static("grid_world", &VecEnv::grid_world, py::arg("n"),
+                    py::arg("config") = GridWorldConfig{})
+        .def_static("multi_room", &VecEnv::multi_room, py::arg("n"),
+                    py::arg("config") = MultiRoomConfig{})
+        .def("__len__", &VecEnv::size)
+        .def("obs_shape", [](const VecEnv& v) {
+            return py::make_tuple(v.size(), v.vis_height(), v.vis_width());
+        })
+        .def("reset", py::overload_cast<>(&VecEnv::reset))
+        .def("reset_world", [](VecEnv& v, size_t i, uint32_t seed) {
+            if (i >= v.size()) throw py::index_error("world index out of range");
+            v.reset(i, seed);
+        }, py::arg("i"), py::arg("seed"))
+        .def("observe", [](py::object self) {
+            auto& v = self.cast<VecEnv&>();
+            const auto& obs = v.observe_all();
+            auto h = static_cast<py::ssize_t>(v.vis_height()), w = static_cast<py::ssize_t>(v.vis_width());
+            auto f = static_cast<py::ssize_t>(sizeof(float));
+            py::array_t<float> a({static_cast<py::ssize_t>(v.size()), h, w},
+                                 {h * w * f, w * f, f}, obs.data(), self);
+            a.attr("flags").attr("writeable") = false;
+            return a;
+        }, "All observations as a zero-copy read-only [n, h, w] view (refilled by every observe())")
+        .def("step", [](VecEnv& v, const FloatIn& dx, const FloatIn& dy) {
+            if (static_cast<size_t>(dx.size()) != v.size() || static_cast<size_t>(dy.size()) != v.size())
+                throw py::value_error("dx/dy must have one entry per world");
+            py::gil_scoped_release nogil;
+            v.step(dx.data(), dy.data());
+        }, py::arg("dx"), py::arg("dy"), "Step world i by (dx[i], dy[i]); results via reward()/pos_x()/...")
+        .def("reward",   view_of(&VecEnv::reward))
+        .def("pos_x",    view_of(&VecEnv::pos_x))
+        .def("pos_y",    view_of(&VecEnv::pos_y))
+        .def("positive", view_of(&VecEnv::positive))
+        .def("negative", view_of(&VecEnv::negative))
+        .def("total_positive", &VecEnv::total_positive)
+        .def("total_negative", &VecEnv::total_negative);
+
+    // =========================================================================
+    // Genome / EvolutionEngine / DevEvolutionEngine
+    // =========================================================================
+    py::class_<Gene>(m, "Gene")
+        .def_readonly("name",     &Gene::name)
+        .def_readwrite("value",   &Gene::value)
+        .def_readonly("min_val",  &Gene::min_val)
+        .def_readonly("max_val",  &Gene::max_val)
+        .def("clamp", &Gene::clamp);
+
+    py::class_<Genome>(m, "Genome", "Direct-encoding genome (AgentConfig parameters)")
+        .def(py::init<>())
+        .def("genes", static_cast<std::vector<Gene*> (Genome::*)()>(&Genome::all_genes),
+             py::return_value_policy::reference_internal)
+        .def("n_genes", &Genome::n_genes)
+        .def_readwrite("fitness",    &Genome::fitness)
+        .def_readwrite("generation", &Genome::generation)
+        .def("to_agent_config", &Genome::to_agent_config)
+        .def("to_json", &Genome::to_json)
+        .def_static("from_json", &Genome::from_json, py::arg("json"))
+        .def("summary", &Genome::summary)
+        .def("__repr__", &Genome::summary);
+
+    py::class_<DevGenome>(m, "DevGenome", "Indirect-encoding developmental genome")
+        .def(py::init<>())
+        .def("genes", static_cast<std::vector<Gene*> (DevGenome::*)()>(&DevGenome::all_genes),
+             py::return_value_policy::reference_internal)
+        .def("n_genes", &DevGenome::n_genes)
+        .def_readwrite("fitness",    &DevGenome::fitness)
+        .def_readwrite("generation", &DevGenome::generation)
+        .def("to_agent_config", [](const DevGenome& g) { return Developer::to_agent_config(g); })
+        .def("to_json", &DevGenome::to_json)
+        .def("summary", &DevGenome::summary)
+        .def("__repr__", &DevGenome::summary);
+
+    py::class_<EvolutionConfig>(m, "EvolutionConfig")
+        .def(py::init<>())
+        .def_readwrite("population_size", &EvolutionConfig::population_size)
+        .def_readwrite("n_generations",   &EvolutionConfig::n_generations)
+        .def_readwrite("tournament_size", &EvolutionConfig::tournament_size)
+        .def_readwrite("mutation_rate",   &EvolutionConfig::mutation_rate)
+        .def_readwrite("mutation_sigma",  &EvolutionConfig::mutation_sigma)
+        .def_readwrite("elite_fraction",  &EvolutionConfig::elite_fraction)
+        .def_readwrite("eval_steps",      &EvolutionConfig::eval_steps)
+        .def_readwrite("eval_seeds",      &EvolutionConfig::eval_seeds)
+        .def_readwrite("ga_seed",         &EvolutionConfig::ga_seed)
+        .def_readwrite("world_config",    &EvolutionConfig::world_config);
+
+    py::class_<FitnessResult>(m, "FitnessResult")
+        .def_readonly("fitness",      &FitnessResult::fitness)
+        .def_readonly("early_safety", &FitnessResult::early_safety)
+        .def_readonly("late_safety",  &FitnessResult::late_safety)
+        .def_readonly("improvement",  &FitnessResult::improvement)
+        .def_readonly("total_food",   &FitnessResult::total_food)
+        .def_readonly("total_danger", &FitnessResult::total_danger);
+
+    py::class_<MultitaskFitness>(m, "MultitaskFitness")
+        .def_readonly("fitness",       &MultitaskFitness::fitness)
+        .def_readonly("open_field",    &MultitaskFitness::open_field)
+        .def_readonly("sparse_reward", &MultitaskFitness::sparse_reward)
+        .def_readonly("reversal",      &MultitaskFitness::reversal)
+        .def_readonly("total_food",    &MultitaskFitness::total_food)
+        .def_readonly("total_danger",  &MultitaskFitness::total_danger);
+
+    // run/evaluate release the GIL; the progress callback re-acquires it (pybind11/functional.h)
+    py::class_<EvolutionEngine>(m, "EvolutionEngine", "Genetic algorithm over Genome")
+        .def(py::init<const EvolutionConfig&>(), py::arg("config") = EvolutionConfig{})
+        .def("run", &EvolutionEngine::run, py::call_guard<py::gil_scoped_release>())
+        .def("evaluate", &EvolutionEngine::evaluate, py::arg("genome"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("hall_of_fame", &EvolutionEngine::hall_of_fame)
+        .def("set_progress_callback", &EvolutionEngine::set_progress_callback, py::arg("callback"),
+             "callback(generation, best_fitness, best_summary), called once per generation");
+
+    py::class_<DevEvolutionEngine>(m, "DevEvolutionEngine",
+        "Genetic algorithm over DevGenome (multitask fitness)")
+        .def(py::init<const EvolutionConfig&>(), py::arg("config") = EvolutionConfig{})
+        .def("run", &DevEvolutionEngine::run, py::call_guard<py::gil_scoped_release>())
+        .def("evaluate", &DevEvolutionEngine::evaluate, py::arg("genome"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("hall_of_fame", &DevEvolutionEngine::hall_of_fame);
+
     m.def("version", []() { return "0.6.0"; });
 }
@@ -1,4 +1,5 @@
 #include "circuit/cortical_column.h"
+#include "core/random_connect.h"
 #include <random>
 #include <algorithm>
 #include <cmath>
@@ -19,25 +20,46 @@ struct COO {
 static COO make_random_connections(
     size_t n_pre, size_t n_post,
     float prob, float weight, int32_t delay,
-    uint32_t seed
+    uint32_t seed, int32_t max_delay = 1
 ) {
     COO coo;
     std::mt19937 rng(seed);
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-
-    for (size_t i = 0; i < n_pre; ++i) {
-        for (size_t j = 0; j < n_post; ++j) {
-            if (dist(rng) < prob) {
-                coo.pre.push_back(static_cast<int32_t>(i));
-                coo.post.push_back(static_cast<int32_t>(j));
-                coo.weights.push_back(weight);
-                coo.delays.push_back(delay);
-            }
-        }
-    }
+    // 延迟谱用独立随机流, 拓扑与 max_delay 无关
+    std::mt19937 delay_rng(seed ^ 0x9E3779B9u);
+    std::uniform_int_distribution<int32_t> delay_dist(delay, std::max(delay, max_delay));
+
+    for_each_random_pair(n_pre, n_post, prob, rng, [&](size_t i, size_t j) {
+        coo.pre.push_back(static_cast<int32_t>(i));
+        coo.post.push_back(static_cast<int32_t>(j));
+        coo.weights.push_back(weight);
+        coo.delays.push_back(max_delay > delay ? delay_dist(delay_rng) : delay);
+    });
     return coo;
 }
 
+// 外部 ID → 内部下标重标号; 行内按 post 升序 (单调收集)
+static void relabel(COO& coo, const NeuronOrder& pre, const NeuronOrder& post) {
+    if (pre.identity() && post.identity()) return;
+    size_t n = coo.pre.size();
+    for (size_t s = 0; s < n; ++s) {
+        coo.pre[s]  = static_cast<int32_t>(pre.to_internal(static_cast<size_t>(coo.pre[s])));
+        coo.post[s] = static_cast<int32_t>(post.to_internal(static_cast<size_t>(coo.post[s])));
+    }
+    std::vector<size_t> idx(n);
+    for (size_t s = 0; s < n; ++s) idx[s] = s;
+    std::sort(idx.begin(), idx.end(), [&](size_t a, size_t b) {
+        return coo.pre[a] != coo.pre[b] ? coo.pre[a] < coo.pre[b] : coo.post[a] < coo.post[b];
+    });
+    COO sorted;
+    for (size_t s : idx) {
+        sorted.pre.push_back(coo.pre[s]);
+        sorted.post.push_back(coo.post[s]);
+        sorted.weights.push_back(coo.weights[s]);
+        sorted.delays.push_back(coo.delays[s]);
+    }
+    coo = std::move(sorted);
+}
+
 // =============================================================================
 // Helper: make a dummy SynapseGroup (0 synapses) as placeholder
 // =============================================================================
@@ -117,10 +139,6 @@ CorticalColumn::CorticalColumn(const ColumnConfig& cfg)
     , syn_l5_to_l6_(EMPTY_SYN(AMPA_PARAMS, CompartmentType::BASAL))
     , syn_l6_to_l4_(EMPTY_SYN(AMPA_PARAMS, CompartmentType::BASAL))
     , syn_l23_recurrent_(EMPTY_SYN(AMPA_PARAMS, CompartmentType::BASAL))
-    // --- NMDA synapses (placeholders) ---
-    , syn_l4_to_l23_nmda_(EMPTY_SYN(NMDA_PARAMS, CompartmentType::BASAL))
-    , syn_l23_to_l5_nmda_(EMPTY_SYN(NMDA_PARAMS, CompartmentType::BASAL))
-    , syn_l23_rec_nmda_(EMPTY_SYN(NMDA_PARAMS, CompartmentType::BASAL))
     // --- Exc -> Inh ---
     , syn_exc_to_pv_(EMPTY_SYN(AMPA_PARAMS, CompartmentType::SOMA))
     , syn_exc_to_sst_(EMPTY_SYN(AMPA_PARAMS, CompartmentType::SOMA))
@@ -150,48 +168,96 @@ CorticalColumn::CorticalColumn(const ColumnConfig& cfg)
 void CorticalColumn::build_synapses() {
     const auto& c = config_;
     uint32_t seed = 42;
+    const size_t pop_n[N_POPS] = {
+        c.n_l4_stellate, c.n_l23_pyramidal, c.n_l5_pyramidal, c.n_l6_pyramidal,
+        c.n_pv_basket, c.n_sst_martinotti, c.n_vip
+    };
 
-    // Helper lambda for building a SynapseGroup
-    auto build = [&](size_t npre, size_t npost, float prob, float w,
-                     const SynapseParams& sp, CompartmentType tgt) -> SynapseGroup {
-        auto coo = make_random_connections(npre, npost, prob, w, 1, seed++);
-        return SynapseGroup(npre, npost, coo.pre, coo.post, coo.weights, coo.delays, sp, tgt);
+    // 先生成全部连接 (种子顺序与逐组构造相同), 重排需要看到整张柱内连接图
+    struct Pending {
+        SynapseGroup* dst;
+        Pop pre, post;
+        COO coo;
+        const SynapseParams* sp;
+        CompartmentType tgt;
+    };
+    std::vector<Pending> pending;
+    auto build = [&](SynapseGroup& dst, Pop pre, Pop post, float prob, float w,
+                     const SynapseParams& sp, CompartmentType tgt) {
+        pending.push_back({&dst, pre, post,
+                           make_random_connections(pop_n[pre], pop_n[post], prob, w, 1, seed++, c.max_intra_delay),
+                           &sp, tgt});
     };
 
     // ===================== Excitatory AMPA =====================
-    syn_l4_to_l23_     = build(c.n_l4_stellate,   c.n_l23_pyramidal, c.p_l4_to_l23,    c.w_exc,       AMPA_PARAMS, CompartmentType::BASAL);
-    syn_l23_to_l5_     = build(c.n_l23_pyramidal,  c.n_l5_pyramidal,  c.p_l23_to_l5,    c.w_exc,       AMPA_PARAMS, CompartmentType::BASAL);
-    syn_l5_to_l6_      = build(c.n_l5_pyramidal,   c.n_l6_pyramidal,  c.p_l5_to_l6,     c.w_exc,       AMPA_PARAMS, CompartmentType::BASAL);
-    syn_l6_to_l4_      = build(c.n_l6_pyramidal,   c.n_l4_stellate,   c.p_l6_to_l4,     c.w_l6_to_l4,  AMPA_PARAMS, CompartmentType::BASAL);
-    syn_l23_recurrent_  = build(c.n_l23_pyramidal,  c.n_l23_pyramidal, c.p_l23_recurrent, c.w_recurrent, AMPA_PARAMS, CompartmentType::BASAL);
-
-    // ===================== Excitatory NMDA (parallel slow) =====================
-    syn_l4_to_l23_nmda_ = build(c.n_l4_stellate,   c.n_l23_pyramidal, c.p_l4_to_l23,    c.w_nmda, NMDA_PARAMS, CompartmentType::BASAL);
-    syn_l23_to_l5_nmda_ = build(c.n_l23_pyramidal,  c.n_l5_pyramidal,  c.p_l23_to_l5,    c.w_nmda, NMDA_PARAMS, CompartmentType::BASAL);
-    syn_l23_rec_nmda_   = build(c.n_l23_pyramidal,  c.n_l23_pyramidal, c.p_l23_recurrent, c.w_nmda * 0.5f, NMDA_PARAMS, CompartmentType::BASAL);
-
-    // ===================== Auto-enable STDP if configured =====================
-    if (c.stdp_enabled) {
-        enable_stdp();
-    }
+    build(syn_l4_to_l23_,     POP_L4,  POP_L23, c.p_l4_to_l23,     c.w_exc,       AMPA_PARAMS, CompartmentType::BASAL);
+    build(syn_l23_to_l5_,     POP_L23, POP_L5,  c.p_l23_to_l5,     c.w_exc,       AMPA_PARAMS, CompartmentType::BASAL);
+    build(syn_l5_to_l6_,      POP_L5,  POP_L6,  c.p_l5_to_l6,      c.w_exc,       AMPA_PARAMS, CompartmentType::BASAL);
+    build(syn_l6_to_l4_,      POP_L6,  POP_L4,  c.p_l6_to_l4,      c.w_l6_to_l4,  AMPA_PARAMS, CompartmentType::BASAL);
+    build(syn_l23_recurrent_, POP_L23, POP_L23, c.p_l23_recurrent, c.w_recurrent, AMPA_PARAMS, CompartmentType::BASAL);
+    seed += 3;  // 保留原独立 NMDA 组的种子位, 其余通路拓扑不变
 
     // ===================== Exc -> Inhibitory (AMPA) =====================
-    syn_exc_to_pv_  = build(c.n_l23_pyramidal, c.n_pv_basket,      c.p_exc_to_pv,  c.w_exc, AMPA_PARAMS, CompartmentType::SOMA);
-    syn_exc_to_sst_ = build(c.n_l23_pyramidal, c.n_sst_martinotti, c.p_exc_to_sst, c.w_exc, AMPA_PARAMS, CompartmentType::SOMA);
-    syn_exc_to_vip_ = build(c.n_l23_pyramidal, c.n_vip,            c.p_exc_to_vip, c.w_exc, AMPA_PARAMS, CompartmentType::SOMA);
+    build(syn_exc_to_pv_,  POP_L23, POP_PV,  c.p_exc_to_pv,  c.w_exc, AMPA_PARAMS, CompartmentType::SOMA);
+    build(syn_exc_to_sst_, POP_L23, POP_SST, c.p_exc_to_sst, c.w_exc, AMPA_PARAMS, CompartmentType::SOMA);
+    build(syn_exc_to_vip_, POP_L23, POP_VIP, c.p_exc_to_vip, c.w_exc, AMPA_PARAMS, CompartmentType::SOMA);
 
     // ===================== PV -> ALL excitatory soma (GABA_A) =====================
-    syn_pv_to_l23_ = build(c.n_pv_basket, c.n_l23_pyramidal, c.p_pv_to_l23, c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
-    syn_pv_to_l4_  = build(c.n_pv_basket, c.n_l4_stellate,   c.p_pv_to_l4,  c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
-    syn_pv_to_l5_  = build(c.n_pv_basket, c.n_l5_pyramidal,  c.p_pv_to_l5,  c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
-    syn_pv_to_l6_  = build(c.n_pv_basket, c.n_l6_pyramidal,  c.p_pv_to_l6,  c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
+    build(syn_pv_to_l23_, POP_PV, POP_L23, c.p_pv_to_l23, c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
+    build(syn_pv_to_l4_,  POP_PV, POP_L4,  c.p_pv_to_l4,  c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
+    build(syn_pv_to_l5_,  POP_PV, POP_L5,  c.p_pv_to_l5,  c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
+    build(syn_pv_to_l6_,  POP_PV, POP_L6,  c.p_pv_to_l6,  c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
 
     // ===================== SST -> L2/3 AND L5 apical (GABA_B) =====================
-    syn_sst_to_l23_api_ = build(c.n_sst_martinotti, c.n_l23_pyramidal, c.p_sst_to_l23_api, c.w_inh, GABA_B_PARAMS, CompartmentType::APICAL);
-    syn_sst_to_l5_api_  = build(c.n_sst_martinotti, c.n_l5_pyramidal,  c.p_sst_to_l5_api,  c.w_inh, GABA_B_PARAMS, CompartmentType::APICAL);
+    build(syn_sst_to_l23_api_, POP_SST, POP_L23, c.p_sst_to_l23_api, c.w_inh, GABA_B_PARAMS, CompartmentType::APICAL);
+    build(syn_sst_to_l5_api_,  POP_SST, POP_L5,  c.p_sst_to_l5_api,  c.w_inh, GABA_B_PARAMS, CompartmentType::APICAL);
 
     // ===================== VIP -> SST (GABA_A disinhibition) =====================
-    syn_vip_to_sst_ = build(c.n_vip, c.n_sst_martinotti, c.p_vip_to_sst, c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
+    build(syn_vip_to_sst_, POP_VIP, POP_SST, c.p_vip_to_sst, c.w_inh, GABA_A_PARAMS, CompartmentType::SOMA);
+
+    // ===================== Locality reordering (optional) =====================
+    // 全柱神经元 (各群体顺次编号) 上做 RCM, 再按全局名次得到每个群体的内部顺序
+    if (c.locality_reorder) {
+        size_t offset[N_POPS + 1] = {0};
+        for (int p = 0; p < N_POPS; ++p) offset[p + 1] = offset[p] + pop_n[p];
+        std::vector<std::pair<int32_t, int32_t>> edges;
+        for (const auto& pg : pending) {
+            for (size_t s = 0; s < pg.coo.pre.size(); ++s) {
+                edges.emplace_back(static_cast<int32_t>(offset[pg.pre])  + pg.coo.pre[s],
+                                   static_cast<int32_t>(offset[pg.post]) + pg.coo.post[s]);
+            }
+        }
+        std::vector<int32_t> global = rcm_order(offset[N_POPS], edges);
+        std::vector<std::vector<int32_t>> seq(N_POPS);
+        for (int32_t g : global) {
+            int p = 0;
+            while (static_cast<size_t>(g) >= offset[p + 1]) ++p;
+            seq[p].push_back(g - static_cast<int32_t>(offset[p]));
+        }
+        for (int p = 0; p < N_POPS; ++p) orders_[p] = NeuronOrder::from_sequence(std::move(seq[p]));
+    }
+
+    for (auto& pg : pending) {
+        relabel(pg.coo, orders_[pg.pre], orders_[pg.post]);
+        *pg.dst = SynapseGroup(pop_n[pg.pre], pop_n[pg.post], pg.coo.pre, pg.coo.post,
+                               pg.coo.weights, pg.coo.delays, *pg.sp, pg.tgt);
+    }
+
+    // ===================== Excitatory NMDA (co-localized slow channel) =====================
+    // NMDA 与 AMPA 共定位于同一突触: 共享 CSR 拓扑, 一次投递/融合计算
+    syn_l4_to_l23_.enable_nmda_channel(NMDA_PARAMS, c.w_nmda);
+    syn_l23_to_l5_.enable_nmda_channel(NMDA_PARAMS, c.w_nmda);
+    syn_l23_recurrent_.enable_nmda_channel(NMDA_PARAMS, c.w_nmda * 0.5f);
+
+    // 放大后的主通路/循环组: CSC 镜像, 电流按 post 行并行归约
+    for (SynapseGroup* sg : {&syn_l4_to_l23_, &syn_l23_to_l5_, &syn_l23_recurrent_}) {
+        if (sg->n_synapses() >= SynapseGroup::POST_MAJOR_MIN_SYNAPSES) sg->enable_post_major();
+    }
+
+    // ===================== Auto-enable STDP if configured =====================
+    if (c.stdp_enabled) {
+        enable_stdp();
+    }
 }
 
 // =============================================================================
@@ -227,8 +293,9 @@ void CorticalColumn::deliver_and_inject(
 
 void CorticalColumn::inject_feedforward(const std::vector<float>& currents) {
     size_t n = std::min(currents.size(), l4_stellate_.size());
+    const auto& order = orders_[POP_L4];
     for (size_t i = 0; i < n; ++i) {
-        l4_stellate_.inject_basal(i, currents[i]);
+        l4_stellate_.inject_basal(order.to_internal(i), currents[i]);
     }
 }
 
@@ -239,12 +306,12 @@ void CorticalColumn::inject_feedback(
     // Feedback -> L2/3 apical (via L1)
     size_t n23 = std::min(currents_l23.size(), l23_pyramidal_.size());
     for (size_t i = 0; i < n23; ++i) {
-        l23_pyramidal_.inject_apical(i, currents_l23[i]);
+        l23_pyramidal_.inject_apical(orders_[POP_L23].to_internal(i), currents_l23[i]);
     }
     // Feedback -> L5 apical (via L1)
     size_t n5 = std::min(currents_l5.size(), l5_pyramidal_.size());
     for (size_t i = 0; i < n5; ++i) {
-        l5_pyramidal_.inject_apical(i, currents_l5[i]);
+        l5_pyramidal_.inject_apical(orders_[POP_L5].to_internal(i), currents_l5[i]);
     }
 }
 
@@ -263,7 +330,7 @@ ColumnOutput CorticalColumn::step(int t, float dt) {
     // STEP 1: Deliver intra-column spikes from previous step
     // ================================================================
 
-    // --- Excitatory AMPA pathway: L4 → L2/3 → L5 → L6 → L4 ---
+    // --- Excitatory pathway: L4 → L2/3 → L5 → L6 → L4 (主通路 AMPA+NMDA 融合) ---
     deliver_and_inject(l4_stellate_,   syn_l4_to_l23_,    l23_pyramidal_, dt);
     deliver_and_inject(l23_pyramidal_, syn_l23_to_l5_,    l5_pyramidal_,  dt);
     deliver_and_inject(l5_pyramidal_,  syn_l5_to_l6_,     l6_pyramidal_,  dt);
@@ -275,11 +342,6 @@ ColumnOutput CorticalColumn::step(int t, float dt) {
         deliver_and_inject(l6_pyramidal_, syn_l6_to_l23_predict_, l23_pyramidal_, dt);
     }
 
-    // --- Excitatory NMDA pathway (parallel slow channel) ---
-    deliver_and_inject(l4_stellate_,   syn_l4_to_l23_nmda_, l23_pyramidal_, dt);
-    deliver_and_inject(l23_pyramidal_, syn_l23_to_l5_nmda_, l5_pyramidal_,  dt);
-    deliver_and_inject(l23_pyramidal_, syn_l23_rec_nmda_,   l23_pyramidal_, dt);
-
     // --- Excitatory → Inhibitory ---
     deliver_and_inject(l23_pyramidal_, syn_exc_to_pv_,  pv_basket_,      dt);
     deliver_and_inject(l23_pyramidal_, syn_exc_to_sst_, sst_martinotti_, dt);
@@ -378,15 +440,36 @@ ColumnOutput CorticalColumn::step(int t, float dt) {
         }
     }
 
+    // ================================================================
+    // STEP 2.55: Structural plasticity (weak-synapse bookkeeping; 压缩在离线阶段)
+    // ================================================================
+    if (structural_active_) {
+        syn_l4_to_l23_.update_structural(l4_stellate_.fired(), l23_pyramidal_.fired(), dt);
+        syn_l23_recurrent_.update_structural(l23_pyramidal_.fired(), l23_pyramidal_.fired(), dt);
+        syn_l23_to_l5_.update_structural(l23_pyramidal_.fired(), l5_pyramidal_.fired(), dt);
+        if (predictive_learning_) {
+            syn_l6_to_l23_predict_.update_structural(l6_pyramidal_.fired(), l23_pyramidal_.fired(), dt);
+        }
+    }
+
     // ================================================================
     // STEP 2.6: Homeostatic plasticity (synaptic scaling)
     // ================================================================
     if (homeo_active_) {
-        // Update rate estimates every step
-        homeo_l4_->update_rates(l4_stellate_.fired().data(), dt);
-        homeo_l23_->update_rates(l23_pyramidal_.fired().data(), dt);
-        homeo_l5_->update_rates(l5_pyramidal_.fired().data(), dt);
-        homeo_l6_->update_rates(l6_pyramidal_.fired().data(), dt);
+        // Count spikes every step; fold into rate estimates on the slow clock
+        homeo_l4_->accumulate_spikes(l4_stellate_.fired().data());
+        homeo_l23_->accumulate_spikes(l23_pyramidal_.fired().data());
+        homeo_l5_->accumulate_spikes(l5_pyramidal_.fired().data());
+        homeo_l6_->accumulate_spikes(l6_pyramidal_.fired().data());
+
+        ++homeo_rate_count_;
+        if (homeo_rate_count_ >= homeo_rate_interval_) {
+            homeo_l4_->flush_rates(homeo_rate_count_, dt);
+            homeo_l23_->flush_rates(homeo_rate_count_, dt);
+            homeo_l5_->flush_rates(homeo_rate_count_, dt);
+            homeo_l6_->flush_rates(homeo_rate_count_, dt);
+            homeo_rate_count_ = 0;
+        }
 
         // Apply scaling periodically
         ++homeo_step_count_;
@@ -404,6 +487,110 @@ ColumnOutput CorticalColumn::step(int t, float dt) {
     return out;
 }
 
+// =============================================================================
+// 静息跳过
+// =============================================================================
+
+template <typename Self, typename Fn>
+void CorticalColumn::for_each_synapse(Self& self, Fn&& fn) {
+    fn(self.syn_l4_to_l23_);  fn(self.syn_l23_to_l5_); fn(self.syn_l5_to_l6_);
+    fn(self.syn_l6_to_l4_);   fn(self.syn_l23_recurrent_);
+    if (self.predictive_learning_) fn(self.syn_l6_to_l23_predict_);
+    fn(self.syn_exc_to_pv_);  fn(self.syn_exc_to_sst_); fn(self.syn_exc_to_vip_);
+    fn(self.syn_pv_to_l23_);  fn(self.syn_pv_to_l4_);   fn(self.syn_pv_to_l5_);
+    fn(self.syn_pv_to_l6_);
+    fn(self.syn_sst_to_l23_api_); fn(self.syn_sst_to_l5_api_);
+    fn(self.syn_vip_to_sst_);
+}
+
+void CorticalColumn::set_weight_format(WeightFormat fmt) {
+    weight_format_ = fmt;
+    for_each_synapse(*this, [fmt](SynapseGroup& sg) { sg.set_weight_format(fmt); });
+    syn_l6_to_l23_predict_.set_weight_format(fmt);
+}
+
+const std::vector<std::pair<const char*, CorticalColumn::SynapseMember>>&
+CorticalColumn::synapse_table() {
+    static const std::vector<std::pair<const char*, SynapseMember>> table = {
+        {"l4_to_l23",         &CorticalColumn::syn_l4_to_l23_},
+        {"l23_to_l5",         &CorticalColumn::syn_l23_to_l5_},
+        {"l5_to_l6",          &CorticalColumn::syn_l5_to_l6_},
+        {"l6_to_l4",          &CorticalColumn::syn_l6_to_l4_},
+        {"l23_recurrent",     &CorticalColumn::syn_l23_recurrent_},
+        {"l6_to_l23_predict", &CorticalColumn::syn_l6_to_l23_predict_},
+        {"exc_to_pv",         &CorticalColumn::syn_exc_to_pv_},
+        {"exc_to_sst",        &CorticalColumn::syn_exc_to_sst_},
+        {"exc_to_vip",        &CorticalColumn::syn_exc_to_vip_},
+        {"pv_to_l23",         &CorticalColumn::syn_pv_to_l23_},
+        {"pv_to_l4",          &CorticalColumn::syn_pv_to_l4_},
+        {"pv_to_l5",          &CorticalColumn::syn_pv_to_l5_},
+        {"pv_to_l6",          &CorticalColumn::syn_pv_to_l6_},
+        {"sst_to_l23_apical", &CorticalColumn::syn_sst_to_l23_api_},
+        {"sst_to_l5_apical",  &CorticalColumn::syn_sst_to_l5_api_},
+        {"vip_to_sst",        &CorticalColumn::syn_vip_to_sst_},
+    };
+    return table;
+}
+
+SynapseGroup* CorticalColumn::find_synapse(const std::string& name) {
+    if (name == "l6_to_l23_predict" && !predictive_learning_) return nullptr;
+    for (const auto& [n, member] : synapse_table()) {
+        if (name == n) return &(this->*member);
+    }
+    return nullptr;
+}
+
+std::vector<std::string> CorticalColumn::synapse_names() const {
+    std::vector<std::string> names;
+    for (const auto& entry : synapse_table()) {
+        if (entry.second == &CorticalColumn::syn_l6_to_l23_predict_ && !predictive_learning_) continue;
+        names.emplace_back(entry.first);
+    }
+    return names;
+}
+
+bool CorticalColumn::quiescent(float i_exc) const {
+    bool quiet = true;
+    for_each_synapse(*this, [&](const SynapseGroup& sg) { quiet = quiet && sg.quiescent(); });
+    return quiet
+        && l4_stellate_.quiescent(i_exc) && l23_pyramidal_.quiescent(i_exc)
+        && l5_pyramidal_.quiescent(i_exc) && l6_pyramidal_.quiescent()
+        && pv_basket_.quiescent() && sst_martinotti_.quiescent() && vip_.quiescent();
+}
+
+void CorticalColumn::catch_up(int32_t n_steps, float dt, float i_exc) {
+    for_each_synapse(*this, [&](SynapseGroup& sg) { sg.relax(n_steps, dt); });
+    l4_stellate_.relax(n_steps, dt, i_exc);
+    l23_pyramidal_.relax(n_steps, dt, i_exc);
+    l5_pyramidal_.relax(n_steps, dt, i_exc);
+    l6_pyramidal_.relax(n_steps, dt);
+    pv_basket_.relax(n_steps, dt);
+    sst_martinotti_.relax(n_steps, dt);
+    vip_.relax(n_steps, dt);
+
+    // 稳态: 跳过期间发放为 0, 只需按原顺序推进发放率窗口与缩放计数
+    if (!homeo_active_) return;
+    uint32_t remaining = static_cast<uint32_t>(n_steps);
+    while (remaining > 0) {
+        uint32_t to_scale = (homeo_interval_ > homeo_step_count_) ? homeo_interval_ - homeo_step_count_ : 1;
+        uint32_t m = std::min({remaining, homeo_rate_interval_ - homeo_rate_count_, to_scale});
+        homeo_rate_count_ += m;
+        homeo_step_count_ += m;
+        remaining -= m;
+        if (homeo_rate_count_ >= homeo_rate_interval_) {
+            homeo_l4_->flush_rates(homeo_rate_count_, dt);
+            homeo_l23_->flush_rates(homeo_rate_count_, dt);
+            homeo_l5_->flush_rates(homeo_rate_count_, dt);
+            homeo_l6_->flush_rates(homeo_rate_count_, dt);
+            homeo_rate_count_ = 0;
+        }
+        if (homeo_step_count_ >= homeo_interval_) {
+            homeo_step_count_ = 0;
+            apply_homeostatic_scaling();
+        }
+    }
+}
+
 // =============================================================================
 // Classify output
 // =============================================================================
@@ -460,13 +647,10 @@ size_t CorticalColumn::total_neurons() const {
 
 size_t CorticalColumn::total_synapses() const {
     return
-        // AMPA excitatory
+        // Excitatory (AMPA+NMDA 双受体突触按一个计)
         syn_l4_to_l23_.n_synapses() + syn_l23_to_l5_.n_synapses() +
         syn_l5_to_l6_.n_synapses() + syn_l6_to_l4_.n_synapses() +
         syn_l23_recurrent_.n_synapses() +
-        // NMDA excitatory
-        syn_l4_to_l23_nmda_.n_synapses() + syn_l23_to_l5_nmda_.n_synapses() +
-        syn_l23_rec_nmda_.n_synapses() +
         // Exc -> Inh
         syn_exc_to_pv_.n_synapses() + syn_exc_to_sst_.n_synapses() +
         syn_exc_to_vip_.n_synapses() +
@@ -514,11 +698,13 @@ void CorticalColumn::enable_predictive_learning() {
     {
         auto coo = make_random_connections(
             l6_pyramidal_.size(), l23_pyramidal_.size(),
-            0.15f, 0.2f, 1, 777);
+            0.15f, 0.2f, 1, 777, config_.max_intra_delay);
+        relabel(coo, orders_[POP_L6], orders_[POP_L23]);
         syn_l6_to_l23_predict_ = SynapseGroup(
             l6_pyramidal_.size(), l23_pyramidal_.size(),
             coo.pre, coo.post, coo.weights, coo.delays,
             AMPA_PARAMS, CompartmentType::APICAL);
+        syn_l6_to_l23_predict_.set_weight_format(weight_format_);
     }
 
     // Enable STDP on the prediction synapse
@@ -532,10 +718,30 @@ void CorticalColumn::enable_predictive_learning() {
     pred_params.w_min     = 0.0f;
     pred_params.w_max     = config_.stdp_w_max;
     syn_l6_to_l23_predict_.enable_stdp(pred_params);
+    if (structural_active_) syn_l6_to_l23_predict_.enable_structural(structural_params_);
 
     predictive_learning_ = true;
 }
 
+// =============================================================================
+// Structural plasticity
+// =============================================================================
+
+void CorticalColumn::enable_structural_plasticity(const StructuralParams& params) {
+    structural_params_ = params;
+    for_each_synapse(*this, [&](SynapseGroup& sg) {
+        if (sg.has_stdp()) sg.enable_structural(params);
+    });
+    structural_active_ = true;
+}
+
+size_t CorticalColumn::compact_synapses() {
+    if (!structural_active_) return 0;
+    size_t removed = 0;
+    for_each_synapse(*this, [&](SynapseGroup& sg) { removed += sg.compact(); });
+    return removed;
+}
+
 // =============================================================================
 // Enable homeostatic plasticity
 // =============================================================================
@@ -547,6 +753,8 @@ void CorticalColumn::enable_homeostatic(const HomeostaticParams& params) {
     homeo_l6_  = std::make_unique<SynapticScaler>(config_.n_l6_pyramidal, params);
     homeo_interval_ = params.scale_interval;
     homeo_step_count_ = 0;
+    homeo_rate_interval_ = std::max<uint32_t>(1, params.rate_interval);
+    homeo_rate_count_ = 0;
     homeo_active_ = true;
 }
 
@@ -557,8 +765,9 @@ void CorticalColumn::apply_homeostatic_scaling() {
 
     auto scale_syn = [](SynapticScaler& scaler, SynapseGroup& syn) {
         if (syn.n_synapses() == 0) return;
-        scaler.apply_scaling(syn.weights().data(), syn.n_synapses(),
-                             syn.col_idx().data());
+        syn.update_weights([&](std::vector<float>& w) {
+            scaler.apply_scaling(w.data(), syn.n_synapses(), syn.col_idx().data());
+        });
     };
 
     // L4 inputs: L6→L4 prediction loop
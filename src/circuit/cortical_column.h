@@ -28,11 +28,15 @@
 #include "core/types.h"
 #include "core/population.h"
 #include "core/synapse_group.h"
+#include "core/reorder.h"
 #include "plasticity/homeostatic.h"
+#include "plasticity/structural.h"
 #include <vector>
 #include <cstddef>
 #include <string>
 #include <memory>
+#include <array>
+#include <utility>
 
 namespace wuyun {
 
@@ -79,6 +83,12 @@ struct ColumnConfig {
     float w_l6_to_l4         = 0.3f;  // Prediction loop (weaker initially)
     float w_recurrent        = 0.2f;  // L2/3 recurrent (weak)
 
+    // --- Intra-column conduction delays (docs/02 §2.3) ---
+    int32_t max_intra_delay  = 1;     // 每条突触延迟 ~ U[1, max] 步 (1 = 统一 1 步)
+
+    // --- Locality reordering (core/reorder.h) ---
+    bool locality_reorder    = false; // 构造时 RCM 重排各群体内部下标 (外部 ID 不变)
+
     // --- Cross-region PSP input parameters ---
     float input_psp_regular  = 35.0f;  // PSP current per regular spike
     float input_psp_burst    = 55.0f;  // PSP current per burst spike
@@ -90,6 +100,9 @@ struct ColumnConfig {
     float stdp_a_minus       = -0.012f;// LTD amplitude
     float stdp_tau           = 20.0f;  // Time window (ms)
     float stdp_w_max         = 1.5f;   // Max weight
+
+    // --- Sleep noise (CorticalRegion REM 噪声 / PGO 波) ---
+    uint32_t sleep_noise_seed = 33333; // 每个区域独立流, 与区域名混合 (同配置的不同区域不相关)
 };
 
 // =============================================================================
@@ -149,12 +162,43 @@ public:
     void enable_homeostatic(const HomeostaticParams& params = {});
     bool has_homeostatic() const { return homeo_active_; }
 
+    /**
+     * 结构可塑性: 已启用 STDP 的突触组 (L4→L2/3, L2/3 循环, L2/3→L5, 预测突触)
+     * 长期弱突触标记剪除, 可选活动相关生长; 之后启用的预测突触也沿用
+     */
+    void enable_structural_plasticity(const StructuralParams& params = {});
+    bool has_structural_plasticity() const { return structural_active_; }
+
+    /** 压缩已剪除突触 / 加入新生突触 (离线阶段调用), 返回移出数 */
+    size_t compact_synapses();
+
     /** Mean firing rate of each excitatory population (for diagnostics) */
     float l4_mean_rate()  const { return homeo_l4_  ? homeo_l4_->mean_rate()  : 0.0f; }
     float l23_mean_rate() const { return homeo_l23_ ? homeo_l23_->mean_rate() : 0.0f; }
     float l5_mean_rate()  const { return homeo_l5_  ? homeo_l5_->mean_rate()  : 0.0f; }
     float l6_mean_rate()  const { return homeo_l6_  ? homeo_l6_->mean_rate()  : 0.0f; }
 
+    // --- 静息跳过 (见 BrainRegion::quiescent) ---
+
+    /**
+     * 所有突触门控 < eps 且各群体静息
+     * @param i_exc  L4/L2/3/L5 的恒定基底电流 (睡眠下行态抑制), 其余群体为 0
+     */
+    bool quiescent(float i_exc = 0.0f) const;
+
+    /** 解析补齐 n 个静息步: 群体弛豫 + 突触衰减 + 稳态计数/缩放 */
+    void catch_up(int32_t n_steps, float dt, float i_exc = 0.0f);
+
+    /** 所有突触组的权重存储格式 (之后重建的预测突触也沿用) */
+    void set_weight_format(WeightFormat fmt);
+
+    /**
+     * 按名称访问内部突触组 (诊断/Python 零拷贝视图用), 名称见 synapse_names()
+     * 如 "l4_to_l23"; 未知名称或未启用的预测突触返回 nullptr
+     */
+    SynapseGroup* find_synapse(const std::string& name);
+    std::vector<std::string> synapse_names() const;
+
     // --- External input injection ---
 
     /** Feedforward input -> L4 stellate basal dendrites */
@@ -172,6 +216,15 @@ public:
     size_t total_neurons() const;
     size_t total_synapses() const;
 
+    /**
+     * 群体内部下标 ↔ 外部 ID (locality_reorder 时非恒等)
+     * l4()/l23()/... 返回的群体按内部下标存储; inject_feedforward/inject_feedback 接收外部 ID
+     */
+    const NeuronOrder& l4_order()  const { return orders_[POP_L4]; }
+    const NeuronOrder& l23_order() const { return orders_[POP_L23]; }
+    const NeuronOrder& l5_order()  const { return orders_[POP_L5]; }
+    const NeuronOrder& l6_order()  const { return orders_[POP_L6]; }
+
     NeuronPopulation& l4()  { return l4_stellate_; }
     NeuronPopulation& l23() { return l23_pyramidal_; }
     NeuronPopulation& l5()  { return l5_pyramidal_; }
@@ -183,6 +236,8 @@ public:
     const NeuronPopulation& l6()  const { return l6_pyramidal_; }
 
 private:
+    enum Pop : int { POP_L4, POP_L23, POP_L5, POP_L6, POP_PV, POP_SST, POP_VIP, N_POPS };
+
     void build_populations();
     void build_synapses();
 
@@ -194,6 +249,13 @@ private:
         float dt
     );
 
+    /** 突触组名称表 (find_synapse/synapse_names) */
+    using SynapseMember = SynapseGroup CorticalColumn::*;
+    static const std::vector<std::pair<const char*, SynapseMember>>& synapse_table();
+
+    /** 每步实际推进的突触组 (静息判定/补齐用) */
+    template <typename Self, typename Fn> static void for_each_synapse(Self& self, Fn&& fn);
+
     /** Classify L2/3 and L5 output into regular/burst categories */
     void classify_output(ColumnOutput& out);
 
@@ -210,17 +272,12 @@ private:
     NeuronPopulation sst_martinotti_;
     NeuronPopulation vip_;
 
-    // === Excitatory AMPA synapses ===
-    SynapseGroup syn_l4_to_l23_;      // L4 -> L2/3 basal (AMPA)
-    SynapseGroup syn_l23_to_l5_;      // L2/3 -> L5 basal (AMPA)
+    // === Excitatory synapses (主通路为 AMPA+NMDA 双受体, 共享 CSR) ===
+    SynapseGroup syn_l4_to_l23_;      // L4 -> L2/3 basal (AMPA+NMDA)
+    SynapseGroup syn_l23_to_l5_;      // L2/3 -> L5 basal (AMPA+NMDA)
     SynapseGroup syn_l5_to_l6_;       // L5 -> L6 basal (AMPA)
     SynapseGroup syn_l6_to_l4_;       // L6 -> L4 basal (AMPA, prediction loop)
-    SynapseGroup syn_l23_recurrent_;  // L2/3 -> L2/3 lateral (AMPA)
-
-    // === Excitatory NMDA synapses (parallel slow channel) ===
-    SynapseGroup syn_l4_to_l23_nmda_; // L4 -> L2/3 (NMDA)
-    SynapseGroup syn_l23_to_l5_nmda_; // L2/3 -> L5 (NMDA)
-    SynapseGroup syn_l23_rec_nmda_;   // L2/3 recurrent (NMDA)
+    SynapseGroup syn_l23_recurrent_;  // L2/3 -> L2/3 lateral (AMPA+NMDA)
 
     // === Excitatory -> Inhibitory ===
     SynapseGroup syn_exc_to_pv_;      // L2/3 -> PV (AMPA)
@@ -243,15 +300,25 @@ private:
     // === L6→L2/3 prediction synapse (v27: predictive coding learning) ===
     SynapseGroup syn_l6_to_l23_predict_;  // L6→L2/3 apical (prediction signal)
     bool predictive_learning_ = false;    // Enable L6 prediction STDP + error-gated FF STDP
+    WeightFormat weight_format_ = WeightFormat::FP32;
+
+    // === 各群体内部顺序 (恒等, 除非 locality_reorder) ===
+    std::array<NeuronOrder, N_POPS> orders_;
 
     // === STDP state ===
     bool stdp_active_ = false;
     float ach_stdp_gain_ = 1.0f;  // v26: ACh modulation of STDP rate
 
+    // === Structural plasticity state ===
+    bool structural_active_ = false;
+    StructuralParams structural_params_;
+
     // === Homeostatic plasticity state ===
     bool homeo_active_ = false;
     uint32_t homeo_step_count_ = 0;
     uint32_t homeo_interval_ = 100;
+    uint32_t homeo_rate_count_ = 0;     // 发放率慢时钟 (计数窗口)
+    uint32_t homeo_rate_interval_ = 10;
     std::unique_ptr<SynapticScaler> homeo_l4_;
     std::unique_ptr<SynapticScaler> homeo_l23_;
     std::unique_ptr<SynapticScaler> homeo_l5_;
@@ -0,0 +1,45 @@
+#pragma once
+/**
+ * bfloat16 — 16 位权重存储 (fp32 高 16 位: 1 符号 + 8 指数 + 7 尾数)
+ *
+ * 与 fp32 同指数范围, 解码只是左移 16 位 (无查表/无特殊指令, 编译器可向量化);
+ * 相对精度 2^-8, 用随机舍入写回时学习增量在期望意义下无偏。
+ */
+
+#include <cstdint>
+#include <cstring>
+
+namespace wuyun {
+
+inline float bf16_to_float(uint16_t h) {
+    uint32_t u = static_cast<uint32_t>(h) << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/** 就近舍入 (ties-to-even) */
+inline uint16_t bf16_from_float(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    u += 0x7FFFu + ((u >> 16) & 1u);
+    return static_cast<uint16_t>(u >> 16);
+}
+
+/** 随机舍入: 低 16 位加均匀随机数后截断, 向上舍入概率 = 被截部分 / LSB */
+inline uint16_t bf16_from_float_stochastic(float f, uint32_t rand_bits) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    u += rand_bits & 0xFFFFu;
+    return static_cast<uint16_t>(u >> 16);
+}
+
+/** xorshift32: 随机舍入用的轻量随机源 (状态非 0) */
+inline uint32_t xorshift32(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace wuyun
@@ -22,10 +22,12 @@ void NeuromodulatorSystem::inject_phasic(float d_da, float d_ne, float d_sht, fl
 
 void NeuromodulatorSystem::step(float dt) {
     // Phasic components decay toward zero
-    phasic_.da  -= phasic_.da  * (dt / tau_da_);
-    phasic_.ne  -= phasic_.ne  * (dt / tau_ne_);
-    phasic_.sht -= phasic_.sht * (dt / tau_sht_);
-    phasic_.ach -= phasic_.ach * (dt / tau_ach_);
+    // Exact exponential: stays stable when the modulation clock runs at
+    // a coarse period (dt = 10~100 ms) instead of every 1 ms step.
+    phasic_.da  *= std::exp(-dt / tau_da_);
+    phasic_.ne  *= std::exp(-dt / tau_ne_);
+    phasic_.sht *= std::exp(-dt / tau_sht_);
+    phasic_.ach *= std::exp(-dt / tau_ach_);
 }
 
 NeuromodulatorLevels NeuromodulatorSystem::current() const {
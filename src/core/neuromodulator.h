@@ -56,7 +56,7 @@ public:
     /** 注入 phasic 突发 (例如 DA burst 信号) */
     void inject_phasic(float d_da, float d_ne, float d_sht, float d_ach);
 
-    /** 每步更新: phasic 向 tonic 衰减 */
+    /** phasic 向 tonic 衰减 (dt 可为多步的调质时钟周期) */
     void step(float dt = 1.0f);
 
     /** 当前总浓度 = tonic + phasic */
@@ -1,4 +1,5 @@
 #include "core/population.h"
+#include "core/worker_pool.h"
 #include <algorithm>
 #include <cmath>
 #include <cstring>
@@ -197,17 +198,37 @@ size_t NeuronPopulation::step(int t, float dt) {
     size_t fire_count = 0;
     {
         int nn = static_cast<int>(n_);
+        WorkerPool* pool = WorkerPool::intra();
+        if (pool && nn >= 256) {
+            // 引擎线程池单独步进的大区域: 神经元循环分块到池线程
+            fire_count = pool->parallel_sum(n_, [&](size_t begin, size_t end) {
+                size_t count = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    if (burst_remain_[i] > 0) {
+                        continue_burst(i, dt);
+                    } else {
+                        update_soma_and_fire(i, t, dt);
+                    }
+                    count += fired_[i];
+                }
+                return count;
+            });
+        } else {
+            // 线程池任务内不开嵌套 OpenMP (避免超额订阅)
+            bool par = nn >= 256 && !WorkerPool::in_worker();
+            (void)par;
 #ifdef WUYUN_OPENMP
-        #pragma omp parallel for schedule(static) if(nn >= 256) reduction(+:fire_count)
+            #pragma omp parallel for schedule(static) if(par) reduction(+:fire_count)
 #endif
-        for (int ii = 0; ii < nn; ++ii) {
-            size_t i = static_cast<size_t>(ii);
-            if (burst_remain_[i] > 0) {
-                continue_burst(i, dt);
-            } else {
-                update_soma_and_fire(i, t, dt);
+            for (int ii = 0; ii < nn; ++ii) {
+                size_t i = static_cast<size_t>(ii);
+                if (burst_remain_[i] > 0) {
+                    continue_burst(i, dt);
+                } else {
+                    update_soma_and_fire(i, t, dt);
+                }
+                fire_count += fired_[i];
             }
-            fire_count += fired_[i];
         }
     }
 
@@ -219,6 +240,105 @@ size_t NeuronPopulation::step(int t, float dt) {
     return fire_count;
 }
 
+// =============================================================================
+// 静息跳过: 判定 + 解析补齐
+// =============================================================================
+
+bool NeuronPopulation::quiescent(float i_const) const {
+    if (n_ == 0) return true;
+    // 同构群体: 平衡点判定用首个神经元的参数
+    if (v_rest_[0] + r_s_[0] * i_const >= v_threshold_[0] - QUIESCENT_MARGIN) return false;
+
+    for (size_t i = 0; i < n_; ++i) {
+        if (fired_[i] || burst_remain_[i] > 0 || refrac_count_[i] > 0) return false;
+        if (i_basal_[i] != 0.0f || i_soma_[i] != 0.0f) return false;
+        if (v_soma_[i] >= v_threshold_[i] - QUIESCENT_MARGIN) return false;
+        if (has_apical_) {
+            if (ca_spike_[i] || ca_timer_[i] > 0 || i_apical_[i] != 0.0f) return false;
+            if (v_apical_[i] >= v_ca_thresh_[i] - QUIESCENT_MARGIN) return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+// 齐次坐标 x = (V_s, w, V_a, I, 1) 上的仿射映射
+using Affine = double[5][5];
+
+void affine_identity(Affine m) {
+    for (int r = 0; r < 5; ++r)
+        for (int c = 0; c < 5; ++c) m[r][c] = (r == c) ? 1.0 : 0.0;
+}
+
+void affine_mul(const Affine a, const Affine b, Affine out) {  // out = a · b
+    Affine tmp;
+    for (int r = 0; r < 5; ++r)
+        for (int c = 0; c < 5; ++c) {
+            double acc = 0.0;
+            for (int k = 0; k < 5; ++k) acc += a[r][k] * b[k][c];
+            tmp[r][c] = acc;
+        }
+    for (int r = 0; r < 5; ++r)
+        for (int c = 0; c < 5; ++c) out[r][c] = tmp[r][c];
+}
+} // namespace
+
+void NeuronPopulation::relax(int32_t n_steps, float dt, float i_const) {
+    if (n_ == 0 || n_steps <= 0) return;
+    enum { VS = 0, W = 1, VA = 2, I = 3, ONE = 4 };
+
+    // 单步映射 (与 update_apical → update_soma_and_fire 的顺序相同): M = Mw · Ms · Ma
+    const double vr = v_rest_[0];
+    const double ka = dt / tau_a_[0], kb = kappa_back_[0];
+    const double km = dt / tau_m_[0], kappa = kappa_[0], rs = r_s_[0];
+    const double kw = dt / tau_w_[0], a = a_adapt_[0];
+
+    Affine ma, ms, mw, m;
+    affine_identity(ma);
+    if (has_apical_) {
+        // V_a' = V_a + ka·(-(V_a - V_rest) + κ_back·(V_s - V_a))
+        ma[VA][VA]  = 1.0 - ka - ka * kb;
+        ma[VA][VS]  = ka * kb;
+        ma[VA][ONE] = ka * vr;
+    }
+    affine_identity(ms);
+    // V_s' = V_s + km·(-(V_s - V_rest) + R_s·I - w + κ·(V_a' - V_s))
+    ms[VS][VS]  = 1.0 - km - km * kappa;
+    ms[VS][W]   = -km;
+    ms[VS][I]   = km * rs;
+    ms[VS][ONE] = km * vr;
+    if (has_apical_) ms[VS][VA] = km * kappa;
+    else             ms[VS][ONE] += km * kappa * vr;
+    affine_identity(mw);
+    // w' = w + kw·(a·(V_s' - V_rest) - w)
+    mw[W][W]   = 1.0 - kw;
+    mw[W][VS]  = kw * a;
+    mw[W][ONE] = -kw * a * vr;
+
+    affine_mul(ms, ma, m);
+    affine_mul(mw, m, m);
+
+    // P = M^n
+    Affine p;
+    affine_identity(p);
+    for (uint32_t e = static_cast<uint32_t>(n_steps); e > 0; e >>= 1) {
+        if (e & 1u) affine_mul(m, p, p);
+        affine_mul(m, m, m);
+    }
+
+    for (size_t i = 0; i < n_; ++i) {
+        double x[5] = {v_soma_[i], w_adapt_[i], v_apical_[i], i_const, 1.0};
+        v_soma_[i] = static_cast<float>(
+            p[VS][VS]*x[0] + p[VS][W]*x[1] + p[VS][VA]*x[2] + p[VS][I]*x[3] + p[VS][ONE]);
+        w_adapt_[i] = static_cast<float>(
+            p[W][VS]*x[0] + p[W][W]*x[1] + p[W][VA]*x[2] + p[W][I]*x[3] + p[W][ONE]);
+        if (has_apical_) {
+            v_apical_[i] = static_cast<float>(
+                p[VA][VS]*x[0] + p[VA][W]*x[1] + p[VA][VA]*x[2] + p[VA][I]*x[3] + p[VA][ONE]);
+        }
+    }
+}
+
 void NeuronPopulation::clear_inputs() {
     std::fill(i_basal_.begin(), i_basal_.end(), 0.0f);
     std::fill(i_apical_.begin(), i_apical_.end(), 0.0f);
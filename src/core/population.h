@@ -24,6 +24,7 @@
 #include "types.h"
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 
 namespace wuyun {
 
@@ -38,6 +39,24 @@ public:
     /** 推进一个时间步, 返回发放的神经元数量 */
     size_t step(int t, float dt = 1.0f);
 
+    // --- 静息跳过 (见 BrainRegion::quiescent) ---
+
+    /**
+     * 静息判定: 无 burst/不应期/Ca²⁺ 平台、本步未发放、无待处理输入,
+     * 且在恒定电流 i_const 下胞体/顶端电压离阈值至少 QUIESCENT_MARGIN
+     * (跳过期间不可能发放)
+     */
+    bool quiescent(float i_const = 0.0f) const;
+
+    /**
+     * 解析补齐 n 个无输入步 (只受恒定基底电流 i_const):
+     * 阈下动力学 (V_s, w, V_a) 为线性, 每步的欧拉更新是一个仿射映射 M,
+     * n 步 = M^n (平方求幂), 与逐步积分一致到舍入误差
+     */
+    void relax(int32_t n_steps, float dt = 1.0f, float i_const = 0.0f);
+
+    static constexpr float QUIESCENT_MARGIN = 2.0f;  // mV
+
     // --- 外部注入电流 (每步清零) ---
     void inject_basal(size_t idx, float current);
     void inject_apical(size_t idx, float current);
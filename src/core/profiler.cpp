@@ -0,0 +1,237 @@
+#include "core/profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define WUYUN_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define WUYUN_HAS_TSC 1
+#endif
+
+namespace wuyun {
+
+// =============================================================================
+// 时间戳 / 阶段登记
+// =============================================================================
+
+namespace prof {
+
+thread_local RegionCounters* t_region = nullptr;
+
+static int64_t wall_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t ticks() {
+#ifdef WUYUN_HAS_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(wall_ns());
+#endif
+}
+
+namespace {
+std::mutex& registry_mutex() { static std::mutex m; return m; }
+std::vector<std::string>& registry() { static std::vector<std::string> names; return names; }
+std::atomic<uint32_t> g_next_tid{0};
+} // namespace
+
+uint32_t phase_id(const char* name) {
+    std::lock_guard<std::mutex> lk(registry_mutex());
+    auto& names = registry();
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return static_cast<uint32_t>(i);
+    }
+    names.emplace_back(name);
+    return static_cast<uint32_t>(names.size() - 1);
+}
+
+std::string phase_name(uint32_t id) {
+    std::lock_guard<std::mutex> lk(registry_mutex());
+    return registry()[id];   // 拷贝: 其它线程登记新名字可能使 vector 重新分配
+}
+
+uint32_t thread_index() {
+    thread_local uint32_t tid = g_next_tid.fetch_add(1);
+    return tid;
+}
+
+} // namespace prof
+
+// =============================================================================
+// Profiler
+// =============================================================================
+
+void Profiler::enable(size_t max_trace_events) {
+    max_trace_ = max_trace_events;
+    enabled_ = true;
+    reset();
+}
+
+void Profiler::reset() {
+    std::fill(calls_.begin(), calls_.end(), 0);
+    std::fill(total_.begin(), total_.end(), 0);
+    std::fill(max_.begin(),   max_.end(),   0);
+    trace_.clear();
+    for (auto& r : regions_) r = RegionCounters{};
+    for (auto& t : region_trace_) t.clear();
+    tick0_    = prof::ticks();
+    wall0_ns_ = prof::wall_ns();
+}
+
+void Profiler::set_regions(const std::vector<std::string>& names) {
+    region_names_ = names;
+    regions_.resize(names.size());
+    region_trace_.resize(names.size());
+}
+
+void Profiler::record(uint32_t phase, uint64_t t0, uint64_t t1) {
+    if (phase >= calls_.size()) {
+        calls_.resize(phase + 1, 0);
+        total_.resize(phase + 1, 0);
+        max_.resize(phase + 1, 0);
+    }
+    uint64_t d = t1 - t0;
+    ++calls_[phase];
+    total_[phase] += d;
+    max_[phase] = std::max(max_[phase], d);
+    if (trace_.size() < max_trace_) trace_.push_back({phase, prof::thread_index(), t0, t1});
+}
+
+void Profiler::record_region(size_t i, uint64_t t0, uint64_t t1) {
+    RegionCounters& r = regions_[i];
+    ++r.steps;
+    r.step_ticks += t1 - t0;
+    auto& tr = region_trace_[i];
+    if (tr.size() < max_trace_) tr.push_back({static_cast<uint32_t>(i), prof::thread_index(), t0, t1});
+}
+
+double Profiler::ns_per_tick() const {
+#ifdef WUYUN_HAS_TSC
+    uint64_t dt = prof::ticks() - tick0_;
+    int64_t  dw = prof::wall_ns() - wall0_ns_;
+    if (dt == 0 || dw <= 0) return 1.0;
+    return static_cast<double>(dw) / static_cast<double>(dt);
+#else
+    return 1.0;
+#endif
+}
+
+std::vector<Profiler::PhaseStats> Profiler::phases() const {
+    std::vector<PhaseStats> out;
+    double k = ns_per_tick();
+    for (size_t id = 0; id < calls_.size(); ++id) {
+        if (calls_[id] == 0) continue;
+        PhaseStats s;
+        s.name     = prof::phase_name(static_cast<uint32_t>(id));
+        s.calls    = calls_[id];
+        s.total_ns = static_cast<double>(total_[id]) * k;
+        s.max_ns   = static_cast<double>(max_[id]) * k;
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+std::string Profiler::summary() const {
+    std::string out;
+    char line[256];
+    double k = ns_per_tick();
+
+    std::snprintf(line, sizeof(line), "%-22s %10s %12s %10s %10s\n",
+                  "phase", "calls", "total(ms)", "mean(us)", "max(us)");
+    out += line;
+    for (const auto& p : phases()) {
+        std::snprintf(line, sizeof(line), "%-22s %10llu %12.3f %10.3f %10.3f\n",
+                      p.name.c_str(), static_cast<unsigned long long>(p.calls),
+                      p.total_ns * 1e-6, p.total_ns * 1e-3 / static_cast<double>(p.calls),
+                      p.max_ns * 1e-3);
+        out += line;
+    }
+
+    std::snprintf(line, sizeof(line), "\n%-14s %8s %10s %9s %10s %10s %12s %10s\n",
+                  "region", "steps", "total(ms)", "mean(us)", "spikes_in", "spikes_out",
+                  "syn_events", "plast_upd");
+    out += line;
+    for (size_t i = 0; i < regions_.size(); ++i) {
+        const RegionCounters& r = regions_[i];
+        if (r.steps == 0) continue;
+        double ns = static_cast<double>(r.step_ticks) * k;
+        std::snprintf(line, sizeof(line), "%-14s %8llu %10.3f %9.3f %10llu %10llu %12llu %10llu\n",
+                      region_names_[i].c_str(), static_cast<unsigned long long>(r.steps),
+                      ns * 1e-6, ns * 1e-3 / static_cast<double>(r.steps),
+                      static_cast<unsigned long long>(r.spikes_in),
+                      static_cast<unsigned long long>(r.spikes_out),
+                      static_cast<unsigned long long>(r.synaptic_events),
+                      static_cast<unsigned long long>(r.plasticity_updates));
+        out += line;
+    }
+    return out;
+}
+
+// JSON 字符串转义 (区域名/阶段名由用户给出, 可含引号、反斜杠、控制字符)
+static std::string json_escape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char esc[8];
+                    std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    out += esc;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    return out;
+}
+
+std::string Profiler::chrome_trace() const {
+    double k = ns_per_tick();
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char buf[160];
+    auto emit = [&](const std::string& name, const char* cat, const Trace& e) {
+        double ts  = static_cast<double>(e.t0 - tick0_) * k * 1e-3;   // us
+        double dur = static_cast<double>(e.t1 - e.t0) * k * 1e-3;
+        out += first ? "\n{\"name\":\"" : ",\n{\"name\":\"";
+        out += name;
+        std::snprintf(buf, sizeof(buf),
+                      "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+                      cat, ts, dur, e.tid);
+        out += buf;
+        first = false;
+    };
+    std::vector<std::string> names(calls_.size());
+    for (size_t id = 0; id < names.size(); ++id) names[id] = json_escape(prof::phase_name(static_cast<uint32_t>(id)));
+    std::vector<std::string> region_names(region_names_.size());
+    for (size_t i = 0; i < region_names.size(); ++i) region_names[i] = json_escape(region_names_[i]);
+    for (const auto& e : trace_) emit(names[e.id], "phase", e);
+    for (size_t i = 0; i < region_trace_.size(); ++i) {
+        for (const auto& e : region_trace_[i]) emit(region_names[i], "region", e);
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Profiler::write_chrome_trace(const std::string& path) const {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    f << chrome_trace();
+    return static_cast<bool>(f);
+}
+
+} // namespace wuyun
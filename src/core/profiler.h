@@ -0,0 +1,217 @@
+#pragma once
+/**
+ * Profiler — 引擎热路径剖析 (分阶段计时 + 每区域计数)
+ *
+ * 两级开关:
+ *   - 编译期: WUYUN_PROFILE (CMake 选项, 默认关)。关闭时 WUYUN_PROF_* 宏展开为空,
+ *     热路径上不留任何指令; Profiler 类仍可用 (无数据)
+ *   - 运行期: Profiler::enable(); 未启用时每个计时点只有一次分支
+ *
+ * 计时: x86 上读 TSC (__rdtsc, ~20 cycles), 其它平台 steady_clock。
+ *   tick → ns 的换算在导出时按 enable 以来的 steady_clock 时长校准。
+ *
+ * 数据:
+ *   - 阶段 (引擎 deliver / regions / clocks / submit / bus_advance, agent 各子阶段):
+ *     调用次数、总/最大耗时; 名称全局登记 (prof::phase_id), 各 Profiler 按 id 存
+ *   - 区域: step 耗时, 收/发脉冲, 突触事件 (发放前神经元的出边数), 可塑性权重更新数。
+ *     突触/可塑性计数经线程局部指针 prof::t_region 累加到当前正在推进的区域,
+ *     SynapseGroup 无需知道自己属于哪个区域
+ *   - 追踪事件 (有上限): 导出 Chrome trace-event JSON (chrome://tracing, Perfetto)
+ *
+ * 线程: 阶段计时与主追踪只在调用线程 (引擎主循环) 记录; 区域数据按区域分开,
+ * 每步每区域只有一个线程写, 无需加锁。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wuyun {
+
+/** 每区域计数 */
+struct RegionCounters {
+    uint64_t steps              = 0;
+    uint64_t step_ticks         = 0;   // receive + step 的总 tick
+    uint64_t spikes_in          = 0;   // 收到的脉冲事件
+    uint64_t spikes_out         = 0;   // 发放的神经元数
+    uint64_t synaptic_events    = 0;   // 突触传递事件
+    uint64_t plasticity_updates = 0;   // 非零权重更新 (STDP / DA-STDP)
+};
+
+namespace prof {
+
+/** 当前时间戳 (tick) */
+uint64_t ticks();
+
+/** 登记阶段名, 返回全局 id (线程安全; 同名返回同一 id) */
+uint32_t phase_id(const char* name);
+std::string phase_name(uint32_t id);
+
+/** 当前线程正在推进的区域计数器 (引擎设置; 为空时计数丢弃) */
+extern thread_local RegionCounters* t_region;
+
+inline void count_synaptic(uint64_t n)  { if (t_region) t_region->synaptic_events += n; }
+inline void count_plasticity(uint64_t n) { if (t_region) t_region->plasticity_updates += n; }
+
+/** 当前线程的追踪 tid (首次调用时分配) */
+uint32_t thread_index();
+
+} // namespace prof
+
+class Profiler {
+public:
+    /**
+     * 开始记录 (清空旧数据)
+     * @param max_trace_events  每条追踪流 (主线程 + 每区域) 的事件上限, 0 = 只汇总
+     */
+    void enable(size_t max_trace_events = 1u << 20);
+    void disable() { enabled_ = false; }
+    bool enabled() const { return enabled_; }
+
+    /** 清空数据 (保持启用状态, 重新校准时间基准) */
+    void reset();
+
+    /** 区域表 (引擎在区域数变化时调用) */
+    void set_regions(const std::vector<std::string>& names);
+    size_t num_regions() const { return regions_.size(); }
+    RegionCounters&       region(size_t i)       { return regions_[i]; }
+    const RegionCounters& region(size_t i) const { return regions_[i]; }
+
+    /** 记录一次阶段耗时 (调用线程) */
+    void record(uint32_t phase, uint64_t t0, uint64_t t1);
+
+    /** 记录一次区域推进 (该区域当前的推进线程) */
+    void record_region(size_t i, uint64_t t0, uint64_t t1);
+
+    // --- 查询 ---
+    struct PhaseStats {
+        std::string name;
+        uint64_t calls = 0;
+        double   total_ns = 0.0;
+        double   max_ns   = 0.0;
+    };
+    /** 已记录的阶段 (按登记顺序, 跳过未调用的) */
+    std::vector<PhaseStats> phases() const;
+    double ns_per_tick() const;
+
+    // --- 导出 ---
+
+    /** 文本汇总表: 阶段 + 区域 */
+    std::string summary() const;
+
+    /** Chrome trace-event JSON */
+    std::string chrome_trace() const;
+    bool write_chrome_trace(const std::string& path) const;
+
+private:
+    struct Trace {
+        uint32_t id;     // 阶段 id, 区域追踪中为区域下标
+        uint32_t tid;
+        uint64_t t0, t1;
+    };
+
+    bool enabled_ = false;
+    size_t max_trace_ = 0;
+    uint64_t tick0_ = 0;
+    int64_t  wall0_ns_ = 0;
+
+    std::vector<uint64_t> calls_, total_, max_;   // 按阶段 id
+    std::vector<Trace>    trace_;
+
+    std::vector<std::string>        region_names_;
+    std::vector<RegionCounters>     regions_;
+    std::vector<std::vector<Trace>> region_trace_;
+};
+
+/** RAII 阶段计时 (profiler 为空或未启用时不计) */
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler* p, uint32_t phase)
+        : p_((p && p->enabled()) ? p : nullptr), phase_(phase), t0_(p_ ? prof::ticks() : 0) {}
+    ~ScopedTimer() { stop(); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    /** 提前结束 (之后析构不再记录) */
+    void stop() {
+        if (!p_) return;
+        p_->record(phase_, t0_, prof::ticks());
+        p_ = nullptr;
+    }
+
+private:
+    Profiler* p_;
+    uint32_t  phase_;
+    uint64_t  t0_;
+};
+
+/** RAII 区域推进: 计时 + 设置 prof::t_region */
+class RegionScope {
+public:
+    RegionScope(Profiler& p, size_t region)
+        : p_(p.enabled() ? &p : nullptr), region_(region), t0_(0) {
+        if (!p_) return;
+        prev_ = prof::t_region;
+        prof::t_region = &p_->region(region_);
+        t0_ = prof::ticks();
+    }
+    ~RegionScope() {
+        if (!p_) return;
+        p_->record_region(region_, t0_, prof::ticks());
+        prof::t_region = prev_;
+    }
+    RegionScope(const RegionScope&) = delete;
+    RegionScope& operator=(const RegionScope&) = delete;
+
+private:
+    Profiler* p_;
+    size_t    region_;
+    uint64_t  t0_;
+    RegionCounters* prev_ = nullptr;
+};
+
+} // namespace wuyun
+
+// =============================================================================
+// 插桩宏 (WUYUN_PROFILE 关闭时为空)
+// =============================================================================
+
+#define WUYUN_PROF_CAT2(a, b) a##b
+#define WUYUN_PROF_CAT(a, b)  WUYUN_PROF_CAT2(a, b)
+
+#ifdef WUYUN_PROFILE
+
+/** 作用域计时: profiler 为 Profiler*, name 为字符串字面量 */
+#define WUYUN_PROF_SCOPE(profiler, name) \
+    static const uint32_t WUYUN_PROF_CAT(wuyun_prof_id_, __LINE__) = ::wuyun::prof::phase_id(name); \
+    ::wuyun::ScopedTimer WUYUN_PROF_CAT(wuyun_prof_scope_, __LINE__)((profiler), WUYUN_PROF_CAT(wuyun_prof_id_, __LINE__))
+
+/** 具名计时, 可用 WUYUN_PROF_STOP(var) 提前结束 */
+#define WUYUN_PROF_TIMER(var, profiler, name) \
+    static const uint32_t WUYUN_PROF_CAT(wuyun_prof_id_, __LINE__) = ::wuyun::prof::phase_id(name); \
+    ::wuyun::ScopedTimer var((profiler), WUYUN_PROF_CAT(wuyun_prof_id_, __LINE__))
+#define WUYUN_PROF_STOP(var) (var).stop()
+
+/** 区域推进作用域: profiler 为 Profiler&, i 为区域下标 */
+#define WUYUN_PROF_REGION(profiler, i) \
+    ::wuyun::RegionScope WUYUN_PROF_CAT(wuyun_prof_region_, __LINE__)((profiler), (i))
+
+/** 区域计数累加 (启用时): field 为 RegionCounters 成员 */
+#define WUYUN_PROF_COUNT(profiler, i, field, n) \
+    do { if ((profiler).enabled()) (profiler).region(i).field += static_cast<uint64_t>(n); } while (0)
+
+#define WUYUN_PROF_SYNAPTIC(n)   ::wuyun::prof::count_synaptic(static_cast<uint64_t>(n))
+#define WUYUN_PROF_PLASTICITY(n) ::wuyun::prof::count_plasticity(static_cast<uint64_t>(n))
+
+#else
+
+#define WUYUN_PROF_SCOPE(profiler, name)         ((void)0)
+#define WUYUN_PROF_TIMER(var, profiler, name)    ((void)0)
+#define WUYUN_PROF_STOP(var)                     ((void)0)
+#define WUYUN_PROF_REGION(profiler, i)           ((void)0)
+#define WUYUN_PROF_COUNT(profiler, i, field, n)  ((void)0)
+#define WUYUN_PROF_SYNAPTIC(n)                   ((void)0)
+#define WUYUN_PROF_PLASTICITY(n)                 ((void)0)
+
+#endif
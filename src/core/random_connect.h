@@ -0,0 +1,50 @@
+#pragma once
+/**
+ * 随机稀疏连接采样 — 每对 (pre, post) 独立以概率 prob 连接
+ *
+ * 小规模 (n_pre × n_post ≤ DENSE_PAIR_LIMIT): 逐对掷骰, 随机流与历史实现逐位相同,
+ *   已调参的脑 (build_brain, brain_scale ≤ 10) 拓扑不变。
+ * 大规模: 几何跳跃采样 — 直接抽取到下一条连接之间跳过的对数,
+ *   O(连接数) 而非 O(n_pre × n_post); 10^4~10^5 神经元的群体也能秒级构造。
+ *
+ * 两种路径都按 (pre, post) 行优先升序输出, 下游 COO→CSR 构造无需排序。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace wuyun {
+
+/** 超过此对数改用几何跳跃 (4M 对 ≈ 2048 × 2048) */
+constexpr uint64_t DENSE_PAIR_LIMIT = uint64_t{1} << 22;
+
+/**
+ * 对每条被选中的连接调用 emit(pre, post)
+ * @param rng  调用方的随机流 (逐对路径每对消耗一个 float 均匀数)
+ */
+template <typename Emit>
+void for_each_random_pair(size_t n_pre, size_t n_post, float prob, std::mt19937& rng, Emit&& emit) {
+    uint64_t n_pairs = static_cast<uint64_t>(n_pre) * n_post;
+    if (n_pairs <= DENSE_PAIR_LIMIT) {
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (size_t i = 0; i < n_pre; ++i) {
+            for (size_t j = 0; j < n_post; ++j) {
+                if (dist(rng) < prob) emit(i, j);
+            }
+        }
+        return;
+    }
+    if (prob <= 0.0f) return;
+    if (prob >= 1.0f) {
+        for (size_t i = 0; i < n_pre; ++i)
+            for (size_t j = 0; j < n_post; ++j) emit(i, j);
+        return;
+    }
+    std::geometric_distribution<uint64_t> skip(static_cast<double>(prob));
+    for (uint64_t k = skip(rng); k < n_pairs; k += 1 + skip(rng)) {
+        emit(static_cast<size_t>(k / n_post), static_cast<size_t>(k % n_post));
+    }
+}
+
+} // namespace wuyun
@@ -0,0 +1,86 @@
+#include "core/reorder.h"
+#include <algorithm>
+
+namespace wuyun {
+
+NeuronOrder NeuronOrder::from_sequence(std::vector<int32_t> id_of_internal) {
+    NeuronOrder order;
+    order.internal_of_id.assign(id_of_internal.size(), 0);
+    for (size_t k = 0; k < id_of_internal.size(); ++k) {
+        order.internal_of_id[static_cast<size_t>(id_of_internal[k])] = static_cast<int32_t>(k);
+    }
+    order.id_of_internal = std::move(id_of_internal);
+    return order;
+}
+
+std::vector<int32_t> rcm_order(size_t n, const std::vector<std::pair<int32_t, int32_t>>& edges) {
+    // 无向邻接 (CSR), 自环忽略
+    std::vector<int32_t> degree(n, 0);
+    for (const auto& e : edges) {
+        if (e.first == e.second) continue;
+        ++degree[static_cast<size_t>(e.first)];
+        ++degree[static_cast<size_t>(e.second)];
+    }
+    std::vector<int32_t> adj_ptr(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) adj_ptr[i + 1] = adj_ptr[i] + degree[i];
+    std::vector<int32_t> adj(static_cast<size_t>(adj_ptr[n]));
+    std::vector<int32_t> fill(adj_ptr.begin(), adj_ptr.end() - 1);
+    for (const auto& e : edges) {
+        if (e.first == e.second) continue;
+        adj[static_cast<size_t>(fill[static_cast<size_t>(e.first)]++)]  = e.second;
+        adj[static_cast<size_t>(fill[static_cast<size_t>(e.second)]++)] = e.first;
+    }
+    auto by_degree = [&](int32_t a, int32_t b) {
+        return degree[static_cast<size_t>(a)] != degree[static_cast<size_t>(b)]
+             ? degree[static_cast<size_t>(a)] < degree[static_cast<size_t>(b)] : a < b;
+    };
+    for (size_t i = 0; i < n; ++i) {
+        std::sort(adj.begin() + adj_ptr[i], adj.begin() + adj_ptr[i + 1], by_degree);
+    }
+
+    // 起点候选: 按度升序 (每个分量取其中度最小的未访问节点)
+    std::vector<int32_t> seeds(n);
+    for (size_t i = 0; i < n; ++i) seeds[i] = static_cast<int32_t>(i);
+    std::stable_sort(seeds.begin(), seeds.end(), by_degree);
+
+    std::vector<int32_t> order;
+    order.reserve(n);
+    std::vector<uint8_t> visited(n, 0);
+    std::vector<int32_t> isolated;
+    for (int32_t s : seeds) {
+        size_t su = static_cast<size_t>(s);
+        if (visited[su]) continue;
+        if (degree[su] == 0) { visited[su] = 1; isolated.push_back(s); continue; }
+        // BFS: order 本身作队列
+        size_t head = order.size();
+        order.push_back(s);
+        visited[su] = 1;
+        while (head < order.size()) {
+            size_t u = static_cast<size_t>(order[head++]);
+            for (int32_t k = adj_ptr[u]; k < adj_ptr[u + 1]; ++k) {
+                size_t v = static_cast<size_t>(adj[static_cast<size_t>(k)]);
+                if (visited[v]) continue;
+                visited[v] = 1;
+                order.push_back(static_cast<int32_t>(v));
+            }
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    order.insert(order.end(), isolated.begin(), isolated.end());
+    return order;
+}
+
+double mean_row_span(const std::vector<int32_t>& row_ptr, const std::vector<int32_t>& col_idx) {
+    double total = 0.0;
+    size_t rows = 0;
+    for (size_t i = 0; i + 1 < row_ptr.size(); ++i) {
+        int32_t k0 = row_ptr[i], k1 = row_ptr[i + 1];
+        if (k0 == k1) continue;
+        auto mm = std::minmax_element(col_idx.begin() + k0, col_idx.begin() + k1);
+        total += static_cast<double>(*mm.second - *mm.first);
+        ++rows;
+    }
+    return rows > 0 ? total / static_cast<double>(rows) : 0.0;
+}
+
+} // namespace wuyun
@@ -0,0 +1,52 @@
+#pragma once
+/**
+ * 神经元重排 — 局部性优化 (Reverse Cuthill-McKee)
+ *
+ * 随机连接生成的 CSR 行中 col_idx 跨越整个突触后群体, 群体超出 L1 后
+ * i_post_/v_post 的收集/散射缓存不友好。构造时对连接图做 RCM 重排,
+ * 使相连神经元的下标靠近 (降低带宽), 所有关联 SynapseGroup 按同一置换重标号。
+ *
+ * NeuronOrder 保存置换: 外部 ID (构造/脉冲路由/注入使用) ↔ 内部下标 (群体/突触存储)。
+ * 空置换表示恒等, 热路径上的映射退化为直接下标。
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace wuyun {
+
+struct NeuronOrder {
+    std::vector<int32_t> internal_of_id;  // 外部 ID → 内部下标 (空 = 恒等)
+    std::vector<int32_t> id_of_internal;  // 内部下标 → 外部 ID
+
+    bool identity() const { return internal_of_id.empty(); }
+
+    size_t to_internal(size_t id) const {
+        return identity() ? id : static_cast<size_t>(internal_of_id[id]);
+    }
+    size_t to_id(size_t k) const {
+        return identity() ? k : static_cast<size_t>(id_of_internal[k]);
+    }
+
+    /** 由内部顺序 (id_of_internal) 建立双向置换 */
+    static NeuronOrder from_sequence(std::vector<int32_t> id_of_internal);
+};
+
+/**
+ * Reverse Cuthill-McKee 顺序
+ *
+ * 把有向边视为无向; 每个连通分量从最小度节点出发 BFS, 邻居按度升序入队,
+ * 最后整体反转。孤立节点保持在末尾。
+ *
+ * @param n      节点数
+ * @param edges  (u, v) 边表, 下标 < n
+ * @return       新顺序: 第 k 个位置放置的原节点
+ */
+std::vector<int32_t> rcm_order(size_t n, const std::vector<std::pair<int32_t, int32_t>>& edges);
+
+/** CSR 行的平均跨度 (每行 max(col) - min(col)), 衡量收集局部性 */
+double mean_row_span(const std::vector<int32_t>& row_ptr, const std::vector<int32_t>& col_idx);
+
+} // namespace wuyun
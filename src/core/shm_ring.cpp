@@ -0,0 +1,154 @@
+#include "core/shm_ring.h"
+#include <new>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace wuyun {
+
+// =============================================================================
+// SharedMemory
+// =============================================================================
+
+SharedMemory::~SharedMemory() {
+    release();
+}
+
+void SharedMemory::release() {
+#ifndef _WIN32
+    if (data_) munmap(data_, size_);
+    if (owner_ && !name_.empty()) shm_unlink(name_.c_str());
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    name_.clear();
+    owner_ = false;
+}
+
+SharedMemory::SharedMemory(SharedMemory&& o) noexcept
+    : data_(o.data_), size_(o.size_), name_(std::move(o.name_)), owner_(o.owner_)
+{
+    o.data_ = nullptr;
+    o.size_ = 0;
+    o.owner_ = false;
+}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& o) noexcept {
+    if (this != &o) {
+        release();
+        data_  = o.data_;
+        size_  = o.size_;
+        name_  = std::move(o.name_);
+        owner_ = o.owner_;
+        o.data_ = nullptr;
+        o.size_ = 0;
+        o.owner_ = false;
+    }
+    return *this;
+}
+
+SharedMemory SharedMemory::anonymous(size_t bytes) {
+    SharedMemory m;
+#ifndef _WIN32
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p != MAP_FAILED) {
+        m.data_ = p;
+        m.size_ = bytes;
+    }
+#else
+    (void)bytes;
+#endif
+    return m;
+}
+
+SharedMemory SharedMemory::create(const std::string& name, size_t bytes) {
+    SharedMemory m;
+#ifndef _WIN32
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) return m;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return m;
+    }
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p != MAP_FAILED) {
+        m.data_ = p;
+        m.size_ = bytes;
+        m.name_ = name;
+        m.owner_ = true;
+    } else {
+        shm_unlink(name.c_str());
+    }
+#else
+    (void)name; (void)bytes;
+#endif
+    return m;
+}
+
+SharedMemory SharedMemory::open(const std::string& name, size_t bytes, bool read_only) {
+    SharedMemory m;
+#ifndef _WIN32
+    int fd = shm_open(name.c_str(), read_only ? O_RDONLY : O_RDWR, 0600);
+    if (fd < 0) return m;
+    void* p = mmap(nullptr, bytes, read_only ? PROT_READ : (PROT_READ | PROT_WRITE),
+                   MAP_SHARED, fd, 0);
+    close(fd);
+    if (p != MAP_FAILED) {
+        m.data_ = p;
+        m.size_ = bytes;
+        m.name_ = name;
+    }
+#else
+    (void)name; (void)bytes; (void)read_only;
+#endif
+    return m;
+}
+
+// =============================================================================
+// ShmSpikeRing
+// =============================================================================
+
+size_t ShmSpikeRing::bytes_for(size_t capacity) {
+    size_t b = sizeof(Header) + capacity * sizeof(ShmSpike);
+    return (b + 63) & ~static_cast<size_t>(63);
+}
+
+ShmSpikeRing::ShmSpikeRing(void* mem, size_t capacity, bool init)
+    : hdr_(static_cast<Header*>(mem))
+    , slots_(reinterpret_cast<ShmSpike*>(static_cast<char*>(mem) + sizeof(Header)))
+    , capacity_(capacity)
+    , mask_(capacity - 1)
+{
+    if (init) {
+        new (&hdr_->head) std::atomic<uint64_t>(0);
+        new (&hdr_->tail) std::atomic<uint64_t>(0);
+        hdr_->capacity = capacity;
+    }
+}
+
+bool ShmSpikeRing::try_push(const ShmSpike& rec) {
+    uint64_t head = hdr_->head.load(std::memory_order_relaxed);
+    uint64_t tail = hdr_->tail.load(std::memory_order_acquire);
+    if (head - tail >= capacity_) return false;
+    slots_[head & mask_] = rec;
+    hdr_->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool ShmSpikeRing::try_pop(ShmSpike& rec) {
+    uint64_t tail = hdr_->tail.load(std::memory_order_relaxed);
+    uint64_t head = hdr_->head.load(std::memory_order_acquire);
+    if (tail == head) return false;
+    rec = slots_[tail & mask_];
+    hdr_->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace wuyun
@@ -0,0 +1,103 @@
+#pragma once
+/**
+ * ShmRing — 共享内存无锁脉冲环 (跨进程分区仿真)
+ *
+ * 用于分区仿真: 每对 (发送分区 → 接收分区) 一个单生产者/单消费者环,
+ * 在同步窗口边界交换跨分区脉冲。本地共享内存传输, 将来可替换为集群互连。
+ *
+ * 设计:
+ *   - SharedMemory: POSIX 共享内存段 (匿名 = fork 继承; 命名 = 独立进程 attach)
+ *   - ShmSpikeRing: SPSC 环, head/tail 为 std::atomic<uint64_t> (无锁、地址无关)
+ *     head/tail 分处不同缓存行, 避免生产者/消费者伪共享
+ *   - 记录 = SpikeEvent + 提交时间步 (接收端按 (提交步, 源区域) 确定性合并)
+ *   - 窗口结束标记: region_id = WINDOW_MARK, neuron_id = 窗口序号
+ *
+ * 非 POSIX 平台: SharedMemory::valid() 恒为 false
+ */
+
+#include "core/spike_bus.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace wuyun {
+
+/** 环中的一条记录 */
+struct ShmSpike {
+    SpikeEvent evt;
+    int32_t    submit_t;   // 源区域提交该脉冲的时间步
+};
+
+/** POSIX 共享内存段 (RAII) */
+class SharedMemory {
+public:
+    SharedMemory() = default;
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+    SharedMemory(SharedMemory&& o) noexcept;
+    SharedMemory& operator=(SharedMemory&& o) noexcept;
+
+    /** 匿名共享段 (MAP_SHARED|MAP_ANONYMOUS), fork 后父子进程共享 */
+    static SharedMemory anonymous(size_t bytes);
+
+    /** 创建命名段 (shm_open, 已存在则覆盖); 析构时 unlink */
+    static SharedMemory create(const std::string& name, size_t bytes);
+
+    /** attach 已存在的命名段 (read_only = 只读映射, 不能写入) */
+    static SharedMemory open(const std::string& name, size_t bytes, bool read_only = false);
+
+    bool   valid() const { return data_ != nullptr; }
+    void*  data()  const { return data_; }
+    size_t size()  const { return size_; }
+
+private:
+    void release();
+
+    void*       data_ = nullptr;
+    size_t      size_ = 0;
+    std::string name_;        // 非空且 owner_ 时析构 unlink
+    bool        owner_ = false;
+};
+
+/**
+ * 单生产者/单消费者无锁脉冲环 (placement 于共享内存)
+ */
+class ShmSpikeRing {
+public:
+    static constexpr uint32_t WINDOW_MARK = 0xFFFFFFFFu;
+
+    /** 容量为 capacity 条记录的环所需字节数 (capacity 需为 2 的幂) */
+    static size_t bytes_for(size_t capacity);
+
+    /**
+     * @param mem       bytes_for(capacity) 字节, 64 字节对齐
+     * @param capacity  记录数 (2 的幂)
+     * @param init      true = 初始化头部 (仅创建方调用一次)
+     */
+    ShmSpikeRing(void* mem, size_t capacity, bool init);
+
+    /** 生产者: 环满返回 false */
+    bool try_push(const ShmSpike& rec);
+
+    /** 消费者: 环空返回 false */
+    bool try_pop(ShmSpike& rec);
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(64) Header {
+        alignas(64) std::atomic<uint64_t> head;   // 生产者写入位置
+        alignas(64) std::atomic<uint64_t> tail;   // 消费者读取位置
+        alignas(64) uint64_t capacity;
+    };
+
+    Header*   hdr_;
+    ShmSpike* slots_;
+    size_t    capacity_;
+    size_t    mask_;
+};
+
+} // namespace wuyun
@@ -28,9 +28,16 @@ void SpikeBus::submit_spikes(uint32_t region_id,
                               const std::vector<uint8_t>& fired,
                               const std::vector<int8_t>& spike_type,
                               int32_t t) {
+    if (staging_) {
+        schedule(region_id, fired, spike_type, t,
+                 staged_[region_id], &staged_t_[region_id]);
+        return;
+    }
+
     // For each projection from this region, schedule spikes with delay
-    for (const auto& proj : projections_) {
-        if (proj.src_region != region_id) continue;
+    for (size_t p = 0; p < projections_.size(); ++p) {
+        const auto& proj = projections_[p];
+        if (proj.src_region != region_id || !projection_enabled(p)) continue;
 
         int32_t arrival_t = t + proj.delay;
         size_t slot = static_cast<size_t>(arrival_t % (max_delay_ + 1));
@@ -48,6 +55,32 @@ void SpikeBus::submit_spikes(uint32_t region_id,
     }
 }
 
+void SpikeBus::schedule(uint32_t region_id,
+                         const std::vector<uint8_t>& fired,
+                         const std::vector<int8_t>& spike_type,
+                         int32_t t,
+                         std::vector<SpikeEvent>& out,
+                         std::vector<int32_t>* out_t) const {
+    // Same event order as the direct path: projection-major, then neuron
+    for (size_t p = 0; p < projections_.size(); ++p) {
+        const auto& proj = projections_[p];
+        if (proj.src_region != region_id || !projection_enabled(p)) continue;
+
+        int32_t arrival_t = t + proj.delay;
+        for (size_t i = 0; i < fired.size(); ++i) {
+            if (!fired[i]) continue;
+            out.push_back({
+                region_id,
+                proj.dst_region,
+                static_cast<uint32_t>(i),
+                spike_type[i],
+                arrival_t
+            });
+            if (out_t) out_t->push_back(t);
+        }
+    }
+}
+
 const std::vector<SpikeEvent>& SpikeBus::get_arriving_spikes(uint32_t dst_region, int32_t t) {
     query_result_.clear();  // reuse allocated memory
     size_t slot = static_cast<size_t>(t % (max_delay_ + 1));
@@ -60,6 +93,65 @@ const std::vector<SpikeEvent>& SpikeBus::get_arriving_spikes(uint32_t dst_region
     return query_result_;
 }
 
+void SpikeBus::collect_arriving_spikes(uint32_t dst_region, int32_t t,
+                                        std::vector<SpikeEvent>& out) const {
+    out.clear();
+    size_t slot = static_cast<size_t>(t % (max_delay_ + 1));
+
+    for (const auto& evt : delay_buffer_[slot]) {
+        if (evt.timestamp != t) continue;
+        if (evt.dst_region != dst_region) continue;
+        out.push_back(evt);
+    }
+}
+
+int32_t SpikeBus::min_delay() const {
+    if (projections_.empty()) return max_delay_;
+    int32_t d = max_delay_;
+    for (const auto& p : projections_) d = std::min(d, p.delay);
+    return d;
+}
+
+void SpikeBus::begin_staging() {
+    staged_.resize(region_names_.size());
+    staged_t_.resize(region_names_.size());
+    for (size_t r = 0; r < staged_.size(); ++r) {
+        staged_[r].clear();
+        staged_t_[r].clear();
+    }
+    staging_ = true;
+}
+
+void SpikeBus::stage_remote(const SpikeEvent& evt, int32_t submit_t) {
+    staged_[evt.region_id].push_back(evt);
+    staged_t_[evt.region_id].push_back(submit_t);
+}
+
+void SpikeBus::end_staging(int32_t t0, int32_t n_steps) {
+    staging_ = false;
+
+    // Slots consumed inside the window are recycled first, exactly as the
+    // per-step advance() calls would have done before the next submit.
+    for (int32_t k = 0; k < n_steps; ++k) advance(t0 + k);
+
+    // Merge in (submit step, source region) order
+    std::vector<size_t> cursor(staged_.size(), 0);
+    for (int32_t k = 0; k < n_steps; ++k) {
+        int32_t t = t0 + k;
+        for (size_t r = 0; r < staged_.size(); ++r) {
+            const auto& evts = staged_[r];
+            const auto& ts   = staged_t_[r];
+            size_t& c = cursor[r];
+            while (c < evts.size() && ts[c] == t) {
+                const auto& evt = evts[c];
+                size_t slot = static_cast<size_t>(evt.timestamp % (max_delay_ + 1));
+                delay_buffer_[slot].push_back(evt);
+                ++c;
+            }
+        }
+    }
+}
+
 void SpikeBus::advance(int32_t t) {
     // Clear the slot that will be reused next
     int32_t clear_t = t + max_delay_ + 1;
@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 namespace wuyun {
 
@@ -80,9 +81,50 @@ public:
      */
     const std::vector<SpikeEvent>& get_arriving_spikes(uint32_t dst_region, int32_t t);
 
+    /**
+     * 线程安全查询: 把到达 dst_region 的脉冲写入调用方缓冲 (out 先清空)
+     * 同步窗口内各区域并行读取总线时使用
+     */
+    void collect_arriving_spikes(uint32_t dst_region, int32_t t,
+                                 std::vector<SpikeEvent>& out) const;
+
     /** 推进时钟 (清理过期缓冲) */
     void advance(int32_t t);
 
+    // --- 保守同步窗口 (conservative synchronisation) ---
+
+    /** 最小投射延迟 (无投射时返回 max_delay) */
+    int32_t min_delay() const;
+    int32_t max_delay() const { return max_delay_; }
+
+    /**
+     * 开始暂存: 之后的 submit_spikes 写入各源区域私有缓冲,
+     * 不触碰共享延迟缓冲, 因此不同区域可在不同线程提交
+     */
+    void begin_staging();
+
+    /**
+     * 结束暂存: 对 [t0, t0+n_steps) 依次 advance, 再按 (提交步, 源区域)
+     * 顺序合并暂存脉冲 — 与逐步运行时的缓冲内容完全一致
+     */
+    void end_staging(int32_t t0, int32_t n_steps);
+    bool staging() const { return staging_; }
+
+    /** 暂存区访问 (分区交换): 源区域本窗口的暂存脉冲, 及对应提交步 (升序) */
+    const std::vector<SpikeEvent>& staged_events(uint32_t src_region) const { return staged_[src_region]; }
+    const std::vector<int32_t>&    staged_steps(uint32_t src_region)  const { return staged_t_[src_region]; }
+
+    /** 暂存远端分区提交的脉冲 (同一源区域须按提交步升序调用) */
+    void stage_remote(const SpikeEvent& evt, int32_t submit_t);
+
+    // --- 执行掩码 (SimulationEngine::use_mask) ---
+
+    /** 只路由 enabled[p] != 0 的投射 (p = 投射添加顺序); 空 = 全部路由 */
+    void set_projection_mask(std::vector<uint8_t> enabled) { projection_mask_ = std::move(enabled); }
+    bool projection_enabled(size_t p) const {
+        return projection_mask_.empty() || (p < projection_mask_.size() && projection_mask_[p]);
+    }
+
     // 访问器
     size_t num_regions() const { return region_names_.size(); }
     size_t num_projections() const { return projections_.size(); }
@@ -101,12 +143,23 @@ private:
     // 投射列表
     std::vector<Projection>  projections_;
 
+    std::vector<uint8_t>     projection_mask_;   // 空 = 全部启用
+
     // 延迟缓冲: delay_buffer_[slot] = vector of SpikeEvents
     // slot = t % (max_delay + 1)
     std::vector<std::vector<SpikeEvent>> delay_buffer_;
 
     // 查询结果缓冲 (零拷贝: 避免每次 get_arriving_spikes 分配新 vector)
     std::vector<SpikeEvent> query_result_;
+
+    // 暂存缓冲 (同步窗口): 每源区域一份, 附提交时间步用于确定性合并
+    bool staging_ = false;
+    std::vector<std::vector<SpikeEvent>> staged_;
+    std::vector<std::vector<int32_t>>    staged_t_;
+
+    void schedule(uint32_t region_id, const std::vector<uint8_t>& fired,
+                  const std::vector<int8_t>& spike_type, int32_t t,
+                  std::vector<SpikeEvent>& out, std::vector<int32_t>* out_t) const;
 };
 
 } // namespace wuyun
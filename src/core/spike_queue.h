@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 
 namespace wuyun {
 
@@ -1,23 +1,32 @@
 #include "core/synapse_group.h"
+#include "core/worker_pool.h"
+#include "core/profiler.h"
 #include "plasticity/stp.h"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <mutex>
+#include <utility>
+
+#ifdef WUYUN_OPENMP
+#include <omp.h>
+#endif
 
 namespace wuyun {
 
 // NMDA B(V) lookup table: 256 entries, V from -100 to +50 mV
 // B(V) = 1/(1 + [Mg2+]/3.57 * exp(-0.062*V)), precomputed for [Mg2+]=1.0
+// 构造可能在多个线程并发进行 (并行构建智能体): call_once 保证只填一次且对所有线程可见
 static float nmda_b_table[256];
-static bool  nmda_table_init = false;
+static std::once_flag nmda_table_once;
 
 static void init_nmda_table() {
-    if (nmda_table_init) return;
-    for (int i = 0; i < 256; ++i) {
-        float v = -100.0f + i * (150.0f / 255.0f);  // -100 to +50 mV
-        nmda_b_table[i] = 1.0f / (1.0f + (1.0f / 3.57f) * std::exp(-0.062f * v));
-    }
-    nmda_table_init = true;
+    std::call_once(nmda_table_once, [] {
+        for (int i = 0; i < 256; ++i) {
+            float v = -100.0f + i * (150.0f / 255.0f);  // -100 to +50 mV
+            nmda_b_table[i] = 1.0f / (1.0f + (1.0f / 3.57f) * std::exp(-0.062f * v));
+        }
+    });
 }
 
 static inline float nmda_b_lookup(float v) {
@@ -28,6 +37,18 @@ static inline float nmda_b_lookup(float v) {
     return nmda_b_table[idx];
 }
 
+// 计算核的权重解码器 (按存储格式模板化, 内层循环无格式分支)
+namespace {
+struct Fp32Weights {
+    const float* w;
+    float operator()(size_t s) const { return w[s]; }
+};
+struct Bf16Weights {
+    const uint16_t* w;
+    float operator()(size_t s) const { return bf16_to_float(w[s]); }
+};
+} // namespace
+
 SynapseGroup::SynapseGroup(
     size_t n_pre,
     size_t n_post,
@@ -81,6 +102,16 @@ SynapseGroup::SynapseGroup(
     weights_ = std::move(sorted_weights);
     delays_  = std::move(sorted_delays);
 
+    // 异质延迟: 每个 post 一个环形累加器, 槽数取 2 的幂 (位掩码取模)
+    for (int32_t d : delays_) max_delay_ = std::max(max_delay_, d);
+    if (max_delay_ > 1) {
+        ring_len_ = 1;
+        while (ring_len_ < static_cast<size_t>(max_delay_)) ring_len_ <<= 1;
+        ring_mask_ = ring_len_ - 1;
+        ring_.assign(ring_len_ * n_post, 0.0f);
+        gd_.assign(n_post, 0.0f);
+    }
+
     // Init NMDA lookup table once
     if (mg_conc_ > 0.0f) init_nmda_table();
 }
@@ -95,10 +126,85 @@ void SynapseGroup::enable_stp(const STPParams& params) {
     }
 }
 
+// =============================================================================
+// 权重存储格式
+// =============================================================================
+
+std::vector<float> SynapseGroup::weights() const {
+    if (weight_format_ == WeightFormat::FP32) return weights_;
+    std::vector<float> w(weights_bf16_.size());
+    for (size_t s = 0; s < weights_bf16_.size(); ++s) w[s] = bf16_to_float(weights_bf16_[s]);
+    return w;
+}
+
+void SynapseGroup::set_weight_format(WeightFormat fmt) {
+    if (fmt == weight_format_) return;
+    if (fmt == WeightFormat::BF16) {
+        pack_weights(false);
+    } else {
+        unpack_weights();
+        weights_bf16_.clear();
+        weights_bf16_.shrink_to_fit();
+    }
+    weight_format_ = fmt;
+}
+
+void SynapseGroup::unpack_weights() {
+    weights_.resize(weights_bf16_.size());
+    for (size_t s = 0; s < weights_bf16_.size(); ++s) weights_[s] = bf16_to_float(weights_bf16_[s]);
+}
+
+void SynapseGroup::pack_weights(bool stochastic) {
+    weights_bf16_.resize(weights_.size());
+    for (size_t s = 0; s < weights_.size(); ++s) {
+        weights_bf16_[s] = stochastic
+            ? bf16_from_float_stochastic(weights_[s], xorshift32(round_state_))
+            : bf16_from_float(weights_[s]);
+    }
+    weights_.clear();
+    weights_.shrink_to_fit();
+}
+
+void SynapseGroup::enable_post_major() {
+    size_t n_syn = col_idx_.size();
+    csc_ptr_.assign(n_post_ + 1, 0);
+    for (size_t s = 0; s < n_syn; ++s) {
+        csc_ptr_[static_cast<size_t>(col_idx_[s]) + 1] += 1;
+    }
+    for (size_t j = 1; j <= n_post_; ++j) {
+        csc_ptr_[j] += csc_ptr_[j - 1];
+    }
+
+    // CSR 顺序遍历 → 每个 post 行内突触按 pre 升序 (与 pre 主序累加顺序一致)
+    csc_syn_.resize(n_syn);
+    std::vector<int32_t> offset(csc_ptr_.begin(), csc_ptr_.end() - 1);
+    for (size_t s = 0; s < n_syn; ++s) {
+        size_t post = static_cast<size_t>(col_idx_[s]);
+        csc_syn_[static_cast<size_t>(offset[post]++)] = static_cast<int32_t>(s);
+    }
+    post_major_ = true;
+}
+
+void SynapseGroup::enable_nmda_channel(const SynapseParams& params, float weight) {
+    nmda_enabled_ = true;
+    tau_nmda_   = params.tau_decay;
+    e_nmda_     = params.e_rev;
+    g_max_nmda_ = params.g_max;
+    w_nmda_     = weight;
+    g_nmda_.assign(col_idx_.size(), 0.0f);
+    g_nmda_bound_ = 0.0f;
+    if (ring_len_ > 0) {
+        ring_nmda_.assign(ring_len_ * n_post_, 0.0f);
+        gd_nmda_.assign(n_post_, 0.0f);
+    }
+    init_nmda_table();
+}
+
 void SynapseGroup::deliver_spikes(
     const std::vector<uint8_t>& pre_fired,
     const std::vector<int8_t>& pre_spike_type
 ) {
+    float max_gain = 0.0f;
     for (size_t pre = 0; pre < n_pre_; ++pre) {
         if (!pre_fired[pre]) {
             // STP decay only (no spike): cheaper path
@@ -114,43 +220,239 @@ void SynapseGroup::deliver_spikes(
         float burst_gain = is_burst(st) ? 2.0f : 1.0f;
 
         float total_gain = burst_gain * stp_gain;
+        max_gain = std::max(max_gain, total_gain);
 
         int32_t start = row_ptr_[pre];
         int32_t end   = row_ptr_[pre + 1];
-        for (int32_t s = start; s < end; ++s) {
-            g_[static_cast<size_t>(s)] += total_gain;
+        WUYUN_PROF_SYNAPTIC(end - start);
+        if (ring_len_ > 0) {
+            // d > 1: w·gain 存入 post 的第 d-1 个未来槽, 到期再并入门控
+            for (int32_t s = start; s < end; ++s) {
+                size_t si = static_cast<size_t>(s);
+                int32_t d = delays_[si];
+                if (d <= 1) {
+                    g_[si] += total_gain;
+                    if (nmda_enabled_) g_nmda_[si] += total_gain;
+                    continue;
+                }
+                size_t slot = (ring_head_ + static_cast<size_t>(d - 1)) & ring_mask_;
+                size_t idx  = slot * n_post_ + static_cast<size_t>(col_idx_[si]);
+                ring_[idx] += weight(si) * total_gain;
+                if (nmda_enabled_) ring_nmda_[idx] += total_gain;
+                ring_busy_ = std::max(ring_busy_, d - 1);
+            }
+        } else if (nmda_enabled_) {
+            // 共受体: 同一次行遍历同时增加两路门控
+            for (int32_t s = start; s < end; ++s) {
+                g_[static_cast<size_t>(s)]      += total_gain;
+                g_nmda_[static_cast<size_t>(s)] += total_gain;
+            }
+        } else {
+            for (int32_t s = start; s < end; ++s) {
+                g_[static_cast<size_t>(s)] += total_gain;
+            }
         }
     }
+    g_bound_ += max_gain;
+    if (nmda_enabled_) g_nmda_bound_ += max_gain;
 }
 
 const std::vector<float>& SynapseGroup::step_and_compute(
     const std::vector<float>& v_post,
     float dt
 ) {
-    // Clear output buffer (reused, no allocation)
-    std::fill(i_post_.begin(), i_post_.end(), 0.0f);
+    if (post_major_) return compute_post_major(v_post, dt);
 
     float decay = dt / tau_decay_;
     size_t n_syn = col_idx_.size();
     bool has_nmda = (mg_conc_ > 0.0f);
 
-    for (size_t s = 0; s < n_syn; ++s) {
-        // Decay gating variable
-        g_[s] -= g_[s] * decay;
+    // 延迟门控: 本步到期的增量并入, 电流直接写作 i_post_ 初值
+    if (ring_len_ > 0) {
+        advance_delay_ring(decay, dt / tau_nmda_);
+        float gw_n = g_max_nmda_ * w_nmda_;
+        for (size_t j = 0; j < n_post_; ++j) {
+            float v = v_post[j];
+            float b_v = has_nmda ? nmda_b_lookup(v) : 1.0f;
+            float i_syn = g_max_ * gd_[j] * b_v * (e_rev_ - v);
+            if (nmda_enabled_) i_syn += gw_n * gd_nmda_[j] * nmda_b_lookup(v) * (e_nmda_ - v);
+            i_post_[j] = i_syn;
+        }
+    } else {
+        // Clear output buffer (reused, no allocation)
+        std::fill(i_post_.begin(), i_post_.end(), 0.0f);
+    }
 
-        size_t post = static_cast<size_t>(col_idx_[s]);
-        float v = v_post[post];
+    float decay_n = dt / tau_nmda_;
+    float gw_n    = g_max_nmda_ * w_nmda_;
+    auto scatter = [&](auto w) {
+        if (nmda_enabled_) {
+            // 融合遍历: 一次读取 col_idx/V_post, 同时计算 AMPA + NMDA 电流
+            for (size_t s = 0; s < n_syn; ++s) {
+                g_[s]      -= g_[s] * decay;
+                g_nmda_[s] -= g_nmda_[s] * decay_n;
+
+                size_t post = static_cast<size_t>(col_idx_[s]);
+                float v = v_post[post];
+                float b_v = has_nmda ? nmda_b_lookup(v) : 1.0f;
+
+                float i_syn = g_max_ * w(s) * g_[s] * b_v * (e_rev_ - v)
+                            + gw_n * g_nmda_[s] * nmda_b_lookup(v) * (e_nmda_ - v);
+                i_post_[post] += i_syn;
+            }
+            return;
+        }
+
+        for (size_t s = 0; s < n_syn; ++s) {
+            // Decay gating variable
+            g_[s] -= g_[s] * decay;
+
+            size_t post = static_cast<size_t>(col_idx_[s]);
+            float v = v_post[post];
 
-        // B(V) lookup table for NMDA (replaces std::exp per synapse)
-        float b_v = has_nmda ? nmda_b_lookup(v) : 1.0f;
+            // B(V) lookup table for NMDA (replaces std::exp per synapse)
+            float b_v = has_nmda ? nmda_b_lookup(v) : 1.0f;
 
-        float i_syn = g_max_ * weights_[s] * g_[s] * b_v * (e_rev_ - v);
-        i_post_[post] += i_syn;
+            float i_syn = g_max_ * w(s) * g_[s] * b_v * (e_rev_ - v);
+            i_post_[post] += i_syn;
+        }
+    };
+    if (weight_format_ == WeightFormat::BF16) {
+        scatter(Bf16Weights{weights_bf16_.data()});
+    } else {
+        scatter(Fp32Weights{weights_.data()});
     }
 
+    if (nmda_enabled_) g_nmda_bound_ -= g_nmda_bound_ * decay_n;
+    g_bound_ -= g_bound_ * decay;
     return i_post_;  // zero-copy: return reference to internal buffer
 }
 
+const std::vector<float>& SynapseGroup::compute_post_major(
+    const std::vector<float>& v_post,
+    float dt
+) {
+    float decay = dt / tau_decay_;
+    size_t n_syn = col_idx_.size();
+    bool has_nmda = (mg_conc_ > 0.0f);
+    bool delayed = ring_len_ > 0;
+    if (delayed) advance_delay_ring(decay, dt / tau_nmda_);
+
+    // 门控衰减: 连续数组, 可向量化
+    for (size_t s = 0; s < n_syn; ++s) g_[s] -= g_[s] * decay;
+    g_bound_ -= g_bound_ * decay;
+
+    float gw_n = 0.0f;
+    if (nmda_enabled_) {
+        float decay_n = dt / tau_nmda_;
+        for (size_t s = 0; s < n_syn; ++s) g_nmda_[s] -= g_nmda_[s] * decay_n;
+        g_nmda_bound_ -= g_nmda_bound_ * decay_n;
+        gw_n = g_max_nmda_ * w_nmda_;
+    }
+
+    // 按 post 行归约: 每行独占 i_post_[j], V/B(V) 每个 post 只取一次
+    auto reduce = [&](auto w) {
+        auto rows = [&, w](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                int32_t k0 = csc_ptr_[j], k1 = csc_ptr_[j + 1];
+                float acc = 0.0f, acc_n = 0.0f;
+                for (int32_t k = k0; k < k1; ++k) {
+                    size_t s = static_cast<size_t>(csc_syn_[static_cast<size_t>(k)]);
+                    acc += w(s) * g_[s];
+                    if (nmda_enabled_) acc_n += g_nmda_[s];
+                }
+                if (delayed) {
+                    acc += gd_[j];
+                    if (nmda_enabled_) acc_n += gd_nmda_[j];
+                }
+                float v = v_post[j];
+                float b_v = has_nmda ? nmda_b_lookup(v) : 1.0f;
+                float i_syn = g_max_ * acc * b_v * (e_rev_ - v);
+                if (nmda_enabled_) i_syn += gw_n * acc_n * nmda_b_lookup(v) * (e_nmda_ - v);
+                i_post_[j] = i_syn;
+            }
+        };
+
+        WorkerPool* pool = WorkerPool::intra();
+        if (pool && n_syn >= POST_MAJOR_MIN_SYNAPSES) {
+            pool->parallel_for(n_post_, rows);
+        } else {
+            // 线程池任务内不开嵌套 OpenMP (同 NeuronPopulation::step)
+            bool par = n_syn >= POST_MAJOR_MIN_SYNAPSES && !WorkerPool::in_worker();
+            (void)par;
+            int np = static_cast<int>(n_post_);
+#ifdef WUYUN_OPENMP
+            #pragma omp parallel for schedule(static) if(par)
+#endif
+            for (int jj = 0; jj < np; ++jj) {
+                size_t j = static_cast<size_t>(jj);
+                rows(j, j + 1);
+            }
+        }
+    };
+    if (weight_format_ == WeightFormat::BF16) {
+        reduce(Bf16Weights{weights_bf16_.data()});
+    } else {
+        reduce(Fp32Weights{weights_.data()});
+    }
+    return i_post_;
+}
+
+void SynapseGroup::advance_delay_ring(float decay, float decay_n) {
+    float* slot = ring_.data() + ring_head_ * n_post_;
+    float bound = 0.0f;
+    for (size_t j = 0; j < n_post_; ++j) {
+        gd_[j] += slot[j];
+        gd_[j] -= gd_[j] * decay;
+        slot[j] = 0.0f;
+        bound = std::max(bound, gd_[j]);
+    }
+    if (nmda_enabled_) {
+        float* slot_n = ring_nmda_.data() + ring_head_ * n_post_;
+        for (size_t j = 0; j < n_post_; ++j) {
+            gd_nmda_[j] += slot_n[j];
+            gd_nmda_[j] -= gd_nmda_[j] * decay_n;
+            slot_n[j] = 0.0f;
+            bound = std::max(bound, gd_nmda_[j]);
+        }
+    }
+    gd_bound_ = bound;
+    ring_head_ = (ring_head_ + 1) & ring_mask_;
+    if (ring_busy_ > 0) --ring_busy_;
+}
+
+void SynapseGroup::relax(int32_t n_steps, float dt) {
+    if (n_steps <= 0 || col_idx_.empty()) return;
+    float n = static_cast<float>(n_steps);
+
+    float g_factor = std::pow(1.0f - dt / tau_decay_, n);
+    for (auto& g : g_) g *= g_factor;
+    g_bound_ *= g_factor;
+
+    // 静息时延迟环已排空 (ring_busy_ == 0), 只需衰减已到达的聚合门控
+    for (auto& g : gd_) g *= g_factor;
+    float gd_factor = g_factor;
+
+    if (nmda_enabled_) {
+        float n_factor = std::pow(1.0f - dt / tau_nmda_, n);
+        for (auto& g : g_nmda_) g *= n_factor;
+        g_nmda_bound_ *= n_factor;
+        for (auto& g : gd_nmda_) g *= n_factor;
+        gd_factor = std::max(gd_factor, n_factor);
+    }
+    gd_bound_ *= gd_factor;
+
+    if (stp_enabled_) {
+        // 无脉冲步: (1-x) 与 (u-U) 每步各乘 (1 - dt/τ)
+        float x_factor = std::pow(1.0f - dt / stp_params_.tau_D, n);
+        float u_factor = std::pow(1.0f - dt / stp_params_.tau_F, n);
+        for (auto& st : stp_states_) {
+            st.x = 1.0f - (1.0f - st.x) * x_factor;
+            st.u = stp_params_.U + (st.u - stp_params_.U) * u_factor;
+        }
+    }
+}
+
 void SynapseGroup::enable_stdp(const STDPParams& params) {
     stdp_enabled_ = true;
     stdp_params_ = params;
@@ -176,6 +478,7 @@ void SynapseGroup::apply_stdp(
     }
 
     // For each synapse: if pre or post fired this step, apply STDP
+    [[maybe_unused]] uint64_t n_updates = 0;
     for (size_t pre = 0; pre < n_pre_; ++pre) {
         int32_t start = row_ptr_[pre];
         int32_t end   = row_ptr_[pre + 1];
@@ -196,11 +499,13 @@ void SynapseGroup::apply_stdp(
             }
 
             if (dw != 0.0f) {
-                weights_[s] += dw;
-                weights_[s] = std::clamp(weights_[s], stdp_params_.w_min, stdp_params_.w_max);
+                size_t si = static_cast<size_t>(s);
+                set_weight(si, std::clamp(weight(si) + dw, stdp_params_.w_min, stdp_params_.w_max));
+                ++n_updates;
             }
         }
     }
+    WUYUN_PROF_PLASTICITY(n_updates);
 }
 
 void SynapseGroup::apply_stdp_error_gated(
@@ -223,6 +528,7 @@ void SynapseGroup::apply_stdp_error_gated(
     }
 
     // Error-gated: only update weights when post fires with required_type
+    [[maybe_unused]] uint64_t n_updates = 0;
     for (size_t pre = 0; pre < n_pre_; ++pre) {
         int32_t start = row_ptr_[pre];
         int32_t end_idx = row_ptr_[pre + 1];
@@ -244,11 +550,150 @@ void SynapseGroup::apply_stdp_error_gated(
             }
 
             if (dw != 0.0f) {
-                weights_[s] += dw;
-                weights_[s] = std::clamp(weights_[s], stdp_params_.w_min, stdp_params_.w_max);
+                size_t si = static_cast<size_t>(s);
+                set_weight(si, std::clamp(weight(si) + dw, stdp_params_.w_min, stdp_params_.w_max));
+                ++n_updates;
             }
         }
     }
+    WUYUN_PROF_PLASTICITY(n_updates);
+}
+
+// =============================================================================
+// 结构可塑性
+// =============================================================================
+
+void SynapseGroup::enable_structural(const StructuralParams& params) {
+    structural_enabled_ = true;
+    structural_params_ = params;
+    weak_steps_.assign(col_idx_.size(), 0);
+    if (params.grow_enabled) {
+        pre_rate_.assign(n_pre_, 0.0f);
+        post_rate_.assign(n_post_, 0.0f);
+    }
+    structural_step_ = 0;
+    pending_prunes_ = 0;
+}
+
+void SynapseGroup::update_structural(
+    const std::vector<uint8_t>& pre_fired,
+    const std::vector<uint8_t>& post_fired,
+    float dt
+) {
+    if (!structural_enabled_) return;
+    const auto& p = structural_params_;
+
+    if (p.grow_enabled) {
+        float a = dt / p.rate_tau;
+        for (size_t i = 0; i < n_pre_; ++i) {
+            pre_rate_[i] += a * (static_cast<float>(pre_fired[i] != 0) - pre_rate_[i]);
+        }
+        for (size_t j = 0; j < n_post_; ++j) {
+            post_rate_[j] += a * (static_cast<float>(post_fired[j] != 0) - post_rate_[j]);
+        }
+    }
+
+    // 权重扫描走慢时钟: 弱计数以 check_interval 为单位累加
+    if (++structural_step_ < p.check_interval) return;
+    uint32_t interval = structural_step_;
+    structural_step_ = 0;
+
+    for (size_t s = 0; s < weak_steps_.size(); ++s) {
+        if (weak_steps_[s] == PRUNED_MARK) {
+            set_weight(s, 0.0f);  // 已标记: STDP 不能在压缩前把它救回
+            continue;
+        }
+        if (weight(s) >= p.prune_threshold) {
+            weak_steps_[s] = 0;
+            continue;
+        }
+        weak_steps_[s] += interval;
+        if (weak_steps_[s] >= p.prune_window) {
+            weak_steps_[s] = PRUNED_MARK;
+            set_weight(s, 0.0f);
+            ++pending_prunes_;
+        }
+    }
+}
+
+size_t SynapseGroup::compact() {
+    if (!structural_enabled_) return 0;
+    const auto& p = structural_params_;
+
+    // 生长候选: 随机采样 (pre, post), 保留发放率迹乘积高且尚未连接的对
+    std::vector<std::pair<int32_t, int32_t>> grown;
+    if (p.grow_enabled && n_pre_ > 0 && n_post_ > 0) {
+        for (uint32_t k = 0; k < p.grow_samples; ++k) {
+            size_t pre  = xorshift32(grow_rng_) % n_pre_;
+            size_t post = xorshift32(grow_rng_) % n_post_;
+            // 方阵组按循环连接处理, 不长自突触
+            if (n_pre_ == n_post_ && pre == post) continue;
+            if (pre_rate_[pre] * post_rate_[post] < p.grow_threshold) continue;
+            bool connected = false;
+            for (int32_t s = row_ptr_[pre]; s < row_ptr_[pre + 1]; ++s) {
+                size_t si = static_cast<size_t>(s);
+                if (col_idx_[si] == static_cast<int32_t>(post) && weak_steps_[si] != PRUNED_MARK) {
+                    connected = true;
+                    break;
+                }
+            }
+            if (!connected) grown.emplace_back(static_cast<int32_t>(pre), static_cast<int32_t>(post));
+        }
+        std::sort(grown.begin(), grown.end());
+        grown.erase(std::unique(grown.begin(), grown.end()), grown.end());
+    }
+
+    if (pending_prunes_ == 0 && grown.empty()) return 0;
+
+    // 按行重建: 保留未标记突触 (保持行内顺序), 新突触追加在所属行末
+    bool bf16 = weight_format_ == WeightFormat::BF16;
+    size_t n_new = col_idx_.size() - pending_prunes_ + grown.size();
+    std::vector<int32_t>  row_ptr(n_pre_ + 1, 0);
+    std::vector<int32_t>  col_idx;   col_idx.reserve(n_new);
+    std::vector<float>    w32;       if (!bf16) w32.reserve(n_new);
+    std::vector<uint16_t> w16;       if (bf16)  w16.reserve(n_new);
+    std::vector<int32_t>  delays;    delays.reserve(n_new);
+    std::vector<float>    g;         g.reserve(n_new);
+    std::vector<float>    g_nmda;    if (nmda_enabled_) g_nmda.reserve(n_new);
+    std::vector<uint32_t> weak;      weak.reserve(n_new);
+
+    size_t removed = 0, gi = 0;
+    for (size_t pre = 0; pre < n_pre_; ++pre) {
+        for (int32_t s = row_ptr_[pre]; s < row_ptr_[pre + 1]; ++s) {
+            size_t si = static_cast<size_t>(s);
+            if (weak_steps_[si] == PRUNED_MARK) { ++removed; continue; }
+            col_idx.push_back(col_idx_[si]);
+            if (bf16) w16.push_back(weights_bf16_[si]); else w32.push_back(weights_[si]);
+            delays.push_back(delays_[si]);
+            g.push_back(g_[si]);
+            if (nmda_enabled_) g_nmda.push_back(g_nmda_[si]);
+            weak.push_back(weak_steps_[si]);
+        }
+        for (; gi < grown.size() && grown[gi].first == static_cast<int32_t>(pre); ++gi) {
+            col_idx.push_back(grown[gi].second);
+            if (bf16) w16.push_back(bf16_from_float(p.grow_w_init)); else w32.push_back(p.grow_w_init);
+            delays.push_back(1);
+            g.push_back(0.0f);
+            if (nmda_enabled_) g_nmda.push_back(0.0f);
+            weak.push_back(0);
+        }
+        row_ptr[pre + 1] = static_cast<int32_t>(col_idx.size());
+    }
+
+    row_ptr_ = std::move(row_ptr);
+    col_idx_ = std::move(col_idx);
+    if (bf16) weights_bf16_ = std::move(w16); else weights_ = std::move(w32);
+    delays_  = std::move(delays);
+    g_       = std::move(g);
+    if (nmda_enabled_) g_nmda_ = std::move(g_nmda);
+    weak_steps_ = std::move(weak);
+    // 延迟环按 post 存放, 已排队增量不受影响; CSC 镜像存突触下标, 需重建
+    if (post_major_) enable_post_major();
+
+    pending_prunes_ = 0;
+    pruned_total_ += removed;
+    grown_total_  += grown.size();
+    return removed;
 }
 
 } // namespace wuyun
@@ -9,12 +9,30 @@
  *   I_syn = g_max * w * s * (V_post - E_rev)
  *   ds/dt = -s / tau_decay  (on spike: s += 1)
  *
+ * 突触后主序镜像 (enable_post_major): 额外一份 CSC 索引 (每个 post 的输入连续),
+ * 电流累加由 pre 主序散射改为按 post 行归约: 无写冲突, 可多线程/向量化
+ *
+ * 传导延迟: delays_[s] > 1 的突触不直接增加 g, 而是把 w·gain 存入突触后神经元的
+ * 环形累加器 (槽 = 当前 + d-1), 到期时并入该 post 的聚合门控 (同 tau 衰减)。
+ * 每个事件 O(1), 无逐脉冲队列分配; 全部 d <= 1 时不建环, 行为不变
+ *
+ * 权重格式 (set_weight_format): 默认 fp32; BF16 时只存 16 位权重,
+ * 计算核按格式模板化解码, STDP/可塑性写回用随机舍入
+ *
+ * 结构可塑性 (enable_structural): 长期低于阈值的突触先标记剪除 (权重置 0),
+ * 可选按 pre/post 发放率迹生长新突触; 真正移出 CSR 由 compact() 在热路径外完成
+ *
+ * 双受体 (enable_nmda_channel): AMPA+NMDA 共定位于同一突触,
+ * 共享一份 CSR 拓扑, 每突触两个门控变量, 一次投递 + 一遍融合计算两路电流
+ *
  * 设计文档: docs/02_neuron_system_design.md §2
  */
 
 #include "types.h"
+#include "bfloat16.h"
 #include "../plasticity/stp.h"
 #include "../plasticity/stdp.h"
+#include "../plasticity/structural.h"
 #include <vector>
 #include <cstdint>
 
@@ -55,21 +73,107 @@ public:
      */
     const std::vector<float>& step_and_compute(const std::vector<float>& v_post, float dt = 1.0f);
 
+    // --- 静息跳过 (见 BrainRegion::quiescent) ---
+
+    /** 所有门控变量 g < eps (用逐步维护的上界判定, O(1)) */
+    bool quiescent(float eps = QUIESCENT_G) const {
+        return g_bound_ < eps && g_nmda_bound_ < eps
+            && ring_busy_ == 0 && gd_bound_ < eps;
+    }
+
+    /** 解析补齐 n 个无脉冲步: g 与 STP 资源按每步衰减因子的 n 次幂恢复 */
+    void relax(int32_t n_steps, float dt = 1.0f);
+
+    static constexpr float QUIESCENT_G = 1e-3f;
+
     // --- 访问器 ---
     size_t n_synapses() const { return col_idx_.size(); }
+    const std::vector<int32_t>& delays() const { return delays_; }
+    int32_t max_delay() const { return max_delay_; }
+    bool has_delay_ring() const { return ring_len_ > 0; }
     size_t n_pre()      const { return n_pre_; }
     size_t n_post()     const { return n_post_; }
     CompartmentType target() const { return target_; }
 
-    const std::vector<float>& weights() const { return weights_; }
-    std::vector<float>& weights() { return weights_; }
+    /**
+     * 权重快照 (按值, 任意格式; BF16 时解码)
+     * 不经共享缓存, 并发只读调用安全; 修改权重用 set_weight / update_weights
+     */
+    std::vector<float> weights() const;
+
+    /**
+     * FP32 权重存储本身 (零拷贝, 可直接修改); 仅 weight_format() == FP32 时有效,
+     * BF16 时为空数组
+     */
+    std::vector<float>&       fp32_weights()       { return weights_; }
+    const std::vector<float>& fp32_weights() const { return weights_; }
+
+    /** 单个突触权重 (任意格式) */
+    float weight(size_t s) const {
+        return weight_format_ == WeightFormat::BF16 ? bf16_to_float(weights_bf16_[s]) : weights_[s];
+    }
+    /** 写单个突触权重; BF16 时随机舍入 */
+    void set_weight(size_t s, float w) {
+        if (weight_format_ == WeightFormat::BF16) {
+            weights_bf16_[s] = bf16_from_float_stochastic(w, xorshift32(round_state_));
+        } else {
+            weights_[s] = w;
+        }
+    }
+
+    /**
+     * 批量修改权重 (稳态缩放等低频整体操作): fn(std::vector<float>&)
+     * BF16 时先解码到临时 fp32 数组, fn 返回后随机舍入写回并释放临时数组
+     */
+    template <typename Fn>
+    void update_weights(Fn&& fn) {
+        if (weight_format_ == WeightFormat::FP32) { fn(weights_); return; }
+        unpack_weights();
+        fn(weights_);
+        pack_weights(true);
+    }
+
+    /** 切换权重存储格式 (FP32 → BF16 就近舍入; BF16 → FP32 无损) */
+    void set_weight_format(WeightFormat fmt);
+    WeightFormat weight_format() const { return weight_format_; }
+    size_t weight_bytes() const {
+        return weight_format_ == WeightFormat::BF16 ? weights_bf16_.size() * sizeof(uint16_t)
+                                                    : weights_.size() * sizeof(float);
+    }
     const std::vector<int32_t>& row_ptr() const { return row_ptr_; }
     const std::vector<int32_t>& col_idx() const { return col_idx_; }
 
+    /**
+     * 构建突触后主序 (CSC) 镜像, step_and_compute 改为按 post 行归约
+     *
+     * 镜像只存突触下标 (指向 CSR 存储), 权重/门控仍以 CSR 为准,
+     * STDP/稳态缩放无需同步。适合大扇入组 (小脑平行纤维, 大规模皮层循环)
+     */
+    void enable_post_major();
+    bool post_major() const { return post_major_; }
+    const std::vector<int32_t>& csc_ptr() const { return csc_ptr_; }
+    const std::vector<int32_t>& csc_syn() const { return csc_syn_; }
+
+    /** 大于此突触数的组才值得开 CSC 镜像 / 行归约并行 */
+    static constexpr size_t POST_MAJOR_MIN_SYNAPSES = 4096;
+
     /** 启用 STP (Tsodyks-Markram 短时程可塑性), 每个突触前神经元一个 STPState */
     void enable_stp(const STPParams& params);
     bool has_stp() const { return stp_enabled_; }
 
+    /**
+     * 启用 NMDA 共受体通道 (共享本组 CSR 拓扑)
+     *
+     * 每个前突触脉冲同时增加 AMPA (主通道) 与 NMDA 门控;
+     * NMDA 权重为组内常数, 不参与 STDP / 稳态缩放 (与主通道权重独立)
+     *
+     * @param params  NMDA 通道参数 (tau_decay, E_rev, g_max, Mg²⁺)
+     * @param weight  NMDA 通道权重
+     */
+    void enable_nmda_channel(const SynapseParams& params, float weight);
+    bool has_nmda_channel() const { return nmda_enabled_; }
+    const std::vector<float>& g_nmda() const { return g_nmda_; }
+
     /** 启用 STDP (长时程可塑性) */
     void enable_stdp(const STDPParams& params);
     bool has_stdp() const { return stdp_enabled_; }
@@ -99,7 +203,38 @@ public:
                                 int8_t required_type,
                                 int32_t t);
 
+    // --- 结构可塑性 ---
+
+    /** 启用结构可塑性: 分配每突触弱计数 (生长启用时另加 pre/post 发放率迹) */
+    void enable_structural(const StructuralParams& params);
+    bool has_structural() const { return structural_enabled_; }
+
+    /**
+     * 每步调用 (在 STDP 之后): 生长启用时更新发放率迹;
+     * 每 check_interval 步扫描一次权重, 持续 prune_window 步低于阈值 → 标记剪除
+     */
+    void update_structural(const std::vector<uint8_t>& pre_fired,
+                           const std::vector<uint8_t>& post_fired,
+                           float dt = 1.0f);
+
+    /**
+     * 压缩 CSR: 移出已标记突触, 生长启用时加入采样到的高相关未连接对,
+     * 重建 row_ptr/col_idx/权重/延迟/门控 (及 CSC 镜像)。
+     * 不在每步调用 — 放在睡眠巩固等离线阶段
+     * @return 移出的突触数
+     */
+    size_t compact();
+
+    size_t pending_prunes() const { return pending_prunes_; }
+    uint64_t pruned_total() const { return pruned_total_; }
+    uint64_t grown_total()  const { return grown_total_; }
+
 private:
+    const std::vector<float>& compute_post_major(const std::vector<float>& v_post, float dt);
+    void advance_delay_ring(float decay, float decay_n);
+    void unpack_weights();
+    void pack_weights(bool stochastic);
+
     size_t n_pre_;
     size_t n_post_;
     CompartmentType target_;
@@ -107,9 +242,19 @@ private:
     // CSR 格式
     std::vector<int32_t> row_ptr_;    // 长度 = n_pre + 1
     std::vector<int32_t> col_idx_;    // 长度 = n_synapses (post neuron IDs)
-    std::vector<float>   weights_;    // 长度 = n_synapses
+    std::vector<float>   weights_;    // 长度 = n_synapses (FP32 时)
     std::vector<int32_t> delays_;     // 长度 = n_synapses
 
+    // BF16 权重 (optional): 启用时 weights_ 为空
+    WeightFormat weight_format_ = WeightFormat::FP32;
+    std::vector<uint16_t> weights_bf16_;
+    uint32_t round_state_ = 0x9E3779B9u;      // 随机舍入 xorshift 状态
+
+    // CSC 镜像 (optional): post j 的输入突触 = csc_syn_[csc_ptr_[j] .. csc_ptr_[j+1])
+    bool post_major_ = false;
+    std::vector<int32_t> csc_ptr_;    // 长度 = n_post + 1
+    std::vector<int32_t> csc_syn_;    // 长度 = n_synapses (CSR 突触下标)
+
     // 突触参数
     float tau_decay_;
     float e_rev_;
@@ -118,6 +263,28 @@ private:
 
     // 门控变量
     std::vector<float> g_;            // 长度 = n_synapses
+    float g_bound_ = 0.0f;            // max(g_) 的上界 (每个突触每步至多一次增量)
+
+    // NMDA 共受体通道 (optional, 共享 row_ptr_/col_idx_)
+    bool nmda_enabled_ = false;
+    float tau_nmda_   = 100.0f;
+    float e_nmda_     = 0.0f;
+    float g_max_nmda_ = 0.0f;
+    float w_nmda_     = 0.0f;
+    std::vector<float> g_nmda_;       // 长度 = n_synapses (enabled 时)
+    float g_nmda_bound_ = 0.0f;
+
+    // 延迟环 (max_delay_ > 1 时): ring_[slot * n_post + post], 槽数为 2 的幂
+    int32_t max_delay_ = 1;
+    size_t ring_len_  = 0;
+    size_t ring_mask_ = 0;
+    size_t ring_head_ = 0;
+    int32_t ring_busy_ = 0;           // 最晚一笔未到期存入还剩的步数
+    std::vector<float> ring_;         // 到期的 w·gain 增量
+    std::vector<float> ring_nmda_;    // NMDA 通道到期增量 (gain, 权重为组常数)
+    std::vector<float> gd_;           // 已到达的延迟门控 Σ w·g, 长度 = n_post
+    std::vector<float> gd_nmda_;
+    float gd_bound_ = 0.0f;           // max(gd_, gd_nmda_)
 
     // STP (optional, per pre-neuron)
     bool stp_enabled_ = false;
@@ -130,6 +297,19 @@ private:
     std::vector<float> last_spike_pre_;   // 长度 = n_pre
     std::vector<float> last_spike_post_;  // 长度 = n_post
 
+    // 结构可塑性 (optional)
+    bool structural_enabled_ = false;
+    StructuralParams structural_params_;
+    std::vector<uint32_t> weak_steps_;    // 长度 = n_synapses, PRUNED_MARK = 待移出
+    std::vector<float> pre_rate_;         // 发放率迹 (每步发放概率), 生长启用时
+    std::vector<float> post_rate_;
+    uint32_t structural_step_ = 0;
+    uint32_t grow_rng_ = 0x85EBCA6Bu;     // 生长候选采样 xorshift 状态
+    size_t pending_prunes_ = 0;
+    uint64_t pruned_total_ = 0;
+    uint64_t grown_total_  = 0;
+    static constexpr uint32_t PRUNED_MARK = 0xFFFFFFFFu;
+
     // 聚合输出缓冲
     std::vector<float> i_post_;       // 长度 = n_post
 };
@@ -0,0 +1,192 @@
+#include "core/telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <new>
+
+namespace wuyun {
+
+static_assert(sizeof(TelemetryHeader) == 4224, "TelemetryHeader 布局被 Python 读者硬编码");
+static_assert(sizeof(TelemetrySlot) == 640, "TelemetrySlot 布局被 Python 读者硬编码");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "遥测 seqlock 需要无锁 64 位原子");
+
+namespace {
+
+std::string shm_name(const std::string& name) {
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t segment_bytes(size_t capacity) {
+    return sizeof(TelemetryHeader) + capacity * sizeof(TelemetrySlot);
+}
+
+} // namespace
+
+// =============================================================================
+// TelemetryWriter
+// =============================================================================
+
+std::unique_ptr<TelemetryWriter> TelemetryWriter::create(const std::string& name,
+                                                         const std::vector<std::string>& regions,
+                                                         uint32_t publish_every, size_t capacity) {
+    capacity = std::max<size_t>(capacity, 2);
+    auto shm = SharedMemory::create(shm_name(name), segment_bytes(capacity));
+    if (!shm.valid()) return nullptr;
+
+    std::unique_ptr<TelemetryWriter> w(new TelemetryWriter());
+    w->shm_ = std::move(shm);
+    w->name_ = shm_name(name);
+    w->capacity_ = capacity;
+    w->publish_every_ = std::max<uint32_t>(publish_every, 1);
+    w->t0_ns_ = now_ns();
+
+    // 新段由 ftruncate 清零; 槽 seq = 0 即 "从未写过"
+    char* base = static_cast<char*>(w->shm_.data());
+    w->hdr_ = new (base) TelemetryHeader();
+    w->slots_ = reinterpret_cast<TelemetrySlot*>(base + sizeof(TelemetryHeader));
+    for (size_t i = 0; i < capacity; ++i) {
+        new (&w->slots_[i].seq) std::atomic<uint64_t>(0);
+    }
+
+    TelemetryHeader& h = *w->hdr_;
+    h.version = TELEMETRY_VERSION;
+    h.header_bytes = static_cast<uint32_t>(sizeof(TelemetryHeader));
+    h.slot_bytes = static_cast<uint32_t>(sizeof(TelemetrySlot));
+    h.frame_bytes = static_cast<uint32_t>(sizeof(TelemetryFrame));
+    h.capacity = static_cast<uint32_t>(capacity);
+    h.n_regions = static_cast<uint32_t>(std::min(regions.size(), TELEMETRY_MAX_REGIONS));
+    h.publish_every = w->publish_every_;
+    h.published.store(0, std::memory_order_relaxed);
+    std::memset(h.region_names, 0, sizeof(h.region_names));
+    for (size_t i = 0; i < h.n_regions; ++i) {
+        std::strncpy(h.region_names[i], regions[i].c_str(), TELEMETRY_NAME_LEN - 1);
+    }
+    // 魔数最后写: 读者看到魔数即看到完整段头
+    std::atomic_thread_fence(std::memory_order_release);
+    h.magic = TELEMETRY_MAGIC;
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    TelemetryFrame& f = w->staging_;
+    f.n_regions = h.n_regions;
+    f.reward_rate = f.last_reward = f.bg_da = f.bg_w_d1_norm = f.bg_w_d2_norm = nan;
+    return w;
+}
+
+void TelemetryWriter::publish() {
+    const uint64_t k = next_;
+    staging_.seq = k;
+    staging_.wall_s = static_cast<double>(now_ns() - t0_ns_) * 1e-9;
+
+    TelemetrySlot& slot = slots_[k % capacity_];
+    slot.seq.store(2 * k + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.frame, &staging_, sizeof(TelemetryFrame));
+    slot.seq.store(2 * k + 2, std::memory_order_release);
+
+    next_ = k + 1;
+    hdr_->published.store(next_, std::memory_order_release);
+}
+
+// =============================================================================
+// TelemetryReader
+// =============================================================================
+
+bool TelemetryReader::attach(const std::string& name) {
+    detach();
+    const std::string n = shm_name(name);
+
+    // 先只映射段头取容量, 再按全长重新映射
+    uint32_t capacity = 0;
+    {
+        auto probe = SharedMemory::open(n, sizeof(TelemetryHeader), true);
+        if (!probe.valid()) return false;
+        const auto* h = static_cast<const TelemetryHeader*>(probe.data());
+        if (h->magic != TELEMETRY_MAGIC || h->version != TELEMETRY_VERSION ||
+            h->slot_bytes != sizeof(TelemetrySlot) || h->capacity == 0) {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        capacity = h->capacity;
+        uint32_t n_regions = std::min<uint32_t>(h->n_regions, TELEMETRY_MAX_REGIONS);
+        names_.clear();
+        for (uint32_t i = 0; i < n_regions; ++i) {
+            names_.emplace_back(h->region_names[i],
+                                strnlen(h->region_names[i], TELEMETRY_NAME_LEN));
+        }
+    }
+
+    shm_ = SharedMemory::open(n, segment_bytes(capacity), true);
+    if (!shm_.valid()) {
+        names_.clear();
+        return false;
+    }
+    const char* base = static_cast<const char*>(shm_.data());
+    hdr_ = reinterpret_cast<const TelemetryHeader*>(base);
+    slots_ = reinterpret_cast<const TelemetrySlot*>(base + sizeof(TelemetryHeader));
+
+    uint64_t pub = hdr_->published.load(std::memory_order_acquire);
+    next_ = pub > hdr_->capacity ? pub - hdr_->capacity : 0;
+    lost_ = 0;
+    return true;
+}
+
+void TelemetryReader::detach() {
+    shm_ = SharedMemory();
+    hdr_ = nullptr;
+    slots_ = nullptr;
+    next_ = 0;
+    names_.clear();
+}
+
+bool TelemetryReader::read_slot(uint64_t k, TelemetryFrame& out) const {
+    const TelemetrySlot& slot = slots_[k % hdr_->capacity];
+    const uint64_t want = 2 * k + 2;
+    if (slot.seq.load(std::memory_order_acquire) != want) return false;
+    std::memcpy(&out, &slot.frame, sizeof(TelemetryFrame));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == want;
+}
+
+size_t TelemetryReader::poll(std::vector<TelemetryFrame>& out) {
+    if (!hdr_) return 0;
+    const uint64_t pub = hdr_->published.load(std::memory_order_acquire);
+    const uint64_t cap = hdr_->capacity;
+    if (pub > next_ + cap) {
+        lost_ += pub - cap - next_;
+        next_ = pub - cap;
+    }
+
+    size_t got = 0;
+    TelemetryFrame f;
+    for (; next_ < pub; ++next_) {
+        if (read_slot(next_, f)) {
+            out.push_back(f);
+            ++got;
+        } else {
+            ++lost_;   // 读取期间被写端覆盖
+        }
+    }
+    return got;
+}
+
+bool TelemetryReader::latest(TelemetryFrame& out) const {
+    if (!hdr_) return false;
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint64_t pub = hdr_->published.load(std::memory_order_acquire);
+        if (pub == 0) return false;
+        if (read_slot(pub - 1, out)) return true;
+    }
+    return false;
+}
+
+void TelemetryReader::skip_to_latest() {
+    if (hdr_) next_ = hdr_->published.load(std::memory_order_acquire);
+}
+
+} // namespace wuyun
@@ -0,0 +1,160 @@
+#pragma once
+/**
+ * Telemetry — 共享内存实时遥测环 (外部监控)
+ *
+ * 长时间运行的仿真/智能体每 N 步把一帧摘要写进命名共享内存段,
+ * 监控方 (tools/telemetry_monitor, python/wuyun/telemetry.py) 随时 attach/detach,
+ * 不需要仿真进程配合, 也不会拖慢它:
+ *
+ *   - 单生产者、任意多读者; 写端从不等待读者 (环满即覆盖最旧帧)
+ *   - 每个槽一把 seqlock: 写前 seq = 2k+1, 写完 seq = 2k+2 (k = 帧序号);
+ *     读者拷贝前后各读一次 seq, 不一致 = 被覆盖, 计入 lost 丢弃
+ *   - 读者只读映射 (PROT_READ), 不写共享内存的任何字节 → 读者数量与快慢不影响写端
+ *   - 布局固定 (小端, 无指针), Python 侧按 struct 解析; 改布局须递增 TELEMETRY_VERSION
+ *
+ * 段布局:
+ *   [0, 4224)    TelemetryHeader (魔数、版本、槽大小、容量、区域名表、已发布帧数)
+ *   [4224, ...)  capacity 个 TelemetrySlot (64 字节对齐)
+ *
+ * 非 POSIX 平台: SharedMemory 不可用, create/attach 返回失败
+ */
+
+#include "core/shm_ring.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wuyun {
+
+constexpr uint32_t TELEMETRY_MAGIC       = 0x4D545957u;   // "WYTM"
+constexpr uint32_t TELEMETRY_VERSION     = 1;
+constexpr size_t   TELEMETRY_MAX_REGIONS = 128;
+constexpr size_t   TELEMETRY_NAME_LEN    = 32;
+
+/**
+ * 一帧遥测 (POD, 600 字节)
+ * 智能体字段在无 ClosedLoopAgent 时为 NaN / 0
+ */
+struct TelemetryFrame {
+    uint64_t seq;              // 帧序号 (从 0 起, 连续)
+    int64_t  step;             // 引擎时间步 (发布时)
+    int64_t  agent_steps;      // 智能体环境步
+    double   wall_s;           // 写端启用遥测以来的墙钟秒数
+
+    float    step_us_mean;     // 本窗口 SimulationEngine::step 平均耗时 (μs)
+    float    step_us_max;      // 本窗口最大单步耗时 (μs)
+    uint32_t window_steps;     // 本窗口步数
+    uint32_t n_regions;        // spikes[] 有效项数
+
+    float    da, ne, sht, ach; // 全局神经调质 (引擎广播值)
+
+    float    reward_rate;      // 本窗口平均奖励 / 智能体步
+    float    last_reward;
+    float    bg_da;            // BasalGanglia DA 水平
+    float    bg_w_d1_norm;     // cortical→D1 权重 L2 范数
+    float    bg_w_d2_norm;     // cortical→D2 权重 L2 范数
+    float    reserved;
+
+    uint32_t spikes[TELEMETRY_MAX_REGIONS];   // 本窗口每区域发放数
+};
+static_assert(sizeof(TelemetryFrame) == 600, "TelemetryFrame 布局被 Python 读者硬编码");
+
+/** 段头 (创建时写一次; 之后只有 published 变化) */
+struct TelemetryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_bytes;
+    uint32_t slot_bytes;
+    uint32_t frame_bytes;
+    uint32_t capacity;
+    uint32_t n_regions;
+    uint32_t publish_every;
+    alignas(64) std::atomic<uint64_t> published;   // 已完整发布的帧数
+    alignas(64) char region_names[TELEMETRY_MAX_REGIONS][TELEMETRY_NAME_LEN];
+};
+
+/** 环中的一个槽 */
+struct alignas(64) TelemetrySlot {
+    std::atomic<uint64_t> seq;   // seqlock: 2k+1 = 写入中, 2k+2 = 帧 k 完整
+    TelemetryFrame        frame;
+};
+
+/** 单生产者遥测写端 (由 SimulationEngine 持有) */
+class TelemetryWriter {
+public:
+    /**
+     * 创建命名段 (已存在则覆盖), 写端析构时 unlink
+     * @param name      共享内存名 (无前导 '/' 时自动补上)
+     * @param regions   区域名 (超过 TELEMETRY_MAX_REGIONS 的截断)
+     * @param capacity  环中帧数
+     * @return 共享内存不可用时 nullptr
+     */
+    static std::unique_ptr<TelemetryWriter> create(const std::string& name,
+                                                   const std::vector<std::string>& regions,
+                                                   uint32_t publish_every, size_t capacity = 1024);
+
+    /** 待发布帧: 调用方就地填写, publish() 补 seq/wall_s 后整帧写入环 */
+    TelemetryFrame& staging() { return staging_; }
+
+    /** 发布 staging() 为下一帧 (无等待) */
+    void publish();
+
+    uint64_t published() const { return next_; }
+    uint32_t publish_every() const { return publish_every_; }
+    const std::string& name() const { return name_; }
+
+private:
+    TelemetryWriter() = default;
+
+    SharedMemory    shm_;
+    TelemetryHeader* hdr_ = nullptr;
+    TelemetrySlot*   slots_ = nullptr;
+    size_t           capacity_ = 0;
+    uint32_t         publish_every_ = 1;
+    uint64_t         next_ = 0;
+    int64_t          t0_ns_ = 0;
+    std::string      name_;
+    TelemetryFrame   staging_{};
+};
+
+/** 只读遥测读者 (可多个, 任意时刻 attach/detach) */
+class TelemetryReader {
+public:
+    /** attach 命名段 (只读映射); 段不存在或魔数/版本不符返回 false */
+    bool attach(const std::string& name);
+    void detach();
+    bool attached() const { return hdr_ != nullptr; }
+
+    /**
+     * 读出自上次 poll (或 attach) 以来的新帧, 追加到 out; 返回新帧数
+     * 首次 poll 从环中保留的最旧帧开始。读者落后超过 capacity 或读到被覆盖的槽时,
+     * 跳过的帧计入 lost()
+     */
+    size_t poll(std::vector<TelemetryFrame>& out);
+
+    /** 最新一帧 (不推进 poll 位置); 尚无帧返回 false */
+    bool latest(TelemetryFrame& out) const;
+
+    /** 跳到当前写位置 (只看之后的帧) */
+    void skip_to_latest();
+
+    uint64_t lost() const { return lost_; }
+    uint32_t capacity() const { return hdr_ ? hdr_->capacity : 0; }
+    uint32_t publish_every() const { return hdr_ ? hdr_->publish_every : 0; }
+    const std::vector<std::string>& region_names() const { return names_; }
+
+private:
+    bool read_slot(uint64_t k, TelemetryFrame& out) const;
+
+    SharedMemory shm_;
+    const TelemetryHeader* hdr_ = nullptr;
+    const TelemetrySlot*   slots_ = nullptr;
+    uint64_t next_ = 0;
+    uint64_t lost_ = 0;
+    std::vector<std::string> names_;
+};
+
+} // namespace wuyun
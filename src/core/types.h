@@ -53,6 +53,12 @@ enum class CompartmentType : int8_t {
     APICAL = 2,   // 顶端树突 (反馈输入)
 };
 
+/** 突触权重存储格式 (见 SynapseGroup::set_weight_format) */
+enum class WeightFormat : int8_t {
+    FP32 = 0,     // 默认: 32 位浮点
+    BF16 = 1,     // bfloat16: 权重流量减半, 可塑性更新随机舍入
+};
+
 // =============================================================================
 // 突触类型枚举
 // =============================================================================
@@ -0,0 +1,137 @@
+#include "core/worker_pool.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace wuyun {
+
+namespace {
+thread_local bool        t_in_worker = false;
+thread_local WorkerPool* t_intra     = nullptr;
+
+constexpr int SPIN_ITERS = 4000;   // 睡眠前自旋次数 (步间隔很短, 多数派发在自旋内到达)
+
+void pin_current_thread(int core) {
+#if defined(__linux__)
+    unsigned ncpu = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned>(core) % ncpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+} // namespace
+
+WorkerPool::WorkerPool(int n_threads, bool pin)
+    : n_threads_(std::max(1, n_threads))
+    , partial_(static_cast<size_t>(n_threads_))
+{
+    threads_.reserve(static_cast<size_t>(n_threads_ - 1));
+    for (int tid = 1; tid < n_threads_; ++tid) {
+        threads_.emplace_back([this, tid, pin] {
+            if (pin) pin_current_thread(tid);
+            worker_main(tid);
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stop_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        generation_.fetch_add(1);
+    }
+    cv_.notify_all();
+    for (auto& th : threads_) th.join();
+}
+
+bool WorkerPool::in_worker() { return t_in_worker; }
+
+WorkerPool* WorkerPool::intra() { return t_intra; }
+
+WorkerPool::IntraScope::IntraScope(WorkerPool* pool) : prev_(t_intra) { t_intra = pool; }
+WorkerPool::IntraScope::~IntraScope() { t_intra = prev_; }
+
+void WorkerPool::execute(int tid) {
+    bool was = t_in_worker;
+    t_in_worker = true;
+    (*task_)(tid);
+    t_in_worker = was;
+}
+
+void WorkerPool::worker_main(int tid) {
+    uint64_t seen = 0;
+    for (;;) {
+        // 自旋等待新一代任务, 超时后睡眠
+        uint64_t gen = generation_.load(std::memory_order_acquire);
+        for (int i = 0; gen == seen && i < SPIN_ITERS; ++i) {
+            std::this_thread::yield();
+            gen = generation_.load(std::memory_order_acquire);
+        }
+        if (gen == seen) {
+            std::unique_lock<std::mutex> lock(mu_);
+            sleepers_.fetch_add(1);
+            cv_.wait(lock, [&] { return generation_.load() != seen; });
+            sleepers_.fetch_sub(1);
+            gen = generation_.load();
+        }
+        seen = gen;
+        if (stop_.load()) return;
+
+        execute(tid);
+        remaining_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void WorkerPool::run(const std::function<void(int tid)>& fn) {
+    // 任务内再次派发 (或单线程池): 当前线程顺序执行, 不嵌套
+    if (n_threads_ == 1 || t_in_worker) {
+        for (int tid = 0; tid < n_threads_; ++tid) fn(tid);
+        return;
+    }
+
+    task_ = &fn;
+    remaining_.store(n_threads_ - 1, std::memory_order_relaxed);
+    generation_.fetch_add(1);   // seq_cst: 与 sleepers_ 的检查构成 Dekker 握手
+    if (sleepers_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(mu_); }
+        cv_.notify_all();
+    }
+
+    execute(0);
+
+    for (int i = 0; remaining_.load(std::memory_order_acquire) != 0; ++i) {
+        if (i >= SPIN_ITERS) std::this_thread::yield();
+    }
+    task_ = nullptr;
+}
+
+void WorkerPool::parallel_for(size_t n, const std::function<void(size_t, size_t)>& fn) {
+    size_t nt = static_cast<size_t>(n_threads_);
+    run([&](int tid) {
+        size_t t = static_cast<size_t>(tid);
+        size_t begin = n * t / nt;
+        size_t end   = n * (t + 1) / nt;
+        if (begin < end) fn(begin, end);
+    });
+}
+
+size_t WorkerPool::parallel_sum(size_t n, const std::function<size_t(size_t, size_t)>& fn) {
+    size_t nt = static_cast<size_t>(n_threads_);
+    run([&](int tid) {
+        size_t t = static_cast<size_t>(tid);
+        size_t begin = n * t / nt;
+        size_t end   = n * (t + 1) / nt;
+        partial_[t].value = (begin < end) ? fn(begin, end) : 0;
+    });
+    size_t sum = 0;
+    for (const auto& p : partial_) sum += p.value;
+    return sum;
+}
+
+} // namespace wuyun
@@ -0,0 +1,92 @@
+#pragma once
+/**
+ * WorkerPool — 常驻线程池 (区域并行 + 区域内神经元循环)
+ *
+ * 引擎默认每步进入一次 omp parallel for 遍历区域, 区域内 NeuronPopulation
+ * 还可能再开嵌套 omp: 线程超额订阅 + 每步 fork/join 开销。
+ * WorkerPool 的线程在引擎生命周期内常驻:
+ *
+ *   - run(fn): 所有线程 (调用线程 = tid 0) 执行 fn(tid), 返回即全部完成
+ *     派发 = 原子代数 +1; 工作线程先自旋后睡眠 (条件变量), 空闲时不占核
+ *   - parallel_for / parallel_sum: 把区间切块分给全部线程 (区域内神经元循环)
+ *   - 可选绑核 (Linux: pthread_setaffinity_np, 第 k 个线程 → 核 k % ncpu);
+ *     调用线程不改亲和性。默认不绑: 核号按池内序号分配, 同进程多个池
+ *     (并行 agent / 多引擎) 会把线程压到同一批核上
+ *
+ * 防嵌套: run() 的任务内 in_worker() 为真, NeuronPopulation 此时串行;
+ * IntraScope 期间 intra() 返回本池, NeuronPopulation 的神经元循环改由本池分块执行
+ * (用于单独步进的大区域, 见 SimulationEngine::use_worker_pool)
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wuyun {
+
+class WorkerPool {
+public:
+    /**
+     * @param n_threads  总线程数 (含调用线程), >= 1
+     * @param pin        工作线程绑核 (仅在进程内只有一个池时使用)
+     */
+    explicit WorkerPool(int n_threads, bool pin = false);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return n_threads_; }
+
+    /** 全部线程执行 fn(tid), tid ∈ [0, size()); 调用线程为 tid 0 */
+    void run(const std::function<void(int tid)>& fn);
+
+    /** [0, n) 按线程静态切块: fn(begin, end) */
+    void parallel_for(size_t n, const std::function<void(size_t begin, size_t end)>& fn);
+
+    /** 同 parallel_for, 各块返回值求和 */
+    size_t parallel_sum(size_t n, const std::function<size_t(size_t begin, size_t end)>& fn);
+
+    /** 当前线程是否正在执行本类任意池的任务 */
+    static bool in_worker();
+
+    /** 当前线程的区域内循环池 (IntraScope 期间), 否则 nullptr */
+    static WorkerPool* intra();
+
+    /** RAII: 作用域内区域内循环交给 pool */
+    class IntraScope {
+    public:
+        explicit IntraScope(WorkerPool* pool);
+        ~IntraScope();
+        IntraScope(const IntraScope&) = delete;
+        IntraScope& operator=(const IntraScope&) = delete;
+    private:
+        WorkerPool* prev_;
+    };
+
+private:
+    void worker_main(int tid);
+    void execute(int tid);
+
+    int n_threads_;
+    std::vector<std::thread> threads_;
+
+    const std::function<void(int)>* task_ = nullptr;
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<int>      remaining_{0};
+    std::atomic<int>      sleepers_{0};
+    std::atomic<bool>     stop_{false};
+    std::mutex              mu_;
+    std::condition_variable cv_;
+
+    // parallel_sum 每线程部分和 (各占一条缓存行)
+    struct alignas(64) Partial { size_t value = 0; };
+    std::vector<Partial> partial_;
+};
+
+} // namespace wuyun
@@ -0,0 +1,108 @@
+#include "engine/background_consolidator.h"
+#include <algorithm>
+
+namespace wuyun {
+
+void BackgroundConsolidator::OwnedSchedule::bind() {
+    for (size_t k = 0; k < schedule.steps.size(); ++k) {
+        schedule.steps[k].ids   = ids.data()   + offsets[k];
+        schedule.steps[k].types = types.data() + offsets[k];
+    }
+}
+
+BackgroundConsolidator::BackgroundConsolidator(int lag)
+    : lag_(std::max(lag, 1))
+{
+    thread_ = std::thread([this] { worker_main(); });
+}
+
+BackgroundConsolidator::~BackgroundConsolidator() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void BackgroundConsolidator::enqueue(const ReplaySchedule& schedule) {
+    for (const auto& seg : schedule.segments) {
+        pending_.schedule.begin_segment(seg.da_level);
+        for (uint32_t k = seg.first; k < seg.first + seg.count; ++k) {
+            const ReplaySchedule::Step& st = schedule.steps[k];
+            pending_.offsets.push_back(static_cast<uint32_t>(pending_.ids.size()));
+            pending_.ids.insert(pending_.ids.end(), st.ids, st.ids + st.n);
+            pending_.types.insert(pending_.types.end(), st.types, st.types + st.n);
+            ReplaySchedule::Step copy = st;
+            copy.ids = nullptr;
+            copy.types = nullptr;
+            pending_.schedule.add_step(copy);
+        }
+    }
+}
+
+void BackgroundConsolidator::dispatch(const BasalGanglia& live) {
+    std::swap(running_, pending_);
+    pending_.clear();
+    running_.bind();
+    if (shadow_) *shadow_ = live;
+    else shadow_ = std::make_unique<BasalGanglia>(live);
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        job_ready_ = true;
+        job_done_  = false;
+    }
+    cv_.notify_all();
+    in_flight_ = true;
+    age_ = 0;
+}
+
+void BackgroundConsolidator::wait_and_merge(BasalGanglia& live) {
+    {
+        std::unique_lock<std::mutex> lk(mu_);
+        cv_.wait(lk, [this] { return job_done_; });
+        job_done_ = false;
+    }
+    live.apply_learning_delta(before_, after_);
+    in_flight_ = false;
+    ++jobs_merged_;
+}
+
+void BackgroundConsolidator::sync(BasalGanglia& live) {
+    if (in_flight_ && ++age_ >= lag_) wait_and_merge(live);
+    if (!in_flight_ && !pending_.schedule.steps.empty()) dispatch(live);
+}
+
+void BackgroundConsolidator::drain(BasalGanglia& live) {
+    if (in_flight_) wait_and_merge(live);
+    if (!pending_.schedule.steps.empty()) {
+        dispatch(live);
+        wait_and_merge(live);
+    }
+}
+
+void BackgroundConsolidator::clear_pending() {
+    pending_.clear();
+}
+
+void BackgroundConsolidator::worker_main() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait(lk, [this] { return job_ready_ || stop_; });
+            if (stop_) return;
+            job_ready_ = false;
+        }
+        // 影子与 running_ 在作业期间只由本线程访问
+        before_ = shadow_->learning_state();
+        shadow_->replay_batch(running_.schedule);
+        after_ = shadow_->learning_state();
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            job_done_ = true;
+        }
+        cv_.notify_all();
+    }
+}
+
+} // namespace wuyun
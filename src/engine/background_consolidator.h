@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * BackgroundConsolidator — 后台异步巩固 (awake replay 离开 agent_step 关键路径)
+ *
+ * 同步路径: 每次奖励后 replay_batch 在 agent_step 内跑完全部重放段。
+ * 异步路径:
+ *   1. enqueue(): 重放计划连同其脉冲拷贝进待派发队列 (EpisodeBuffer 的 arena
+ *      之后可被继续复用)
+ *   2. sync() 派发: 拷贝在线 BG 为影子, 常驻工作线程在影子上 replay_batch
+ *   3. 派发后第 lag 次 sync() 为合并点: 等待作业完成, 把影子重放前后的
+ *      学习状态差 (权重 + 巩固分数) 加到在线 BG 上
+ *
+ * 合并点由 agent step 计数决定 (不看线程何时完成), 给定 lag 时结果可复现。
+ * 在线 BG 在作业期间的学习不会被覆盖 (增量合并, 而非整体替换)。
+ */
+
+#include "region/subcortical/basal_ganglia.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wuyun {
+
+class BackgroundConsolidator {
+public:
+    /** @param lag  派发到合并之间的 sync() 次数 (≥ 1) */
+    explicit BackgroundConsolidator(int lag = 1);
+    ~BackgroundConsolidator();
+
+    BackgroundConsolidator(const BackgroundConsolidator&) = delete;
+    BackgroundConsolidator& operator=(const BackgroundConsolidator&) = delete;
+
+    /** 追加一个重放计划到待派发队列 (拷贝脉冲, 不引用调用方存储) */
+    void enqueue(const ReplaySchedule& schedule);
+
+    /** 同步点 (每个 agent step 一次): 到期作业等待并合并; 空闲且有排队时派发 */
+    void sync(BasalGanglia& live);
+
+    /** 等待并合并全部作业 (含排队中的, 就地同步执行) — 睡眠/保存前调用 */
+    void drain(BasalGanglia& live);
+
+    /** 丢弃尚未派发的计划 (世界布局改变, 旧经验作废) */
+    void clear_pending();
+
+    bool     busy()          const { return in_flight_; }
+    size_t   pending_steps() const { return pending_.schedule.steps.size(); }
+    uint64_t jobs_merged()   const { return jobs_merged_; }
+
+private:
+    // 自持有的重放计划: steps 的 ids/types 指向本对象的 ids/types
+    struct OwnedSchedule {
+        std::vector<uint16_t> ids;
+        std::vector<int8_t>   types;
+        std::vector<uint32_t> offsets;   // 每个 step 在 ids 中的起点
+        ReplaySchedule        schedule;
+        void clear() { ids.clear(); types.clear(); offsets.clear(); schedule.clear(); }
+        void bind();                     // 修正 steps 指针 (ids 增长后失效)
+    };
+
+    void dispatch(const BasalGanglia& live);
+    void wait_and_merge(BasalGanglia& live);
+    void worker_main();
+
+    int lag_;
+    OwnedSchedule pending_;
+    OwnedSchedule running_;
+    std::unique_ptr<BasalGanglia> shadow_;
+    BasalGanglia::LearningState before_, after_;
+
+    bool     in_flight_ = false;   // 主线程视角: 已派发未合并
+    int      age_       = 0;       // 派发后经过的 sync() 次数
+    uint64_t jobs_merged_ = 0;
+
+    std::thread             thread_;
+    std::mutex              mu_;
+    std::condition_variable cv_;
+    bool job_ready_ = false;       // 受 mu_ 保护
+    bool job_done_  = false;
+    bool stop_      = false;
+};
+
+} // namespace wuyun
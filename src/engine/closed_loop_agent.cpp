@@ -3,6 +3,7 @@
 #include "region/neuromod/drn_5ht.h"
 #include "region/neuromod/nbm_ach.h"
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <numeric>
 
@@ -26,6 +27,10 @@ ClosedLoopAgent::ClosedLoopAgent(std::unique_ptr<Environment> env, const AgentCo
 
     build_brain();
 
+    if (config_.enable_replay && config_.async_consolidation) {
+        consolidator_ = std::make_unique<BackgroundConsolidator>(config_.async_consolidation_lag);
+    }
+
     // v36: Initialize spatial value map (cognitive map)
     spatial_map_w_ = static_cast<int>(env_->world_width());
     spatial_map_h_ = static_cast<int>(env_->world_height());
@@ -629,6 +634,17 @@ void ClosedLoopAgent::build_brain() {
         if (hipp_) hipp_->enable_homeostatic(hp);
     }
 
+    // --- Structural plasticity: 视觉皮层 STDP 突触长期弱 → 剪除, 睡眠时压缩 ---
+    // (只作用于已启用 STDP 的突触组; fast_eval/无皮层 STDP 时为空操作)
+    if (config_.enable_structural_plasticity) {
+        StructuralParams sp;
+        sp.prune_threshold = config_.structural_prune_threshold;
+        sp.prune_window    = config_.structural_prune_window;
+        if (v1_) v1_->enable_structural_plasticity(sp);
+        if (v2_) v2_->enable_structural_plasticity(sp);
+        if (v4_) v4_->enable_structural_plasticity(sp);
+    }
+
     // --- v27: Enable predictive coding learning on visual hierarchy ---
     // L6 learns to predict L2/3, L4→L2/3 STDP becomes error-gated
     if (config_.enable_predictive_learning && config_.enable_cortical_stdp) {
@@ -679,6 +695,15 @@ void ClosedLoopAgent::build_brain() {
             d1_preferred_dir_[i] = base_angle + jitter_dist(pv_rng);
         }
     }
+
+    // --- 睡眠执行掩码: 巩固只需 海马 → 皮层 → BG 通路, 其余脑区冻结 ---
+    // NREM: SWR 经 Hippocampus→dlPFC/FPC/vmPFC 传到皮层, dlPFC→BG + VTA→BG 完成 BG 巩固
+    // REM:  theta 海马-皮层交互, BG 不参与 (DA 在基线)
+    // 觉醒 = 全脑 (无掩码); awake replay 走 BasalGanglia::replay_batch, 不推进引擎
+    if (config_.sleep_region_masks) {
+        engine_.define_mask("nrem", {"Hippocampus", "dlPFC", "FPC", "vmPFC", "BG", "VTA"});
+        engine_.define_mask("rem",  {"Hippocampus", "dlPFC", "FPC", "vmPFC"});
+    }
 }
 
 // =============================================================================
@@ -706,6 +731,10 @@ void ClosedLoopAgent::reset_world_with_seed(uint32_t seed) {
     if (config_.enable_replay) {
         replay_buffer_.clear();
     }
+    if (consolidator_) {
+        consolidator_->clear_pending();
+        if (bg_) consolidator_->drain(*bg_);  // 已派发的作业照常合并
+    }
     // 清空奖励历史 (重新统计)
     std::fill(reward_history_.begin(), reward_history_.end(), 0.0f);
     std::fill(food_history_.begin(), food_history_.end(), 0);
@@ -727,6 +756,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
     //            M1 L5 accumulates spikes → decode action
     //   Phase C: Act in world → store reward as pending for next step
     // =====================================================================
+    WUYUN_PROF_SCOPE(&engine_.profiler(), "agent.step");
 
     // --- Sleep consolidation: periodic offline replay ---
     // Biology: after sustained waking, NREM sleep replays recent experiences
@@ -736,6 +766,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
     if (config_.enable_sleep_consolidation && config_.wake_steps_before_sleep > 0) {
         ++wake_step_counter_;
         if (wake_step_counter_ >= config_.wake_steps_before_sleep) {
+            WUYUN_PROF_SCOPE(&engine_.profiler(), "agent.sleep");
             run_sleep_consolidation();
             wake_step_counter_ = 0;
         }
@@ -751,6 +782,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
 
     // --- Phase A: Process pending reward (from previous action) ---
     if (has_pending_reward_) {
+        WUYUN_PROF_SCOPE(&engine_.profiler(), "agent.reward");
         inject_reward(pending_reward_);
 
         // Hippocampal reward tagging: encode current location with reward value
@@ -758,6 +790,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
         // (Lisman & Grace 2005: DA gates hippocampal memory formation)
         if (hipp_ && std::abs(pending_reward_) > 0.01f) {
             hipp_->inject_reward_tag(std::abs(pending_reward_));
+            trace_scalar(TraceOp::HIPP_REWARD_TAG, hipp_, std::abs(pending_reward_));
         }
 
         // v36: Update spatial value map (cognitive map)
@@ -771,6 +804,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
         if (amyg_ && pending_reward_ < -0.01f) {
             float us_mag = -pending_reward_ * config_.amyg_us_gain;
             amyg_->inject_us(us_mag);
+            trace_scalar(TraceOp::AMYG_US, amyg_, us_mag);
         }
 
         // v32: LHb NO LONGER receives direct punishment (was double-counting with VTA RPE)
@@ -785,6 +819,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
         if (lhb_ && pending_reward_ < 0.01f && expected_reward_level_ > 0.05f) {
             float frustration = expected_reward_level_ * 0.3f;  // Mild frustration signal
             lhb_->inject_frustration(frustration);
+            trace_scalar(TraceOp::LHB_FRUSTRATION, lhb_, frustration);
         }
 
         // v34: ACh-gated visual STDP — 由 NBM-ACh 神经元驱动
@@ -794,12 +829,15 @@ Environment::Result ClosedLoopAgent::agent_step() {
         if (nbm_) {
             float da_error = std::abs(vta_->da_output() - 0.3f);
             nbm_->inject_surprise(da_error);  // DA偏离→意外→ACh↑
+            trace_scalar(TraceOp::NBM_SURPRISE, nbm_, da_error);
         }
         float ach_boost = nbm_ ? (nbm_->ach_output() / 0.2f)
                                 : (1.0f + std::abs(pending_reward_) * 0.5f);  // fallback
-        if (v1_)  v1_->column().set_ach_stdp_gain(ach_boost);
-        if (v2_)  v2_->column().set_ach_stdp_gain(ach_boost);
-        if (v4_)  v4_->column().set_ach_stdp_gain(ach_boost);
+        for (CorticalRegion* vis : {v1_, v2_, v4_}) {
+            if (!vis) continue;
+            vis->column().set_ach_stdp_gain(ach_boost);
+            trace_scalar(TraceOp::CTX_ACH_STDP_GAIN, vis, ach_boost);
+        }
         // IT intentionally excluded (NO STDP, representation stability)
 
         // v38: ACh → BG consolidation gating (volume transmission)
@@ -809,17 +847,20 @@ Environment::Result ClosedLoopAgent::agent_step() {
         if (bg_) {
             float ach = nbm_ ? nbm_->ach_output() : 0.2f;
             bg_->set_ach_level(ach);
+            trace_scalar(TraceOp::BG_ACH_LEVEL, bg_, ach);
         }
 
         // v40: Feed VTA DA to NAcc (mesolimbic pathway)
         // NAcc processes reward signal for motivation, independent of BG motor selection
         if (nacc_) {
             nacc_->set_da_level(vta_->da_output());
+            trace_scalar(TraceOp::NACC_DA_LEVEL, nacc_, vta_->da_output());
         }
         // v42: Feed VTA DA to OFC (value update signal, volume transmission)
         // DA+ → strengthen positive value associations, DA- → strengthen negative
         if (ofc_) {
             ofc_->set_da_level(vta_->da_output());
+            trace_scalar(TraceOp::OFC_DA_LEVEL, ofc_, vta_->da_output());
         }
 
         // v40: SNc habit maintenance — blend tonic DA with VTA phasic DA
@@ -836,8 +877,9 @@ Environment::Result ClosedLoopAgent::agent_step() {
             // (supplements SpikeBus projection with immediate DA level effect)
             if (lhb_) {
                 vta_->inject_lhb_inhibition(lhb_->vta_inhibition());
+                trace_scalar(TraceOp::VTA_LHB_INHIBITION, vta_, lhb_->vta_inhibition());
             }
-            engine_.step();
+            step_brain();
             // v37: Read DA AFTER engine step (VTA processes reward during step)
             // Previous bug: bg read da BEFORE engine step → missed the DA change
             // on the first reward processing step entirely.
@@ -851,18 +893,25 @@ Environment::Result ClosedLoopAgent::agent_step() {
                 da = da * 0.7f + snc_->da_output() * 0.3f;
             }
             bg_->set_da_level(da);
+            trace_scalar(TraceOp::BG_DA_LEVEL, bg_, da);
         }
         has_pending_reward_ = false;
 
         // Reset ACh STDP boost after reward processing
-        if (v1_)  v1_->column().set_ach_stdp_gain(1.0f);
-        if (v2_)  v2_->column().set_ach_stdp_gain(1.0f);
-        if (v4_)  v4_->column().set_ach_stdp_gain(1.0f);
+        for (CorticalRegion* vis : {v1_, v2_, v4_}) {
+            if (!vis) continue;
+            vis->column().set_ach_stdp_gain(1.0f);
+            trace_scalar(TraceOp::CTX_ACH_STDP_GAIN, vis, 1.0f);
+        }
         // v38: Reset BG ACh to baseline (consolidation fully protected during routine Phase B)
-        if (bg_) bg_->set_ach_level(0.2f);
+        if (bg_) {
+            bg_->set_ach_level(0.2f);
+            trace_scalar(TraceOp::BG_ACH_LEVEL, bg_, 0.2f);
+        }
     }
 
     // --- Phase B: Observe + decide ---
+    WUYUN_PROF_TIMER(observe_timer, &engine_.profiler(), "agent.observe");
 
     // Begin recording episode for awake SWR replay
     if (config_.enable_replay) {
@@ -935,13 +984,16 @@ Environment::Result ClosedLoopAgent::agent_step() {
             }
         }
         acc_->inject_d1_rates(d1_rates);
+        trace_values(TraceOp::ACC_D1_RATES, acc_, d1_rates.data(), d1_rates.size());
 
         // 注入上一步的奖励结果 (PRO模型: 预测vs实际)
         acc_->inject_outcome(last_reward_);
+        trace_scalar(TraceOp::ACC_OUTCOME, acc_, last_reward_);
 
         // 注入威胁信号 (Amygdala CeA → vACC)
         if (amyg_) {
             acc_->inject_threat(amyg_->cea_vta_drive());
+            trace_scalar(TraceOp::ACC_THREAT, acc_, amyg_->cea_vta_drive());
         }
     }
 
@@ -959,6 +1011,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
             arousal = std::max(0.0f, 0.05f - fr * 0.1f);
         }
         lc_->inject_arousal(arousal);
+        trace_scalar(TraceOp::LC_AROUSAL, lc_, arousal);
     }
 
     // v35b: ACC→dlPFC 注意力增益 (冲突/惊讶 → dlPFC更专注)
@@ -967,10 +1020,12 @@ Environment::Result ClosedLoopAgent::agent_step() {
     if (acc_ && dlpfc_) {
         float att_gain = 1.0f + acc_->attention_signal() * 0.5f;  // [1.0, 1.5]
         dlpfc_->set_attention_gain(att_gain);
+        trace_scalar(TraceOp::CTX_ATTENTION_GAIN, dlpfc_, att_gain);
     }
     // v34: DRN-5HT wellbeing 注入 (持续获得食物→5-HT↑→更耐心)
     if (drn_) {
         drn_->inject_wellbeing(food_rate(200));
+        trace_scalar(TraceOp::DRN_WELLBEING, drn_, food_rate(200));
     }
 
     float noise_scale = 1.0f;
@@ -1033,8 +1088,11 @@ Environment::Result ClosedLoopAgent::agent_step() {
     float attractor_drive = effective_noise * config_.attractor_drive_ratio;
     float attractor_jitter = effective_noise * (1.0f - config_.attractor_drive_ratio);
     float background_drive = effective_noise * config_.background_drive_ratio;
+    WUYUN_PROF_STOP(observe_timer);
 
+    WUYUN_PROF_TIMER(loop_timer, &engine_.profiler(), "agent.brain_loop");
     for (size_t i = 0; i < config_.brain_steps_per_action; ++i) {
+        WUYUN_PROF_TIMER(reflex_timer, &engine_.profiler(), "agent.reflex");
         // Inject observation EVERY brain step to provide sustained drive to LGN.
         // Thalamic relay neurons (tau_m=20, threshold=-50, rest=-65) need ~7 steps
         // of sustained I=45 current to charge from rest to threshold.
@@ -1047,6 +1105,12 @@ Environment::Result ClosedLoopAgent::agent_step() {
             hipp_->inject_spatial_context(
                 static_cast<int>(env_->pos_x()), static_cast<int>(env_->pos_y()),
                 spatial_map_w_, spatial_map_h_);
+            if (trace_) {
+                float ctx[4] = {static_cast<float>(static_cast<int>(env_->pos_x())),
+                                static_cast<float>(static_cast<int>(env_->pos_y())),
+                                static_cast<float>(spatial_map_w_), static_cast<float>(spatial_map_h_)};
+                trace_values(TraceOp::HIPP_SPATIAL_CONTEXT, hipp_, ctx, 4);
+            }
         }
 
         // v36: CLS — spatial value gradient → BG sensory context
@@ -1065,11 +1129,13 @@ Environment::Result ClosedLoopAgent::agent_step() {
             if (ax > 0)     adj[2] = spatial_value_map_[ay * w + (ax - 1)];  // LEFT
             if (ax < w - 1) adj[3] = spatial_value_map_[ay * w + (ax + 1)];  // RIGHT
             bg_->inject_sensory_context(adj);
+            trace_values(TraceOp::BG_SENSORY_CONTEXT, bg_, adj, 4);
         }
 
         // LHb → VTA inhibition broadcast (every brain step during action processing)
         if (lhb_) {
             vta_->inject_lhb_inhibition(lhb_->vta_inhibition());
+            trace_scalar(TraceOp::VTA_LHB_INHIBITION, vta_, lhb_->vta_inhibition());
         }
         // v41 anti-cheat: PAG defense is fully spike-driven.
         // CeA→PAG and PAG→M1/LC all via SpikeBus projections.
@@ -1082,6 +1148,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
             float cea_drive = amyg_->cea_vta_drive();
             if (cea_drive > 0.01f) {
                 vta_->inject_lhb_inhibition(cea_drive);  // CeA → VTA DA轻微抑制
+                trace_scalar(TraceOp::VTA_LHB_INHIBITION, vta_, cea_drive);
             }
             // v33: 主动消退 — 安全步骤时PFC驱动ITC抑制CeA
             // 生物学: mPFC在安全环境中持续激活ITC(闰细胞)，
@@ -1091,6 +1158,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
             if (!has_pending_reward_ || pending_reward_ > -0.01f) {
                 std::vector<float> itc_drive(amyg_->itc().size(), 5.0f);
                 amyg_->inject_pfc_to_itc(itc_drive);
+                trace_values(TraceOp::AMYG_PFC_ITC, amyg_, itc_drive.data(), itc_drive.size());
             }
         }
         // v30: Cerebellum climbing fiber injection (every brain step)
@@ -1099,6 +1167,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
         if (cb_ && std::abs(last_reward_) > 0.05f) {
             float cf_error = std::min(1.0f, std::abs(last_reward_));
             cb_->inject_climbing_fiber(cf_error);
+            trace_scalar(TraceOp::CB_CLIMBING_FIBER, cb_, cf_error);
         }
 
         // DA neuromodulatory broadcast: VTA → BG (volume transmission, every step)
@@ -1126,6 +1195,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
                 da = std::clamp(da, 0.0f, 1.0f);
             }
             bg_->set_da_level(da);
+            trace_scalar(TraceOp::BG_DA_LEVEL, bg_, da);
         }
 
         // Hippocampal spatial memory → dlPFC: handled via SpikeBus projection
@@ -1145,10 +1215,17 @@ Environment::Result ClosedLoopAgent::agent_step() {
         auto& l5 = m1_->column().l5();
         if (sc_ && config_.sc_approach_gain > 0.01f) {
             // 注入视觉 patch → SC 计算显著性方向
-            auto obs = env_->observe();
+            const auto& obs = observe_env();
             sc_->inject_visual_patch(obs, static_cast<int>(config_.vision_width),
                                      static_cast<int>(config_.vision_height),
                                      config_.sc_approach_gain);
+            if (trace_) {
+                std::vector<float> rec(obs);
+                rec.push_back(static_cast<float>(config_.vision_width));
+                rec.push_back(static_cast<float>(config_.vision_height));
+                rec.push_back(config_.sc_approach_gain);
+                trace_values(TraceOp::SC_VISUAL_PATCH, sc_, rec.data(), rec.size());
+            }
 
             // SC 深层群体向量 → M1 cos 驱动
             const auto& sc_deep_fired = sc_->deep().fired();
@@ -1196,7 +1273,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
         //     M1 注入反方向 cos 驱动 = "看到墙就转向"
         //     生物学: 触须/视动反射 — 不需要学习, 硬连线回避 (Goodale 2011)
         if (config_.wall_avoid_gain > 0.01f && i == 0) {
-            auto obs = env_->observe();
+            const auto& obs = observe_env();
             int vw = static_cast<int>(config_.vision_width);
             int vh = static_cast<int>(config_.vision_height);
             int cx = vw / 2, cy = vh / 2;
@@ -1271,8 +1348,11 @@ Environment::Result ClosedLoopAgent::agent_step() {
                 }
             }
         }
+        WUYUN_PROF_STOP(reflex_timer);
 
-        engine_.step();
+        // 反射/探索/BG 偏置在 L5 上的合计电流 (本步之前 L5 只有这些输入)
+        trace_values(TraceOp::CTX_L5_BASAL, m1_, l5.i_basal().data(), l5_size);
+        step_brain();
 
         // Capture dlPFC spike pattern for awake SWR replay buffer
         if (config_.enable_replay) {
@@ -1291,16 +1371,23 @@ Environment::Result ClosedLoopAgent::agent_step() {
         // v29: i>=10: evolved brain_steps=17, pipeline ~10 steps
         if (i >= 10 && attractor_group >= 0) {
             bg_->mark_motor_efference(attractor_group);
+            trace_scalar(TraceOp::BG_MOTOR_EFFERENCE, bg_, static_cast<float>(attractor_group));
         }
     }
 
+    WUYUN_PROF_STOP(loop_timer);
+
     // B3. Decode action from M1 L5 (biological: M1 is the motor output)
     // v55: continuous movement is the ONLY mode — no discrete 4-direction path
+    WUYUN_PROF_TIMER(decode_timer, &engine_.profiler(), "agent.decode");
     auto [dx, dy] = decode_m1_continuous(l5_accum);
     Action action = decode_m1_action(l5_accum);  // nearest cardinal for efference copy/replay
+    WUYUN_PROF_STOP(decode_timer);
 
     // --- Phase C: Act in environment ---
+    WUYUN_PROF_TIMER(act_timer, &engine_.profiler(), "agent.act");
     Environment::Result result = env_->step(dx, dy);
+    WUYUN_PROF_STOP(act_timer);
 
     // Store reward as pending (will be processed at START of next agent_step)
     // Only trigger Phase A for significant rewards (food/danger), not step penalties
@@ -1328,6 +1415,7 @@ Environment::Result ClosedLoopAgent::agent_step() {
     }
 
     // End episode recording and trigger awake SWR replay for significant rewards
+    WUYUN_PROF_TIMER(replay_timer, &engine_.profiler(), "agent.replay");
     if (config_.enable_replay) {
         replay_buffer_.end_episode(result.reward, static_cast<int>(action));
         // Positive replay: food found → replay old successes (consolidate Go)
@@ -1355,6 +1443,10 @@ Environment::Result ClosedLoopAgent::agent_step() {
         }
     }
 
+    // Async replay sync point: merge the due background job, dispatch queued replay
+    if (consolidator_ && bg_) consolidator_->sync(*bg_);
+    WUYUN_PROF_STOP(replay_timer);
+
     // Update state
     last_action_ = action;
     last_reward_ = result.reward;
@@ -1373,6 +1465,8 @@ Environment::Result ClosedLoopAgent::agent_step() {
         steps_since_reward_++;
     }
 
+    if (engine_.telemetry()) update_telemetry(result.reward);
+
     // Callback
     if (callback_) {
         callback_(agent_step_count_, action, result.reward,
@@ -1388,13 +1482,50 @@ void ClosedLoopAgent::run(int n_steps) {
     }
 }
 
+void ClosedLoopAgent::update_telemetry(float reward) {
+    TelemetryWriter* w = engine_.telemetry();
+    TelemetryFrame& f = w->staging();
+
+    // 上一帧已发布 → 新窗口: 清奖励累计, 刷新 BG 快照 (权重范数每帧只算一次)
+    if (w->published() != telemetry_seen_) {
+        telemetry_seen_ = w->published();
+        telemetry_reward_sum_ = 0.0;
+        telemetry_reward_n_ = 0;
+        if (bg_) {
+            double d1 = 0.0, d2 = 0.0;
+            for (size_t s = 0; s < bg_->d1_weight_count(); ++s) {
+                for (float x : bg_->d1_weights_for(s)) d1 += static_cast<double>(x) * x;
+            }
+            for (size_t s = 0; s < bg_->d2_weight_count(); ++s) {
+                for (float x : bg_->d2_weights_for(s)) d2 += static_cast<double>(x) * x;
+            }
+            f.bg_da = bg_->da_level();
+            f.bg_w_d1_norm = static_cast<float>(std::sqrt(d1));
+            f.bg_w_d2_norm = static_cast<float>(std::sqrt(d2));
+        }
+    }
+
+    telemetry_reward_sum_ += reward;
+    telemetry_reward_n_ += 1;
+    f.reward_rate = static_cast<float>(telemetry_reward_sum_ / telemetry_reward_n_);
+    f.last_reward = reward;
+    f.agent_steps = agent_step_count_;
+}
+
 // =============================================================================
 // Perception: observe → encode → inject LGN
 // =============================================================================
 
 void ClosedLoopAgent::inject_observation() {
-    auto obs = env_->observe();  // NxN patch from environment
-    visual_encoder_.encode_and_inject(obs, lgn_);
+    const auto& obs = observe_env();  // NxN patch from environment
+    if (!trace_) {
+        visual_encoder_.encode_and_inject(obs, lgn_);
+        return;
+    }
+    if (!lgn_) return;
+    auto currents = visual_encoder_.encode(obs);
+    trace_values(TraceOp::EXTERNAL, lgn_, currents.data(), currents.size());
+    lgn_->inject_external(currents);
 }
 // =============================================================================
 // Action decoding: M1 L5 population vector → direction (Georgopoulos 1986)
@@ -1494,6 +1625,7 @@ std::pair<float, float> ClosedLoopAgent::decode_m1_continuous(
 void ClosedLoopAgent::inject_reward(float reward) {
     if (hypo_ && std::abs(reward) > 0.001f) {
         hypo_->inject_hedonic(reward);
+        trace_scalar(TraceOp::HYPO_HEDONIC, hypo_, reward);
     }
 }
 
@@ -1532,44 +1664,18 @@ float ClosedLoopAgent::food_rate(size_t window) const {
 void ClosedLoopAgent::capture_dlpfc_spikes(int action_group) {
     if (!dlpfc_ || !bg_) return;
 
-    // Capture dlPFC fired neurons as SpikeEvents (for BG replay)
-    const auto& fired = dlpfc_->fired();
-    const auto& stypes = dlpfc_->spike_type();
-    uint32_t rid = dlpfc_->region_id();
-
-    std::vector<SpikeEvent> cortical_events;
-    for (size_t i = 0; i < fired.size(); ++i) {
-        if (fired[i]) {
-            SpikeEvent evt;
-            evt.region_id  = rid;
-            evt.neuron_id  = static_cast<uint32_t>(i);
-            evt.spike_type = stypes[i];
-            evt.timestamp  = 0;
-            cortical_events.push_back(evt);
-        }
-    }
-
+    // Capture dlPFC fired neurons (for BG replay), packed straight into the arena
     // Also capture V1 fired neurons (for cortical consolidation)
     // Biology: SWR replay reactivates both sensory (V1) and association (dlPFC)
     // cortex representations, strengthening V1→dlPFC feature pathways
-    std::vector<SpikeEvent> sensory_events;
     if (v1_) {
-        const auto& v1_fired = v1_->fired();
-        const auto& v1_stypes = v1_->spike_type();
-        uint32_t v1_rid = v1_->region_id();
-        for (size_t i = 0; i < v1_fired.size(); ++i) {
-            if (v1_fired[i]) {
-                SpikeEvent evt;
-                evt.region_id  = v1_rid;
-                evt.neuron_id  = static_cast<uint32_t>(i);
-                evt.spike_type = v1_stypes[i];
-                evt.timestamp  = 0;
-                sensory_events.push_back(evt);
-            }
-        }
+        replay_buffer_.record_step(dlpfc_->region_id(), dlpfc_->fired(), dlpfc_->spike_type(),
+                                   action_group,
+                                   v1_->region_id(), &v1_->fired(), &v1_->spike_type());
+    } else {
+        replay_buffer_.record_step(dlpfc_->region_id(), dlpfc_->fired(), dlpfc_->spike_type(),
+                                   action_group);
     }
-
-    replay_buffer_.record_step(cortical_events, action_group, sensory_events);
 }
 
 void ClosedLoopAgent::run_negative_replay(float reward) {
@@ -1596,15 +1702,12 @@ void ClosedLoopAgent::run_negative_replay(float reward) {
     auto recent = replay_buffer_.recent(std::min(replay_buffer_.size(), (size_t)10));
     std::vector<const Episode*> replay_candidates;
     for (size_t i = 1; i < recent.size(); ++i) {  // Skip index 0 = current
-        if (recent[i]->reward < -0.05f && !recent[i]->steps.empty()) {
-            replay_candidates.push_back(recent[i]);
+        if (recent[i].reward < -0.05f && !recent[i].empty()) {
+            replay_candidates.push_back(&recent[i]);
         }
     }
     if (replay_candidates.empty()) return;
 
-    // Save current BG state
-    float saved_da = bg_->da_level();
-
     // Replay DA: below baseline (LHb-mediated DA pause)
     // Biology: LHb activation during replay drives VTA DA below tonic level
     //   da_replay = baseline - |reward| × scale = 0.3 - 1.0×0.3 = 0.0
@@ -1613,38 +1716,34 @@ void ClosedLoopAgent::run_negative_replay(float reward) {
     float da_dip = std::abs(reward) * config_.negative_replay_da_scale;
     float da_replay_level = std::clamp(da_baseline - da_dip, 0.05f, 0.25f);
 
-    // Enter replay mode (suppresses weight decay)
-    bg_->set_replay_mode(true);
-
-    // Replay each candidate episode once
+    // Replay each candidate episode once (replay mode suppresses weight decay;
+    // replay_batch restores BG DA level and mode afterwards)
+    // Cortical spikes → BG DA-STDP with low DA
+    // D2: Δw = -lr × (da_replay - baseline) × elig
+    //     = -lr × (-0.15) × elig = +0.0045 × elig (D2 strengthened)
+    // D1: Δw = +lr × (-0.15) × elig = -0.0045 × elig (D1 weakened)
+    replay_schedule_.clear();
     size_t n_replay = std::min(replay_candidates.size(), (size_t)config_.negative_replay_passes);
     for (size_t ep_idx = 0; ep_idx < n_replay; ++ep_idx) {
-        const Episode& ep = *replay_candidates[ep_idx];
-
-        bg_->set_da_level(da_replay_level);
+        append_replay_segment(*replay_candidates[ep_idx], da_replay_level);
+    }
+    submit_replay();
+}
 
-        // Replay later brain steps (i>=8) where visual context is established
-        size_t start_step = (ep.steps.size() > 8) ? 8 : 0;
-        for (size_t i = start_step; i < ep.steps.size(); ++i) {
-            const SpikeSnapshot& snap = ep.steps[i];
+void ClosedLoopAgent::submit_replay() {
+    if (consolidator_) consolidator_->enqueue(replay_schedule_);
+    else bg_->replay_batch(replay_schedule_);
+}
 
-            // Inject cortical spikes → BG DA-STDP with low DA
-            // D2: Δw = -lr × (da_replay - baseline) × elig
-            //     = -lr × (-0.15) × elig = +0.0045 × elig (D2 strengthened)
-            // D1: Δw = +lr × (-0.15) × elig = -0.0045 × elig (D1 weakened)
-            if (!snap.cortical_events.empty()) {
-                bg_->receive_spikes(snap.cortical_events);
-            }
-            if (snap.action_group >= 0) {
-                bg_->mark_motor_efference(snap.action_group);
-            }
-            bg_->replay_learning_step(0, 1.0f);
-        }
+void ClosedLoopAgent::append_replay_segment(const Episode& ep, float da_level) {
+    replay_schedule_.begin_segment(da_level);
+    // Replay later brain steps (i>=8) where visual context is established
+    size_t start_step = (ep.size() > 8) ? 8 : 0;
+    for (size_t i = start_step; i < ep.size(); ++i) {
+        SpikeSnapshot snap = ep.step(i);
+        replay_schedule_.add_step({snap.cortical_region, snap.cortical_ids, snap.cortical_types,
+                                   snap.n_cortical, snap.action_group});
     }
-
-    // Exit replay mode and restore DA level
-    bg_->set_replay_mode(false);
-    bg_->set_da_level(saved_da);
 }
 
 void ClosedLoopAgent::run_awake_replay(float reward) {
@@ -1669,17 +1768,15 @@ void ClosedLoopAgent::run_awake_replay(float reward) {
     // Collect positive AND negative candidates (skip index 0 = current)
     std::vector<const Episode*> pos_candidates, neg_candidates;
     for (size_t i = 1; i < recent.size(); ++i) {
-        if (recent[i]->steps.empty()) continue;
-        if (recent[i]->reward > 0.05f)
-            pos_candidates.push_back(recent[i]);
-        else if (recent[i]->reward < -0.05f)
-            neg_candidates.push_back(recent[i]);
+        if (recent[i].empty()) continue;
+        if (recent[i].reward > 0.05f)
+            pos_candidates.push_back(&recent[i]);
+        else if (recent[i].reward < -0.05f)
+            neg_candidates.push_back(&recent[i]);
     }
     if (pos_candidates.empty() && neg_candidates.empty()) return;
 
-    float saved_da = bg_->da_level();
     float da_baseline = 0.3f;
-    bg_->set_replay_mode(true);
 
     // Build interleaved replay schedule: alternate positive and negative
     // Positive episodes get more passes (they're the trigger context)
@@ -1707,26 +1804,12 @@ void ClosedLoopAgent::run_awake_replay(float reward) {
         }
     }
 
-    // Execute interleaved replay schedule
+    // Execute interleaved replay schedule (one batched BG call)
+    replay_schedule_.clear();
     for (const auto& [ep, da_level] : schedule) {
-        bg_->set_da_level(da_level);
-
-        size_t start_step = (ep->steps.size() > 8) ? 8 : 0;
-        for (size_t i = start_step; i < ep->steps.size(); ++i) {
-            const SpikeSnapshot& snap = ep->steps[i];
-
-            if (!snap.cortical_events.empty()) {
-                bg_->receive_spikes(snap.cortical_events);
-            }
-            if (snap.action_group >= 0) {
-                bg_->mark_motor_efference(snap.action_group);
-            }
-            bg_->replay_learning_step(0, 1.0f);
-        }
+        append_replay_segment(*ep, da_level);
     }
-
-    bg_->set_replay_mode(false);
-    bg_->set_da_level(saved_da);
+    submit_replay();
 }
 
 // =============================================================================
@@ -1750,13 +1833,20 @@ void ClosedLoopAgent::run_sleep_consolidation() {
 
     if (!bg_ || !vta_) return;
 
+    // Sleep steps the whole engine: finish outstanding background replay first
+    if (consolidator_) consolidator_->drain(*bg_);
+
     // --- Enter sleep ---
     sleep_mgr_.enter_sleep();
-    if (hipp_) hipp_->enable_sleep_replay();
+    if (hipp_) {
+        hipp_->enable_sleep_replay();
+        trace_scalar(TraceOp::HIPP_SLEEP_REPLAY, hipp_, 1.0f);
+    }
 
     // DA at baseline during NREM (no new BG learning)
     float saved_da = bg_->da_level();
     bg_->set_da_level(config_.sleep_positive_da);  // = 0.30 (baseline)
+    trace_scalar(TraceOp::BG_DA_LEVEL, bg_, config_.sleep_positive_da);
 
     // --- NREM consolidation: hippocampus SWR + systems consolidation ---
     // v36: CLS systems consolidation (McClelland 1995, Kumaran 2016)
@@ -1772,8 +1862,15 @@ void ClosedLoopAgent::run_sleep_consolidation() {
     size_t total_nrem = config_.sleep_nrem_steps;
 
     for (size_t i = 0; i < total_nrem; ++i) {
-        // Step the ENTIRE brain (hippocampus SWR → SpikeBus → cortex)
-        engine_.step();
+        // Step the consolidation pathway (hippocampus SWR → SpikeBus → cortex → BG);
+        // whole brain when sleep_region_masks is off
+        if (config_.sleep_region_masks) {
+            const char* mask = sleep_mgr_.is_rem() ? "rem" : "nrem";
+            if (trace_ && engine_.active_mask() != mask)
+                trace_->text(TraceOp::ENGINE_MASK, InputTrace::ENGINE, mask);
+            engine_.use_mask(mask);
+        }
+        step_brain();
         sleep_mgr_.step();
 
         // v36: Systems consolidation — spatial value map → BG during SWR
@@ -1802,20 +1899,36 @@ void ClosedLoopAgent::run_sleep_consolidation() {
                 if (best_x > 0)     adj[2] = spatial_value_map_[best_y*w + (best_x-1)];
                 if (best_x < w - 1) adj[3] = spatial_value_map_[best_y*w + (best_x+1)];
                 bg_->inject_sensory_context(adj);
+                trace_values(TraceOp::BG_SENSORY_CONTEXT, bg_, adj, 4);
 
                 // SWR-triggered DA burst (Gomperts 2015)
                 float swr_da = config_.sleep_positive_da + 0.15f;
                 bg_->set_da_level(std::min(swr_da, 0.6f));
+                trace_scalar(TraceOp::BG_DA_LEVEL, bg_, std::min(swr_da, 0.6f));
             }
         } else {
             bg_->set_da_level(config_.sleep_positive_da);
+            trace_scalar(TraceOp::BG_DA_LEVEL, bg_, config_.sleep_positive_da);
         }
     }
 
     // --- Wake up ---
+    if (trace_ && !engine_.active_mask().empty())
+        trace_->text(TraceOp::ENGINE_MASK, InputTrace::ENGINE, "");
+    engine_.clear_mask();
     sleep_mgr_.wake_up();
-    if (hipp_) hipp_->disable_sleep_replay();
+    if (hipp_) {
+        hipp_->disable_sleep_replay();
+        trace_scalar(TraceOp::HIPP_SLEEP_REPLAY, hipp_, 0.0f);
+    }
     bg_->set_da_level(saved_da);
+    trace_scalar(TraceOp::BG_DA_LEVEL, bg_, saved_da);
+
+    // Structural plasticity: 睡眠期间 (离线) 移出已剪除突触 — 突触稳态假说 (Tononi 2014)
+    if (config_.enable_structural_plasticity) {
+        engine_.compact_synapses();
+        if (trace_) trace_->values(TraceOp::ENGINE_COMPACT, InputTrace::ENGINE, nullptr, 0);
+    }
 }
 
 void ClosedLoopAgent::update_spatial_value_map(float reward) {
@@ -24,6 +24,8 @@
 #include "engine/simulation_engine.h"
 #include "engine/sensory_input.h"
 #include "engine/episode_buffer.h"
+#include "engine/background_consolidator.h"
+#include "engine/input_trace.h"
 #include "region/cortical_region.h"
 #include "region/subcortical/basal_ganglia.h"
 #include "region/subcortical/thalamic_relay.h"
@@ -83,6 +85,10 @@ struct AgentConfig {
     float cortical_stdp_a_plus  = 0.0015f; // v47: Baldwin 0.001→0.0015
     float cortical_stdp_a_minus = -0.013f; // v47: Baldwin -0.010→-0.013
     float cortical_stdp_w_max   = 1.42f;   // v47: Baldwin 0.81→1.42
+    // 结构可塑性: 皮层 STDP 突触持续低于阈值 → 剪除, 睡眠巩固结束时压缩 CSR
+    bool     enable_structural_plasticity = false;
+    float    structural_prune_threshold   = 0.02f;
+    uint32_t structural_prune_window      = 2000;
 
     float lgn_gain           = 234.0f;  // v47: Baldwin 394→234 (Hypo added signal, less LGN needed)
     float lgn_baseline       = 17.3f;   // v47: Baldwin 16→17.3
@@ -128,6 +134,11 @@ struct AgentConfig {
     float replay_da_scale    = 0.61f;   // v47: Baldwin 0.31→0.61 (stronger replay DA for spike RPE)
     size_t replay_buffer_size = 50;    // Max episodes in buffer (v21: 30→50, 10×10 has 100 positions)
     bool  enable_interleaved_replay = true;  // v33: mix positive+negative episodes during replay
+    // Async replay: awake/negative replay runs on a background worker against a shadow
+    // BG; weight/consolidation deltas merge into the live BG async_consolidation_lag
+    // agent steps later (deterministic sync point). Off = replay inside agent_step.
+    bool  async_consolidation     = false;
+    int   async_consolidation_lag = 1;
 
     // Negative experience replay (LHb-controlled avoidance learning)
     // Previously disabled: D2 over-strengthening without LHb control.
@@ -150,6 +161,9 @@ struct AgentConfig {
     size_t sleep_nrem_steps           = 15;    // v21: very light consolidation per bout
     int    sleep_replay_passes        = 1;     // Single pass (prevent over-consolidation)
     float  sleep_positive_da          = 0.30f; // v31: =baseline (NREM DA is LOW, no new learning)
+    // 睡眠期执行掩码: NREM 只推进 海马→皮层→BG (+VTA), REM 只推进 海马-皮层;
+    // 视觉通路/M1/SC/PAG/杏仁核等在睡眠中冻结 (不计算). Off = 睡眠推进全脑
+    bool   sleep_region_masks         = true;
 
     // v34: 神经调质系统接入 (LC-NE, NBM-ACh, DRN-5HT)
     // 替换手工计算的探索噪声和ACh boost，用真实神经元动态驱动
@@ -303,6 +317,22 @@ public:
     /** 设置每步回调 */
     void set_callback(AgentStepCallback cb) { callback_ = std::move(cb); }
 
+    /**
+     * 启用实时遥测 (见 core/telemetry.h): 大脑每 every 步发布一帧, 除引擎字段外
+     * 附带本窗口奖励率、最近奖励、智能体步数, 以及 BG DA 与 D1/D2 权重 L2 范数
+     * (每帧刷新一次, 反映窗口开始时的状态)。外部监控用它代替 set_callback 打印
+     */
+    bool enable_telemetry(const std::string& name, int32_t every = 1000, size_t capacity = 1024) {
+        telemetry_seen_ = UINT64_MAX;
+        return engine_.enable_telemetry(name, every, capacity);
+    }
+
+    /**
+     * 录制对大脑的全部外部注入与步边界 (见 engine/input_trace.h); nullptr 停止录制
+     * 调用方持有 trace, 先 trace.begin(brain()) 再设置
+     */
+    void set_input_trace(InputTrace* trace) { trace_ = trace; }
+
     // --- 访问器 ---
     Environment&       env()    { return *env_; }
     const Environment& env() const { return *env_; }
@@ -348,6 +378,7 @@ private:
     std::unique_ptr<Environment> env_;
     SimulationEngine engine_;
     VisualInput visual_encoder_;
+    std::vector<float> obs_buf_;   // 观测缓冲 (observe_env 复用, 无每步分配)
 
     // Cached region pointers
     BrainRegion*    lgn_   = nullptr;
@@ -397,12 +428,38 @@ private:
 
     AgentStepCallback callback_;
     std::mt19937 motor_rng_{12345};
+    InputTrace* trace_ = nullptr;
+
+    // 遥测: 自上一帧发布以来的奖励累计
+    uint64_t telemetry_seen_ = UINT64_MAX;
+    double   telemetry_reward_sum_ = 0.0;
+    int      telemetry_reward_n_ = 0;
+    void update_telemetry(float reward);
+
+    // 输入录制: trace_ 为空时只有一次分支
+    void trace_scalar(TraceOp op, const BrainRegion* r, float v) {
+        if (trace_) trace_->scalar(op, r->region_id(), v);
+    }
+    void trace_values(TraceOp op, const BrainRegion* r, const float* v, size_t n) {
+        if (trace_) trace_->values(op, r->region_id(), v, n);
+    }
+    /** engine_.step() + 录制步边界 */
+    void step_brain() {
+        if (trace_) trace_->step();
+        engine_.step();
+    }
 
     void build_brain();
     Action decode_m1_action(const std::vector<int>& l5_accum) const;
     // v55: Continuous decode — returns (dx, dy) displacement from population vector
     std::pair<float, float> decode_m1_continuous(const std::vector<int>& l5_accum) const;
     void inject_observation();
+    /** 当前观测写入 obs_buf_ (Environment::observe_into) */
+    const std::vector<float>& observe_env() {
+        obs_buf_.resize(env_->vis_width() * env_->vis_height());
+        env_->observe_into(obs_buf_.data());
+        return obs_buf_;
+    }
     void inject_reward(float reward);
 
     // --- Frustration tracking (expected reward not received) ---
@@ -438,8 +495,12 @@ private:
 
     // --- Awake SWR replay ---
     EpisodeBuffer replay_buffer_;
+    ReplaySchedule replay_schedule_;  // 批量重放计划 (复用容量)
+    std::unique_ptr<BackgroundConsolidator> consolidator_;  // async_consolidation 时非空
+    void submit_replay();
     void run_awake_replay(float reward);
     void run_negative_replay(float reward);
+    void append_replay_segment(const Episode& ep, float da_level);
     void capture_dlpfc_spikes(int action_group);
 
     // --- Sleep consolidation ---
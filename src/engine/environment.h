@@ -9,7 +9,8 @@
  *
  * 设计原则:
  *   - 只暴露大脑需要的信息, 不暴露环境内部结构
- *   - observe() 返回通用 float 向量 (视觉/任何 2D 传感器)
+ *   - observe() 返回通用 float 向量 (视觉/任何 2D 传感器);
+ *     热路径用 observe_into() 写入调用方缓冲 (无分配), 批量见 VecEnv
  *   - 空间信息独立于视觉 (海马不需要知道"格子")
  *   - 统计用 positive/negative 而非 food/danger (语义无关)
  *
@@ -19,7 +20,9 @@
  */
 
 #include <vector>
+#include <algorithm>
 #include <cstdint>
+#include <cstddef>
 
 namespace wuyun {
 
@@ -34,6 +37,11 @@ public:
     // --- Sensory ---
     /** 获取当前观测 (视觉 patch, row-major float[vis_width * vis_height]) */
     virtual std::vector<float> observe() const = 0;
+    /** 无分配观测: 写入 out[0 .. vis_width*vis_height) (默认经 observe() 复制, 具体环境覆盖) */
+    virtual void observe_into(float* out) const {
+        auto obs = observe();
+        std::copy(obs.begin(), obs.end(), out);
+    }
     virtual size_t vis_width() const = 0;
     virtual size_t vis_height() const = 0;
 
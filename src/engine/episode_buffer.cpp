@@ -0,0 +1,148 @@
+#include "engine/episode_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace wuyun {
+
+// =============================================================================
+// 视图
+// =============================================================================
+
+static void expand(uint32_t region, const uint16_t* ids, const int8_t* types, uint32_t n,
+                   std::vector<SpikeEvent>& out) {
+    out.resize(n);
+    for (uint32_t k = 0; k < n; ++k) {
+        SpikeEvent& evt = out[k];
+        evt.region_id  = region;
+        evt.dst_region = 0;
+        evt.neuron_id  = ids[k];
+        evt.spike_type = types[k];
+        evt.timestamp  = 0;
+    }
+}
+
+void SpikeSnapshot::cortical_events(std::vector<SpikeEvent>& out) const {
+    expand(cortical_region, cortical_ids, cortical_types, n_cortical, out);
+}
+
+void SpikeSnapshot::sensory_events(std::vector<SpikeEvent>& out) const {
+    expand(sensory_region, sensory_ids, sensory_types, n_sensory, out);
+}
+
+SpikeSnapshot Episode::step(size_t i) const {
+    const EpisodeSlot::Step& st = slot_->steps[i];
+    SpikeSnapshot snap;
+    snap.cortical_region = st.cortical_region;
+    snap.cortical_ids    = slot_->ids.data()   + st.cortical_off;
+    snap.cortical_types  = slot_->types.data() + st.cortical_off;
+    snap.n_cortical      = st.n_cortical;
+    snap.sensory_region  = st.sensory_region;
+    snap.sensory_ids     = slot_->ids.data()   + st.sensory_off;
+    snap.sensory_types   = slot_->types.data() + st.sensory_off;
+    snap.n_sensory       = st.n_sensory;
+    snap.action_group    = st.action_group;
+    return snap;
+}
+
+// =============================================================================
+// EpisodeBuffer
+// =============================================================================
+
+EpisodeBuffer::EpisodeBuffer(size_t max_episodes, size_t brain_steps)
+    : max_episodes_(max_episodes)
+    , brain_steps_(brain_steps)
+    , slots_(max_episodes + 1)
+{
+    for (auto& slot : slots_) slot.steps.reserve(brain_steps_);
+}
+
+void EpisodeBuffer::begin_episode() {
+    EpisodeSlot& slot = slots_[head_];
+    slot.ids.clear();
+    slot.types.clear();
+    slot.steps.clear();
+    slot.reward = 0.0f;
+    slot.action = -1;
+}
+
+uint32_t EpisodeBuffer::pack(EpisodeSlot& slot, const std::vector<uint8_t>& fired,
+                             const std::vector<int8_t>& types) {
+    uint32_t n = 0;
+    for (size_t i = 0; i < fired.size(); ++i) {
+        if (!fired[i]) continue;
+        if (i > 0xFFFFu) { ++dropped_events_; continue; }
+        slot.ids.push_back(static_cast<uint16_t>(i));
+        slot.types.push_back(types[i]);
+        ++n;
+    }
+    return n;
+}
+
+void EpisodeBuffer::record_step(uint32_t cortical_region,
+                                const std::vector<uint8_t>& cortical_fired,
+                                const std::vector<int8_t>&  cortical_types,
+                                int action_group,
+                                uint32_t sensory_region,
+                                const std::vector<uint8_t>* sensory_fired,
+                                const std::vector<int8_t>*  sensory_types) {
+    EpisodeSlot& slot = slots_[head_];
+    EpisodeSlot::Step st{};
+    st.cortical_region = cortical_region;
+    st.cortical_off    = static_cast<uint32_t>(slot.ids.size());
+    st.n_cortical      = pack(slot, cortical_fired, cortical_types);
+    st.sensory_region  = sensory_region;
+    st.sensory_off     = static_cast<uint32_t>(slot.ids.size());
+    st.n_sensory       = (sensory_fired && sensory_types) ? pack(slot, *sensory_fired, *sensory_types) : 0;
+    st.action_group    = action_group;
+    slot.steps.push_back(st);
+}
+
+void EpisodeBuffer::end_episode(float reward, int action) {
+    EpisodeSlot& slot = slots_[head_];
+    slot.reward = reward;
+    slot.action = action;
+    head_ = (head_ + 1) % slots_.size();
+    if (count_ < max_episodes_) ++count_;
+    begin_episode();  // 下一个槽: 最旧片段 (若已满) 在此被复用
+}
+
+Episode EpisodeBuffer::view(const EpisodeSlot& slot) const {
+    Episode ep;
+    ep.reward   = slot.reward;
+    ep.action   = slot.action;
+    ep.slot_    = &slot;
+    ep.n_steps_ = slot.steps.size();
+    return ep;
+}
+
+std::vector<Episode> EpisodeBuffer::recent(size_t n) const {
+    std::vector<Episode> result;
+    size_t count = std::min(n, count_);
+    result.reserve(count);
+    size_t cap = slots_.size();
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(view(slots_[(head_ + cap - 1 - i) % cap]));
+    }
+    return result;
+}
+
+std::optional<Episode> EpisodeBuffer::last_rewarded(float threshold) const {
+    size_t cap = slots_.size();
+    for (size_t i = 0; i < count_; ++i) {
+        const EpisodeSlot& slot = slots_[(head_ + cap - 1 - i) % cap];
+        if (std::abs(slot.reward) > threshold) return view(slot);
+    }
+    return std::nullopt;
+}
+
+size_t EpisodeBuffer::arena_bytes() const {
+    size_t bytes = 0;
+    for (const auto& slot : slots_) {
+        bytes += slot.ids.capacity() * sizeof(uint16_t)
+               + slot.types.capacity() * sizeof(int8_t)
+               + slot.steps.capacity() * sizeof(EpisodeSlot::Step);
+    }
+    return bytes;
+}
+
+} // namespace wuyun
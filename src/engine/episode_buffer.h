@@ -12,28 +12,70 @@
  *   - 重放驱动 VTA DA burst → 纹状体 DA-STDP 二次强化
  *   - 效果: 1 次奖励事件 → 10-20 次突触权重更新
  *
- * 设计: 环形缓冲区, 存储最近 N 个 agent step 的 spike 序列
+ * 设计: 固定容量的片段环 (max_episodes + 1 个槽, 含正在记录的一个)。
+ *   每个槽是一块 arena: 所有 step 的脉冲按 uint16 神经元 ID + 1 字节 spike type
+ *   顺次打包, step 记录只存偏移/计数 (每事件 3 字节, SpikeEvent 为 20 字节)。
+ *   槽复用时只清空不释放, 预热后记录无分配; 重放拿到的是指向 arena 的视图。
  */
 
 #include "core/spike_bus.h"
 #include <vector>
-#include <deque>
+#include <optional>
 #include <cstdint>
+#include <cstddef>
 
 namespace wuyun {
 
-/** 单个 brain step 的皮层 spike 快照 */
+/**
+ * 单个 brain step 的 spike 快照 (arena 视图)
+ * 有效期: 所在槽被复用前 (之后 max_episodes 次 end_episode)
+ */
 struct SpikeSnapshot {
-    std::vector<SpikeEvent> cortical_events;  // dlPFC → BG 的 spike events
-    std::vector<SpikeEvent> sensory_events;   // V1 → dlPFC 的 spike events (皮层巩固用)
-    int action_group = -1;                     // 当前探索方向 (efference copy)
+    uint32_t        cortical_region = 0;        // dlPFC → BG 的 spike 来源区域
+    const uint16_t* cortical_ids    = nullptr;
+    const int8_t*   cortical_types  = nullptr;
+    uint32_t        n_cortical      = 0;
+
+    uint32_t        sensory_region  = 0;        // V1 → dlPFC (皮层巩固用)
+    const uint16_t* sensory_ids     = nullptr;
+    const int8_t*   sensory_types   = nullptr;
+    uint32_t        n_sensory       = 0;
+
+    int action_group = -1;                      // 当前探索方向 (efference copy)
+
+    /** 展开为 SpikeEvent (覆盖 out, 复用其容量) */
+    void cortical_events(std::vector<SpikeEvent>& out) const;
+    void sensory_events(std::vector<SpikeEvent>& out) const;
 };
 
-/** 单个 agent step 的完整经验片段 */
-struct Episode {
-    std::vector<SpikeSnapshot> steps;  // brain_steps_per_action 个快照
-    float reward = 0.0f;              // 该 step 获得的奖励
-    int action = -1;                   // 执行的动作 (Action enum)
+/** 片段槽: 一块按 step 追加的脉冲 arena */
+struct EpisodeSlot {
+    struct Step {
+        uint32_t cortical_region, cortical_off, n_cortical;
+        uint32_t sensory_region,  sensory_off,  n_sensory;
+        int32_t  action_group;
+    };
+    std::vector<uint16_t> ids;     // 所有 step 的 cortical / sensory ID 顺次存放
+    std::vector<int8_t>   types;
+    std::vector<Step>     steps;
+    float reward = 0.0f;
+    int   action = -1;
+};
+
+/** 单个 agent step 的完整经验片段 (arena 视图) */
+class Episode {
+public:
+    float reward = 0.0f;               // 该 step 获得的奖励
+    int   action = -1;                 // 执行的动作 (Action enum)
+
+    size_t size()  const { return n_steps_; }
+    bool   empty() const { return n_steps_ == 0; }
+    SpikeSnapshot step(size_t i) const;
+
+private:
+    friend class EpisodeBuffer;
+    const EpisodeSlot* slot_ = nullptr;
+    size_t n_steps_ = 0;
 };
 
 /**
@@ -41,74 +83,53 @@ struct Episode {
  */
 class EpisodeBuffer {
 public:
-    explicit EpisodeBuffer(size_t max_episodes = 30, size_t brain_steps = 15)
-        : max_episodes_(max_episodes)
-        , brain_steps_(brain_steps)
-    {
-        current_.steps.reserve(brain_steps);
-    }
-
-    /** 开始记录新的 agent step */
-    void begin_episode() {
-        current_.steps.clear();
-        current_.reward = 0.0f;
-        current_.action = -1;
-    }
-
-    /** 记录一个 brain step 的 spike 快照 */
-    void record_step(const std::vector<SpikeEvent>& cortical_events,
+    explicit EpisodeBuffer(size_t max_episodes = 30, size_t brain_steps = 15);
+
+    /** 开始记录新的 agent step (清空当前槽, 保留其容量) */
+    void begin_episode();
+
+    /**
+     * 记录一个 brain step: 直接从区域发放数组打包 (无 SpikeEvent 中间数组)
+     * 神经元 ID ≥ 65536 的脉冲无法用 uint16 表示, 丢弃并计入 dropped_events()
+     */
+    void record_step(uint32_t cortical_region,
+                     const std::vector<uint8_t>& cortical_fired,
+                     const std::vector<int8_t>&  cortical_types,
                      int action_group,
-                     const std::vector<SpikeEvent>& sensory_events = {}) {
-        SpikeSnapshot snap;
-        snap.cortical_events = cortical_events;
-        snap.sensory_events = sensory_events;
-        snap.action_group = action_group;
-        current_.steps.push_back(std::move(snap));
-    }
-
-    /** 结束当前 episode, 设置奖励和动作 */
-    void end_episode(float reward, int action) {
-        current_.reward = reward;
-        current_.action = action;
-        buffer_.push_back(std::move(current_));
-        if (buffer_.size() > max_episodes_) {
-            buffer_.pop_front();
-        }
-        current_ = Episode{};
-        current_.steps.reserve(brain_steps_);
-    }
+                     uint32_t sensory_region = 0,
+                     const std::vector<uint8_t>* sensory_fired = nullptr,
+                     const std::vector<int8_t>*  sensory_types = nullptr);
+
+    /** 结束当前 episode, 设置奖励和动作; 最旧的片段槽被下一次记录复用 */
+    void end_episode(float reward, int action);
 
     /** 获取最近的 N 个 episodes (从最新到最旧) */
-    std::vector<const Episode*> recent(size_t n = 5) const {
-        std::vector<const Episode*> result;
-        size_t count = std::min(n, buffer_.size());
-        for (size_t i = 0; i < count; ++i) {
-            result.push_back(&buffer_[buffer_.size() - 1 - i]);
-        }
-        return result;
-    }
+    std::vector<Episode> recent(size_t n = 5) const;
 
     /** 获取最近一个有显著奖励的 episode */
-    const Episode* last_rewarded(float threshold = 0.05f) const {
-        for (auto it = buffer_.rbegin(); it != buffer_.rend(); ++it) {
-            if (std::abs(it->reward) > threshold) {
-                return &(*it);
-            }
-        }
-        return nullptr;
-    }
-
-    size_t size() const { return buffer_.size(); }
-    bool empty() const { return buffer_.empty(); }
+    std::optional<Episode> last_rewarded(float threshold = 0.05f) const;
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
 
     /** v53: 清空缓冲区 (反转学习: 旧世界经验不适用新布局) */
-    void clear() { buffer_.clear(); }
+    void clear() { count_ = 0; }
+
+    /** arena 占用 (已分配容量, 字节) */
+    size_t arena_bytes() const;
+    uint64_t dropped_events() const { return dropped_events_; }
 
 private:
+    Episode view(const EpisodeSlot& slot) const;
+    uint32_t pack(EpisodeSlot& slot, const std::vector<uint8_t>& fired,
+                  const std::vector<int8_t>& types);
+
     size_t max_episodes_;
     size_t brain_steps_;
-    std::deque<Episode> buffer_;
-    Episode current_;
+    std::vector<EpisodeSlot> slots_;   // max_episodes + 1 个槽
+    size_t head_  = 0;                 // 正在记录的槽
+    size_t count_ = 0;                 // 已完成片段数 (≤ max_episodes)
+    uint64_t dropped_events_ = 0;
 };
 
 } // namespace wuyun
@@ -18,8 +18,7 @@ void GlobalWorkspace::register_source(uint32_t region_id, const std::string& nam
 }
 
 void GlobalWorkspace::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // =========================================================
     // 1. Update salience from this step's incoming spikes
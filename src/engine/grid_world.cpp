@@ -334,16 +334,32 @@ float GridWorld::cell_to_visual(int x, int y) const {
 }
 
 std::vector<float> GridWorld::observe() const {
+    std::vector<float> obs(config_.vision_pixels());
+    observe_into(obs.data());
+    return obs;
+}
+
+void GridWorld::observe_into(float* out) const {
+    // 逐行扫窗口, 格子类型查表 (与 cell_to_visual 等价); agent 总在窗口中心
+    const float lut[4] = {config_.vis_empty, config_.vis_food, config_.vis_danger, config_.vis_wall};
     int r = config_.vision_radius;
     int side = 2 * r + 1;
-    std::vector<float> obs(static_cast<size_t>(side * side));
-    int k = 0;
+    int w = static_cast<int>(config_.width), h = static_cast<int>(config_.height);
+    float* p = out;
     for (int dy = -r; dy <= r; ++dy) {
+        int y = agent_y_ + dy;
+        if (y < 0 || y >= h) {
+            std::fill(p, p + side, config_.vis_wall);
+            p += side;
+            continue;
+        }
+        const CellType* row = grid_.data() + idx(0, y);
         for (int dx = -r; dx <= r; ++dx) {
-            obs[k++] = cell_to_visual(agent_x_ + dx, agent_y_ + dy);
+            int x = agent_x_ + dx;
+            *p++ = (x >= 0 && x < w) ? lut[static_cast<uint8_t>(row[x])] : config_.vis_wall;
         }
     }
-    return obs;
+    out[r * side + r] = config_.vis_agent;
 }
 
 std::vector<float> GridWorld::full_observation() const {
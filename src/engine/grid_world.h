@@ -102,6 +102,9 @@ public:
     /** 获取 NxN 局部视野 (N=2*vision_radius+1, 行优先) */
     std::vector<float> observe() const;
 
+    /** 无分配版 observe(): 写入 out[0 .. vision_pixels()) */
+    void observe_into(float* out) const;
+
     /** 获取完整视野 (长度=width*height, 用于可视化) */
     std::vector<float> full_observation() const;
 
@@ -24,6 +24,10 @@ std::vector<float> GridWorldEnv::observe() const {
     return world_.observe();
 }
 
+void GridWorldEnv::observe_into(float* out) const {
+    world_.observe_into(out);
+}
+
 size_t GridWorldEnv::vis_width() const { return vis_w_; }
 size_t GridWorldEnv::vis_height() const { return vis_h_; }
 
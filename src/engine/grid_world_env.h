@@ -26,6 +26,7 @@ public:
     void reset_with_seed(uint32_t seed) override;
 
     std::vector<float> observe() const override;
+    void observe_into(float* out) const override;
     size_t vis_width() const override;
     size_t vis_height() const override;
 
@@ -0,0 +1,488 @@
+#include "engine/input_trace.h"
+#include "engine/simulation_engine.h"
+#include "region/cortical_region.h"
+#include "region/subcortical/basal_ganglia.h"
+#include "region/subcortical/cerebellum.h"
+#include "region/subcortical/nucleus_accumbens.h"
+#include "region/subcortical/superior_colliculus.h"
+#include "region/neuromod/vta_da.h"
+#include "region/neuromod/lc_ne.h"
+#include "region/neuromod/nbm_ach.h"
+#include "region/neuromod/drn_5ht.h"
+#include "region/limbic/hippocampus.h"
+#include "region/limbic/amygdala.h"
+#include "region/limbic/lateral_habenula.h"
+#include "region/limbic/hypothalamus.h"
+#include "region/anterior_cingulate.h"
+#include "region/prefrontal/orbitofrontal.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace wuyun {
+
+namespace {
+
+constexpr char    MAGIC[4]    = {'W', 'Y', 'I', 'T'};
+constexpr uint8_t FLAG_SPARSE = 1;   // payload = (u32 n, {u32 idx, f32 v}…)
+
+template <typename T>
+T read_as(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+template <typename T>
+void write_as(std::ostream& os, T v) {
+    os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+bool read_from(std::istream& is, T& v) {
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&v), sizeof(T)));
+}
+
+constexpr uint32_t MAX_DENSE = 1u << 24;   // 稀疏记录的稠密长度上限 (损坏文件不致巨量分配)
+
+/** op 的最少浮点数 (单值 op 为 1) */
+uint32_t min_values(TraceOp op) {
+    switch (op) {
+    case TraceOp::EXTERNAL:
+    case TraceOp::CTX_L5_BASAL:
+    case TraceOp::AMYG_PFC_ITC:         return 0;
+    case TraceOp::HIPP_SPATIAL_CONTEXT:
+    case TraceOp::ACC_D1_RATES:
+    case TraceOp::BG_SENSORY_CONTEXT:   return 4;
+    case TraceOp::SC_VISUAL_PATCH:      return 3;
+    default:                            return 1;
+    }
+}
+
+/**
+ * 单条记录的结构校验 (load 与回放共用)
+ * @return nullptr = 合法, 否则为原因
+ */
+const char* check_record(TraceOp op, uint8_t flags, uint16_t region,
+                         const uint8_t* p, uint32_t bytes, size_t n_regions) {
+    if (op >= TraceOp::COUNT) return "unknown op";
+    if (op == TraceOp::STEP) {
+        return (region == InputTrace::ENGINE && bytes == 4) ? nullptr : "malformed step record";
+    }
+    if (op == TraceOp::ENGINE_MASK || op == TraceOp::ENGINE_COMPACT) {
+        return region == InputTrace::ENGINE ? nullptr : "engine record with region index";
+    }
+    if (region >= n_regions) return "region index out of range";
+
+    uint32_t n = 0;
+    if (flags & FLAG_SPARSE) {
+        if (bytes < 4 || (bytes - 4) % 8 != 0) return "malformed sparse payload";
+        n = read_as<uint32_t>(p);
+        if (n > MAX_DENSE) return "sparse dense size too large";
+        for (uint32_t k = 4; k < bytes; k += 8) {
+            if (read_as<uint32_t>(p + k) >= n) return "sparse index out of range";
+        }
+    } else {
+        if (bytes % sizeof(float) != 0) return "payload not a float array";
+        n = bytes / sizeof(float);
+    }
+    return n >= min_values(op) ? nullptr : "payload too short";
+}
+
+/** 区域类型与 op 相符 (dynamic_cast; EXTERNAL 对任意区域有效) */
+bool region_kind_ok(TraceOp op, BrainRegion& r) {
+    switch (op) {
+    case TraceOp::EXTERNAL:             return true;
+    case TraceOp::CTX_L5_BASAL:
+    case TraceOp::CTX_ACH_STDP_GAIN:
+    case TraceOp::CTX_ATTENTION_GAIN:   return dynamic_cast<CorticalRegion*>(&r) != nullptr;
+    case TraceOp::HYPO_HEDONIC:         return dynamic_cast<Hypothalamus*>(&r) != nullptr;
+    case TraceOp::HIPP_REWARD_TAG:
+    case TraceOp::HIPP_SPATIAL_CONTEXT:
+    case TraceOp::HIPP_SLEEP_REPLAY:    return dynamic_cast<Hippocampus*>(&r) != nullptr;
+    case TraceOp::AMYG_US:
+    case TraceOp::AMYG_PFC_ITC:         return dynamic_cast<Amygdala*>(&r) != nullptr;
+    case TraceOp::LHB_FRUSTRATION:      return dynamic_cast<LateralHabenula*>(&r) != nullptr;
+    case TraceOp::VTA_LHB_INHIBITION:   return dynamic_cast<VTA_DA*>(&r) != nullptr;
+    case TraceOp::NBM_SURPRISE:         return dynamic_cast<NBM_ACh*>(&r) != nullptr;
+    case TraceOp::LC_AROUSAL:           return dynamic_cast<LC_NE*>(&r) != nullptr;
+    case TraceOp::DRN_WELLBEING:        return dynamic_cast<DRN_5HT*>(&r) != nullptr;
+    case TraceOp::ACC_D1_RATES:
+    case TraceOp::ACC_OUTCOME:
+    case TraceOp::ACC_THREAT:           return dynamic_cast<AnteriorCingulate*>(&r) != nullptr;
+    case TraceOp::BG_DA_LEVEL:
+    case TraceOp::BG_ACH_LEVEL:
+    case TraceOp::BG_SENSORY_CONTEXT:
+    case TraceOp::BG_MOTOR_EFFERENCE:   return dynamic_cast<BasalGanglia*>(&r) != nullptr;
+    case TraceOp::NACC_DA_LEVEL:        return dynamic_cast<NucleusAccumbens*>(&r) != nullptr;
+    case TraceOp::OFC_DA_LEVEL:         return dynamic_cast<OrbitofrontalCortex*>(&r) != nullptr;
+    case TraceOp::CB_CLIMBING_FIBER:    return dynamic_cast<Cerebellum*>(&r) != nullptr;
+    case TraceOp::SC_VISUAL_PATCH:      return dynamic_cast<SuperiorColliculus*>(&r) != nullptr;
+    default:                            return false;
+    }
+}
+
+} // namespace
+
+const char* trace_op_name(TraceOp op) {
+    static const char* names[] = {
+        "step", "external", "ctx_l5_basal", "ctx_ach_stdp_gain", "ctx_attention_gain",
+        "hypo_hedonic", "hipp_reward_tag", "hipp_spatial_context", "hipp_sleep_replay",
+        "amyg_us", "amyg_pfc_itc", "lhb_frustration", "vta_lhb_inhibition", "nbm_surprise",
+        "lc_arousal", "drn_wellbeing", "acc_d1_rates", "acc_outcome", "acc_threat",
+        "bg_da_level", "bg_ach_level", "bg_sensory_context", "bg_motor_efference",
+        "nacc_da_level", "ofc_da_level", "cb_climbing_fiber", "sc_visual_patch",
+        "engine_mask", "engine_compact",
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(TraceOp::COUNT),
+                  "trace_op_name table out of sync with TraceOp");
+    auto i = static_cast<size_t>(op);
+    return i < static_cast<size_t>(TraceOp::COUNT) ? names[i] : "?";
+}
+
+// =============================================================================
+// 录制
+// =============================================================================
+
+void InputTrace::begin(const SimulationEngine& engine, const std::string& meta) {
+    meta_ = meta;
+    region_names_.clear();
+    region_sizes_.clear();
+    for (size_t i = 0; i < engine.num_regions(); ++i) {
+        region_names_.push_back(engine.region(i).name());
+        region_sizes_.push_back(static_cast<uint32_t>(engine.region(i).n_neurons()));
+    }
+    data_.clear();
+    n_steps_ = 0;
+    pending_steps_ = 0;
+    n_records_ = 0;
+}
+
+void InputTrace::put(const void* p, size_t n) {
+    const auto* b = static_cast<const uint8_t*>(p);
+    data_.insert(data_.end(), b, b + n);
+}
+
+void InputTrace::put_header(TraceOp op, uint8_t flags, uint32_t region, uint32_t bytes) {
+    uint8_t  o = static_cast<uint8_t>(op);
+    uint16_t r = static_cast<uint16_t>(region);
+    put(&o, 1);
+    put(&flags, 1);
+    put(&r, 2);
+    put(&bytes, 4);
+    ++n_records_;
+}
+
+void InputTrace::flush_steps() {
+    if (pending_steps_ == 0) return;
+    put_header(TraceOp::STEP, 0, ENGINE, 4);
+    put(&pending_steps_, 4);
+    n_steps_ += pending_steps_;
+    pending_steps_ = 0;
+}
+
+void InputTrace::step() {
+    if (pending_steps_ == UINT32_MAX) flush_steps();
+    ++pending_steps_;
+}
+
+void InputTrace::scalar(TraceOp op, uint32_t region, float value) {
+    values(op, region, &value, 1);
+}
+
+void InputTrace::values(TraceOp op, uint32_t region, const float* data, size_t n) {
+    flush_steps();
+    size_t nnz = 0;
+    for (size_t i = 0; i < n; ++i) nnz += (data[i] != 0.0f);
+    if (n >= 8 && nnz * 2 < n) {
+        uint32_t count = static_cast<uint32_t>(n);
+        put_header(op, FLAG_SPARSE, region, static_cast<uint32_t>(4 + nnz * 8));
+        put(&count, 4);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (data[i] == 0.0f) continue;
+            put(&i, 4);
+            put(&data[i], 4);
+        }
+    } else {
+        put_header(op, 0, region, static_cast<uint32_t>(n * sizeof(float)));
+        put(data, n * sizeof(float));
+    }
+}
+
+void InputTrace::text(TraceOp op, uint32_t region, const std::string& s) {
+    flush_steps();
+    put_header(op, 0, region, static_cast<uint32_t>(s.size()));
+    put(s.data(), s.size());
+}
+
+// =============================================================================
+// 持久化
+// =============================================================================
+
+bool InputTrace::save(const std::string& path) const {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    f.write(MAGIC, 4);
+    write_as<uint32_t>(f, VERSION);
+    write_as<uint32_t>(f, static_cast<uint32_t>(region_names_.size()));
+    for (size_t i = 0; i < region_names_.size(); ++i) {
+        write_as<uint16_t>(f, static_cast<uint16_t>(region_names_[i].size()));
+        f.write(region_names_[i].data(), static_cast<std::streamsize>(region_names_[i].size()));
+        write_as<uint32_t>(f, region_sizes_[i]);
+    }
+    write_as<uint16_t>(f, static_cast<uint16_t>(meta_.size()));
+    f.write(meta_.data(), static_cast<std::streamsize>(meta_.size()));
+    f.write(reinterpret_cast<const char*>(data_.data()), static_cast<std::streamsize>(data_.size()));
+    if (pending_steps_ > 0) {
+        // 未写出的尾部 STEP (录制仍在进行时也可保存)
+        write_as<uint8_t>(f, static_cast<uint8_t>(TraceOp::STEP));
+        write_as<uint8_t>(f, 0);
+        write_as<uint16_t>(f, ENGINE);
+        write_as<uint32_t>(f, 4);
+        write_as<uint32_t>(f, pending_steps_);
+    }
+    return static_cast<bool>(f);
+}
+
+bool InputTrace::load(const std::string& path, std::string* why) {
+    auto fail = [&](const std::string& msg) {
+        if (why) *why = msg;
+        return false;
+    };
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return fail("cannot open " + path);
+    char magic[4];
+    uint32_t version = 0, n_regions = 0;
+    if (!f.read(magic, 4) || std::memcmp(magic, MAGIC, 4) != 0) return fail("not a WYIT trace");
+    if (!read_from(f, version) || version != VERSION) return fail("unsupported version");
+    if (!read_from(f, n_regions) || n_regions >= ENGINE) return fail("bad region count");
+
+    region_names_.assign(n_regions, "");
+    region_sizes_.assign(n_regions, 0);
+    for (uint32_t i = 0; i < n_regions; ++i) {
+        uint16_t len = 0;
+        if (!read_from(f, len)) return fail("truncated region table");
+        region_names_[i].resize(len);
+        if (len && !f.read(&region_names_[i][0], len)) return fail("truncated region table");
+        if (!read_from(f, region_sizes_[i])) return fail("truncated region table");
+    }
+    uint16_t meta_len = 0;
+    if (!read_from(f, meta_len)) return fail("truncated header");
+    meta_.resize(meta_len);
+    if (meta_len && !f.read(&meta_[0], meta_len)) return fail("truncated header");
+
+    data_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+
+    // 扫描一遍: 校验记录边界与结构, 统计步数/记录数
+    n_steps_ = 0;
+    n_records_ = 0;
+    pending_steps_ = 0;
+    size_t pos = 0;
+    while (pos < data_.size()) {
+        std::string at = "record " + std::to_string(n_records_) + ": ";
+        if (pos + 8 > data_.size()) return fail(at + "truncated header");
+        auto op     = static_cast<TraceOp>(data_[pos]);
+        uint8_t flg = data_[pos + 1];
+        auto region = read_as<uint16_t>(&data_[pos + 2]);
+        auto bytes  = read_as<uint32_t>(&data_[pos + 4]);
+        if (bytes > data_.size() - pos - 8) return fail(at + "truncated payload");
+        if (const char* err = check_record(op, flg, region, &data_[pos + 8], bytes, n_regions))
+            return fail(at + err);
+        if (op == TraceOp::STEP) n_steps_ += read_as<uint32_t>(&data_[pos + 8]);
+        ++n_records_;
+        pos += 8 + bytes;
+    }
+    return true;
+}
+
+bool InputTrace::matches(const SimulationEngine& engine, std::string* why) const {
+    auto fail = [&](const std::string& msg) {
+        if (why) *why = msg;
+        return false;
+    };
+    if (engine.num_regions() != region_names_.size())
+        return fail("region count " + std::to_string(engine.num_regions()) + " != trace " +
+                    std::to_string(region_names_.size()));
+    for (size_t i = 0; i < region_names_.size(); ++i) {
+        const auto& r = engine.region(i);
+        if (r.name() != region_names_[i] || r.n_neurons() != region_sizes_[i])
+            return fail("region " + std::to_string(i) + " is " + r.name() + "/" +
+                        std::to_string(r.n_neurons()) + ", trace has " + region_names_[i] + "/" +
+                        std::to_string(region_sizes_[i]));
+    }
+    return true;
+}
+
+// =============================================================================
+// 回放
+// =============================================================================
+
+InputTraceReplayer::InputTraceReplayer(const InputTrace& trace, SimulationEngine& engine)
+    : trace_(trace), engine_(engine)
+{
+    std::string why;
+    if (!trace_.matches(engine_, &why)) error_ = "trace does not match engine: " + why;
+}
+
+bool InputTraceReplayer::step() {
+    if (!error_.empty()) return false;
+    const auto& d = trace_.data_;
+    while (steps_left_ == 0) {
+        if (pos_ >= d.size()) return false;
+        // 录制中的 trace 未经 load(): 同样逐条校验
+        if (pos_ + 8 > d.size()) { error_ = "truncated record"; return false; }
+        auto op     = static_cast<TraceOp>(d[pos_]);
+        uint8_t flg = d[pos_ + 1];
+        auto region = read_as<uint16_t>(&d[pos_ + 2]);
+        auto bytes  = read_as<uint32_t>(&d[pos_ + 4]);
+        if (bytes > d.size() - pos_ - 8) { error_ = "truncated record"; return false; }
+        const uint8_t* p = &d[pos_ + 8];
+        if (const char* err = check_record(op, flg, region, p, bytes, engine_.num_regions())) {
+            error_ = err;
+            return false;
+        }
+        pos_ += 8 + bytes;
+        if (op == TraceOp::STEP) steps_left_ = read_as<uint32_t>(p);
+        else if (!apply(op, flg, region, p, bytes)) return false;
+    }
+    --steps_left_;
+    engine_.step();
+    ++steps_done_;
+    return true;
+}
+
+uint64_t InputTraceReplayer::run(uint64_t max_steps) {
+    uint64_t n = 0;
+    while ((max_steps == 0 || n < max_steps) && step()) ++n;
+    return n;
+}
+
+bool InputTraceReplayer::apply(TraceOp op, uint8_t flags, uint16_t region,
+                               const uint8_t* p, uint32_t bytes) {
+    // 解码浮点 payload (稀疏 → 稠密)
+    if (op != TraceOp::ENGINE_MASK) {
+        if (flags & FLAG_SPARSE) {
+            buf_.assign(read_as<uint32_t>(p), 0.0f);
+            for (uint32_t k = 4; k + 8 <= bytes; k += 8)
+                buf_[read_as<uint32_t>(p + k)] = read_as<float>(p + k + 4);
+        } else {
+            buf_.resize(bytes / sizeof(float));
+            if (bytes) std::memcpy(buf_.data(), p, bytes);
+        }
+    }
+    const float s = buf_.empty() ? 0.0f : buf_[0];
+
+    if (op == TraceOp::ENGINE_MASK) {
+        std::string name(reinterpret_cast<const char*>(p), bytes);
+        if (name.empty()) engine_.clear_mask();
+        else engine_.use_mask(name);
+        return true;
+    }
+    if (op == TraceOp::ENGINE_COMPACT) {
+        engine_.compact_synapses();
+        return true;
+    }
+
+    // 区域记录: 类型由 op 决定 (录制方按同一 op 表写出), 先 dynamic_cast 校验
+    BrainRegion& r = engine_.region(region);
+    if (!region_kind_ok(op, r)) {
+        error_ = std::string(trace_op_name(op)) + " on region " + r.name() + " of the wrong kind";
+        return false;
+    }
+    switch (op) {
+    case TraceOp::EXTERNAL:
+        r.inject_external(buf_);
+        break;
+    case TraceOp::CTX_L5_BASAL: {
+        auto& l5 = static_cast<CorticalRegion&>(r).column().l5();
+        for (size_t j = 0; j < buf_.size(); ++j)
+            if (buf_[j] != 0.0f) l5.inject_basal(j, buf_[j]);
+        break;
+    }
+    case TraceOp::CTX_ACH_STDP_GAIN:
+        static_cast<CorticalRegion&>(r).column().set_ach_stdp_gain(s);
+        break;
+    case TraceOp::CTX_ATTENTION_GAIN:
+        static_cast<CorticalRegion&>(r).set_attention_gain(s);
+        break;
+    case TraceOp::HYPO_HEDONIC:
+        static_cast<Hypothalamus&>(r).inject_hedonic(s);
+        break;
+    case TraceOp::HIPP_REWARD_TAG:
+        static_cast<Hippocampus&>(r).inject_reward_tag(s);
+        break;
+    case TraceOp::HIPP_SPATIAL_CONTEXT:
+        static_cast<Hippocampus&>(r).inject_spatial_context(
+            static_cast<int>(buf_[0]), static_cast<int>(buf_[1]),
+            static_cast<int>(buf_[2]), static_cast<int>(buf_[3]));
+        break;
+    case TraceOp::HIPP_SLEEP_REPLAY:
+        if (s != 0.0f) static_cast<Hippocampus&>(r).enable_sleep_replay();
+        else static_cast<Hippocampus&>(r).disable_sleep_replay();
+        break;
+    case TraceOp::AMYG_US:
+        static_cast<Amygdala&>(r).inject_us(s);
+        break;
+    case TraceOp::AMYG_PFC_ITC:
+        static_cast<Amygdala&>(r).inject_pfc_to_itc(buf_);
+        break;
+    case TraceOp::LHB_FRUSTRATION:
+        static_cast<LateralHabenula&>(r).inject_frustration(s);
+        break;
+    case TraceOp::VTA_LHB_INHIBITION:
+        static_cast<VTA_DA&>(r).inject_lhb_inhibition(s);
+        break;
+    case TraceOp::NBM_SURPRISE:
+        static_cast<NBM_ACh&>(r).inject_surprise(s);
+        break;
+    case TraceOp::LC_AROUSAL:
+        static_cast<LC_NE&>(r).inject_arousal(s);
+        break;
+    case TraceOp::DRN_WELLBEING:
+        static_cast<DRN_5HT&>(r).inject_wellbeing(s);
+        break;
+    case TraceOp::ACC_D1_RATES:
+        static_cast<AnteriorCingulate&>(r).inject_d1_rates({buf_[0], buf_[1], buf_[2], buf_[3]});
+        break;
+    case TraceOp::ACC_OUTCOME:
+        static_cast<AnteriorCingulate&>(r).inject_outcome(s);
+        break;
+    case TraceOp::ACC_THREAT:
+        static_cast<AnteriorCingulate&>(r).inject_threat(s);
+        break;
+    case TraceOp::BG_DA_LEVEL:
+        static_cast<BasalGanglia&>(r).set_da_level(s);
+        break;
+    case TraceOp::BG_ACH_LEVEL:
+        static_cast<BasalGanglia&>(r).set_ach_level(s);
+        break;
+    case TraceOp::BG_SENSORY_CONTEXT:
+        static_cast<BasalGanglia&>(r).inject_sensory_context(buf_.data());
+        break;
+    case TraceOp::BG_MOTOR_EFFERENCE:
+        static_cast<BasalGanglia&>(r).mark_motor_efference(static_cast<int>(s));
+        break;
+    case TraceOp::NACC_DA_LEVEL:
+        static_cast<NucleusAccumbens&>(r).set_da_level(s);
+        break;
+    case TraceOp::OFC_DA_LEVEL:
+        static_cast<OrbitofrontalCortex&>(r).set_da_level(s);
+        break;
+    case TraceOp::CB_CLIMBING_FIBER:
+        static_cast<Cerebellum&>(r).inject_climbing_fiber(s);
+        break;
+    case TraceOp::SC_VISUAL_PATCH: {
+        // payload: pixels…, width, height, gain
+        size_t n = buf_.size() - 3;
+        std::vector<float> pixels(buf_.begin(), buf_.begin() + static_cast<std::ptrdiff_t>(n));
+        static_cast<SuperiorColliculus&>(r).inject_visual_patch(
+            pixels, static_cast<int>(buf_[n]), static_cast<int>(buf_[n + 1]), buf_[n + 2]);
+        break;
+    }
+    default:
+        break;
+    }
+    return true;
+}
+
+} // namespace wuyun
@@ -0,0 +1,159 @@
+#pragma once
+/**
+ * InputTrace — 外部输入录制/回放 (纯脑基准的固定负载)
+ *
+ * ClosedLoopAgent 的端到端耗时混合了环境、编码器与大脑, 且行为随每次优化而变,
+ * 不适合做内核 A/B 对比。录制模式把智能体对大脑的每一次外部注入
+ * (LGN 编码电流、奖赏/下丘脑、杏仁核/缰核驱动、空间上下文、调质标量、
+ * M1 L5 反射/探索电流、睡眠掩码…) 连同步边界写入紧凑二进制流;
+ * InputTraceReplayer 据此直接驱动一个结构相同的 SimulationEngine,
+ * 不需要环境、编码器与决策逻辑 — 同一 trace 每次回放得到同一负载。
+ *
+ * 记录 = (op, region, payload), 按发生顺序排列; STEP 记录表示 engine.step()
+ * (连续无输入的步合并为一条带计数的 STEP)。稀疏向量 (非零 < 一半) 按
+ * (下标, 值) 对存储。op 与区域 API 一一对应, 回放时按 op 的区域类型调用同一方法。
+ *
+ * 不录制: 智能体在引擎外直接改写 BG 权重的离线过程 (清醒 SWR 回放批核、
+ * 异步巩固的权重交换)。开启这些功能录得的 trace 回放时 BG 权重演化与原运行不同,
+ * 但回放本身仍完全确定; 需要逐位复现原运行时关闭 enable_replay。
+ *
+ * 校验: load() 逐条检查记录结构 (op、region 字段 < 区域数、payload 长度、稀疏下标
+ * < 稠密长度); InputTraceReplayer 只在 matches() 通过时回放, 并按 op 的区域类型
+ * dynamic_cast, 类型不符即停止 (error() 给出原因), 损坏或不匹配的 trace 不会越界写。
+ *
+ * 文件格式 (小端):
+ *   "WYIT" u32 version | u32 n_regions | { u16 len, name, u32 n_neurons } × n
+ *   | u16 len, meta | 记录流 { u8 op, u8 flags, u16 region, u32 bytes, payload }
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wuyun {
+
+class SimulationEngine;
+
+enum class TraceOp : uint8_t {
+    STEP = 0,               // payload: u32 步数
+    EXTERNAL,               // BrainRegion::inject_external (LGN 编码电流)
+    CTX_L5_BASAL,           // CorticalRegion L5 basal 电流 (M1 反射 + 探索 + BG 偏置合计)
+    CTX_ACH_STDP_GAIN,      // CorticalColumn::set_ach_stdp_gain
+    CTX_ATTENTION_GAIN,     // CorticalRegion::set_attention_gain
+    HYPO_HEDONIC,           // Hypothalamus::inject_hedonic
+    HIPP_REWARD_TAG,        // Hippocampus::inject_reward_tag
+    HIPP_SPATIAL_CONTEXT,   // Hippocampus::inject_spatial_context (x, y, w, h)
+    HIPP_SLEEP_REPLAY,      // Hippocampus::enable/disable_sleep_replay (1 / 0)
+    AMYG_US,                // Amygdala::inject_us
+    AMYG_PFC_ITC,           // Amygdala::inject_pfc_to_itc
+    LHB_FRUSTRATION,        // LateralHabenula::inject_frustration
+    VTA_LHB_INHIBITION,     // VTA_DA::inject_lhb_inhibition
+    NBM_SURPRISE,           // NBM_ACh::inject_surprise
+    LC_AROUSAL,             // LC_NE::inject_arousal
+    DRN_WELLBEING,          // DRN_5HT::inject_wellbeing
+    ACC_D1_RATES,           // AnteriorCingulate::inject_d1_rates (4)
+    ACC_OUTCOME,            // AnteriorCingulate::inject_outcome
+    ACC_THREAT,             // AnteriorCingulate::inject_threat
+    BG_DA_LEVEL,            // BasalGanglia::set_da_level
+    BG_ACH_LEVEL,           // BasalGanglia::set_ach_level
+    BG_SENSORY_CONTEXT,     // BasalGanglia::inject_sensory_context (4)
+    BG_MOTOR_EFFERENCE,     // BasalGanglia::mark_motor_efference
+    NACC_DA_LEVEL,          // NucleusAccumbens::set_da_level
+    OFC_DA_LEVEL,           // OrbitofrontalCortex::set_da_level
+    CB_CLIMBING_FIBER,      // Cerebellum::inject_climbing_fiber
+    SC_VISUAL_PATCH,        // SuperiorColliculus::inject_visual_patch (pixels…, w, h, gain)
+    ENGINE_MASK,            // SimulationEngine::use_mask (payload: 掩码名, 空 = 清除)
+    ENGINE_COMPACT,         // SimulationEngine::compact_synapses
+    COUNT
+};
+
+const char* trace_op_name(TraceOp op);
+
+class InputTrace {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint16_t ENGINE = 0xFFFF;   // 引擎级记录的 region 字段
+
+    /** 开始录制: 清空并记下引擎的区域表 (回放时校验), meta 为自由文本 (如 "brain_scale=3") */
+    void begin(const SimulationEngine& engine, const std::string& meta = "");
+
+    // --- 录制 ---
+    void step();
+    void scalar(TraceOp op, uint32_t region, float value);
+    void values(TraceOp op, uint32_t region, const float* data, size_t n);
+    void values(TraceOp op, uint32_t region, const std::vector<float>& v) {
+        values(op, region, v.data(), v.size());
+    }
+    void text(TraceOp op, uint32_t region, const std::string& s);
+
+    // --- 持久化 ---
+    bool save(const std::string& path) const;
+    /** 读取并校验每条记录; 失败返回 false, why 给出原因 */
+    bool load(const std::string& path, std::string* why = nullptr);
+
+    /** 区域表与 engine 一致 (名称 + 神经元数); 不一致时 why 给出原因 */
+    bool matches(const SimulationEngine& engine, std::string* why = nullptr) const;
+
+    // --- 查询 ---
+    const std::string& meta() const { return meta_; }
+    size_t num_regions() const { return region_names_.size(); }
+    uint64_t num_steps()   const { return n_steps_ + pending_steps_; }
+    size_t num_records()   const { return n_records_; }
+    /** 记录流字节数 (不含文件头) */
+    size_t bytes() const { return data_.size() + (pending_steps_ ? 8 + 4 : 0); }
+
+private:
+    friend class InputTraceReplayer;
+
+    void flush_steps();
+    void put_header(TraceOp op, uint8_t flags, uint32_t region, uint32_t bytes);
+    void put(const void* p, size_t n);
+
+    std::string meta_;
+    std::vector<std::string> region_names_;
+    std::vector<uint32_t>    region_sizes_;
+    std::vector<uint8_t> data_;         // 记录流
+    uint64_t n_steps_ = 0;
+    uint32_t pending_steps_ = 0;        // 尚未写出的连续 STEP
+    size_t   n_records_ = 0;
+};
+
+/**
+ * 按 trace 驱动引擎: 应用到下一条 STEP 之前的全部输入, 然后 engine.step()
+ * engine 须与录制时结构相同 (同配置构造的脑, 见 InputTrace::matches);
+ * 不匹配时构造即记下错误, step() 一步也不回放。
+ */
+class InputTraceReplayer {
+public:
+    InputTraceReplayer(const InputTrace& trace, SimulationEngine& engine);
+
+    /** 回放一步; trace 结束或出错返回 false (出错时 ok() 为 false) */
+    bool step();
+
+    /** 回放至多 max_steps 步 (0 = 全部), 返回实际步数 */
+    uint64_t run(uint64_t max_steps = 0);
+
+    /** 回到 trace 开头 (引擎状态不变) */
+    void rewind() { pos_ = 0; steps_left_ = 0; steps_done_ = 0; }
+
+    uint64_t steps_done() const { return steps_done_; }
+
+    /** 未出错 (trace 与引擎匹配, 已回放的记录均合法) */
+    bool ok() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+
+private:
+    /** 应用一条输入记录; 区域类型与 op 不符时记下错误并返回 false */
+    bool apply(TraceOp op, uint8_t flags, uint16_t region, const uint8_t* p, uint32_t bytes);
+
+    const InputTrace& trace_;
+    SimulationEngine& engine_;
+    size_t   pos_ = 0;
+    uint32_t steps_left_ = 0;           // 当前 STEP 记录剩余步数
+    uint64_t steps_done_ = 0;
+    std::vector<float> buf_;
+    std::string error_;
+};
+
+} // namespace wuyun
@@ -143,23 +143,32 @@ float MultiRoomEnv::cell_visual(int x, int y) const {
 }
 
 std::vector<float> MultiRoomEnv::observe() const {
-    int r = cfg_.vision_radius;
     size_t side = cfg_.vision_side();
-    std::vector<float> patch(side * side, cfg_.vis_wall);
+    std::vector<float> patch(side * side);
+    observe_into(patch.data());
+    return patch;
+}
 
+void MultiRoomEnv::observe_into(float* out) const {
+    // 逐行扫窗口, 格子类型查表 (与 cell_visual 等价), 中心为 agent
+    const float lut[4] = {cfg_.vis_empty, cfg_.vis_food, cfg_.vis_danger, cfg_.vis_wall};
+    int r = cfg_.vision_radius;
+    int side = 2 * r + 1;
+    float* p = out;
     for (int dy = -r; dy <= r; ++dy) {
+        int wy = agent_iy_ + dy;
+        if (wy < 0 || wy >= (int)grid_h_) {
+            std::fill(p, p + side, cfg_.vis_wall);
+            p += side;
+            continue;
+        }
+        const Cell* row = grid_.data() + idx(0, wy);
         for (int dx = -r; dx <= r; ++dx) {
             int wx = agent_ix_ + dx;
-            int wy = agent_iy_ + dy;
-            size_t pi = static_cast<size_t>((dy + r) * (int)side + (dx + r));
-            if (dx == 0 && dy == 0) {
-                patch[pi] = cfg_.vis_agent;
-            } else {
-                patch[pi] = cell_visual(wx, wy);
-            }
+            *p++ = (wx >= 0 && wx < (int)grid_w_) ? lut[static_cast<uint8_t>(row[wx])] : cfg_.vis_wall;
         }
     }
-    return patch;
+    out[r * side + r] = cfg_.vis_agent;
 }
 
 size_t MultiRoomEnv::vis_width()  const { return cfg_.vision_side(); }
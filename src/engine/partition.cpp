@@ -0,0 +1,365 @@
+#include "engine/partition.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef WUYUN_OPENMP
+#include <omp.h>
+#endif
+
+namespace wuyun {
+
+// =============================================================================
+// PartitionPlan
+// =============================================================================
+
+std::vector<uint8_t> PartitionPlan::local_mask(int part) const {
+    std::vector<uint8_t> mask(owner.size(), 0);
+    for (size_t i = 0; i < owner.size(); ++i) mask[i] = is_local(i, part) ? 1 : 0;
+    return mask;
+}
+
+float PartitionPlan::imbalance() const {
+    if (load.empty()) return 1.0f;
+    double sum = std::accumulate(load.begin(), load.end(), 0.0);
+    double mx = *std::max_element(load.begin(), load.end());
+    if (sum <= 0.0) return 1.0f;
+    return static_cast<float>(mx / (sum / static_cast<double>(load.size())));
+}
+
+// =============================================================================
+// 代价测量
+// =============================================================================
+
+std::vector<double> measure_region_costs(const BrainBuilder& build, int32_t n_steps) {
+    SimulationEngine engine;
+    build(engine);
+    auto& bus = engine.bus();
+    size_t n = engine.num_regions();
+    std::vector<double> ns(n, 0.0);
+
+    // Sequential replica of the step loop, timing each region's step()
+    for (int32_t t = 0; t < n_steps; ++t) {
+        for (size_t i = 0; i < n; ++i) {
+            auto& r = engine.region(i);
+            const auto& events = bus.get_arriving_spikes(r.region_id(), t);
+            if (!events.empty()) r.receive_spikes(events);
+            auto t0 = std::chrono::steady_clock::now();
+            r.step(t, 1.0f);
+            auto t1 = std::chrono::steady_clock::now();
+            ns[i] += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        }
+        for (size_t i = 0; i < n; ++i) engine.region(i).submit_spikes(bus, t);
+        bus.advance(t);
+    }
+    for (auto& v : ns) v /= std::max<int32_t>(1, n_steps);
+    return ns;
+}
+
+// =============================================================================
+// 分区
+// =============================================================================
+
+PartitionPlan partition_regions(const SimulationEngine& engine, int n_parts,
+                                const PartitionOptions& opt) {
+    PartitionPlan plan;
+    size_t n = engine.num_regions();
+    plan.n_parts = std::max(1, n_parts);
+    plan.owner.assign(n, 0);
+    plan.load.assign(static_cast<size_t>(plan.n_parts), 0.0);
+
+    std::vector<double> cost(n);
+    for (size_t i = 0; i < n; ++i) {
+        cost[i] = (i < opt.region_cost.size()) ? opt.region_cost[i]
+                                               : static_cast<double>(engine.region(i).n_neurons());
+    }
+
+    // Replicated regions run in every partition
+    std::vector<std::string> rep = opt.replicate;
+    if (opt.replicate_neuromod_sources) {
+        auto nm = engine.neuromod_source_names();
+        rep.insert(rep.end(), nm.begin(), nm.end());
+    }
+    std::vector<uint8_t> placed(n, 0);
+    if (plan.n_parts > 1) {
+        for (size_t i = 0; i < n; ++i) {
+            if (std::find(rep.begin(), rep.end(), engine.region(i).name()) != rep.end()) {
+                plan.owner[i] = PartitionPlan::REPLICATED;
+                placed[i] = 1;
+            }
+        }
+    }
+
+    // Projection adjacency (undirected, by region index == region_id)
+    std::vector<std::vector<size_t>> adj(n);
+    for (const auto& p : engine.bus().projections()) {
+        if (p.src_region >= n || p.dst_region >= n || p.src_region == p.dst_region) continue;
+        adj[p.src_region].push_back(p.dst_region);
+        adj[p.dst_region].push_back(p.src_region);
+    }
+
+    // LPT: heaviest region first onto the least-loaded partition; among
+    // partitions within eps of the minimum, prefer most projection neighbours
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return cost[a] > cost[b]; });
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) if (!placed[i]) total += cost[i];
+    double eps = 0.1 * total / plan.n_parts;
+
+    for (size_t r : order) {
+        if (placed[r]) continue;
+        double min_load = *std::min_element(plan.load.begin(), plan.load.end());
+        int best = -1;
+        int best_aff = -1;
+        for (int p = 0; p < plan.n_parts; ++p) {
+            if (plan.load[p] > min_load + eps) continue;
+            int aff = 0;
+            for (size_t nb : adj[r]) {
+                if (placed[nb] && plan.owner[nb] == p) aff++;
+            }
+            if (aff > best_aff || (aff == best_aff && plan.load[p] < plan.load[best])) {
+                best = p;
+                best_aff = aff;
+            }
+        }
+        plan.owner[r] = best;
+        plan.load[best] += cost[r];
+        placed[r] = 1;
+    }
+
+    for (const auto& p : engine.bus().projections()) {
+        if (p.src_region >= n || p.dst_region >= n) continue;
+        int a = plan.owner[p.src_region], b = plan.owner[p.dst_region];
+        if (a != PartitionPlan::REPLICATED && b != PartitionPlan::REPLICATED && a != b) {
+            plan.cut_projections++;
+        }
+    }
+    return plan;
+}
+
+// =============================================================================
+// SpikeExchange
+// =============================================================================
+
+SpikeExchange::SpikeExchange(const PartitionPlan& plan, int self,
+                             std::vector<ShmSpikeRing*> out, std::vector<ShmSpikeRing*> in)
+    : plan_(plan)
+    , self_(self)
+    , out_(std::move(out))
+    , in_(std::move(in))
+    , pending_(static_cast<size_t>(plan.n_parts))
+    , got_mark_(static_cast<size_t>(plan.n_parts), 0)
+{}
+
+void SpikeExchange::drain(int peer) {
+    if (got_mark_[peer]) return;
+    ShmSpike rec;
+    while (in_[peer]->try_pop(rec)) {
+        if (rec.evt.region_id == ShmSpikeRing::WINDOW_MARK) {
+            got_mark_[peer] = 1;   // later records belong to the next window
+            return;
+        }
+        pending_[peer].push_back(rec);
+    }
+}
+
+void SpikeExchange::push(int peer, const ShmSpike& rec) {
+    while (!out_[peer]->try_push(rec)) {
+        // Ring full: make progress on our inputs so the peer can drain too
+        for (int q = 0; q < plan_.n_parts; ++q) {
+            if (q != self_) drain(q);
+        }
+        std::this_thread::yield();
+    }
+}
+
+void SpikeExchange::operator()(int32_t /*t0*/, int32_t /*n_steps*/, SpikeBus& bus) {
+    const int np = plan_.n_parts;
+    std::fill(got_mark_.begin(), got_mark_.end(), 0);
+
+    // 1. Export spikes of regions we own to every peer that runs the target
+    for (size_t r = 0; r < plan_.owner.size(); ++r) {
+        if (plan_.owner[r] != self_) continue;
+        const auto& evts = bus.staged_events(static_cast<uint32_t>(r));
+        const auto& ts   = bus.staged_steps(static_cast<uint32_t>(r));
+        for (size_t k = 0; k < evts.size(); ++k) {
+            for (int p = 0; p < np; ++p) {
+                if (p == self_ || !plan_.is_local(evts[k].dst_region, p)) continue;
+                push(p, {evts[k], ts[k]});
+                sent_++;
+            }
+        }
+    }
+    ShmSpike mark{};
+    mark.evt.region_id = ShmSpikeRing::WINDOW_MARK;
+    mark.evt.neuron_id = window_;
+    for (int p = 0; p < np; ++p) {
+        if (p != self_) push(p, mark);
+    }
+
+    // 2. Receive until every peer's window mark has arrived
+    bool done = false;
+    while (!done) {
+        done = true;
+        for (int p = 0; p < np; ++p) {
+            if (p == self_) continue;
+            drain(p);
+            if (!got_mark_[p]) done = false;
+        }
+        if (!done) std::this_thread::yield();
+    }
+
+    // 3. Stage remote spikes; end_staging merges them in lockstep order
+    for (int p = 0; p < np; ++p) {
+        for (const auto& rec : pending_[p]) bus.stage_remote(rec.evt, rec.submit_t);
+        received_ += pending_[p].size();
+        pending_[p].clear();
+    }
+    window_++;
+}
+
+// =============================================================================
+// 多进程运行
+// =============================================================================
+
+namespace {
+
+struct SharedResults {
+    uint64_t* region_events;   // [n_regions]
+    double*   part_seconds;    // [n_parts]
+    uint64_t* part_sent;       // [n_parts]
+};
+
+void run_partition(const BrainBuilder& build, const PartitionPlan& plan, int self,
+                   int32_t n_steps, float dt,
+                   std::vector<ShmSpikeRing*> out, std::vector<ShmSpikeRing*> in,
+                   SharedResults res) {
+    SimulationEngine engine;
+    build(engine);
+    engine.set_local_regions(plan.local_mask(self));
+
+    SpikeExchange exchange(plan, self, std::move(out), std::move(in));
+    const size_t n = engine.num_regions();
+
+    engine.set_window_hook([&](int32_t t0, int32_t n_win, SpikeBus& bus) {
+        // Region event counts: owner counts its regions, partition 0 the replicas
+        for (size_t r = 0; r < n; ++r) {
+            int o = plan.owner[r];
+            if (o == self || (o == PartitionPlan::REPLICATED && self == 0)) {
+                res.region_events[r] += bus.staged_events(static_cast<uint32_t>(r)).size();
+            }
+        }
+        if (plan.n_parts > 1) exchange(t0, n_win, bus);
+    });
+
+    auto t0 = std::chrono::steady_clock::now();
+    engine.run_windowed(n_steps, dt);
+    auto t1 = std::chrono::steady_clock::now();
+    res.part_seconds[self] = std::chrono::duration<double>(t1 - t0).count();
+    res.part_sent[self] = exchange.sent();
+}
+
+} // namespace
+
+PartitionRunResult run_partitioned(const BrainBuilder& build, const PartitionPlan& plan,
+                                   int32_t n_steps, float dt, size_t ring_capacity) {
+    PartitionRunResult result;
+    const int np = plan.n_parts;
+    const size_t n_regions = plan.owner.size();
+
+    // Round capacity up to a power of two
+    size_t cap = 1;
+    while (cap < ring_capacity) cap <<= 1;
+
+    // Shared layout: [results][ring 0→1][ring 0→2]...[ring np-1→np-2]
+    size_t res_bytes = n_regions * sizeof(uint64_t) + np * (sizeof(double) + sizeof(uint64_t));
+    res_bytes = (res_bytes + 63) & ~static_cast<size_t>(63);
+    size_t ring_bytes = ShmSpikeRing::bytes_for(cap);
+    size_t n_rings = static_cast<size_t>(np) * static_cast<size_t>(np - 1);
+    auto shm = SharedMemory::anonymous(res_bytes + n_rings * ring_bytes);
+    if (!shm.valid()) return result;
+
+    char* base = static_cast<char*>(shm.data());
+    std::fill(base, base + res_bytes, 0);
+    SharedResults res{
+        reinterpret_cast<uint64_t*>(base),
+        reinterpret_cast<double*>(base + n_regions * sizeof(uint64_t)),
+        reinterpret_cast<uint64_t*>(base + n_regions * sizeof(uint64_t) + np * sizeof(double))
+    };
+
+    // rings[src][dst]
+    std::vector<std::vector<ShmSpikeRing*>> rings(np, std::vector<ShmSpikeRing*>(np, nullptr));
+    std::vector<std::unique_ptr<ShmSpikeRing>> ring_store;
+    size_t k = 0;
+    for (int s = 0; s < np; ++s) {
+        for (int d = 0; d < np; ++d) {
+            if (s == d) continue;
+            ring_store.push_back(std::make_unique<ShmSpikeRing>(
+                base + res_bytes + k * ring_bytes, cap, true));
+            rings[s][d] = ring_store.back().get();
+            ++k;
+        }
+    }
+    auto ring_out = [&](int self) {
+        std::vector<ShmSpikeRing*> v(np, nullptr);
+        for (int p = 0; p < np; ++p) if (p != self) v[p] = rings[self][p];
+        return v;
+    };
+    auto ring_in = [&](int self) {
+        std::vector<ShmSpikeRing*> v(np, nullptr);
+        for (int p = 0; p < np; ++p) if (p != self) v[p] = rings[p][self];
+        return v;
+    };
+
+    if (np == 1) {
+        run_partition(build, plan, 0, n_steps, dt, ring_out(0), ring_in(0), res);
+    } else {
+#ifndef _WIN32
+        std::vector<pid_t> children;
+        for (int p = 1; p < np; ++p) {
+            pid_t pid = fork();
+            if (pid == 0) {
+#ifdef WUYUN_OPENMP
+                omp_set_num_threads(1);   // one process per partition
+#endif
+                run_partition(build, plan, p, n_steps, dt, ring_out(p), ring_in(p), res);
+                _exit(0);
+            }
+            if (pid < 0) {
+                for (pid_t c : children) kill(c, SIGKILL);
+                for (pid_t c : children) waitpid(c, nullptr, 0);
+                return result;
+            }
+            children.push_back(pid);
+        }
+        run_partition(build, plan, 0, n_steps, dt, ring_out(0), ring_in(0), res);
+        bool ok = true;
+        for (pid_t c : children) {
+            int status = 0;
+            waitpid(c, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+        }
+        if (!ok) return result;
+#else
+        return result;
+#endif
+    }
+
+    result.ok = true;
+    result.region_events.assign(res.region_events, res.region_events + n_regions);
+    result.part_seconds.assign(res.part_seconds, res.part_seconds + np);
+    for (int p = 0; p < np; ++p) result.exchanged += res.part_sent[p];
+    return result;
+}
+
+} // namespace wuyun
@@ -0,0 +1,109 @@
+#pragma once
+/**
+ * Partition — 多进程分区仿真 (同机共享内存)
+ *
+ * 单个 SimulationEngine 只能用满一个进程的核; 区域循环的 OpenMP 在 ~8 线程后
+ * 不再扩展。分区仿真把区域图切分到多个进程:
+ *
+ *   1. partition_regions(): 按每区域代价 (神经元数或实测步进耗时) 做贪心
+ *      负载均衡 (LPT), 负载相近时优先放到投射邻居多的分区以减少割边;
+ *      小型调质源区域 (VTA/LC/DRN/NBM) 在每个分区复制运行, 全局调质广播无需跨进程
+ *   2. 每个进程用同一个 BrainBuilder 构建完整大脑, 只推进本地区域
+ *   3. 同步窗口 (最小投射延迟 D) 边界处, SpikeExchange 通过共享内存无锁环
+ *      交换跨分区脉冲; 接收端按 (提交步, 源区域) 合并 — 与单进程运行逐位一致
+ *
+ * 共享内存传输是将来集群互连的本地替身: SpikeExchange 只依赖 ShmSpikeRing 接口。
+ *
+ * 平台: run_partitioned() 需要 POSIX fork; 其他平台返回 ok=false
+ */
+
+#include "engine/simulation_engine.h"
+#include "core/shm_ring.h"
+#include <functional>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace wuyun {
+
+/** 确定性大脑构建函数 (每个分区进程各调用一次, 结果须完全相同) */
+using BrainBuilder = std::function<void(SimulationEngine&)>;
+
+struct PartitionOptions {
+    std::vector<double> region_cost;        // 每区域每步代价 (空 = 神经元数)
+    std::vector<std::string> replicate;     // 额外在每个分区复制的区域
+    bool replicate_neuromod_sources = true; // 调质源区域默认复制
+};
+
+struct PartitionPlan {
+    static constexpr int REPLICATED = -1;
+
+    int n_parts = 1;
+    std::vector<int>    owner;        // 区域索引 → 分区 (REPLICATED = 每个分区都运行)
+    std::vector<double> load;         // 每分区代价和 (不含复制区域)
+    size_t cut_projections = 0;       // 跨分区投射数
+
+    bool is_local(size_t region, int part) const {
+        return owner[region] == REPLICATED || owner[region] == part;
+    }
+    std::vector<uint8_t> local_mask(int part) const;
+
+    /** 最大负载 / 平均负载 (1.0 = 完美均衡) */
+    float imbalance() const;
+};
+
+/** 实测每区域平均步进耗时 (ns); 在一个临时大脑上运行 n_steps 步 */
+std::vector<double> measure_region_costs(const BrainBuilder& build, int32_t n_steps = 100);
+
+/** 区域图分区 */
+PartitionPlan partition_regions(const SimulationEngine& engine, int n_parts,
+                                const PartitionOptions& opt = {});
+
+/**
+ * 窗口边界的跨分区脉冲交换 (作为 SimulationEngine 的 WindowHook)
+ *
+ * out[p] / in[p]: 本分区 → 分区 p / 分区 p → 本分区 的环 (p == self 为空)
+ * 协议: 先推送本窗口全部导出脉冲 + 窗口标记, 再读取各对端直到其窗口标记;
+ * 推送遇环满时先排空自己的输入环, 避免双向满环死锁。
+ */
+class SpikeExchange {
+public:
+    SpikeExchange(const PartitionPlan& plan, int self,
+                  std::vector<ShmSpikeRing*> out, std::vector<ShmSpikeRing*> in);
+
+    void operator()(int32_t t0, int32_t n_steps, SpikeBus& bus);
+
+    uint64_t sent()     const { return sent_; }
+    uint64_t received() const { return received_; }
+
+private:
+    void push(int peer, const ShmSpike& rec);
+    void drain(int peer);
+
+    const PartitionPlan& plan_;
+    int self_;
+    std::vector<ShmSpikeRing*> out_;
+    std::vector<ShmSpikeRing*> in_;
+    std::vector<std::vector<ShmSpike>> pending_;   // 每对端本窗口已收记录
+    std::vector<uint8_t> got_mark_;
+    uint32_t window_ = 0;
+    uint64_t sent_ = 0;
+    uint64_t received_ = 0;
+};
+
+struct PartitionRunResult {
+    bool ok = false;
+    std::vector<uint64_t> region_events;   // 每区域累计提交的脉冲事件 (由其所属分区统计)
+    std::vector<double>   part_seconds;    // 每分区墙钟时间
+    uint64_t exchanged = 0;                // 跨分区传输的脉冲记录数
+};
+
+/**
+ * 多进程分区运行: 分区 0 在当前进程, 其余 fork 子进程; 全部用 run_windowed()
+ * n_parts == 1 时在当前进程单独运行 (基准/对照)
+ */
+PartitionRunResult run_partitioned(const BrainBuilder& build, const PartitionPlan& plan,
+                                   int32_t n_steps, float dt = 1.0f,
+                                   size_t ring_capacity = 1u << 16);
+
+} // namespace wuyun
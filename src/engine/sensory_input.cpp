@@ -10,6 +10,7 @@ namespace wuyun {
 
 VisualInput::VisualInput(const VisualInputConfig& config)
     : config_(config)
+    , noise_rng_(config.noise_seed)
 {
     build_receptive_fields();
 }
@@ -21,7 +22,13 @@ void VisualInput::build_receptive_fields() {
 
     rf_center_x_.resize(n_lgn);
     rf_center_y_.resize(n_lgn);
-    rf_weights_.resize(n_lgn);
+
+    // 先按行收集 (pixel_idx, weight), 最后编译为 ELL
+    struct RFConnection {
+        uint32_t pixel_idx;
+        float    weight;
+    };
+    std::vector<std::vector<RFConnection>> rows(n_lgn);
 
     // Distribute LGN neuron receptive field centers across the image
     // Use a grid-like layout with some jitter
@@ -69,7 +76,7 @@ void VisualInput::build_receptive_fields() {
                 }
 
                 if (std::fabs(weight) > 0.01f) {
-                    rf_weights_[i].push_back({py * w + px, weight});
+                    rows[i].push_back({static_cast<uint32_t>(py * w + px), weight});
                 }
             }
         }
@@ -85,49 +92,96 @@ void VisualInput::build_receptive_fields() {
             rf_center_y_[i] = rf_center_y_[on_idx];
 
             // Copy ON weights but invert sign
-            for (const auto& conn : rf_weights_[on_idx]) {
-                rf_weights_[i].push_back({conn.pixel_idx, -conn.weight});
+            for (const auto& conn : rows[on_idx]) {
+                rows[i].push_back({conn.pixel_idx, -conn.weight});
             }
         }
     }
-}
 
-std::vector<float> VisualInput::encode(const std::vector<float>& pixels) const {
-    size_t n_lgn = config_.n_lgn_neurons;
-    std::vector<float> currents(n_lgn, config_.baseline);
+    // 编译为 ELL (槽主序, 填充 = 像素 0 · 权重 0)
+    ell_width_ = 0;
+    n_connections_ = 0;
+    for (const auto& row : rows) {
+        ell_width_ = std::max(ell_width_, row.size());
+        n_connections_ += row.size();
+    }
+    ell_col_.assign(ell_width_ * n_lgn, 0);
+    ell_w_.assign(ell_width_ * n_lgn, 0.0f);
+    for (size_t i = 0; i < n_lgn; ++i) {
+        for (size_t k = 0; k < rows[i].size(); ++k) {
+            ell_col_[k * n_lgn + i] = rows[i][k].pixel_idx;
+            ell_w_[k * n_lgn + i]   = rows[i][k].weight;
+        }
+    }
+}
 
-    size_t n_pixels = config_.input_width * config_.input_height;
-    if (pixels.size() < n_pixels) return currents;
+// ELL 一个槽对一帧的累加: r[i] += w[i] · px[col[i]]
+// 跨神经元无分支, 可向量化 (像素读取为 gather)。每个神经元仍按槽序 (= 原逐连接的像素序)
+// 求和, 填充槽只加 0 · px[0] = ±0 → 与逐连接循环结果逐位一致。
+static void ell_slot_pass(float* r, const float* px, const uint32_t* col, const float* w,
+                          size_t n) {
+#ifdef WUYUN_OPENMP
+    #pragma omp simd
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        r[i] += w[i] * px[col[i]];
+    }
+}
 
-    // Apply receptive field weights
-    for (size_t i = 0; i < n_lgn; ++i) {
-        float response = 0.0f;
-        for (const auto& conn : rf_weights_[i]) {
-            if (conn.pixel_idx < pixels.size()) {
-                response += conn.weight * pixels[conn.pixel_idx];
-            }
+void VisualInput::accumulate(const float* frames, size_t n_frames, float* resp) const {
+    const size_t n_lgn = config_.n_lgn_neurons;
+    const size_t n_pix = n_pixels();
+    std::fill(resp, resp + n_frames * n_lgn, 0.0f);
+    // 槽在外层: 每个槽的列/权重只读一次, 对全部帧复用
+    for (size_t k = 0; k < ell_width_; ++k) {
+        const uint32_t* col = ell_col_.data() + k * n_lgn;
+        const float* w = ell_w_.data() + k * n_lgn;
+        for (size_t f = 0; f < n_frames; ++f) {
+            ell_slot_pass(resp + f * n_lgn, frames + f * n_pix, col, w, n_lgn);
         }
-        // Scale and add to baseline
-        currents[i] += config_.gain * std::max(0.0f, response);
     }
+}
 
-    // Add noise
+void VisualInput::finish(float* currents, std::mt19937& rng) const {
+    const size_t n_lgn = config_.n_lgn_neurons;
+    for (size_t i = 0; i < n_lgn; ++i) {
+        currents[i] = config_.baseline + config_.gain * std::max(0.0f, currents[i]);
+    }
     if (config_.noise_amp > 0.0f) {
-        static std::mt19937 noise_rng(12345);
         std::uniform_real_distribution<float> noise(0.0f, config_.noise_amp);
         for (size_t i = 0; i < n_lgn; ++i) {
-            currents[i] += noise(noise_rng);
+            currents[i] += noise(rng);
         }
     }
+}
 
+std::vector<float> VisualInput::encode(const std::vector<float>& pixels) const {
+    std::vector<float> currents(config_.n_lgn_neurons, config_.baseline);
+    if (pixels.size() < n_pixels()) return currents;
+    encode_into(pixels.data(), currents.data());
     return currents;
 }
 
+void VisualInput::encode_into(const float* pixels, float* out) const {
+    accumulate(pixels, 1, out);
+    finish(out, noise_rng_);
+}
+
+void VisualInput::encode_batch(const float* frames, size_t n_frames, float* out,
+                               std::mt19937* noise) const {
+    accumulate(frames, n_frames, out);
+    const size_t n_lgn = config_.n_lgn_neurons;
+    for (size_t f = 0; f < n_frames; ++f) {
+        finish(out + f * n_lgn, noise ? noise[f] : noise_rng_);
+    }
+}
+
 void VisualInput::encode_and_inject(const std::vector<float>& pixels,
                                      BrainRegion* lgn) const {
     if (!lgn) return;
-    auto currents = encode(pixels);
-    lgn->inject_external(currents);
+    inject_buf_.assign(config_.n_lgn_neurons, config_.baseline);
+    if (pixels.size() >= n_pixels()) encode_into(pixels.data(), inject_buf_.data());
+    lgn->inject_external(inject_buf_);
 }
 
 // =============================================================================
@@ -137,6 +191,7 @@ void VisualInput::encode_and_inject(const std::vector<float>& pixels,
 AuditoryInput::AuditoryInput(const AuditoryInputConfig& config)
     : config_(config)
     , prev_spectrum_(config.n_freq_bands, 0.0f)
+    , noise_rng_(config.noise_seed)
 {
 }
 
@@ -178,10 +233,9 @@ std::vector<float> AuditoryInput::encode(const std::vector<float>& spectrum) {
 
     // Add noise
     if (config_.noise_amp > 0.0f) {
-        static std::mt19937 noise_rng(54321);
         std::uniform_real_distribution<float> noise(0.0f, config_.noise_amp);
         for (size_t i = 0; i < n_mgn; ++i) {
-            currents[i] += noise(noise_rng);
+            currents[i] += noise(noise_rng_);
         }
     }
 
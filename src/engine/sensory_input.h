@@ -23,6 +23,7 @@
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <random>
 
 namespace wuyun {
 
@@ -45,6 +46,7 @@ struct VisualInputConfig {
     float gain           = 40.0f; // 电流增益 (像素强度 → nA)
     float baseline       = 5.0f;  // 基线电流 (自发活动)
     float noise_amp      = 2.0f;  // 随机噪声幅度
+    uint32_t noise_seed  = 12345; // 编码器自身噪声流种子 (每个实例独立)
 
     // ON/OFF 通道
     bool on_off_channels = true;  // true: 前半LGN=ON, 后半=OFF
@@ -62,6 +64,26 @@ public:
      */
     std::vector<float> encode(const std::vector<float>& pixels) const;
 
+    /**
+     * 无分配编码: pixels[0 .. n_pixels) → out[0 .. n_lgn)
+     * 噪声取自编码器自身的流 (与 encode 同一序列)
+     */
+    void encode_into(const float* pixels, float* out) const;
+
+    /**
+     * 批量编码 (集成 / VecEnv 的 N 个智能体一次编码)
+     *
+     * 感受野矩阵逐槽读取一次, 对全部帧复用 (稀疏矩阵 × 帧矩阵)。
+     * 帧 f 的结果与用同一噪声流单独 encode_into 该帧逐位一致。
+     *
+     * @param frames    [n_frames × n_pixels] 行优先 (如 VecEnv::observe_all())
+     * @param out       [n_frames × n_lgn] 行优先
+     * @param noise     每帧一个噪声流 (长度 n_frames, 各智能体各自的流);
+     *                  nullptr = 各帧依次取编码器自身的流
+     */
+    void encode_batch(const float* frames, size_t n_frames, float* out,
+                      std::mt19937* noise = nullptr) const;
+
     /**
      * 编码并直接注入到 LGN 区域
      */
@@ -73,21 +95,34 @@ public:
     size_t n_pixels()     const { return config_.input_width * config_.input_height; }
     size_t n_lgn()        const { return config_.n_lgn_neurons; }
 
+    /** ELL 宽度 (最长感受野的连接数) 与有效连接总数 */
+    size_t rf_width()       const { return ell_width_; }
+    size_t n_connections()  const { return n_connections_; }
+
     const VisualInputConfig& config() const { return config_; }
 
 private:
     VisualInputConfig config_;
 
-    // 预计算: 像素→LGN 权重矩阵 (center-surround receptive fields)
-    // rf_weights_[lgn_idx] = vector of (pixel_idx, weight) pairs
-    struct RFConnection {
-        size_t pixel_idx;
-        float  weight;
-    };
-    std::vector<std::vector<RFConnection>> rf_weights_;
+    // 预计算: 像素→LGN 权重矩阵 (center-surround receptive fields), ELL 格式
+    // 槽主序: 第 k 个槽的 n_lgn 个条目连续存放, ell_col_[k*n_lgn + i] / ell_w_[k*n_lgn + i]
+    // = 神经元 i 的第 k 个连接 (按像素序); 不足 ell_width_ 的行以 (像素 0, 权重 0) 填充。
+    // 感受野半径有界, 行长相近 → 填充很少, 内层循环跨神经元连续、无分支
+    size_t ell_width_ = 0;
+    size_t n_connections_ = 0;
+    std::vector<uint32_t> ell_col_;
+    std::vector<float>    ell_w_;
 
     void build_receptive_fields();
 
+    // 累加感受野响应: resp[f*n_lgn + i] = Σ_k w · frames[f*n_pixels + col]
+    void accumulate(const float* frames, size_t n_frames, float* resp) const;
+    // 响应 → 电流 (基线 + 增益 · 整流 + 噪声), 原地
+    void finish(float* currents, std::mt19937& rng) const;
+
+    mutable std::mt19937 noise_rng_;
+    mutable std::vector<float> inject_buf_;  // encode_and_inject 复用
+
     // LGN 神经元的感受野中心位置 (像素空间)
     std::vector<float> rf_center_x_;
     std::vector<float> rf_center_y_;
@@ -105,6 +140,7 @@ struct AuditoryInputConfig {
     float baseline        = 3.0f;  // 基线电流
     float noise_amp       = 1.5f;  // 噪声
     float temporal_decay  = 0.7f;  // 时间平滑 (onset emphasis)
+    uint32_t noise_seed   = 54321; // 编码器自身噪声流种子 (每个实例独立)
 };
 
 class AuditoryInput {
@@ -132,6 +168,7 @@ public:
 private:
     AuditoryInputConfig config_;
     std::vector<float> prev_spectrum_;  // 上一帧 (onset 检测)
+    std::mt19937 noise_rng_;
 };
 
 } // namespace wuyun
@@ -1,9 +1,11 @@
 #include "engine/simulation_engine.h"
+#include "engine/spike_raster.h"
 #include "region/neuromod/vta_da.h"
 #include "region/neuromod/lc_ne.h"
 #include "region/neuromod/drn_5ht.h"
 #include "region/neuromod/nbm_ach.h"
 #include <algorithm>
+#include <chrono>
 
 #ifdef WUYUN_OPENMP
 #include <omp.h>
@@ -13,11 +15,20 @@ namespace wuyun {
 
 SimulationEngine::SimulationEngine(int32_t max_delay)
     : bus_(max_delay)
-{}
+{
+    // 内置慢时钟 (02 文档 §7.1): 振荡 10 ms, 调质 10 ms
+    clocks_.push_back({CLOCK_OSCILLATION, 10, 0, ClockKind::OSCILLATION, {}});
+    clocks_.push_back({CLOCK_NEUROMOD,    10, 0, ClockKind::NEUROMOD,    {}});
+}
 
 void SimulationEngine::add_region(std::unique_ptr<BrainRegion> region) {
     region->register_to_bus(bus_);
+    region->set_external_clocks(true);
     regions_.push_back(std::move(region));
+
+    std::vector<std::string> names;
+    for (const auto& r : regions_) names.push_back(r->name());
+    profiler_.set_regions(names);
 }
 
 BrainRegion* SimulationEngine::find_region(const std::string& name) {
@@ -43,36 +54,65 @@ void SimulationEngine::run(int32_t n_steps, float dt) {
     }
 }
 
+namespace {
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
 void SimulationEngine::step(float dt) {
-    // 1. Deliver arriving spikes to each region
-    for (auto& region : regions_) {
-        auto events = bus_.get_arriving_spikes(region->region_id(), t_);
-        if (!events.empty()) {
-            region->receive_spikes(events);
+    WUYUN_PROF_SCOPE(&profiler_, "engine.step");
+    const int64_t tele_t0 = telemetry_ ? steady_ns() : 0;
+
+    // 1. Deliver arriving spikes to each region (frozen regions drop theirs)
+    {
+        WUYUN_PROF_SCOPE(&profiler_, "engine.deliver");
+        for (size_t i = 0; i < regions_.size(); ++i) {
+            if (frozen(i)) continue;
+            auto& region = regions_[i];
+            auto events = bus_.get_arriving_spikes(region->region_id(), t_);
+            if (!events.empty()) {
+                WUYUN_PROF_COUNT(profiler_, i, spikes_in, events.size());
+                region->wake();
+                region->receive_spikes(events);
+            }
         }
     }
 
-    // 2. Each region steps internally (OpenMP parallel — regions are independent within a step)
+    // 2. Each region steps internally (parallel — regions are independent within a step)
     {
-        int n_regions = static_cast<int>(regions_.size());
-#ifdef WUYUN_OPENMP
-        #pragma omp parallel for schedule(dynamic)
-#endif
-        for (int i = 0; i < n_regions; ++i) {
-            regions_[i]->step(t_, dt);
-        }
+        WUYUN_PROF_SCOPE(&profiler_, "engine.regions");
+        for_each_local_region([&](size_t i) {
+            auto& region = *regions_[i];
+            if (skip_quiescent_) {
+                if (region.skip_if_quiescent(dt)) return;
+                region.wake();
+            }
+            WUYUN_PROF_REGION(profiler_, i);
+            region.step(t_, dt);
+        }, 1);
     }
 
-    // 3. Collect neuromodulator levels and broadcast to all regions
-    collect_and_broadcast_neuromod();
+    // 3. Slow clocks (oscillation, neuromodulation, user-registered)
+    run_clocks(dt);
 
     // 4. Each region submits outgoing spikes
-    for (auto& region : regions_) {
-        region->submit_spikes(bus_, t_);
+    {
+        WUYUN_PROF_SCOPE(&profiler_, "engine.submit");
+        for (size_t i = 0; i < regions_.size(); ++i) {
+            if (!is_active(i)) continue;
+            regions_[i]->submit_spikes(bus_, t_);
+            count_spikes_out(i);
+            if (recorder_) recorder_->capture(i, t_, regions_[i]->fired());
+        }
     }
 
     // 5. Advance bus (clear expired slots)
-    bus_.advance(t_);
+    {
+        WUYUN_PROF_SCOPE(&profiler_, "engine.bus_advance");
+        bus_.advance(t_);
+    }
 
     // 6. Callback
     if (callback_) {
@@ -80,6 +120,379 @@ void SimulationEngine::step(float dt) {
     }
 
     t_++;
+    if (recorder_) recorder_->end_step(t_);
+    if (telemetry_) telemetry_tick(tele_t0, 1);
+}
+
+void SimulationEngine::count_spikes_out(size_t i) {
+    bool prof = false;
+#ifdef WUYUN_PROFILE
+    prof = profiler_.enabled();
+#endif
+    const bool tele = telemetry_ && i < TELEMETRY_MAX_REGIONS;
+    if (!prof && !tele) return;
+    const auto& fired = regions_[i]->fired();
+    const auto n = static_cast<uint64_t>(
+        std::count_if(fired.begin(), fired.end(), [](uint8_t f) { return f != 0; }));
+#ifdef WUYUN_PROFILE
+    if (prof) profiler_.region(i).spikes_out += n;
+#endif
+    if (tele) telemetry_->staging().spikes[i] += static_cast<uint32_t>(n);
+}
+
+// =============================================================================
+// 实时遥测
+// =============================================================================
+
+bool SimulationEngine::enable_telemetry(const std::string& name, int32_t every, size_t capacity) {
+    std::vector<std::string> names;
+    for (const auto& r : regions_) names.push_back(r->name());
+    telemetry_ = TelemetryWriter::create(name, names, static_cast<uint32_t>(std::max<int32_t>(every, 1)),
+                                         capacity);
+    telemetry_steps_ = 0;
+    telemetry_us_ = 0.0;
+    return telemetry_ != nullptr;
+}
+
+void SimulationEngine::telemetry_tick(int64_t t0_ns, int32_t steps) {
+    TelemetryFrame& f = telemetry_->staging();
+    double us = static_cast<double>(steady_ns() - t0_ns) * 1e-3;
+    telemetry_us_ += us;
+    telemetry_steps_ += steps;
+    f.step_us_max = std::max(f.step_us_max, static_cast<float>(us / steps));
+    if (telemetry_steps_ < static_cast<int32_t>(telemetry_->publish_every())) return;
+
+    f.step = t_;
+    f.window_steps = static_cast<uint32_t>(telemetry_steps_);
+    f.step_us_mean = static_cast<float>(telemetry_us_ / telemetry_steps_);
+    f.da  = global_neuromod_.da;
+    f.ne  = global_neuromod_.ne;
+    f.sht = global_neuromod_.sht;
+    f.ach = global_neuromod_.ach;
+    telemetry_->publish();
+
+    std::fill(std::begin(f.spikes), std::end(f.spikes), 0u);
+    f.step_us_max = 0.0f;
+    telemetry_steps_ = 0;
+    telemetry_us_ = 0.0;
+}
+
+// =============================================================================
+// 多速率时钟
+// =============================================================================
+
+size_t SimulationEngine::register_clock(const std::string& name, int32_t period,
+                                        ClockCallback cb, int32_t phase) {
+    period = std::max<int32_t>(1, period);
+    clocks_.push_back({name, period, phase % period, ClockKind::USER, std::move(cb)});
+    return clocks_.size() - 1;
+}
+
+bool SimulationEngine::set_clock_period(const std::string& name, int32_t period) {
+    for (auto& c : clocks_) {
+        if (c.name == name) {
+            c.period = std::max<int32_t>(1, period);
+            c.phase %= c.period;
+            return true;
+        }
+    }
+    return false;
+}
+
+int32_t SimulationEngine::clock_period(const std::string& name) const {
+    for (const auto& c : clocks_) {
+        if (c.name == name) return c.period;
+    }
+    return 0;
+}
+
+void SimulationEngine::run_clocks(float dt) {
+    WUYUN_PROF_SCOPE(&profiler_, "engine.clocks");
+    for (auto& c : clocks_) {
+        if (t_ % c.period != c.phase) continue;
+        float clock_dt = dt * static_cast<float>(c.period);
+        switch (c.kind) {
+            case ClockKind::OSCILLATION:
+                for (size_t i = 0; i < regions_.size(); ++i) {
+                    if (!frozen(i)) regions_[i]->step_oscillation(clock_dt);
+                }
+                break;
+            case ClockKind::NEUROMOD: {
+                WUYUN_PROF_SCOPE(&profiler_, "engine.neuromod");
+                for (size_t i = 0; i < regions_.size(); ++i) {
+                    if (!frozen(i)) regions_[i]->step_neuromod(clock_dt);
+                }
+                collect_and_broadcast_neuromod();
+                break;
+            }
+            case ClockKind::USER:
+                if (c.fn) c.fn(t_, clock_dt);
+                break;
+        }
+    }
+}
+
+// =============================================================================
+// 保守同步窗口
+// =============================================================================
+
+void SimulationEngine::run_windowed(int32_t n_steps, float dt, int32_t window) {
+    int32_t d_min = bus_.min_delay();
+    int32_t w = (window <= 0) ? d_min : std::min(window, d_min);
+    w = std::max<int32_t>(1, std::min(w, bus_.max_delay()));
+    if (w <= 1 && !window_hook_) {
+        run(n_steps, dt);
+        return;
+    }
+
+    int32_t done = 0;
+    while (done < n_steps) {
+        int32_t n = std::min(w, n_steps - done);
+        step_window(n, dt);
+        done += n;
+    }
+}
+
+void SimulationEngine::step_window(int32_t n_steps, float dt) {
+    WUYUN_PROF_SCOPE(&profiler_, "engine.window");
+    const int32_t t0 = t_;
+    const int64_t tele_t0 = telemetry_ ? steady_ns() : 0;
+
+    // Regions advance independently: bus reads are const, submits are staged
+    bus_.begin_staging();
+    for_each_local_region([&](size_t i) {
+        thread_local std::vector<SpikeEvent> inbox;
+        auto& region = *regions_[i];
+        for (int32_t k = 0; k < n_steps; ++k) {
+            int32_t t = t0 + k;
+            bus_.collect_arriving_spikes(region.region_id(), t, inbox);
+            if (!inbox.empty()) {
+                WUYUN_PROF_COUNT(profiler_, i, spikes_in, inbox.size());
+                region.wake();
+                region.receive_spikes(inbox);
+            }
+            if (skip_quiescent_ && region.skip_if_quiescent(dt)) continue;
+            region.wake();
+            {
+                WUYUN_PROF_REGION(profiler_, i);
+                region.step(t, dt);
+            }
+            region.submit_spikes(bus_, t);
+            count_spikes_out(i);
+            if (recorder_) recorder_->capture(i, t, region.fired());
+        }
+    }, n_steps);
+    if (window_hook_) {
+        window_hook_(t0, n_steps, bus_);
+    }
+    bus_.end_staging(t0, n_steps);
+
+    // Slow clocks that fell inside the window, in step order
+    for (int32_t k = 0; k < n_steps; ++k) {
+        t_ = t0 + k;
+        run_clocks(dt);
+    }
+
+    if (callback_) {
+        callback_(t_, *this);
+    }
+
+    t_ = t0 + n_steps;
+    if (recorder_) recorder_->end_step(t_);
+    if (telemetry_) telemetry_tick(tele_t0, n_steps);
+}
+
+// =============================================================================
+// 执行掩码
+// =============================================================================
+
+void SimulationEngine::define_mask(const std::string& name,
+                                   const std::vector<std::string>& regions,
+                                   const std::vector<std::string>& projections) {
+    ExecMask mask;
+    mask.name = name;
+    mask.regions.assign(regions_.size(), 0);
+    for (const auto& rn : regions) {
+        for (size_t i = 0; i < regions_.size(); ++i) {
+            if (regions_[i]->name() == rn) mask.regions[i] = 1;
+        }
+    }
+
+    // region_id → 下标 (投射端点按 region_id 记录)
+    std::vector<int> index_of(bus_.num_regions(), -1);
+    for (size_t i = 0; i < regions_.size(); ++i) {
+        uint32_t id = regions_[i]->region_id();
+        if (id < index_of.size()) index_of[id] = static_cast<int>(i);
+    }
+    auto enabled = [&](uint32_t id) {
+        return id < index_of.size() && index_of[id] >= 0 && mask.regions[index_of[id]];
+    };
+
+    const auto& projs = bus_.projections();
+    mask.projections.assign(projs.size(), 0);
+    for (size_t p = 0; p < projs.size(); ++p) {
+        bool listed = projections.empty() ||
+            std::find(projections.begin(), projections.end(), projs[p].name) != projections.end();
+        mask.projections[p] = (listed && enabled(projs[p].src_region) && enabled(projs[p].dst_region)) ? 1 : 0;
+    }
+
+    for (auto& m : masks_) {
+        if (m.name == name) {
+            m = std::move(mask);
+            if (active_mask_ == name) {             // 重新应用
+                active_mask_.clear();
+                use_mask(name);
+            }
+            return;
+        }
+    }
+    masks_.push_back(std::move(mask));
+}
+
+bool SimulationEngine::use_mask(const std::string& name) {
+    if (name == active_mask_) return true;
+    if (name.empty()) {
+        active_mask_.clear();
+        exec_regions_.clear();
+        bus_.set_projection_mask({});
+        return true;
+    }
+    for (const auto& m : masks_) {
+        if (m.name != name) continue;
+        active_mask_   = name;
+        exec_regions_  = m.regions;
+        bus_.set_projection_mask(m.projections);
+        return true;
+    }
+    return false;
+}
+
+void SimulationEngine::set_quiescence_skipping(bool enable) {
+    skip_quiescent_ = enable;
+    if (!enable) {
+        for (auto& r : regions_) r->wake();
+    }
+}
+
+void SimulationEngine::set_weight_format(WeightFormat fmt) {
+    for (auto& r : regions_) r->set_weight_format(fmt);
+}
+
+size_t SimulationEngine::compact_synapses() {
+    size_t removed = 0;
+    for (auto& r : regions_) removed += r->compact_synapses();
+    return removed;
+}
+
+// =============================================================================
+// 区域并行: OpenMP 或常驻线程池
+// =============================================================================
+
+void SimulationEngine::use_worker_pool(int n_threads, int32_t rebalance_interval, bool pin) {
+    pool_.reset();
+    region_thread_.clear();
+    thread_regions_.clear();
+    wide_regions_.clear();
+    if (n_threads <= 0) return;
+
+    pool_ = std::make_unique<WorkerPool>(n_threads, pin);
+    rebalance_interval_ = std::max<int32_t>(1, rebalance_interval);
+    rebalance_worker_pool();
+}
+
+void SimulationEngine::rebalance_worker_pool() {
+    if (!pool_) return;
+    const size_t n = regions_.size();
+    const size_t nt = static_cast<size_t>(pool_->size());
+    region_cost_.resize(n, 0.0);
+
+    // 未测量的区域按神经元数估计, 换算系数取已测量区域的平均 ns/神经元
+    double measured_ns = 0.0, measured_neurons = 0.0;
+    bool any_unmeasured = false;
+    for (size_t i = 0; i < n; ++i) {
+        if (region_cost_[i] > 0.0) {
+            measured_ns += region_cost_[i];
+            measured_neurons += static_cast<double>(regions_[i]->n_neurons());
+        } else {
+            any_unmeasured = true;
+        }
+    }
+    double ns_per_neuron = (measured_neurons > 0.0) ? measured_ns / measured_neurons : 1.0;
+
+    std::vector<size_t> order;
+    std::vector<double> cost(n, 0.0);
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!is_local(i)) continue;
+        cost[i] = (region_cost_[i] > 0.0)
+                ? region_cost_[i]
+                : static_cast<double>(regions_[i]->n_neurons() + 1) * ns_per_neuron;
+        total += cost[i];
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return cost[a] > cost[b]; });
+
+    // LPT: 大区域单独步进, 其余依次放到当前负载最小的线程
+    region_thread_.assign(n, -1);
+    thread_regions_.assign(nt, {});
+    wide_regions_.clear();
+    std::vector<double> load(nt, 0.0);
+    for (size_t i : order) {
+        if (nt > 1 && cost[i] > total / static_cast<double>(nt)) {
+            region_thread_[i] = WIDE_REGION;
+            wide_regions_.push_back(i);
+            continue;
+        }
+        size_t best = static_cast<size_t>(
+            std::min_element(load.begin(), load.end()) - load.begin());
+        load[best] += cost[i];
+        region_thread_[i] = static_cast<int>(best);
+        thread_regions_[best].push_back(i);
+    }
+
+    // 仍有未测量区域时, 短暂预热后再分配一次
+    steps_since_rebalance_ = any_unmeasured ? std::max<int32_t>(0, rebalance_interval_ - 10) : 0;
+}
+
+void SimulationEngine::for_each_local_region(const std::function<void(size_t)>& fn,
+                                             int32_t steps) {
+    if (!pool_) {
+        int n_regions = static_cast<int>(regions_.size());
+#ifdef WUYUN_OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < n_regions; ++i) {
+            if (!is_active(static_cast<size_t>(i))) continue;
+            fn(static_cast<size_t>(i));
+        }
+        return;
+    }
+
+    if (region_thread_.size() != regions_.size()) rebalance_worker_pool();
+
+    // 每区域只由一个线程执行, region_cost_[i] 无竞争
+    // 冻结区域不计时 (保留其代价, 静态分配不随掩码切换重算)
+    auto timed = [&](size_t i) {
+        if (frozen(i)) return;
+        auto start = std::chrono::steady_clock::now();
+        fn(i);
+        double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / static_cast<double>(steps);
+        double& c = region_cost_[i];
+        c = (c > 0.0) ? c + 0.1 * (ns - c) : std::max(ns, 1.0);
+    };
+
+    pool_->run([&](int tid) {
+        for (size_t i : thread_regions_[static_cast<size_t>(tid)]) timed(i);
+    });
+    if (!wide_regions_.empty()) {
+        WorkerPool::IntraScope scope(pool_.get());
+        for (size_t i : wide_regions_) timed(i);
+    }
+
+    steps_since_rebalance_ += steps;
+    if (steps_since_rebalance_ >= rebalance_interval_) rebalance_worker_pool();
 }
 
 SimStats SimulationEngine::stats() const {
@@ -98,40 +511,44 @@ SimStats SimulationEngine::stats() const {
 void SimulationEngine::register_neuromod_source(const std::string& region_name,
                                                   NeuromodType type) {
     auto* r = find_region(region_name);
-    if (r) {
-        neuromod_sources_.push_back({r, type});
+    if (!r) return;
+    size_t idx = 0;
+    while (regions_[idx].get() != r) ++idx;
+
+    // Resolve the typed output getter once; the per-step path is a plain call
+    std::function<float()> read;
+    switch (type) {
+        case NeuromodType::DA:
+            if (auto* vta = dynamic_cast<VTA_DA*>(r)) read = [vta] { return vta->da_output(); };
+            break;
+        case NeuromodType::NE:
+            if (auto* lc = dynamic_cast<LC_NE*>(r)) read = [lc] { return lc->ne_output(); };
+            break;
+        case NeuromodType::SHT:
+            if (auto* drn = dynamic_cast<DRN_5HT*>(r)) read = [drn] { return drn->sht_output(); };
+            break;
+        case NeuromodType::ACh:
+            if (auto* nbm = dynamic_cast<NBM_ACh*>(r)) read = [nbm] { return nbm->ach_output(); };
+            break;
     }
+    if (!read) read = [] { return 0.0f; };
+    neuromod_sources_.push_back({std::move(read), type, region_name, idx});
+}
+
+std::vector<std::string> SimulationEngine::neuromod_source_names() const {
+    std::vector<std::string> names;
+    for (const auto& src : neuromod_sources_) names.push_back(src.name);
+    return names;
 }
 
 void SimulationEngine::collect_and_broadcast_neuromod() {
     if (neuromod_sources_.empty()) return;
 
     // Collect output levels from registered source regions
+    // (冻结的源输出停在冻结时刻, 不参与采集; 冻结区域也不接收广播)
     for (const auto& src : neuromod_sources_) {
-        float level = 0.0f;
-        switch (src.type) {
-            case NeuromodType::DA: {
-                auto* vta = dynamic_cast<VTA_DA*>(src.region);
-                if (vta) level = vta->da_output();
-                break;
-            }
-            case NeuromodType::NE: {
-                auto* lc = dynamic_cast<LC_NE*>(src.region);
-                if (lc) level = lc->ne_output();
-                break;
-            }
-            case NeuromodType::SHT: {
-                auto* drn = dynamic_cast<DRN_5HT*>(src.region);
-                if (drn) level = drn->sht_output();
-                break;
-            }
-            case NeuromodType::ACh: {
-                auto* nbm = dynamic_cast<NBM_ACh*>(src.region);
-                if (nbm) level = nbm->ach_output();
-                break;
-            }
-        }
-
+        if (frozen(src.region)) continue;
+        float level = src.read();
         switch (src.type) {
             case NeuromodType::DA:  global_neuromod_.da  = level; break;
             case NeuromodType::NE:  global_neuromod_.ne  = level; break;
@@ -141,8 +558,9 @@ void SimulationEngine::collect_and_broadcast_neuromod() {
     }
 
     // Broadcast to all regions' NeuromodulatorSystem
-    for (auto& region : regions_) {
-        region->neuromod().set_tonic(global_neuromod_);
+    for (size_t i = 0; i < regions_.size(); ++i) {
+        if (frozen(i)) continue;
+        regions_[i]->neuromod().set_tonic(global_neuromod_);
     }
 }
 
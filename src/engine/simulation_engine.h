@@ -8,16 +8,21 @@
  *   3. 编排 SpikeBus 脉冲收发
  *   4. 每步循环: 收脉冲 → 区域计算 → 发脉冲 → 推进总线
  *
- * 时钟层级 (02 文档 §7.1):
- *   脉冲时钟: 1 ms  (每步)
- *   振荡时钟: 10 ms (由各 Region 内部 OscillationTracker 处理)
- *   调制时钟: 100 ms (由 NeuromodulatorSystem 处理)
+ * 时钟层级 (02 文档 §7.1), 多速率调度:
+ *   脉冲时钟: 1 ms  (每步: 收发脉冲 + Region::step)
+ *   振荡时钟: 每 10 步 (各 Region 的 OscillationTracker, dt×10)
+ *   调制时钟: 每 10 步 (phasic 衰减 + 调质源采集/广播, dt×10)
+ *   其它慢过程可通过 register_clock() 以自己的周期注册
+ *   (Region 内部的稳态发放率/巩固衰减使用各自 config 的 interval)
  *
  * 设计文档: docs/02_neuron_system_design.md §7.2
  */
 
 #include "core/spike_bus.h"
 #include "core/neuromodulator.h"
+#include "core/worker_pool.h"
+#include "core/profiler.h"
+#include "core/telemetry.h"
 #include "region/brain_region.h"
 #include <vector>
 #include <memory>
@@ -40,8 +45,16 @@ struct SimStats {
  * @param engine 引擎引用
  */
 class SimulationEngine;
+class SpikeRasterWriter;
 using StepCallback = std::function<void(int32_t t, SimulationEngine& engine)>;
 
+/**
+ * 慢时钟回调
+ * @param t   当前时间步
+ * @param dt  该时钟周期覆盖的时长 (ms) = 步长 × period
+ */
+using ClockCallback = std::function<void(int32_t t, float dt)>;
+
 class SimulationEngine {
 public:
     /**
@@ -75,15 +88,178 @@ public:
     /** 运行单步 */
     void step(float dt = 1.0f);
 
-    /** 设置每步回调 */
+    /**
+     * 保守同步窗口运行 (conservative PDES)
+     *
+     * 所有跨区域投射延迟 >= D 时, 窗口 [t, t+D) 内提交的脉冲最早在 t+D 到达,
+     * 因此各区域 (各自线程) 可独立推进 D 步, 窗口结束时统一交换脉冲:
+     * 屏障次数减少 D 倍。脉冲路由结果与逐步 step() 完全一致。
+     *
+     * 与 step() 的差异: 慢时钟在窗口结束后按步补跑 (区域看到的广播最多滞后 D-1 步);
+     * 每步回调仅在窗口末触发一次。窗口中途不能注入外部输入。
+     *
+     * @param window  窗口步数, 0 = 自动取最小投射延迟; 超过最小延迟时截断
+     */
+    void run_windowed(int32_t n_steps, float dt = 1.0f, int32_t window = 0);
+
+    /** 最小跨区域投射延迟 (同步窗口上限) */
+    int32_t min_projection_delay() const { return bus_.min_delay(); }
+
+    // --- 分区运行 (多进程, 见 engine/partition.h) ---
+
+    /** 只推进本地区域 (mask[i] != 0); 空 mask = 全部本地 */
+    void set_local_regions(std::vector<uint8_t> mask) {
+        local_mask_ = std::move(mask);
+        region_thread_.clear();   // 线程池分配在下一步重算
+    }
+    bool is_local(size_t i) const { return local_mask_.empty() || local_mask_[i]; }
+
+    /**
+     * 同步窗口交换钩子: 窗口内各区域计算完成后、暂存脉冲合并前调用,
+     * 用于导出/导入跨分区脉冲 (设置后即使窗口为 1 也走窗口路径)
+     */
+    using WindowHook = std::function<void(int32_t t0, int32_t n_steps, SpikeBus& bus)>;
+    void set_window_hook(WindowHook hook) { window_hook_ = std::move(hook); }
+
+    // --- 执行掩码 (按阶段只推进部分脑区) ---
+
+    /**
+     * 定义命名执行掩码: 启用 regions 中的区域, 其余区域冻结
+     * (不收脉冲、不 step、不发脉冲、不跑振荡/调质时钟, 状态原样保留, 零开销)。
+     * projections 为空 = 两端都启用的全部投射; 否则只路由列出的投射名
+     * (add_projection 的 proj_name, 默认 "src->dst")。未找到的名字忽略。
+     * 冻结期间到达冻结区域的脉冲被丢弃。重复定义同名掩码覆盖旧定义。
+     */
+    void define_mask(const std::string& name, const std::vector<std::string>& regions,
+                     const std::vector<std::string>& projections = {});
+
+    /** 切换到命名掩码; 空名 = 全脑 (默认); 未定义返回 false 且不改变当前掩码 */
+    bool use_mask(const std::string& name);
+    void clear_mask() { use_mask(""); }
+
+    /** 当前掩码名 (全脑为空串) */
+    const std::string& active_mask() const { return active_mask_; }
+
+    /** 区域在本步推进: 本地 (分区) 且未被执行掩码冻结 */
+    bool is_active(size_t i) const {
+        return is_local(i) && !frozen(i);
+    }
+    bool frozen(size_t i) const {
+        return !exec_regions_.empty() && (i >= exec_regions_.size() || !exec_regions_[i]);
+    }
+
+    // --- 常驻线程池 (见 core/worker_pool.h) ---
+
+    /**
+     * 用常驻线程池代替每步的 omp parallel for 推进区域
+     *
+     * 每区域步进耗时在线测量 (EMA); 每 rebalance_interval 步按代价做 LPT,
+     * 得到静态的 区域→线程 分配 (初始代价 = 神经元数)。
+     * 代价超过 总代价/线程数 的大区域不参与静态分配: 在其余区域并行完成后
+     * 逐个单独步进, 其神经元循环由同一个池分块执行 (无嵌套并行)。
+     * 结果与 step() 逐位一致。
+     *
+     * @param n_threads  总线程数 (含调用线程); <= 0 关闭线程池, 恢复 OpenMP
+     * @param pin        工作线程绑核 (见 WorkerPool; 多引擎同进程时勿开)
+     */
+    void use_worker_pool(int n_threads, int32_t rebalance_interval = 1000, bool pin = false);
+
+    int worker_threads() const { return pool_ ? pool_->size() : 0; }
+
+    /** 区域步进耗时 EMA (ns/步; 线程池启用后才测量) */
+    double region_cost_ns(size_t i) const { return i < region_cost_.size() ? region_cost_[i] : 0.0; }
+
+    /** 区域当前分配的线程 (WIDE_REGION = 单独步进的大区域; 未启用线程池为 -1) */
+    static constexpr int WIDE_REGION = -2;
+    int region_thread(size_t i) const { return i < region_thread_.size() ? region_thread_[i] : -1; }
+
+    /** 立即按当前代价重新分配 */
+    void rebalance_worker_pool();
+
+    // --- 静息区域跳过 ---
+
+    /**
+     * 开启后, 本步无到达脉冲且 BrainRegion::quiescent() 的区域不计算;
+     * 有输入到达或不再静息时先 catch_up() 解析补齐再逐步。
+     * 默认关闭 (逐步精确); 关闭时立即补齐所有区域
+     */
+    void set_quiescence_skipping(bool enable);
+    bool quiescence_skipping() const { return skip_quiescent_; }
+
+    /**
+     * 所有区域突触权重的存储格式 (默认 FP32)
+     * BF16: 权重流量减半, STDP/小脑 LTD 写回随机舍入; 基底节 ctx→MSN 权重表不受影响
+     */
+    void set_weight_format(WeightFormat fmt);
+
+    /**
+     * 压缩所有区域中结构可塑性已剪除的突触 (重建 CSR)
+     * 开销与突触数成正比, 放在睡眠巩固等离线阶段; 返回移出总数
+     */
+    size_t compact_synapses();
+
+    /**
+     * 热路径剖析 (见 core/profiler.h): profiler().enable() 后记录
+     * 各阶段 (deliver / regions / clocks / neuromod / submit / bus_advance) 耗时
+     * 和每区域 step 耗时、收发脉冲、突触事件、可塑性更新; 编译期关闭时无数据
+     */
+    Profiler&       profiler()       { return profiler_; }
+    const Profiler& profiler() const { return profiler_; }
+
+    /** 设置每步回调 (在热路径上同步执行; 只做监控用途时改用遥测) */
     void set_callback(StepCallback cb) { callback_ = std::move(cb); }
 
+    // --- 实时遥测 ---
+
+    /**
+     * 启用实时遥测 (见 core/telemetry.h): 每 every 步向命名共享内存段发布一帧
+     * (每区域发放数、全局调质、步耗时均值/最大值), 外部读者随时 attach/detach。
+     * 启用后每步多一次计时与每区域 fired 计数, 发布为一次 memcpy, 不等待读者。
+     * 区域表在启用时固定, 之后添加的区域不在帧中; 共享内存不可用时返回 false
+     */
+    bool enable_telemetry(const std::string& name, int32_t every = 100, size_t capacity = 1024);
+    void disable_telemetry() { telemetry_.reset(); }
+
+    /** 遥测写端 (未启用为 nullptr); 上层 (ClosedLoopAgent) 经 staging() 补充自己的字段 */
+    TelemetryWriter*       telemetry()       { return telemetry_.get(); }
+    const TelemetryWriter* telemetry() const { return telemetry_.get(); }
+
+    /**
+     * 流式脉冲录制 (见 engine/spike_raster.h): 各区域提交脉冲后 capture 其发放,
+     * 每步 (窗口运行为每窗口) 末 end_step。调用方持有 writer, 先 open 再设置; nullptr 停止
+     */
+    void set_spike_recorder(SpikeRasterWriter* writer) { recorder_ = writer; }
+    SpikeRasterWriter* spike_recorder() const { return recorder_; }
+
+    // --- 多速率时钟 ---
+
+    /** 内置时钟名 */
+    static constexpr const char* CLOCK_OSCILLATION = "oscillation";
+    static constexpr const char* CLOCK_NEUROMOD    = "neuromod";
+
+    /**
+     * 注册慢时钟: 每 period 步 (t % period == phase) 调用一次, dt 按 period 放大
+     * 在所有 Region::step 之后、提交脉冲之前执行, 按注册顺序
+     * @return 时钟索引
+     */
+    size_t register_clock(const std::string& name, int32_t period, ClockCallback cb,
+                          int32_t phase = 0);
+
+    /** 修改时钟周期 (period=1 即逐步运行); 未找到返回 false */
+    bool set_clock_period(const std::string& name, int32_t period);
+
+    /** 查询时钟周期 (未找到返回 0) */
+    int32_t clock_period(const std::string& name) const;
+
     // --- 神经调质广播 ---
 
     /** 注册神经调质源区域 (DA=VTA, NE=LC, 5-HT=DRN, ACh=NBM) */
     enum class NeuromodType { DA, NE, SHT, ACh };
     void register_neuromod_source(const std::string& region_name, NeuromodType type);
 
+    /** 已注册的调质源区域名 (分区器默认在各分区复制这些小区域) */
+    std::vector<std::string> neuromod_source_names() const;
+
     /** 获取全局神经调质水平 */
     const NeuromodulatorLevels& global_neuromod() const { return global_neuromod_; }
 
@@ -110,12 +286,65 @@ private:
     std::vector<std::unique_ptr<BrainRegion>> regions_;
     int32_t t_ = 0;
     StepCallback callback_;
+    std::vector<uint8_t> local_mask_;   // 分区运行: 本地区域
+    WindowHook window_hook_;
+    bool skip_quiescent_ = false;
+    Profiler profiler_;
+
+    // 执行掩码: 区域标志按 regions_ 下标, 投射标志按 SpikeBus 投射顺序
+    struct ExecMask {
+        std::string          name;
+        std::vector<uint8_t> regions;
+        std::vector<uint8_t> projections;
+    };
+    std::vector<ExecMask> masks_;
+    std::string           active_mask_;
+    std::vector<uint8_t>  exec_regions_;   // 空 = 全部推进
+
+    // 多速率时钟
+    // 内置时钟不捕获 this (引擎可移动), 由 kind 分派
+    enum class ClockKind { OSCILLATION, NEUROMOD, USER };
+    struct Clock {
+        std::string   name;
+        int32_t       period = 1;
+        int32_t       phase  = 0;
+        ClockKind     kind   = ClockKind::USER;
+        ClockCallback fn;
+    };
+    std::vector<Clock> clocks_;
+
+    void run_clocks(float dt);
+    void count_spikes_out(size_t i);   // 剖析/遥测: 本步发放数 (都未启用时空操作)
+    void step_window(int32_t n_steps, float dt);
+
+    // 实时遥测: 本窗口累计, 满 publish_every 步发布一帧
+    std::unique_ptr<TelemetryWriter> telemetry_;
+    int32_t telemetry_steps_ = 0;
+    double  telemetry_us_    = 0.0;
+    void telemetry_tick(int64_t t0_ns, int32_t steps);
+
+    SpikeRasterWriter* recorder_ = nullptr;
+
+    // 常驻线程池: 静态 区域→线程 分配 + 在线代价
+    std::unique_ptr<WorkerPool> pool_;
+    int32_t rebalance_interval_ = 1000;
+    int32_t steps_since_rebalance_ = 0;
+    std::vector<double> region_cost_;               // 每区域 ns/步 (EMA)
+    std::vector<int>    region_thread_;             // 区域 → 线程 / WIDE_REGION
+    std::vector<std::vector<size_t>> thread_regions_;
+    std::vector<size_t> wide_regions_;
+
+    /** 对本地且未冻结的区域执行 fn(i) (线程池或 OpenMP), 并记录 steps 步的耗时 */
+    void for_each_local_region(const std::function<void(size_t)>& fn, int32_t steps);
 
     // 神经调质广播系统
+    // 源区域的输出读取在注册时解析一次 (无逐步 dynamic_cast)
     NeuromodulatorLevels global_neuromod_;
     struct NeuromodSource {
-        BrainRegion* region = nullptr;
+        std::function<float()> read;
         NeuromodType type;
+        std::string  name;
+        size_t       region;   // regions_ 下标 (执行掩码冻结时不采集)
     };
     std::vector<NeuromodSource> neuromod_sources_;
 
@@ -7,6 +7,7 @@ namespace wuyun {
 
 SleepCycleManager::SleepCycleManager(const SleepCycleConfig& config)
     : config_(config)
+    , pgo_rng_(config.pgo_seed)
 {
 }
 
@@ -41,9 +42,8 @@ void SleepCycleManager::step() {
         if (theta_phase_ >= 1.0f) theta_phase_ -= 1.0f;
 
         // PGO wave generation (stochastic)
-        static std::mt19937 pgo_rng(77777);
         std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-        pgo_active_ = (dist(pgo_rng) < config_.rem_pgo_prob);
+        pgo_active_ = (dist(pgo_rng_) < config_.rem_pgo_prob);
 
         // REM → NREM transition (new cycle)
         if (stage_timer_ >= current_rem_dur_) {
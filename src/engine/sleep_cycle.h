@@ -24,6 +24,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <random>
 
 namespace wuyun {
 
@@ -49,6 +50,7 @@ struct SleepCycleConfig {
     float rem_motor_inhibit  = -15.0f;  // Motor cortex inhibition during REM (atonia)
     float rem_cortex_noise   = 8.0f;    // Desynchronized cortical noise during REM
     float rem_theta_amp      = 10.0f;   // Hippocampal theta modulation amplitude
+    uint32_t pgo_seed        = 77777;   // PGO 触发的实例随机流种子
 };
 
 class SleepCycleManager {
@@ -107,6 +109,7 @@ private:
     // REM state
     float theta_phase_ = 0.0f;
     bool  pgo_active_  = false;
+    std::mt19937 pgo_rng_;
 
     void transition_to_nrem();
     void transition_to_rem();
@@ -0,0 +1,437 @@
+#include "engine/spike_raster.h"
+#include "engine/simulation_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wuyun {
+
+namespace {
+
+constexpr char MAGIC_FILE[4]  = {'W', 'Y', 'S', 'R'};
+constexpr char MAGIC_CHUNK[4] = {'W', 'Y', 'C', 'K'};
+constexpr char MAGIC_INDEX[4] = {'W', 'Y', 'I', 'X'};
+constexpr char MAGIC_END[4]   = {'W', 'Y', 'S', 'E'};
+constexpr size_t CHUNK_HEADER = 16;   // magic, t0, n_steps, n_regions
+
+template <typename T>
+T read_as(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+template <typename T>
+void put_as(std::vector<uint8_t>& out, T v) {
+    const auto* p = reinterpret_cast<const uint8_t*>(&v);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+inline void put_varint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+/** LEB128 解码; 越界返回 false */
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        v |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+// =============================================================================
+// SpikeRasterWriter
+// =============================================================================
+
+void SpikeRasterWriter::Chunk::reset(int32_t t) {
+    t0 = t;
+    n_steps = 0;
+    for (auto& v : ids) v.clear();
+    for (auto& v : step_off) v.clear();
+    for (auto& v : step_count) v.clear();
+}
+
+SpikeRasterWriter::~SpikeRasterWriter() {
+    close();
+}
+
+bool SpikeRasterWriter::open(const std::string& path, const SimulationEngine& engine,
+                             uint32_t chunk_steps, const std::vector<std::string>& regions) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+    io_ok_ = true;
+    chunk_steps_ = std::max<uint32_t>(chunk_steps, 1);
+
+    std::vector<size_t> recorded;
+    slot_of_.assign(engine.num_regions(), -1);
+    for (size_t i = 0; i < engine.num_regions(); ++i) {
+        bool want = regions.empty() ||
+                    std::find(regions.begin(), regions.end(), engine.region(i).name()) != regions.end();
+        if (!want) continue;
+        slot_of_[i] = static_cast<int32_t>(recorded.size());
+        recorded.push_back(i);
+    }
+    n_slots_ = recorded.size();
+
+    std::vector<uint8_t> hdr(MAGIC_FILE, MAGIC_FILE + 4);
+    put_as<uint32_t>(hdr, VERSION);
+    put_as<uint32_t>(hdr, chunk_steps_);
+    put_as<uint32_t>(hdr, static_cast<uint32_t>(n_slots_));
+    for (size_t i : recorded) {
+        const BrainRegion& r = engine.region(i);
+        put_as<uint16_t>(hdr, static_cast<uint16_t>(r.name().size()));
+        hdr.insert(hdr.end(), r.name().begin(), r.name().end());
+        put_as<uint32_t>(hdr, static_cast<uint32_t>(r.n_neurons()));
+    }
+    io_ok_ = std::fwrite(hdr.data(), 1, hdr.size(), file_) == hdr.size();
+    file_pos_ = hdr.size();
+    bytes_ = file_pos_;
+    spikes_ = 0;
+    chunks_ = 0;
+    index_.clear();
+
+    for (Chunk* c : {&front_, &back_}) {
+        c->ids.assign(n_slots_, {});
+        c->step_off.assign(n_slots_, {});
+        c->step_count.assign(n_slots_, {});
+    }
+    t_last_ = engine.current_time();
+    front_.reset(t_last_);
+    back_ready_ = false;
+    stop_ = false;
+    thread_ = std::thread([this] { writer_loop(); });
+    return io_ok_;
+}
+
+void SpikeRasterWriter::capture(size_t region_index, int32_t t, const std::vector<uint8_t>& fired) {
+    if (region_index >= slot_of_.size() || t < front_.t0) return;
+    int32_t slot = slot_of_[region_index];
+    if (slot < 0) return;
+
+    auto& ids = front_.ids[static_cast<size_t>(slot)];
+    size_t before = ids.size();
+    for (size_t j = 0; j < fired.size(); ++j) {
+        if (fired[j]) ids.push_back(static_cast<uint32_t>(j));
+    }
+    if (ids.size() == before) return;
+    front_.step_off[static_cast<size_t>(slot)].push_back(static_cast<uint32_t>(t - front_.t0));
+    front_.step_count[static_cast<size_t>(slot)].push_back(static_cast<uint32_t>(ids.size() - before));
+}
+
+void SpikeRasterWriter::end_step(int32_t t_next) {
+    if (!file_) return;
+    t_last_ = t_next;
+    if (t_next - front_.t0 < static_cast<int32_t>(chunk_steps_)) return;
+    front_.n_steps = static_cast<uint32_t>(t_next - front_.t0);
+    hand_off();
+    front_.reset(t_next);
+}
+
+void SpikeRasterWriter::hand_off() {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this] { return !back_ready_; });   // 后台仍在写上一块时才等待
+    std::swap(front_, back_);
+    back_ready_ = true;
+    lk.unlock();
+    cv_.notify_all();
+}
+
+void SpikeRasterWriter::writer_loop() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        cv_.wait(lk, [this] { return back_ready_ || stop_; });
+        if (!back_ready_) return;   // stop_ 且无待写块
+        lk.unlock();
+        write_chunk(back_);
+        lk.lock();
+        back_ready_ = false;
+        cv_.notify_all();
+    }
+}
+
+void SpikeRasterWriter::write_chunk(const Chunk& c) {
+    buf_.clear();
+    table_.assign(n_slots_ * 2, 0);
+    uint64_t n_spikes = 0;
+    for (size_t s = 0; s < n_slots_; ++s) {
+        size_t start = buf_.size();
+        const auto& ids = c.ids[s];
+        const auto& offs = c.step_off[s];
+        const auto& counts = c.step_count[s];
+        size_t k = 0;
+        uint32_t prev_off = 0;
+        for (size_t rec = 0; rec < offs.size(); ++rec) {
+            put_varint(buf_, offs[rec] - prev_off);
+            put_varint(buf_, counts[rec]);
+            prev_off = offs[rec];
+            uint32_t prev = 0;
+            for (uint32_t j = 0; j < counts[rec]; ++j, ++k) {
+                // 同一步内 ID 严格递增: 首个存绝对值, 之后存间隔 − 1
+                put_varint(buf_, j == 0 ? ids[k] : ids[k] - prev - 1);
+                prev = ids[k];
+            }
+        }
+        table_[2 * s]     = static_cast<uint32_t>(buf_.size() - start);
+        table_[2 * s + 1] = static_cast<uint32_t>(ids.size());
+        n_spikes += ids.size();
+    }
+
+    std::vector<uint8_t> head(MAGIC_CHUNK, MAGIC_CHUNK + 4);
+    put_as<int32_t>(head, c.t0);
+    put_as<uint32_t>(head, c.n_steps);
+    put_as<uint32_t>(head, static_cast<uint32_t>(n_slots_));
+    for (uint32_t v : table_) put_as<uint32_t>(head, v);
+
+    bool ok = std::fwrite(head.data(), 1, head.size(), file_) == head.size() &&
+              std::fwrite(buf_.data(), 1, buf_.size(), file_) == buf_.size();
+    if (!ok) io_ok_ = false;
+    index_.push_back({c.t0, c.n_steps, file_pos_});
+    file_pos_ += head.size() + buf_.size();
+
+    spikes_.fetch_add(n_spikes, std::memory_order_relaxed);
+    chunks_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.store(file_pos_, std::memory_order_relaxed);
+}
+
+bool SpikeRasterWriter::close() {
+    if (!file_) return false;
+    if (t_last_ > front_.t0) {
+        front_.n_steps = static_cast<uint32_t>(t_last_ - front_.t0);
+        hand_off();
+    }
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+
+    std::vector<uint8_t> tail(MAGIC_INDEX, MAGIC_INDEX + 4);
+    put_as<uint32_t>(tail, static_cast<uint32_t>(index_.size()));
+    for (const auto& e : index_) {
+        put_as<int32_t>(tail, e.t0);
+        put_as<uint32_t>(tail, e.n_steps);
+        put_as<uint64_t>(tail, e.offset);
+    }
+    put_as<uint64_t>(tail, file_pos_);
+    tail.insert(tail.end(), MAGIC_END, MAGIC_END + 4);
+    bool ok = io_ok_ && std::fwrite(tail.data(), 1, tail.size(), file_) == tail.size();
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    bytes_ = file_pos_ + tail.size();
+    return ok;
+}
+
+// =============================================================================
+// SpikeRasterReader
+// =============================================================================
+
+SpikeRasterReader::~SpikeRasterReader() {
+    close();
+}
+
+void SpikeRasterReader::close() {
+#ifndef _WIN32
+    if (mapped_ && data_) munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    mapped_ = false;
+    data_ = nullptr;
+    size_ = 0;
+    owned_.clear();
+    names_.clear();
+    sizes_.clear();
+    chunks_.clear();
+    indexed_ = false;
+}
+
+bool SpikeRasterReader::open(const std::string& path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            data_ = static_cast<const uint8_t*>(p);
+            size_ = static_cast<size_t>(st.st_size);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+#endif
+    if (!data_) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) return false;
+        owned_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        data_ = owned_.data();
+        size_ = owned_.size();
+    }
+    if (!parse()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SpikeRasterReader::parse() {
+    if (size_ < 16 || std::memcmp(data_, MAGIC_FILE, 4) != 0) return false;
+    if (read_as<uint32_t>(data_ + 4) != SpikeRasterWriter::VERSION) return false;
+    chunk_steps_ = read_as<uint32_t>(data_ + 8);
+    uint32_t n = read_as<uint32_t>(data_ + 12);
+    size_t pos = 16;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (pos + 2 > size_) return false;
+        uint16_t len = read_as<uint16_t>(data_ + pos);
+        pos += 2;
+        if (pos + len + 4 > size_) return false;
+        names_.emplace_back(reinterpret_cast<const char*>(data_ + pos), len);
+        pos += len;
+        sizes_.push_back(read_as<uint32_t>(data_ + pos));
+        pos += 4;
+    }
+
+    // 写端正常关闭: 尾部索引
+    if (size_ >= pos + 12 && std::memcmp(data_ + size_ - 4, MAGIC_END, 4) == 0) {
+        uint64_t ix = read_as<uint64_t>(data_ + size_ - 12);
+        if (ix + 8 <= size_ - 12 && std::memcmp(data_ + ix, MAGIC_INDEX, 4) == 0) {
+            uint32_t nc = read_as<uint32_t>(data_ + ix + 4);
+            if (ix + 8 + static_cast<uint64_t>(nc) * 16 <= size_ - 12) {
+                const uint8_t* e = data_ + ix + 8;
+                for (uint32_t c = 0; c < nc; ++c, e += 16) {
+                    chunks_.push_back({read_as<int32_t>(e), read_as<uint32_t>(e + 4),
+                                       read_as<uint64_t>(e + 8)});
+                }
+                indexed_ = true;
+                return true;
+            }
+        }
+    }
+    // 未关闭 (进程中途退出): 顺序扫描块头
+    return scan_chunks(pos, size_);
+}
+
+bool SpikeRasterReader::scan_chunks(uint64_t pos, uint64_t end) {
+    const size_t n = names_.size();
+    while (pos + CHUNK_HEADER + 8 * n <= end) {
+        const uint8_t* p = data_ + pos;
+        if (std::memcmp(p, MAGIC_CHUNK, 4) != 0) break;
+        if (read_as<uint32_t>(p + 12) != n) break;
+        uint64_t payload = 0;
+        for (size_t r = 0; r < n; ++r) payload += read_as<uint32_t>(p + CHUNK_HEADER + 8 * r);
+        uint64_t total = CHUNK_HEADER + 8 * n + payload;
+        if (pos + total > end) break;   // 截断的尾块
+        chunks_.push_back({read_as<int32_t>(p + 4), read_as<uint32_t>(p + 8), pos});
+        pos += total;
+    }
+    return true;
+}
+
+int SpikeRasterReader::find_region(const std::string& name) const {
+    for (size_t i = 0; i < names_.size(); ++i) {
+        if (names_[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int32_t SpikeRasterReader::t_begin() const {
+    return chunks_.empty() ? 0 : chunks_.front().t0;
+}
+
+int32_t SpikeRasterReader::t_end() const {
+    return chunks_.empty() ? 0 : chunks_.back().t0 + static_cast<int32_t>(chunks_.back().n_steps);
+}
+
+bool SpikeRasterReader::region_span(const ChunkRef& c, size_t r, const uint8_t*& p,
+                                    uint32_t& bytes, uint32_t& n_spikes) const {
+    const size_t n = names_.size();
+    if (r >= n || c.offset + CHUNK_HEADER + 8 * n > size_) return false;
+    const uint8_t* table = data_ + c.offset + CHUNK_HEADER;
+    uint64_t off = c.offset + CHUNK_HEADER + 8 * n;
+    for (size_t i = 0; i < r; ++i) off += read_as<uint32_t>(table + 8 * i);
+    bytes = read_as<uint32_t>(table + 8 * r);
+    n_spikes = read_as<uint32_t>(table + 8 * r + 4);
+    if (off + bytes > size_) return false;
+    p = data_ + off;
+    return true;
+}
+
+size_t SpikeRasterReader::first_chunk(int32_t t) const {
+    // 最后一个 t0 ≤ t 的块 (t 早于录制开始时为 0)
+    auto it = std::upper_bound(chunks_.begin(), chunks_.end(), t,
+                               [](int32_t v, const ChunkRef& c) { return v < c.t0; });
+    return it == chunks_.begin() ? 0 : static_cast<size_t>(it - chunks_.begin()) - 1;
+}
+
+size_t SpikeRasterReader::read(size_t r, int32_t t0, int32_t t1,
+                               std::vector<int32_t>& times, std::vector<uint32_t>& ids) const {
+    size_t added = 0;
+    for (size_t ci = first_chunk(t0); ci < chunks_.size() && chunks_[ci].t0 < t1; ++ci) {
+        const ChunkRef& c = chunks_[ci];
+        const uint8_t* p;
+        uint32_t bytes, n_spikes;
+        if (!region_span(c, r, p, bytes, n_spikes)) break;
+        const uint8_t* end = p + bytes;
+        uint32_t off = 0;
+        while (p < end) {
+            uint32_t d, count;
+            if (!get_varint(p, end, d) || !get_varint(p, end, count)) return added;
+            off += d;
+            int32_t t = c.t0 + static_cast<int32_t>(off);
+            bool keep = t >= t0 && t < t1;
+            uint32_t id = 0;
+            for (uint32_t j = 0; j < count; ++j) {
+                uint32_t v;
+                if (!get_varint(p, end, v)) return added;
+                id = j == 0 ? v : id + v + 1;
+                if (keep) {
+                    times.push_back(t);
+                    ids.push_back(id);
+                    ++added;
+                }
+            }
+        }
+    }
+    return added;
+}
+
+uint64_t SpikeRasterReader::count(size_t r, int32_t t0, int32_t t1) const {
+    uint64_t total = 0;
+    std::vector<int32_t> times;
+    std::vector<uint32_t> ids;
+    for (size_t ci = first_chunk(t0); ci < chunks_.size() && chunks_[ci].t0 < t1; ++ci) {
+        const ChunkRef& c = chunks_[ci];
+        if (c.t0 >= t0 && c.t0 + static_cast<int32_t>(c.n_steps) <= t1) {
+            const uint8_t* p;
+            uint32_t bytes, n_spikes;
+            if (!region_span(c, r, p, bytes, n_spikes)) break;
+            total += n_spikes;
+        } else {
+            times.clear();
+            ids.clear();
+            int32_t lo = std::max(t0, c.t0);
+            int32_t hi = std::min(t1, c.t0 + static_cast<int32_t>(c.n_steps));
+            total += read(r, lo, hi, times, ids);
+        }
+    }
+    return total;
+}
+
+} // namespace wuyun
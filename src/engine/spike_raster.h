@@ -0,0 +1,178 @@
+#pragma once
+/**
+ * SpikeRaster — 流式二进制脉冲栅格 (分块 + 增量/varint 压缩 + 时间索引)
+ *
+ * 长时间录制不能像 pywuyun 的 SpikeRecorder 那样把每步发放 ID 全留在内存里。
+ * SpikeRasterWriter 按 chunk_steps 步一块, 把各区域的发放写入磁盘:
+ *
+ *   - 仿真线程只做 capture: 扫 fired 向量, 把发放 ID 追加到当前块的每区域缓冲
+ *     (每区域独立缓冲 → 窗口运行中各工作线程并发 capture 不同区域无需加锁)
+ *   - 双缓冲: 块满时与后台线程交换缓冲 (后台尚未写完上一块时才等待),
+ *     varint 编码与文件写入全部在后台线程
+ *   - 结束时写时间索引; 进程中途退出时读者顺序扫描块头重建索引
+ *
+ * SpikeRasterReader 以内存映射打开, 按 (区域, 时间窗) 随机访问:
+ * 二分定位块, 只解码该区域在该块中的字节段。Python 侧见 python/wuyun/raster.py (numpy)。
+ *
+ * 文件格式 (小端):
+ *   头:   "WYSR" u32 version | u32 chunk_steps | u32 n_regions | { u16 len, name, u32 n_neurons } × n
+ *   块:   "WYCK" i32 t0 | u32 n_steps | u32 n_regions | { u32 bytes, u32 n_spikes } × n | 载荷
+ *         载荷 = 各区域字节段依次拼接; 区域段 = 有发放的步的记录序列
+ *         { varint Δstep, varint count, varint id₀, varint (idₖ − idₖ₋₁ − 1)… }
+ *         (Δstep 相对上一条记录的块内步偏移, 首条相对块起点)
+ *   索引: "WYIX" u32 n_chunks | { i32 t0, u32 n_steps, u64 offset } × n | u64 index_offset | "WYSE"
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wuyun {
+
+class SimulationEngine;
+
+class SpikeRasterWriter {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    SpikeRasterWriter() = default;
+    ~SpikeRasterWriter();
+
+    SpikeRasterWriter(const SpikeRasterWriter&) = delete;
+    SpikeRasterWriter& operator=(const SpikeRasterWriter&) = delete;
+
+    /**
+     * 创建文件并写头, 启动后台写线程
+     * @param regions  要录制的区域名 (空 = 全部); 未知名称忽略
+     * @return 文件无法创建返回 false
+     */
+    bool open(const std::string& path, const SimulationEngine& engine,
+              uint32_t chunk_steps = 1000, const std::vector<std::string>& regions = {});
+
+    /**
+     * 记录 engine 区域 region_index 在时间步 t 的发放 (未录制的区域直接返回)
+     * 同一区域的调用须按 t 递增; 不同区域可由不同线程并发调用
+     */
+    void capture(size_t region_index, int32_t t, const std::vector<uint8_t>& fired);
+
+    /** 步边界 (单线程): t_next 之前的步已全部 capture; 块满则交给后台线程 */
+    void end_step(int32_t t_next);
+
+    /** 写出未满的当前块 (截至最后一次 end_step) 与索引, 停止后台线程; 返回是否全部写入成功 */
+    bool close();
+
+    bool     is_open()       const { return file_ != nullptr; }
+    /** 已写出的脉冲数 / 块数 / 字节数 (后台线程更新) */
+    uint64_t spikes()        const { return spikes_.load(std::memory_order_relaxed); }
+    uint64_t chunks()        const { return chunks_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Chunk {
+        int32_t t0 = 0;
+        uint32_t n_steps = 0;
+        // 每录制区域: 发放 ID 与每个有发放步的 (块内步偏移, 个数)
+        std::vector<std::vector<uint32_t>> ids;
+        std::vector<std::vector<uint32_t>> step_off, step_count;
+        void reset(int32_t t);
+    };
+    struct IndexEntry {
+        int32_t  t0;
+        uint32_t n_steps;
+        uint64_t offset;
+    };
+
+    void writer_loop();
+    void write_chunk(const Chunk& c);
+    void hand_off();
+
+    FILE* file_ = nullptr;
+    bool  io_ok_ = true;                // 后台线程写, close() join 后读
+    uint64_t file_pos_ = 0;
+    uint32_t chunk_steps_ = 1000;
+    std::vector<int32_t> slot_of_;      // engine 区域下标 → 录制槽 (-1 = 不录制)
+    size_t n_slots_ = 0;
+
+    Chunk front_, back_;                // front_ 仿真线程填写, back_ 后台线程编码写出
+    std::thread thread_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool back_ready_ = false, stop_ = false;
+
+    int32_t t_last_ = 0;                // 最后一次 end_step 的 t_next
+
+    std::vector<IndexEntry> index_;     // 仅后台线程写, close() join 后读
+    std::vector<uint8_t> buf_;          // 后台编码缓冲
+    std::vector<uint32_t> table_;       // 后台: 每槽 (bytes, n_spikes)
+    std::atomic<uint64_t> spikes_{0}, chunks_{0}, bytes_{0};
+};
+
+/** 只读栅格 (内存映射), 按 (区域, 时间窗) 随机访问 */
+class SpikeRasterReader {
+public:
+    SpikeRasterReader() = default;
+    ~SpikeRasterReader();
+
+    SpikeRasterReader(const SpikeRasterReader&) = delete;
+    SpikeRasterReader& operator=(const SpikeRasterReader&) = delete;
+
+    /** 打开文件; 无索引 (写端未 close) 时扫描块头重建, 截断的尾块丢弃 */
+    bool open(const std::string& path);
+    void close();
+
+    size_t num_regions() const { return names_.size(); }
+    const std::string& region_name(size_t r) const { return names_[r]; }
+    uint32_t region_size(size_t r) const { return sizes_[r]; }
+    /** 区域名 → 下标 (未找到返回 -1) */
+    int find_region(const std::string& name) const;
+
+    size_t  num_chunks()  const { return chunks_.size(); }
+    uint32_t chunk_steps() const { return chunk_steps_; }
+    /** 录制覆盖的时间范围 [t_begin, t_end) */
+    int32_t t_begin() const;
+    int32_t t_end()   const;
+    /** 文件中有索引 (写端正常 close) */
+    bool indexed() const { return indexed_; }
+
+    /**
+     * 读出区域 r 在 [t0, t1) 内的全部脉冲, 追加到 times / ids (按时间、ID 递增)
+     * @return 追加的脉冲数
+     */
+    size_t read(size_t r, int32_t t0, int32_t t1,
+                std::vector<int32_t>& times, std::vector<uint32_t>& ids) const;
+
+    /** 区域 r 在 [t0, t1) 内的脉冲数 (整块落在窗内时只读块表, 不解码) */
+    uint64_t count(size_t r, int32_t t0, int32_t t1) const;
+
+private:
+    struct ChunkRef {
+        int32_t  t0;
+        uint32_t n_steps;
+        uint64_t offset;          // 块头在文件中的位置
+    };
+    bool parse();
+    bool scan_chunks(uint64_t pos, uint64_t end);
+    /** 块 c 中区域 r 的 (字节段起点, 字节数, 脉冲数) */
+    bool region_span(const ChunkRef& c, size_t r, const uint8_t*& p, uint32_t& bytes,
+                     uint32_t& n_spikes) const;
+    size_t first_chunk(int32_t t) const;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<uint8_t> owned_;   // 无 mmap 的平台: 整个文件读入
+    bool mapped_ = false;
+
+    uint32_t chunk_steps_ = 0;
+    std::vector<std::string> names_;
+    std::vector<uint32_t>    sizes_;
+    std::vector<ChunkRef>    chunks_;
+    bool indexed_ = false;
+};
+
+} // namespace wuyun
@@ -0,0 +1,297 @@
+#include "engine/synthetic_brain.h"
+#include "region/cortical_region.h"
+#include "region/subcortical/thalamic_relay.h"
+#include "region/subcortical/basal_ganglia.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#ifdef WUYUN_OPENMP
+#include <omp.h>
+#endif
+
+namespace wuyun {
+
+// 连接概率截断: 每个突触后神经元的期望输入数不超过 fan_in
+static float capped(float p, size_t n_pre, float fan_in) {
+    if (n_pre == 0) return p;
+    return std::min(p, fan_in / static_cast<float>(n_pre));
+}
+
+static std::string region_name(SyntheticBrain::RegionKind k, size_t i) {
+    switch (k) {
+        case SyntheticBrain::RegionKind::THALAMIC: return "thal" + std::to_string(i);
+        case SyntheticBrain::RegionKind::BG:       return "bg" + std::to_string(i);
+        default:                                   return "ctx" + std::to_string(i);
+    }
+}
+
+SyntheticBrain::SyntheticBrain(const SyntheticBrainConfig& config)
+    : config_(config)
+    , engine_(std::max<int32_t>(10, config.delay_max))
+{
+    config_.delay_min = std::max<int32_t>(1, config_.delay_min);
+    config_.delay_max = std::max(config_.delay_min, config_.delay_max);
+    plan_topology();
+    build_regions();
+    for (const auto& e : edges_) {
+        engine_.add_projection(engine_.region(e.src).name(), engine_.region(e.dst).name(), e.delay);
+    }
+    gains_.assign(engine_.num_regions(), 1.0f);
+    drive_.resize(engine_.num_regions());
+    for (size_t i = 0; i < engine_.num_regions(); ++i) build_drive(i);
+}
+
+// =============================================================================
+// 构造
+// =============================================================================
+
+void SyntheticBrain::plan_topology() {
+    const auto& c = config_;
+    size_t R = std::max<size_t>(c.n_regions, 1);
+    size_t n_thal = static_cast<size_t>(std::lround(c.frac_thalamic * static_cast<float>(R)));
+    size_t n_bg   = static_cast<size_t>(std::lround(c.frac_bg * static_cast<float>(R)));
+    n_thal = std::min(n_thal, R);
+    n_bg   = std::min(n_bg, R - n_thal);
+
+    kinds_.assign(R, RegionKind::CORTICAL);
+    for (size_t i = 0; i < n_thal; ++i) kinds_[i] = RegionKind::THALAMIC;
+    for (size_t i = 0; i < n_bg; ++i)   kinds_[n_thal + i] = RegionKind::BG;
+    std::mt19937 rng(c.seed);
+    std::shuffle(kinds_.begin(), kinds_.end(), rng);
+
+    std::uniform_real_distribution<float> spread(1.0f - c.size_spread, 1.0f + c.size_spread);
+    sizes_.resize(R);
+    for (size_t i = 0; i < R; ++i) {
+        float f = c.size_spread > 0.0f ? spread(rng) : 1.0f;
+        sizes_[i] = std::max<size_t>(20, static_cast<size_t>(static_cast<float>(c.neurons_per_region) * f));
+    }
+
+    // 基底节只投射到丘脑 (BG → 丘脑 → 皮层, 如 BG→MotorThal): GPi/GPe 紧张放电
+    // 的脉冲流直接进皮层会使其饱和; 环形骨架上 BG 的出边改连其后第一个丘脑区域
+    auto allowed = [&](size_t a, size_t b) {
+        return kinds_[a] != RegionKind::BG || kinds_[b] == RegionKind::THALAMIC;
+    };
+    std::vector<size_t> ring_next(R, R);
+    for (size_t a = 0; a < R && R > 1; ++a) {
+        for (size_t k = 1; k < R; ++k) {
+            size_t b = (a + k) % R;
+            if (allowed(a, b)) { ring_next[a] = b; break; }
+        }
+    }
+
+    std::mt19937 proj_rng(c.seed ^ 0x5bd1e995u);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    std::uniform_int_distribution<int32_t> delay(c.delay_min, c.delay_max);
+    in_degree_.assign(R, 0);
+    for (size_t a = 0; a < R; ++a) {
+        for (size_t b = 0; b < R; ++b) {
+            if (a == b) continue;
+            bool ring  = (b == ring_next[a]);
+            bool drawn = u(proj_rng) < c.projection_density;   // 每个有序对都抽样, 拓扑与约束无关
+            if (!allowed(a, b) || (!ring && !drawn)) continue;
+            edges_.push_back({a, b, delay(proj_rng)});
+            ++in_degree_[b];
+        }
+    }
+}
+
+void SyntheticBrain::build_regions() {
+    const auto& c = config_;
+    size_t R = kinds_.size();
+    const float fan = c.intra_fan_in;
+
+    for (size_t i = 0; i < R; ++i) {
+        size_t N = sizes_[i];
+        std::string name = region_name(kinds_[i], i);
+
+        switch (kinds_[i]) {
+        case RegionKind::CORTICAL: {
+            // 与 build_brain 的 add_ctx 相同的层比例
+            ColumnConfig cc;
+            cc.name = name;
+            cc.n_l4_stellate    = std::max<size_t>(3, N * 25 / 100);
+            cc.n_l23_pyramidal  = std::max<size_t>(3, N * 35 / 100);
+            cc.n_l5_pyramidal   = std::max<size_t>(3, N * 20 / 100);
+            cc.n_l6_pyramidal   = std::max<size_t>(2, N * 12 / 100);
+            cc.n_pv_basket      = std::max<size_t>(2, N * 4 / 100);
+            cc.n_sst_martinotti = std::max<size_t>(1, N * 3 / 100);
+            cc.n_vip            = std::max<size_t>(1, N * 1 / 100);
+            cc.p_l4_to_l23      = capped(cc.p_l4_to_l23,      cc.n_l4_stellate,    fan);
+            cc.p_l23_to_l5      = capped(cc.p_l23_to_l5,      cc.n_l23_pyramidal,  fan);
+            cc.p_l5_to_l6       = capped(cc.p_l5_to_l6,       cc.n_l5_pyramidal,   fan);
+            cc.p_l6_to_l4       = capped(cc.p_l6_to_l4,       cc.n_l6_pyramidal,   fan);
+            cc.p_l23_recurrent  = capped(cc.p_l23_recurrent,  cc.n_l23_pyramidal,  fan);
+            cc.p_exc_to_pv      = capped(cc.p_exc_to_pv,      cc.n_l23_pyramidal,  fan);
+            cc.p_exc_to_sst     = capped(cc.p_exc_to_sst,     cc.n_l23_pyramidal,  fan);
+            cc.p_exc_to_vip     = capped(cc.p_exc_to_vip,     cc.n_l23_pyramidal,  fan);
+            cc.p_pv_to_l23      = capped(cc.p_pv_to_l23,      cc.n_pv_basket,      fan);
+            cc.p_pv_to_l4       = capped(cc.p_pv_to_l4,       cc.n_pv_basket,      fan);
+            cc.p_pv_to_l5       = capped(cc.p_pv_to_l5,       cc.n_pv_basket,      fan);
+            cc.p_pv_to_l6       = capped(cc.p_pv_to_l6,       cc.n_pv_basket,      fan);
+            cc.p_sst_to_l23_api = capped(cc.p_sst_to_l23_api, cc.n_sst_martinotti, fan);
+            cc.p_sst_to_l5_api  = capped(cc.p_sst_to_l5_api,  cc.n_sst_martinotti, fan);
+            cc.p_vip_to_sst     = capped(cc.p_vip_to_sst,     cc.n_vip,            fan);
+            // 入度归一: 区域收到的跨区域总驱动与投射数无关
+            float psp = c.input_psp / static_cast<float>(std::max<size_t>(in_degree_[i], 1));
+            cc.input_psp_burst    = psp * (cc.input_psp_burst / cc.input_psp_regular);
+            cc.input_psp_regular  = psp;
+            cc.input_fan_out_frac = std::min(cc.input_fan_out_frac,
+                static_cast<float>(c.spike_fan_out) / static_cast<float>(cc.n_l4_stellate));
+            engine_.add_region(std::make_unique<CorticalRegion>(name, cc));
+            break;
+        }
+        case RegionKind::THALAMIC: {
+            ThalamicConfig tc;
+            tc.name    = name;
+            tc.n_relay = std::max<size_t>(3, N * 3 / 4);
+            tc.n_trn   = std::max<size_t>(2, N - tc.n_relay);
+            tc.p_relay_to_trn = capped(tc.p_relay_to_trn, tc.n_relay, fan);
+            tc.p_trn_to_relay = capped(tc.p_trn_to_relay, tc.n_trn,   fan);
+            engine_.add_region(std::make_unique<ThalamicRelay>(tc));
+            break;
+        }
+        case RegionKind::BG: {
+            BasalGangliaConfig bc;
+            bc.name     = name;
+            bc.n_d1_msn = std::max<size_t>(4, N * 35 / 100);
+            bc.n_d2_msn = std::max<size_t>(4, N * 35 / 100);
+            bc.n_gpi    = std::max<size_t>(2, N * 10 / 100);
+            bc.n_gpe    = std::max<size_t>(2, N * 10 / 100);
+            bc.n_stn    = std::max<size_t>(2, N - bc.n_d1_msn - bc.n_d2_msn - bc.n_gpi - bc.n_gpe);
+            bc.p_d1_to_gpi  = capped(bc.p_d1_to_gpi,  bc.n_d1_msn, fan);
+            bc.p_d2_to_gpe  = capped(bc.p_d2_to_gpe,  bc.n_d2_msn, fan);
+            bc.p_gpe_to_stn = capped(bc.p_gpe_to_stn, bc.n_gpe,    fan);
+            bc.p_stn_to_gpi = capped(bc.p_stn_to_gpi, bc.n_stn,    fan);
+            // 皮层输入映射: 概率相对突触后群体 → 每个脉冲激活 ≤ spike_fan_out 个 MSN
+            float fo = static_cast<float>(c.spike_fan_out);
+            bc.p_ctx_to_d1  = capped(bc.p_ctx_to_d1,  bc.n_d1_msn, fo);
+            bc.p_ctx_to_d2  = capped(bc.p_ctx_to_d2,  bc.n_d2_msn, fo);
+            bc.p_ctx_to_stn = capped(bc.p_ctx_to_stn, bc.n_stn,    fo);
+            engine_.add_region(std::make_unique<BasalGanglia>(bc));
+            break;
+        }
+        }
+        total_neurons_ += engine_.region(engine_.num_regions() - 1).n_neurons();
+    }
+}
+
+/** 输入群体大小: 皮层 L4 / 丘脑 relay / 基底节 D1 (inject_external 的作用范围) */
+static size_t input_size(BrainRegion& r, SyntheticBrain::RegionKind k) {
+    switch (k) {
+        case SyntheticBrain::RegionKind::CORTICAL:
+            return static_cast<CorticalRegion&>(r).column().l4().size();
+        case SyntheticBrain::RegionKind::THALAMIC:
+            return static_cast<ThalamicRelay&>(r).relay().size();
+        case SyntheticBrain::RegionKind::BG:
+            return static_cast<BasalGanglia&>(r).d1().size();
+    }
+    return r.n_neurons();
+}
+
+void SyntheticBrain::build_drive(size_t i) {
+    const auto& c = config_;
+    size_t n_in = input_size(engine_.region(i), kinds_[i]);
+    std::mt19937 rng(c.seed * 2654435761u + static_cast<uint32_t>(i));
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    // 增益调节受驱比例 (幅度固定为超阈值), 发放率对增益近似线性
+    float frac = std::clamp(c.drive_fraction * gains_[i], 0.0f, 1.0f);
+    auto& pats = drive_[i];
+    pats.assign(std::max<size_t>(c.drive_patterns, 1), std::vector<float>(n_in, 0.0f));
+    for (auto& pat : pats) {
+        for (auto& x : pat) x = (u(rng) < frac) ? c.drive_current * (0.5f + u(rng)) : 0.0f;
+    }
+}
+
+// =============================================================================
+// 运行
+// =============================================================================
+
+void SyntheticBrain::step() {
+    size_t R = engine_.num_regions();
+    size_t k = static_cast<size_t>(t_) % drive_[0].size();
+    // 背景驱动是 O(神经元数) 的串行前置工作, 与区域步进同样按区域并行
+#ifdef WUYUN_OPENMP
+    #pragma omp parallel for schedule(dynamic) if (R > 1)
+#endif
+    for (int64_t i = 0; i < static_cast<int64_t>(R); ++i) {
+        if (engine_.is_active(static_cast<size_t>(i)))
+            engine_.region(static_cast<size_t>(i)).inject_external(drive_[i][k]);
+    }
+    engine_.step();
+    ++t_;
+}
+
+void SyntheticBrain::run(int32_t n_steps) {
+    for (int32_t s = 0; s < n_steps; ++s) step();
+}
+
+size_t SyntheticBrain::count_spikes(size_t i) const {
+    const auto& f = engine_.region(i).fired();
+    size_t n = 0;
+    for (uint8_t x : f) n += x ? 1 : 0;
+    return n;
+}
+
+std::vector<float> SyntheticBrain::measure_rates(int32_t n_steps) {
+    size_t R = engine_.num_regions();
+    std::vector<uint64_t> count(R, 0);
+    for (int32_t s = 0; s < n_steps; ++s) {
+        step();
+        for (size_t i = 0; i < R; ++i) {
+            count[i] += count_spikes(i);
+        }
+    }
+    std::vector<float> rates(R, 0.0f);
+    for (size_t i = 0; i < R; ++i) {
+        double per_neuron_step = static_cast<double>(count[i])
+            / (static_cast<double>(engine_.region(i).n_neurons()) * std::max(n_steps, 1));
+        rates[i] = static_cast<float>(per_neuron_step * 1000.0);   // dt = 1 ms
+    }
+    return rates;
+}
+
+std::vector<float> SyntheticBrain::calibrate(int rounds, int32_t steps_per_round) {
+    // 驱动为超阈值脉冲, 发放率随受驱比例单调上升, 但皮层间递归有滞回与陡峭跃迁:
+    // 大步长会把网络推入高活动态, 固定步长会在跃迁两侧来回振荡。
+    // 每区域对数步长从 ×1.25 起, 方向反转时减半 (对数域二分); 每轮先稳定 steps/4 步再测量。
+    // 基底节 GPi/GPe 为内源性紧张放电, 不参与校准
+    size_t R = engine_.num_regions();
+    const float target = std::max(config_.target_rate_hz, 0.01f);
+    std::vector<float> log_step(R, std::log(1.25f));
+    std::vector<int>   last_dir(R, 0);
+    std::vector<float> rates;
+    for (int r = 0; r < rounds; ++r) {
+        run(std::max(steps_per_round / 4, 1));
+        rates = measure_rates(steps_per_round);
+        if (r + 1 == rounds) break;
+        for (size_t i = 0; i < R; ++i) {
+            if (kinds_[i] == RegionKind::BG || rates[i] == target) continue;
+            int dir = (rates[i] < target) ? 1 : -1;
+            if (last_dir[i] != 0 && dir != last_dir[i]) log_step[i] *= 0.5f;
+            last_dir[i] = dir;
+            gains_[i] = std::clamp(gains_[i] * std::exp(dir * log_step[i]), 0.05f, 20.0f);
+            build_drive(i);
+        }
+    }
+    return rates;
+}
+
+std::string SyntheticBrain::summary() const {
+    size_t n_ctx = 0, n_thal = 0, n_bg = 0;
+    for (auto k : kinds_) {
+        if (k == RegionKind::CORTICAL) ++n_ctx;
+        else if (k == RegionKind::THALAMIC) ++n_thal;
+        else ++n_bg;
+    }
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "SyntheticBrain: %zu regions (%zu ctx, %zu thal, %zu bg), %zu neurons, "
+                  "%zu projections, delay U[%d,%d]",
+                  engine_.num_regions(), n_ctx, n_thal, n_bg, total_neurons_, edges_.size(),
+                  config_.delay_min, config_.delay_max);
+    return buf;
+}
+
+} // namespace wuyun
@@ -0,0 +1,114 @@
+#pragma once
+/**
+ * SyntheticBrain — 参数化合成脑 (引擎规模研究)
+ *
+ * ClosedLoopAgent::build_brain 面向 5×5 视网膜调参, 区域只有几十到几百个神经元,
+ * 无法考察 10^4~10^6 神经元时引擎的表现。本生成器用现有区域类型
+ * (CorticalRegion / ThalamicRelay / BasalGanglia) 拼出任意规模的 SimulationEngine:
+ *
+ *   - 区域数与类型比例 (丘脑 / 基底节, 其余为皮层柱), 每区域神经元数 (可带离散度)
+ *   - 区域内连接: 各通路连接概率按 min(默认概率, fan_in / n_pre) 截断,
+ *     每个神经元的期望输入数不随规模增长 (突触数 ∝ 神经元数)
+ *   - 区域间投射: 环形骨架保证连通, 其余有序对以 projection_density 概率投射
+ *     (基底节只投射到丘脑);
+ *     每个到达脉冲激活的目标数上限为 spike_fan_out (皮层 L4 / 基底节 MSN 映射)
+ *   - 投射延迟 ~ U[delay_min, delay_max] 步
+ *   - 发放率目标: 每区域背景驱动 (预生成的稀疏超阈值电流模式循环注入) 的
+ *     受驱比例由 calibrate() 按实测发放率做乘性校准 (尽力而为, 返回实测值)。皮层跨区域耦合保持弱 (input_psp),
+ *     发放率才随驱动单调变化; 强耦合下皮层柱呈双稳态 (静息 / ~150 Hz 饱和)。
+ *     基底节 GPi/GPe 为内源性紧张放电, 其发放率基本不受驱动影响
+ *
+ * 构造与驱动完全由 seed 决定 (同配置同种子 → 同拓扑同轨迹)。
+ */
+
+#include "engine/simulation_engine.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wuyun {
+
+struct SyntheticBrainConfig {
+    // --- 区域 ---
+    size_t n_regions          = 8;
+    size_t neurons_per_region = 1000;
+    float  size_spread        = 0.0f;    // 区域规模 ~ N × U[1-s, 1+s] (负载不均研究)
+    float  frac_thalamic      = 0.25f;
+    float  frac_bg            = 0.125f;  // 其余为皮层
+
+    // --- 连接 ---
+    float  intra_fan_in        = 30.0f;  // 区域内每通路每神经元期望输入数
+    float  projection_density  = 0.2f;   // 有序区域对的投射概率 (环形骨架之外)
+    size_t spike_fan_out       = 20;     // 每个到达脉冲激活的目标神经元数上限
+    float  input_psp           = 4.0f;   // 皮层跨区域输入 PSP 总量, 按入度均分
+                                         // (build_brain 小区域每投射用 35; 大区域汇聚的
+                                         // 脉冲多, 弱耦合才不会整体饱和)
+    int32_t delay_min          = 1;
+    int32_t delay_max          = 5;
+
+    // --- 活动 ---
+    float  target_rate_hz      = 5.0f;   // calibrate() 的目标平均发放率
+    float  drive_fraction      = 0.02f;  // 每步接受背景驱动的输入神经元比例 (增益 1 时)
+    float  drive_current       = 300.0f; // 背景电流幅度 (超阈值, 受驱神经元基本必发放)
+    size_t drive_patterns      = 8;      // 预生成驱动模式数 (循环使用)
+
+    uint32_t seed = 1;
+};
+
+class SyntheticBrain {
+public:
+    enum class RegionKind { CORTICAL, THALAMIC, BG };
+
+    explicit SyntheticBrain(const SyntheticBrainConfig& config);
+
+    SimulationEngine&       engine()       { return engine_; }
+    const SimulationEngine& engine() const { return engine_; }
+
+    /** 注入背景驱动后推进一步 */
+    void step();
+    void run(int32_t n_steps);
+
+    /** 各区域最近 n_steps 步的平均发放率 (Hz, dt = 1 ms) */
+    std::vector<float> measure_rates(int32_t n_steps);
+
+    /**
+     * 乘性校准各区域背景驱动增益 (受驱比例), 使发放率接近 target_rate_hz
+     * 基底节不参与 (内源性紧张放电)
+     * @return 最后一轮各区域发放率 (Hz)
+     */
+    std::vector<float> calibrate(int rounds = 8, int32_t steps_per_round = 200);
+
+    // --- 查询 ---
+    const SyntheticBrainConfig& config() const { return config_; }
+    RegionKind region_kind(size_t i) const { return kinds_[i]; }
+    float  drive_gain(size_t i)      const { return gains_[i]; }
+    size_t total_neurons()   const { return total_neurons_; }
+    size_t num_projections() const { return edges_.size(); }
+
+    /** 文本摘要: 区域类型统计 + 神经元/投射数 */
+    std::string summary() const;
+
+private:
+    void plan_topology();
+    void build_regions();
+    void build_drive(size_t i);
+    size_t count_spikes(size_t i) const;
+
+    SyntheticBrainConfig config_;
+    SimulationEngine engine_;
+    struct Edge {
+        size_t  src, dst;
+        int32_t delay;
+    };
+
+    std::vector<RegionKind> kinds_;
+    std::vector<size_t>     sizes_;
+    std::vector<Edge>       edges_;
+    std::vector<size_t>     in_degree_;
+    std::vector<float> gains_;
+    std::vector<std::vector<std::vector<float>>> drive_;   // [区域][模式] 稠密电流
+    size_t   total_neurons_ = 0;
+    int32_t  t_ = 0;
+};
+
+} // namespace wuyun
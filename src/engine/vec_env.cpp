@@ -0,0 +1,92 @@
+#include "engine/vec_env.h"
+#include "engine/grid_world_env.h"
+
+namespace wuyun {
+
+VecEnv::VecEnv(size_t n, const EnvFactory& make, uint32_t seed0)
+    : reward_(n, 0.0f)
+    , pos_x_(n, 0.0f)
+    , pos_y_(n, 0.0f)
+    , positive_(n, 0)
+    , negative_(n, 0)
+{
+    envs_.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        envs_.push_back(make(seed0 + static_cast<uint32_t>(i)));
+        pos_x_[i] = envs_[i]->pos_x();
+        pos_y_[i] = envs_[i]->pos_y();
+    }
+    if (n > 0) {
+        vis_w_ = envs_[0]->vis_width();
+        vis_h_ = envs_[0]->vis_height();
+    }
+    obs_.resize(n * obs_size());
+}
+
+VecEnv VecEnv::grid_world(size_t n, const GridWorldConfig& cfg) {
+    return VecEnv(n, [cfg](uint32_t seed) -> std::unique_ptr<Environment> {
+        GridWorldConfig c = cfg;
+        c.seed = seed;
+        return std::make_unique<GridWorldEnv>(c);
+    }, cfg.seed);
+}
+
+VecEnv VecEnv::multi_room(size_t n, const MultiRoomConfig& cfg) {
+    return VecEnv(n, [cfg](uint32_t seed) -> std::unique_ptr<Environment> {
+        MultiRoomConfig c = cfg;
+        c.seed = seed;
+        return std::make_unique<MultiRoomEnv>(c);
+    }, cfg.seed);
+}
+
+void VecEnv::reset() {
+    for (size_t i = 0; i < envs_.size(); ++i) {
+        envs_[i]->reset();
+        pos_x_[i] = envs_[i]->pos_x();
+        pos_y_[i] = envs_[i]->pos_y();
+    }
+}
+
+void VecEnv::reset(size_t i, uint32_t seed) {
+    if (i >= envs_.size()) return;
+    envs_[i]->reset_with_seed(seed);
+    pos_x_[i] = envs_[i]->pos_x();
+    pos_y_[i] = envs_[i]->pos_y();
+}
+
+void VecEnv::observe_into(float* out) const {
+    const size_t stride = obs_size();
+    for (size_t i = 0; i < envs_.size(); ++i) {
+        envs_[i]->observe_into(out + i * stride);
+    }
+}
+
+const std::vector<float>& VecEnv::observe_all() {
+    observe_into(obs_.data());
+    return obs_;
+}
+
+void VecEnv::step(const float* dx, const float* dy) {
+    for (size_t i = 0; i < envs_.size(); ++i) {
+        Environment::Result r = envs_[i]->step(dx[i], dy[i]);
+        reward_[i]   = r.reward;
+        pos_x_[i]    = r.pos_x;
+        pos_y_[i]    = r.pos_y;
+        positive_[i] = r.positive_event;
+        negative_[i] = r.negative_event;
+    }
+}
+
+uint64_t VecEnv::total_positive() const {
+    uint64_t n = 0;
+    for (const auto& e : envs_) n += e->positive_count();
+    return n;
+}
+
+uint64_t VecEnv::total_negative() const {
+    uint64_t n = 0;
+    for (const auto& e : envs_) n += e->negative_count();
+    return n;
+}
+
+} // namespace wuyun
@@ -0,0 +1,86 @@
+#pragma once
+/**
+ * VecEnv — 批量环境 (N 个世界一次 step / observe)
+ *
+ * 多智能体、集成评估与进化种群要同时推进许多世界; 逐个持有 Environment
+ * 再逐个 observe() 意味着每世界每步一次堆分配和一次虚调用链。
+ * VecEnv 持有 N 个同构环境 (同一配置、各自种子), 一次调用推进全部:
+ *
+ *   - observe_into / observe_all: 全部观测写入一块连续矩阵 [n × obs_size] (行优先),
+ *     各世界经 Environment::observe_into 直接写入自己的行, 无分配
+ *   - step(dx, dy): 逐世界执行位移, 结果写入 SoA 数组 (reward / pos / 事件标志)
+ *
+ * 每个世界仍是完整的环境实例 (保留各自的 RNG 流、迷宫与重生规则),
+ * 批量结果与逐个推进单个环境逐位一致。
+ */
+
+#include "engine/environment.h"
+#include "engine/grid_world.h"
+#include "engine/multi_room_env.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace wuyun {
+
+/** 按种子构造一个世界 */
+using EnvFactory = std::function<std::unique_ptr<Environment>(uint32_t seed)>;
+
+class VecEnv {
+public:
+    /**
+     * @param n      世界数
+     * @param make   工厂; 第 i 个世界用种子 seed0 + i 构造 (视野尺寸须相同)
+     */
+    VecEnv(size_t n, const EnvFactory& make, uint32_t seed0 = 42);
+
+    /** N 个 GridWorldEnv, 种子 cfg.seed + i */
+    static VecEnv grid_world(size_t n, const GridWorldConfig& cfg);
+    /** N 个 MultiRoomEnv, 种子 cfg.seed + i */
+    static VecEnv multi_room(size_t n, const MultiRoomConfig& cfg);
+
+    size_t size()       const { return envs_.size(); }
+    size_t vis_width()  const { return vis_w_; }
+    size_t vis_height() const { return vis_h_; }
+    size_t obs_size()   const { return vis_w_ * vis_h_; }
+
+    /** 全部世界重置 (各自当前种子) */
+    void reset();
+    /** 第 i 个世界换种子重置 (i 越界时忽略) */
+    void reset(size_t i, uint32_t seed);
+
+    /** 全部观测 → out[0 .. size() × obs_size()) */
+    void observe_into(float* out) const;
+    /** 全部观测写入内部矩阵并返回 (缓冲复用) */
+    const std::vector<float>& observe_all();
+
+    /** 第 i 个世界执行 (dx[i], dy[i]); 结果见 reward()/pos_x()/pos_y()/positive()/negative() */
+    void step(const float* dx, const float* dy);
+    void step(const std::vector<float>& dx, const std::vector<float>& dy) { step(dx.data(), dy.data()); }
+
+    // --- 上一次 step 的结果 (SoA, 长度 size()) ---
+    const std::vector<float>&   reward()   const { return reward_; }
+    const std::vector<float>&   pos_x()    const { return pos_x_; }
+    const std::vector<float>&   pos_y()    const { return pos_y_; }
+    const std::vector<uint8_t>& positive() const { return positive_; }
+    const std::vector<uint8_t>& negative() const { return negative_; }
+
+    /** 累计统计之和 (全部世界) */
+    uint64_t total_positive() const;
+    uint64_t total_negative() const;
+
+    Environment&       env(size_t i)       { return *envs_[i]; }
+    const Environment& env(size_t i) const { return *envs_[i]; }
+
+private:
+    std::vector<std::unique_ptr<Environment>> envs_;
+    size_t vis_w_ = 0, vis_h_ = 0;
+
+    std::vector<float>   obs_;
+    std::vector<float>   reward_, pos_x_, pos_y_;
+    std::vector<uint8_t> positive_, negative_;
+};
+
+} // namespace wuyun
@@ -210,10 +210,13 @@ Genome EvolutionEngine::run() {
             }
         }
 
-        // Wait with progress dots
-        while (done_count.load() < population_.size()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            printf(".");
+        // Wait with progress dots (one per finished individual; short poll so
+        // generation wall time is not rounded up to the poll period)
+        size_t reported = 0;
+        while (reported < population_.size()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            size_t done = done_count.load();
+            for (; reported < done; ++reported) printf(".");
             fflush(stdout);
         }
         for (auto& th : threads) th.join();
@@ -18,6 +18,7 @@
 #include "stdp.h"
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 
 namespace wuyun {
 
@@ -9,6 +9,7 @@ SynapticScaler::SynapticScaler(size_t n_neurons, const HomeostaticParams& params
     : n_(n_neurons)
     , params_(params)
     , rates_(n_neurons, params.target_rate)  // Initialize at target
+    , counts_(n_neurons, 0)
 {}
 
 void SynapticScaler::update_rates(const uint8_t* fired, float dt) {
@@ -23,6 +24,28 @@ void SynapticScaler::update_rates(const uint8_t* fired, float dt) {
     }
 }
 
+void SynapticScaler::accumulate_spikes(const uint8_t* fired) {
+    for (size_t i = 0; i < n_; ++i) {
+        counts_[i] = static_cast<uint16_t>(counts_[i] + (fired[i] ? 1 : 0));
+    }
+}
+
+void SynapticScaler::flush_rates(uint32_t n_steps, float dt) {
+    if (n_steps == 0) return;
+    // One EMA update over the whole window:
+    // alpha_window = 1 - (1 - dt/tau)^n  (same decay as n per-step updates)
+    float window_ms = dt * static_cast<float>(n_steps);
+    float inv_window_s = 1000.0f / window_ms;
+    float alpha = 1.0f - std::pow(1.0f - dt / params_.tau_rate,
+                                  static_cast<float>(n_steps));
+
+    for (size_t i = 0; i < n_; ++i) {
+        float window_rate = static_cast<float>(counts_[i]) * inv_window_s;
+        rates_[i] += alpha * (window_rate - rates_[i]);
+        counts_[i] = 0;
+    }
+}
+
 float SynapticScaler::mean_rate() const {
     if (n_ == 0) return 0.0f;
     float sum = 0.0f;
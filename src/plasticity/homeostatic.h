@@ -27,6 +27,7 @@ struct HomeostaticParams {
     float w_min            = 0.01f;   // 权重下限 (不允许降到0)
     float w_max            = 2.0f;    // 权重上限
     uint32_t scale_interval = 100;    // 每 N 步执行一次缩放
+    uint32_t rate_interval  = 10;     // 每 N 步折算一次发放率 (其间只累加 spike 计数)
 };
 
 /**
@@ -50,6 +51,18 @@ public:
      */
     void update_rates(const uint8_t* fired, float dt = 1.0f);
 
+    /**
+     * 慢时钟路径: 每步只累加 spike 计数 (整数加法)
+     * 由 flush_rates() 每 rate_interval 步折算到发放率估计
+     */
+    void accumulate_spikes(const uint8_t* fired);
+
+    /**
+     * 把累计计数折算为发放率 (窗口 = n_steps × dt), 并清零计数
+     * 等价于 n_steps 次 update_rates 的平均发放率近似
+     */
+    void flush_rates(uint32_t n_steps, float dt = 1.0f);
+
     /**
      * 对一组突触权重应用缩放
      *
@@ -69,6 +82,7 @@ private:
     size_t n_;
     HomeostaticParams params_;
     std::vector<float> rates_;   // 滑动平均发放率估计 (Hz)
+    std::vector<uint16_t> counts_;  // 当前窗口 spike 计数 (accumulate_spikes)
 };
 
 } // namespace wuyun
@@ -0,0 +1,32 @@
+#pragma once
+/**
+ * Structural Plasticity — 结构可塑性 (突触剪除 + 活动相关生长)
+ *
+ * 剪除: STDP/稳态把大量突触推到 w_min 后, 它们仍在每步被衰减/相乘/散射。
+ *   权重持续 prune_window 步低于 prune_threshold → 标记剪除 (权重置 0, 不再贡献)
+ *   权重扫描每 check_interval 步一次 (摊销到慢时钟, 不进入每步热路径)
+ *
+ * 生长 (可选): pre/post 发放率迹都高的未连接对 → 新建 w_init 突触
+ *   (Hebbian 突触发生: 共同活跃的神经元倾向于形成新连接)
+ *
+ * 压缩: 被标记的突触在 SynapseGroup::compact() 时才真正移出 CSR,
+ *   由调用方放在热路径之外 (如睡眠巩固结束时)
+ */
+
+#include <cstdint>
+
+namespace wuyun {
+
+struct StructuralParams {
+    float    prune_threshold = 0.02f;   // 低于此权重视为"死"突触
+    uint32_t prune_window    = 2000;    // 持续低于阈值的步数 → 剪除
+    uint32_t check_interval  = 100;     // 每 N 步扫描一次权重
+
+    bool     grow_enabled    = false;   // 活动相关生长
+    float    grow_threshold  = 0.01f;   // pre 迹 × post 迹 (每步发放概率之积) 阈值
+    float    grow_w_init     = 0.1f;    // 新突触初始权重
+    uint32_t grow_samples    = 1000;    // 每次压缩随机采样的候选 (pre, post) 对数
+    float    rate_tau        = 1000.0f; // 发放率迹时间常数 (ms)
+};
+
+} // namespace wuyun
@@ -70,17 +70,88 @@ public:
     NeuromodulatorSystem&       neuromod()       { return neuromod_; }
     const NeuromodulatorSystem& neuromod() const { return neuromod_; }
 
+    // --- 慢时钟 (多速率调度) ---
+
+    /** 由引擎接管振荡/调质推进 (add_region 时设置, 之后 step() 不再逐步推进) */
+    void set_external_clocks(bool external) { external_clocks_ = external; }
+    bool external_clocks() const { return external_clocks_; }
+
+    /** 振荡时钟: dt 为该时钟周期对应的毫秒数 */
+    void step_oscillation(float dt) { oscillation_.step(dt); }
+
+    /** 调质时钟: phasic 衰减, dt 同上 (未推进调质的区域为空操作) */
+    void step_neuromod(float dt) { if (steps_neuromod_) neuromod_.step(dt); }
+    bool steps_neuromod() const { return steps_neuromod_; }
+
+    // --- 静息跳过 (SimulationEngine::set_quiescence_skipping) ---
+
+    /**
+     * 本步可整体跳过: 无待处理输入、门控变量 < eps、无 burst、跳过期间不会发放
+     * (子类按自身状态实现, 可用 skipped_steps() 推算跳过期间的内部节律; 默认从不静息)
+     * 到达脉冲由引擎单独判断, 有到达脉冲的步不会询问
+     */
+    virtual bool quiescent() const { return false; }
+
+    /** 跳过的步数补齐: 阈下状态按指数弛豫解析推进, 各衰减缓冲乘以衰减因子的 n 次幂 */
+    virtual void catch_up(int32_t n_steps, float dt) { (void)n_steps; (void)dt; }
+
+    /** 引擎调用: 静息则记一步跳过并返回 true */
+    bool skip_if_quiescent(float dt) {
+        if (!quiescent()) return false;
+        ++skipped_steps_;
+        ++skipped_total_;
+        skip_dt_ = dt;
+        return true;
+    }
+
+    /** 唤醒 (有输入/恢复逐步/改变跳过期间所依赖的模式前), 补齐已跳过的步 */
+    void wake() {
+        if (skipped_steps_ == 0) return;
+        int32_t n = skipped_steps_;
+        skipped_steps_ = 0;
+        catch_up(n, skip_dt_);
+    }
+
+    int32_t  skipped_steps() const { return skipped_steps_; }   // 当前连续跳过 (未补齐)
+    uint64_t skipped_total() const { return skipped_total_; }   // 累计跳过
+
+    // --- 权重存储格式 (SimulationEngine::set_weight_format) ---
+
+    /** 切换区域内 SynapseGroup 的权重格式 (默认: 无 SynapseGroup 或不支持, 忽略) */
+    virtual void set_weight_format(WeightFormat fmt) { (void)fmt; }
+
+    // --- 结构可塑性 (SimulationEngine::compact_synapses) ---
+
+    /** 压缩已剪除突触 (离线阶段调用); 返回移出数, 默认无结构可塑性 */
+    virtual size_t compact_synapses() { return 0; }
+
     /** 获取发放状态 (子类负责填充) */
     virtual const std::vector<uint8_t>& fired()      const = 0;
     virtual const std::vector<int8_t>&  spike_type()  const = 0;
 
 protected:
+    /** 子类 step() 开头调用: 独立运行时逐步推进振荡/调质, 引擎接管后为空操作 */
+    void advance_local_clocks(float dt) {
+        if (external_clocks_) return;
+        oscillation_.step(dt);
+        if (steps_neuromod_) neuromod_.step(dt);
+    }
+
     std::string name_;
     uint32_t    region_id_ = 0;
     size_t      n_neurons_;
 
     OscillationTracker   oscillation_;
     NeuromodulatorSystem neuromod_;
+
+    bool external_clocks_ = false;
+    // 是否推进自身调质 phasic 衰减; 调质核团 (VTA/LC/DRN/NBM)、LHb、小脑
+    // 只推进振荡, 构造时置 false
+    bool steps_neuromod_ = true;
+
+    int32_t  skipped_steps_ = 0;
+    uint64_t skipped_total_ = 0;
+    float    skip_dt_ = 1.0f;
 };
 
 } // namespace wuyun
@@ -1,9 +1,17 @@
 #include "region/cortical_region.h"
 #include <algorithm>
+#include <cmath>
 #include <random>
 
 namespace wuyun {
 
+// 区域名 → 种子扰动 (FNV-1a, 跨平台稳定)
+static uint32_t name_seed(const std::string& name) {
+    uint32_t h = 2166136261u;
+    for (unsigned char c : name) { h ^= c; h *= 16777619u; }
+    return h;
+}
+
 CorticalRegion::CorticalRegion(const std::string& name, const ColumnConfig& config)
     : BrainRegion(name, config.n_l4_stellate + config.n_l23_pyramidal +
                         config.n_l5_pyramidal + config.n_l6_pyramidal +
@@ -17,12 +25,15 @@ CorticalRegion::CorticalRegion(const std::string& name, const ColumnConfig& conf
     , psp_current_burst_(config.input_psp_burst)
     , psp_fan_out_(std::max<size_t>(3, static_cast<size_t>(config.n_l4_stellate * config.input_fan_out_frac)))
     , pc_prediction_buf_(config.n_l23_pyramidal, 0.0f)
-{}
+{
+    uint32_t seed = config.sleep_noise_seed ^ name_seed(name);
+    rem_rng_.seed(seed);
+    pgo_rng_.seed(seed ^ 0x9E3779B9u);
+}
 
 void CorticalRegion::step(int32_t t, float dt) {
     // Update oscillation and neuromodulation
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // === Sleep slow oscillation (~1Hz up/down states) ===
     if (sleep_mode_) {
@@ -42,14 +53,13 @@ void CorticalRegion::step(int32_t t, float dt) {
 
     // === REM sleep: desynchronized noise + motor atonia ===
     if (rem_mode_) {
-        static std::mt19937 rem_rng(33333);
         float bias = REM_NOISE_AMP * 0.6f;       // ~15 baseline
         float jitter_range = REM_NOISE_AMP * 0.4f; // ~10 jitter
         std::uniform_real_distribution<float> noise(-jitter_range, jitter_range);
         auto& l23 = column_.l23();
         auto& l5  = column_.l5();
-        for (size_t i = 0; i < l23.size(); ++i) l23.inject_basal(i, bias + noise(rem_rng));
-        for (size_t i = 0; i < l5.size(); ++i)  l5.inject_basal(i, bias + noise(rem_rng));
+        for (size_t i = 0; i < l23.size(); ++i) l23.inject_basal(i, bias + noise(rem_rng_));
+        for (size_t i = 0; i < l5.size(); ++i)  l5.inject_basal(i, bias + noise(rem_rng_));
 
         // Motor atonia: suppress L5 output (prevents acting out dreams)
         if (motor_atonia_) {
@@ -79,9 +89,10 @@ void CorticalRegion::step(int32_t t, float dt) {
         wm_da_gain_ = 1.0f + WM_DA_SENSITIVITY * da;
 
         auto& l23 = column_.l23();
+        const auto& order = column_.l23_order();
         for (size_t i = 0; i < wm_recurrent_buf_.size(); ++i) {
             if (wm_recurrent_buf_[i] > 0.5f) {
-                l23.inject_basal(i, wm_recurrent_buf_[i] * wm_da_gain_);
+                l23.inject_basal(order.to_internal(i), wm_recurrent_buf_[i] * wm_da_gain_);
             }
             wm_recurrent_buf_[i] *= WM_DECAY;
         }
@@ -105,13 +116,15 @@ void CorticalRegion::step(int32_t t, float dt) {
     }
 
     // Inject decaying PSP buffer into L4 basal (feedforward sensory input)
+    // 缓冲按外部 ID (拓扑映射) 排列, 注入时转换到群体内部下标
     auto& l4 = column_.l4();
+    const auto& l4_order = column_.l4_order();
     for (size_t i = 0; i < psp_buffer_.size(); ++i) {
         if (psp_buffer_[i] > 0.5f) {
             float current = psp_buffer_[i] * att_gain;  // Attention gain on feedforward
             if (pc_enabled_) current *= pc_precision_sensory_;
             else current *= ne_gain;
-            l4.inject_basal(i, current);
+            l4.inject_basal(l4_order.to_internal(i), current);
         }
         psp_buffer_[i] *= PSP_DECAY;
     }
@@ -125,7 +138,7 @@ void CorticalRegion::step(int32_t t, float dt) {
                 // Prediction arrives as INHIBITORY input to L2/3 apical
                 // (predictions suppress prediction error units)
                 float pred = pc_prediction_buf_[i] * pc_precision_prior_;
-                l23.inject_apical(i, -pred);  // Negative = suppressive
+                l23.inject_apical(column_.l23_order().to_internal(i), -pred);  // Negative = suppressive
                 error_sum += pc_prediction_buf_[i];
             }
             pc_prediction_buf_[i] *= PC_PRED_DECAY;
@@ -142,9 +155,10 @@ void CorticalRegion::step(int32_t t, float dt) {
     if (wm_enabled_) {
         auto& l23 = column_.l23();
         const auto& l23_fired = l23.fired();
+        const auto& order = column_.l23_order();
         size_t fan = static_cast<size_t>(WM_FAN_OUT);
         for (size_t i = 0; i < l23.size(); ++i) {
-            if (l23_fired[i]) {
+            if (l23_fired[order.to_internal(i)]) {
                 for (size_t k = 0; k <= fan; ++k) {
                     size_t idx = (i + k) % l23.size();
                     wm_recurrent_buf_[idx] += WM_RECURRENT_STR;
@@ -157,6 +171,58 @@ void CorticalRegion::step(int32_t t, float dt) {
     aggregate_firing_state();
 }
 
+// =============================================================================
+// 静息跳过
+// =============================================================================
+
+bool CorticalRegion::quiescent() const {
+    if (rem_mode_ || tonic_drive_ > 0.01f || attention_gain_ > 1.01f) return false;
+    // 缓冲只在 > 0.5 时注入, 低于此值只衰减
+    for (float v : psp_buffer_) if (v > 0.5f) return false;
+    if (pc_enabled_) for (float v : pc_prediction_buf_) if (v > 0.5f) return false;
+    if (wm_enabled_) for (float v : wm_recurrent_buf_) if (v > 0.5f) return false;
+
+    // 睡眠: 整段跳过须处于同一 up/down 状态 (下行态抑制作为恒定电流解析处理)
+    float i_exc = 0.0f;
+    if (sleep_mode_) {
+        float first = slow_wave_phase_ + SLOW_WAVE_FREQ;
+        float next  = slow_wave_phase_ + SLOW_WAVE_FREQ * static_cast<float>(skipped_steps_ + 1);
+        if (next >= 1.0f) return false;
+        bool down = first >= UP_DUTY_CYCLE;
+        if (down != (next >= UP_DUTY_CYCLE)) return false;
+        if (down) i_exc = DOWN_STATE_INH;
+    }
+    return column_.quiescent(i_exc);
+}
+
+void CorticalRegion::catch_up(int32_t n_steps, float dt) {
+    float n = static_cast<float>(n_steps);
+
+    float i_exc = 0.0f;
+    if (sleep_mode_) {
+        // 与逐步相同的相位累加 (跳过段不跨越 up/down 边界, 见 quiescent)
+        for (int32_t k = 0; k < n_steps; ++k) {
+            slow_wave_phase_ += SLOW_WAVE_FREQ;
+            if (slow_wave_phase_ >= 1.0f) slow_wave_phase_ -= 1.0f;
+        }
+        if (slow_wave_phase_ >= UP_DUTY_CYCLE) i_exc = DOWN_STATE_INH;
+    }
+
+    float psp_factor = std::pow(PSP_DECAY, n);
+    for (auto& v : psp_buffer_) v *= psp_factor;
+    if (pc_enabled_) {
+        float pred_factor = std::pow(PC_PRED_DECAY, n);
+        for (auto& v : pc_prediction_buf_) v *= pred_factor;
+        pc_error_smooth_ *= std::pow(1.0f - PC_ERROR_SMOOTH, n);
+    }
+    if (wm_enabled_) {
+        float wm_factor = std::pow(WM_DECAY, n);
+        for (auto& v : wm_recurrent_buf_) v *= wm_factor;
+    }
+
+    column_.catch_up(n_steps, dt, i_exc);
+}
+
 void CorticalRegion::replay_cortical_step(int32_t t, float dt) {
     // Lightweight replay step for cortical STDP consolidation.
     // Only: PSP buffer → L4 injection → column step (neurons + STDP)
@@ -169,7 +235,7 @@ void CorticalRegion::replay_cortical_step(int32_t t, float dt) {
     auto& l4 = column_.l4();
     for (size_t i = 0; i < psp_buffer_.size(); ++i) {
         if (psp_buffer_[i] > 0.5f) {
-            l4.inject_basal(i, psp_buffer_[i]);
+            l4.inject_basal(column_.l4_order().to_internal(i), psp_buffer_[i]);
         }
         psp_buffer_[i] *= PSP_DECAY;
     }
@@ -274,21 +340,23 @@ void CorticalRegion::inject_attention(float vip_current) {
 void CorticalRegion::aggregate_firing_state() {
     // Merge all population firing states into a single flat vector
     // Order: L4, L23, L5, L6, PV, SST, VIP
+    // 区域输出按外部 ID 排列 (locality_reorder 时从内部下标映射回来)
     size_t offset = 0;
-    auto copy_pop = [&](const NeuronPopulation& pop) {
+    auto copy_pop = [&](const NeuronPopulation& pop, const NeuronOrder& order) {
         const auto& f = pop.fired();
         const auto& s = pop.spike_type();
         for (size_t i = 0; i < pop.size(); ++i) {
-            fired_[offset + i]      = f[i];
-            spike_type_[offset + i] = s[i];
+            size_t k = order.to_internal(i);
+            fired_[offset + i]      = f[k];
+            spike_type_[offset + i] = s[k];
         }
         offset += pop.size();
     };
 
-    copy_pop(column_.l4());
-    copy_pop(column_.l23());
-    copy_pop(column_.l5());
-    copy_pop(column_.l6());
+    copy_pop(column_.l4(),  column_.l4_order());
+    copy_pop(column_.l23(), column_.l23_order());
+    copy_pop(column_.l5(),  column_.l5_order());
+    copy_pop(column_.l6(),  column_.l6_order());
 
     // Access inhibitory populations through column internals
     // For now, the remaining slots stay 0 (inhibitory firing not exported)
@@ -318,6 +386,7 @@ float CorticalRegion::wm_persistence() const {
 }
 
 void CorticalRegion::set_rem_mode(bool rem) {
+    wake();
     rem_mode_ = rem;
     sleep_mode_ = false;  // REM and NREM are mutually exclusive
     slow_wave_phase_ = 0.0f;
@@ -326,11 +395,10 @@ void CorticalRegion::set_rem_mode(bool rem) {
 void CorticalRegion::inject_pgo_wave(float amplitude) {
     // PGO (ponto-geniculo-occipital) wave: burst of random L4 activation
     // Simulates dream imagery generation in visual cortex
-    static std::mt19937 pgo_rng(55555);
     std::uniform_real_distribution<float> dist(0.0f, amplitude);
     auto& l4 = column_.l4();
     for (size_t i = 0; i < l4.size(); ++i) {
-        l4.inject_basal(i, dist(pgo_rng));
+        l4.inject_basal(i, dist(pgo_rng_));
     }
 }
 
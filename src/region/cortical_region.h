@@ -10,6 +10,7 @@
 
 #include "region/brain_region.h"
 #include "circuit/cortical_column.h"
+#include <random>
 #include <set>
 #include <unordered_map>
 
@@ -28,6 +29,12 @@ public:
     void submit_spikes(SpikeBus& bus, int32_t t) override;
     void inject_external(const std::vector<float>& currents) override;
 
+    /** 静息: 无残余 PSP/预测/工作记忆输入, 无噪声/驱动; 睡眠时跳过段不跨越 up/down 边界 */
+    bool quiescent() const override;
+    void catch_up(int32_t n_steps, float dt) override;
+    void set_weight_format(WeightFormat fmt) override { column_.set_weight_format(fmt); }
+    size_t compact_synapses() override { return column_.compact_synapses(); }
+
     const std::vector<uint8_t>& fired()      const override { return fired_; }
     const std::vector<int8_t>&  spike_type()  const override { return spike_type_; }
 
@@ -110,6 +117,9 @@ public:
 
     /** 启用稳态可塑性 (突触缩放, 维持E/I平衡) */
     void enable_homeostatic(const HomeostaticParams& params = {}) { column_.enable_homeostatic(params); }
+    void enable_structural_plasticity(const StructuralParams& params = {}) {
+        column_.enable_structural_plasticity(params);
+    }
     bool homeostatic_enabled() const { return column_.has_homeostatic(); }
 
     /** 各层平均发放率 (诊断) */
@@ -121,7 +131,7 @@ public:
     // --- 睡眠慢波接口 ---
 
     /** 设置睡眠模式 (NREM慢波 up/down 状态交替) */
-    void set_sleep_mode(bool sleep) { sleep_mode_ = sleep; rem_mode_ = false; slow_wave_phase_ = 0.0f; }
+    void set_sleep_mode(bool sleep) { wake(); sleep_mode_ = sleep; rem_mode_ = false; slow_wave_phase_ = 0.0f; }
     bool is_sleep_mode() const { return sleep_mode_; }
 
     /** 当前是否处于 up state (慢波上升期, 神经元可兴奋) */
@@ -205,6 +215,8 @@ private:
     bool  motor_atonia_     = false;
     static constexpr float REM_NOISE_AMP   = 30.0f;   // 去同步化噪声幅度 (bias=18+jitter=12)
     static constexpr float ATONIA_INH      = -20.0f;  // 运动抑制电流
+    std::mt19937 rem_rng_;                 // REM 去同步噪声 (实例独立)
+    std::mt19937 pgo_rng_;                 // PGO 波
 };
 
 } // namespace wuyun
@@ -1,6 +1,7 @@
 #include "region/limbic/amygdala.h"
 #include <random>
 #include <algorithm>
+#include <cmath>
 
 namespace wuyun {
 
@@ -150,8 +151,7 @@ void Amygdala::build_synapses() {
 // =============================================================================
 
 void Amygdala::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // Inject PSP buffer into La (sensory input)
     for (size_t i = 0; i < psp_la_.size(); ++i) {
@@ -339,6 +339,47 @@ float Amygdala::cea_vta_drive() const {
 // Aggregate
 // =============================================================================
 
+// =============================================================================
+// 静息跳过
+// =============================================================================
+
+template <typename Self, typename Fn>
+void Amygdala::for_each_active_synapse(Self& self, Fn&& fn) {
+    fn(self.syn_la_to_bla_); fn(self.syn_bla_rec_); fn(self.syn_bla_to_cea_);
+    fn(self.syn_la_to_cea_); fn(self.syn_bla_to_itc_); fn(self.syn_itc_to_cea_);
+    if (self.config_.n_mea > 0) { fn(self.syn_la_to_mea_); fn(self.syn_mea_to_cea_); }
+    if (self.config_.n_coa > 0) fn(self.syn_la_to_coa_);
+    if (self.config_.n_ab > 0)  { fn(self.syn_bla_to_ab_); fn(self.syn_ab_to_cea_); }
+}
+
+template <typename Self, typename Fn>
+void Amygdala::for_each_active_population(Self& self, Fn&& fn) {
+    fn(self.la_); fn(self.bla_); fn(self.itc_); fn(self.cea_);
+    if (self.config_.n_mea > 0) fn(self.mea_);
+    if (self.config_.n_coa > 0) fn(self.coa_);
+    if (self.config_.n_ab > 0)  fn(self.ab_);
+}
+
+bool Amygdala::quiescent() const {
+    // PSP/US 只在 > 0.5 时注入, 低于此值只衰减
+    if (us_strength_ > 0.5f) return false;
+    for (float v : psp_la_)  if (v > 0.5f) return false;
+    for (float v : psp_itc_) if (v > 0.5f) return false;
+
+    bool quiet = true;
+    for_each_active_synapse(*this, [&](const SynapseGroup& sg) { quiet = quiet && sg.quiescent(); });
+    for_each_active_population(*this, [&](const NeuronPopulation& p) { quiet = quiet && p.quiescent(); });
+    return quiet;
+}
+
+void Amygdala::catch_up(int32_t n_steps, float dt) {
+    float psp_factor = std::pow(PSP_DECAY, static_cast<float>(n_steps));
+    for (auto& v : psp_la_)  v *= psp_factor;
+    for (auto& v : psp_itc_) v *= psp_factor;
+    for_each_active_synapse(*this, [&](SynapseGroup& sg) { sg.relax(n_steps, dt); });
+    for_each_active_population(*this, [&](NeuronPopulation& p) { p.relax(n_steps, dt); });
+}
+
 void Amygdala::aggregate_state() {
     size_t offset = 0;
     auto copy_pop = [&](const NeuronPopulation& pop) {
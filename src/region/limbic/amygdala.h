@@ -84,6 +84,9 @@ public:
     void submit_spikes(SpikeBus& bus, int32_t t) override;
     void inject_external(const std::vector<float>& currents) override;
 
+    bool quiescent() const override;
+    void catch_up(int32_t n_steps, float dt) override;
+
     const std::vector<uint8_t>& fired()      const override { return fired_all_; }
     const std::vector<int8_t>&  spike_type()  const override { return spike_type_all_; }
 
@@ -134,6 +137,10 @@ private:
     void build_synapses();
     void aggregate_state();
 
+    /** 本区域逐步推进的突触组/群体 (可选核团按 config 计入) */
+    template <typename Self, typename Fn> static void for_each_active_synapse(Self& self, Fn&& fn);
+    template <typename Self, typename Fn> static void for_each_active_population(Self& self, Fn&& fn);
+
     AmygdalaConfig config_;
 
     // --- 4 populations ---
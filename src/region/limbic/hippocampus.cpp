@@ -92,6 +92,8 @@ Hippocampus::Hippocampus(const HippocampusConfig& config)
     , fired_all_(n_neurons_, 0)
     , spike_type_all_(n_neurons_, 0)
 {
+    swr_rng_.seed(config.sleep_noise_seed);
+    rem_rng_.seed(config.sleep_noise_seed ^ 0x9E3779B9u);
     build_synapses();
     init_grid_cell_tuning();
 }
@@ -208,8 +210,7 @@ void Hippocampus::build_synapses() {
 // =============================================================================
 
 void Hippocampus::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // === Sleep SWR generation (NREM, before normal processing) ===
     if (sleep_replay_) {
@@ -366,9 +367,17 @@ void Hippocampus::step(int32_t t, float dt) {
     // Homeostatic plasticity (synaptic scaling)
     // ========================================
     if (homeo_active_) {
-        homeo_dg_->update_rates(dg_.fired().data(), dt);
-        homeo_ca3_->update_rates(ca3_.fired().data(), dt);
-        homeo_ca1_->update_rates(ca1_.fired().data(), dt);
+        homeo_dg_->accumulate_spikes(dg_.fired().data());
+        homeo_ca3_->accumulate_spikes(ca3_.fired().data());
+        homeo_ca1_->accumulate_spikes(ca1_.fired().data());
+
+        ++homeo_rate_count_;
+        if (homeo_rate_count_ >= homeo_rate_interval_) {
+            homeo_dg_->flush_rates(homeo_rate_count_, dt);
+            homeo_ca3_->flush_rates(homeo_rate_count_, dt);
+            homeo_ca1_->flush_rates(homeo_rate_count_, dt);
+            homeo_rate_count_ = 0;
+        }
 
         ++homeo_step_count_;
         if (homeo_step_count_ >= homeo_interval_) {
@@ -479,12 +488,11 @@ void Hippocampus::try_generate_swr(int32_t t) {
         // Stochastic noise → CA3: bias + jitter
         // Bias ensures enough drive for place cells (threshold ~15),
         // jitter provides randomness for pattern selection
-        static std::mt19937 rng(9999);
         float bias = config_.swr_noise_amp * 0.6f;
         float jitter = config_.swr_noise_amp * 0.4f;
         std::uniform_real_distribution<float> dist(0.0f, jitter);
         for (size_t i = 0; i < ca3_.size(); ++i) {
-            ca3_.inject_basal(i, bias + dist(rng));
+            ca3_.inject_basal(i, bias + dist(swr_rng_));
         }
 
         // Detect SWR onset: CA3 firing fraction exceeds threshold
@@ -518,26 +526,25 @@ void Hippocampus::try_rem_theta(int32_t t) {
     float ca3_drive = REM_THETA_AMP * (0.5f + 0.5f * theta_val);   // 0 to AMP
     float ca1_drive = REM_THETA_AMP * (0.5f - 0.5f * theta_val);   // AMP to 0
 
-    static std::mt19937 rem_rng(88888);
     std::uniform_real_distribution<float> jitter(0.0f, 3.0f);
 
     for (size_t i = 0; i < ca3_.size(); ++i) {
-        ca3_.inject_basal(i, ca3_drive + jitter(rem_rng));
+        ca3_.inject_basal(i, ca3_drive + jitter(rem_rng_));
     }
     for (size_t i = 0; i < ca1_.size(); ++i) {
-        ca1_.inject_basal(i, ca1_drive + jitter(rem_rng));
+        ca1_.inject_basal(i, ca1_drive + jitter(rem_rng_));
     }
 
     // Creative recombination: occasionally inject random pattern into CA3
     // This activates different memory traces than what was encoded,
     // potentially creating novel associations (dream content)
     std::uniform_real_distribution<float> prob(0.0f, 1.0f);
-    if (prob(rem_rng) < REM_RECOMB_PROB) {
+    if (prob(rem_rng_) < REM_RECOMB_PROB) {
         std::uniform_int_distribution<size_t> idx_dist(0, ca3_.size() - 1);
         size_t n_activate = ca3_.size() / 5;  // 20% random subset
         float recomb_amp = REM_THETA_AMP * 1.5f;
         for (size_t k = 0; k < n_activate; ++k) {
-            size_t idx = idx_dist(rem_rng);
+            size_t idx = idx_dist(rem_rng_);
             ca3_.inject_basal(idx, recomb_amp);
         }
         ++rem_recomb_count_;
@@ -554,16 +561,30 @@ void Hippocampus::enable_homeostatic(const HomeostaticParams& params) {
     homeo_ca1_ = std::make_unique<SynapticScaler>(config_.n_ca1, params);
     homeo_interval_ = params.scale_interval;
     homeo_step_count_ = 0;
+    homeo_rate_interval_ = std::max<uint32_t>(1, params.rate_interval);
+    homeo_rate_count_ = 0;
     homeo_active_ = true;
 }
 
+void Hippocampus::set_weight_format(WeightFormat fmt) {
+    for (SynapseGroup* sg : {&syn_ec_to_dg_, &syn_dg_to_ca3_, &syn_ca3_to_ca3_, &syn_ca3_to_ca1_,
+                             &syn_ca1_to_sub_, &syn_sub_to_ec_, &syn_ec_to_ca1_, &syn_ca3_to_dg_fb_,
+                             &syn_ca1_to_presub_, &syn_presub_to_ec_, &syn_ca1_to_hata_,
+                             &syn_ec_to_dg_inh_, &syn_dg_to_dg_inh_, &syn_dg_inh_to_dg_,
+                             &syn_ca3_to_ca3_inh_, &syn_ca3_inh_to_ca3_,
+                             &syn_ca1_to_ca1_inh_, &syn_ca1_inh_to_ca1_}) {
+        sg->set_weight_format(fmt);
+    }
+}
+
 void Hippocampus::apply_homeostatic_scaling() {
     // Scale feedforward excitatory synapses only.
     // Do NOT scale CA3 recurrent (stores memories!).
     auto scale_syn = [](SynapticScaler& scaler, SynapseGroup& syn) {
         if (syn.n_synapses() == 0) return;
-        scaler.apply_scaling(syn.weights().data(), syn.n_synapses(),
-                             syn.col_idx().data());
+        syn.update_weights([&](std::vector<float>& w) {
+            scaler.apply_scaling(w.data(), syn.n_synapses(), syn.col_idx().data());
+        });
     };
 
     // DG inputs: EC→DG perforant path
@@ -25,6 +25,7 @@
 #include "core/synapse_group.h"
 #include "plasticity/homeostatic.h"
 #include <memory>
+#include <random>
 
 namespace wuyun {
 
@@ -98,6 +99,7 @@ struct HippocampusConfig {
     size_t swr_refractory   = 25;     // Min steps between SWR events
     float swr_ca3_threshold = 0.15f;  // CA3 firing fraction to detect SWR onset
     float swr_boost         = 20.0f;  // Extra CA3 drive during active SWR (amplify replay)
+    uint32_t sleep_noise_seed = 9999; // SWR CA3 噪声 / REM theta 抖动的实例流种子
 };
 
 class Hippocampus : public BrainRegion {
@@ -108,6 +110,7 @@ public:
     void receive_spikes(const std::vector<SpikeEvent>& events) override;
     void submit_spikes(SpikeBus& bus, int32_t t) override;
     void inject_external(const std::vector<float>& currents) override;
+    void set_weight_format(WeightFormat fmt) override;
 
     const std::vector<uint8_t>& fired()      const override { return fired_all_; }
     const std::vector<int8_t>&  spike_type()  const override { return spike_type_all_; }
@@ -252,6 +255,8 @@ private:
     int32_t  swr_refractory_cd_  = 0;     // Refractory countdown between SWRs
     float    last_replay_strength_ = 0.0f;
 
+    std::mt19937 swr_rng_;               // SWR CA3 噪声 (实例独立)
+
     void try_generate_swr(int32_t t);
 
     // --- REM theta state ---
@@ -261,6 +266,7 @@ private:
     static constexpr float REM_THETA_FREQ = 0.006f;  // ~6Hz theta
     static constexpr float REM_THETA_AMP  = 10.0f;   // Theta modulation amplitude
     static constexpr float REM_RECOMB_PROB = 0.01f;  // Creative recombination probability/step
+    std::mt19937 rem_rng_;               // REM theta 抖动 / 重组
 
     void try_rem_theta(int32_t t);
 
@@ -268,6 +274,8 @@ private:
     bool homeo_active_ = false;
     uint32_t homeo_step_count_ = 0;
     uint32_t homeo_interval_ = 100;
+    uint32_t homeo_rate_count_ = 0;     // 发放率慢时钟 (计数窗口)
+    uint32_t homeo_rate_interval_ = 10;
     std::unique_ptr<SynapticScaler> homeo_dg_;
     std::unique_ptr<SynapticScaler> homeo_ca3_;
     std::unique_ptr<SynapticScaler> homeo_ca1_;
@@ -80,8 +80,7 @@ Hypothalamus::Hypothalamus(const HypothalamusConfig& config)
 // === Step ===
 
 void Hypothalamus::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // =========================================================
     // 1. SCN circadian pacemaker
@@ -11,10 +11,12 @@ LateralHabenula::LateralHabenula(const LHbConfig& config)
     , psp_(config.n_neurons, 0.0f)
     , fired_(config.n_neurons, 0)
     , spike_type_(config.n_neurons, 0)
-{}
+{
+    steps_neuromod_ = false;
+}
 
 void LateralHabenula::step(int32_t t, float dt) {
-    oscillation_.step(dt);
+    advance_local_clocks(dt);
 
     // Accumulate aversive signals into sustained PSP buffer
     // Biology: LHb neurons have sustained responses to aversive events
@@ -64,6 +66,21 @@ void LateralHabenula::step(int32_t t, float dt) {
     frustration_input_ = 0.0f;
 }
 
+bool LateralHabenula::quiescent() const {
+    if (punishment_input_ > 0.01f || frustration_input_ > 0.01f) return false;
+    if (aversive_psp_ > 0.05f) return false;
+    for (float v : psp_) if (v > 0.5f) return false;
+    return neurons_.quiescent(config_.tonic_drive);
+}
+
+void LateralHabenula::catch_up(int32_t n_steps, float dt) {
+    float n = static_cast<float>(n_steps);
+    aversive_psp_ *= std::pow(AVERSIVE_PSP_DECAY, n);
+    float psp_factor = std::pow(PSP_DECAY, n);
+    for (auto& v : psp_) v *= psp_factor;
+    neurons_.relax(n_steps, dt, config_.tonic_drive);
+}
+
 void LateralHabenula::receive_spikes(const std::vector<SpikeEvent>& events) {
     // Arriving spikes → PSP buffer (from GPb, PFC, etc.)
     for (const auto& evt : events) {
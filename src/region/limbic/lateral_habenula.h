@@ -48,6 +48,10 @@ public:
     void submit_spikes(SpikeBus& bus, int32_t t) override;
     void inject_external(const std::vector<float>& currents) override;
 
+    /** 静息: 无惩罚/挫折输入、残余 PSP 小, 且基线驱动下神经元不发放 */
+    bool quiescent() const override;
+    void catch_up(int32_t n_steps, float dt) override;
+
     const std::vector<uint8_t>& fired()      const override { return fired_; }
     const std::vector<int8_t>&  spike_type()  const override { return spike_type_; }
 
@@ -50,8 +50,7 @@ MammillaryBody::MammillaryBody(const MammillaryConfig& config)
 }
 
 void MammillaryBody::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // Inject PSP to medial neurons (from Hippocampus Sub)
     for (size_t i = 0; i < psp_medial_.size(); ++i) {
@@ -51,8 +51,7 @@ SeptalNucleus::SeptalNucleus(const SeptalConfig& config)
 }
 
 void SeptalNucleus::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // === Theta pacemaker: rhythmic drive to GABA neurons ===
     theta_phase_ += dt / config_.theta_period;
@@ -31,10 +31,12 @@ DRN_5HT::DRN_5HT(const DRNConfig& config)
     , psp_5ht_(config.n_5ht_neurons, 0.0f)
     , fired_(config.n_5ht_neurons, 0)
     , spike_type_(config.n_5ht_neurons, 0)
-{}
+{
+    steps_neuromod_ = false;
+}
 
 void DRN_5HT::step(int32_t t, float dt) {
-    oscillation_.step(dt);
+    advance_local_clocks(dt);
 
     float wellbeing_current = wellbeing_input_ * 30.0f;
 
@@ -31,10 +31,12 @@ LC_NE::LC_NE(const LCConfig& config)
     , psp_ne_(config.n_ne_neurons, 0.0f)
     , fired_(config.n_ne_neurons, 0)
     , spike_type_(config.n_ne_neurons, 0)
-{}
+{
+    steps_neuromod_ = false;
+}
 
 void LC_NE::step(int32_t t, float dt) {
-    oscillation_.step(dt);
+    advance_local_clocks(dt);
 
     // Arousal → NE neuron excitation
     float arousal_current = arousal_input_ * 40.0f;
@@ -31,10 +31,12 @@ NBM_ACh::NBM_ACh(const NBMConfig& config)
     , psp_ach_(config.n_ach_neurons, 0.0f)
     , fired_(config.n_ach_neurons, 0)
     , spike_type_(config.n_ach_neurons, 0)
-{}
+{
+    steps_neuromod_ = false;
+}
 
 void NBM_ACh::step(int32_t t, float dt) {
-    oscillation_.step(dt);
+    advance_local_clocks(dt);
 
     float surprise_current = surprise_input_ * 35.0f;
 
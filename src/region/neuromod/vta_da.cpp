@@ -12,10 +12,12 @@ VTA_DA::VTA_DA(const VTAConfig& config)
     , psp_da_(config.n_da_neurons, 0.0f)
     , fired_(config.n_da_neurons, 0)
     , spike_type_(config.n_da_neurons, 0)
-{}
+{
+    steps_neuromod_ = false;
+}
 
 void VTA_DA::step(int32_t t, float dt) {
-    oscillation_.step(dt);
+    advance_local_clocks(dt);
 
     // =========================================================
     // v46: Spike-driven RPE (replaces inject_reward scalar)
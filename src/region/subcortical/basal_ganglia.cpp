@@ -1,7 +1,11 @@
 #include "region/subcortical/basal_ganglia.h"
+#include "core/random_connect.h"
+#include "core/profiler.h"
 #include <random>
 #include <algorithm>
 #include <climits>
+#include <cmath>
+#include <limits>
 
 namespace wuyun {
 
@@ -14,17 +18,12 @@ static void build_sparse_connections(
     unsigned seed = 42
 ) {
     std::mt19937 rng(seed);
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    for (size_t i = 0; i < n_pre; ++i) {
-        for (size_t j = 0; j < n_post; ++j) {
-            if (dist(rng) < prob) {
-                pre_ids.push_back(static_cast<int32_t>(i));
-                post_ids.push_back(static_cast<int32_t>(j));
-                weights.push_back(weight);
-                delays.push_back(1);
-            }
-        }
-    }
+    for_each_random_pair(n_pre, n_post, prob, rng, [&](size_t i, size_t j) {
+        pre_ids.push_back(static_cast<int32_t>(i));
+        post_ids.push_back(static_cast<int32_t>(j));
+        weights.push_back(weight);
+        delays.push_back(1);
+    });
 }
 
 static SynapseGroup make_empty(size_t n_pre, size_t n_post,
@@ -267,8 +266,7 @@ void BasalGanglia::set_topographic_cortical_source(uint32_t region_id, size_t n_
 }
 
 void BasalGanglia::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // DA modulation: D1 gets tonic excitation proportional to DA
     //                D2 gets tonic excitation inversely proportional to DA
@@ -449,26 +447,36 @@ void BasalGanglia::receive_spikes(const std::vector<SpikeEvent>& events) {
             total_cortical_inputs_++;
         }
 
-        for (size_t idx = 0; idx < ctx_to_d1_map_[src].size(); ++idx) {
-            uint32_t tgt = ctx_to_d1_map_[src][idx];
-            float w = (config_.da_stdp_enabled && src < ctx_d1_w_.size()) ? ctx_d1_w_[src][idx] : 1.0f;
-            // v26: multiplicative gain (Surmeier 2007)
-            // w=1.0→gain=1.0, w=1.5→gain=2.5, w=0.5→gain=0.25
-            // Weight differences are nonlinearly amplified, making learned preferences decisive
-            float gain = 1.0f + (w - 1.0f) * config_.weight_gain_factor;
-            if (gain < 0.1f) gain = 0.1f;  // Floor: don't go fully silent
-            psp_d1_[tgt] += base_current * gain;
-        }
-        for (size_t idx = 0; idx < ctx_to_d2_map_[src].size(); ++idx) {
-            uint32_t tgt = ctx_to_d2_map_[src][idx];
-            float w = (config_.da_stdp_enabled && src < ctx_d2_w_.size()) ? ctx_d2_w_[src][idx] : 1.0f;
-            float gain = 1.0f + (w - 1.0f) * config_.weight_gain_factor;
-            if (gain < 0.1f) gain = 0.1f;
-            psp_d2_[tgt] += base_current * gain;
-        }
-        for (uint32_t tgt : ctx_to_stn_map_[src]) {
-            psp_stn_[tgt] += base_current * 0.5f;
-        }
+        bool learned_d1 = config_.da_stdp_enabled && src < ctx_d1_w_.size();
+        bool learned_d2 = config_.da_stdp_enabled && src < ctx_d2_w_.size();
+        route_cortical(src, base_current,
+                       ctx_to_d1_map_[src].data(), learned_d1 ? ctx_d1_w_[src].data() : nullptr,
+                       ctx_to_d1_map_[src].size(),
+                       ctx_to_d2_map_[src].data(), learned_d2 ? ctx_d2_w_[src].data() : nullptr,
+                       ctx_to_d2_map_[src].size());
+    }
+}
+
+void BasalGanglia::route_cortical(size_t src, float base_current,
+                                  const uint32_t* d1_tgt, const float* d1_w, size_t n_d1,
+                                  const uint32_t* d2_tgt, const float* d2_w, size_t n_d2) {
+    for (size_t idx = 0; idx < n_d1; ++idx) {
+        float w = d1_w ? d1_w[idx] : 1.0f;
+        // v26: multiplicative gain (Surmeier 2007)
+        // w=1.0→gain=1.0, w=1.5→gain=2.5, w=0.5→gain=0.25
+        // Weight differences are nonlinearly amplified, making learned preferences decisive
+        float gain = 1.0f + (w - 1.0f) * config_.weight_gain_factor;
+        if (gain < 0.1f) gain = 0.1f;  // Floor: don't go fully silent
+        psp_d1_[d1_tgt[idx]] += base_current * gain;
+    }
+    for (size_t idx = 0; idx < n_d2; ++idx) {
+        float w = d2_w ? d2_w[idx] : 1.0f;
+        float gain = 1.0f + (w - 1.0f) * config_.weight_gain_factor;
+        if (gain < 0.1f) gain = 0.1f;
+        psp_d2_[d2_tgt[idx]] += base_current * gain;
+    }
+    for (uint32_t tgt : ctx_to_stn_map_[src]) {
+        psp_stn_[tgt] += base_current * 0.5f;
     }
 }
 
@@ -537,7 +545,15 @@ void BasalGanglia::replay_learning_step(int32_t t, float dt) {
     // Lightweight replay: only D1/D2 firing + DA-STDP update.
     // Does NOT step GPi/GPe/STN or process internal synapses.
     // Avoids disrupting BG motor output state during replay.
+    step_msn_replay(t, dt);
+
+    // DA-STDP: update weights (replay_mode_ suppresses weight decay)
+    if (config_.da_stdp_enabled) {
+        apply_da_stdp(t);
+    }
+}
 
+void BasalGanglia::step_msn_replay(int32_t t, float dt) {
     // MSN up-state drive + DA modulation (same as normal step)
     float up = config_.msn_up_state_drive;
     float da_delta = da_level_ - config_.da_stdp_baseline;
@@ -561,11 +577,262 @@ void BasalGanglia::replay_learning_step(int32_t t, float dt) {
     // Step only D1 and D2 (they need to fire for eligibility trace formation)
     d1_msn_.step(t, dt);
     d2_msn_.step(t, dt);
+}
 
-    // DA-STDP: update weights (replay_mode_ suppresses weight decay)
-    if (config_.da_stdp_enabled) {
-        apply_da_stdp(t);
+// =============================================================================
+// Batched replay
+// =============================================================================
+
+// replay DA-STDP Phase 2+3 的融合内核 (D1: sign=+1, D2: sign=-1)
+// 无分支 (select 代替 if) 且标量按值传入, 循环可向量化; 逐元素算术与 apply_da_stdp 相同。
+// 痕迹 ≤ 0.001 的突触: dw = ±0 → 权重不变 (已在 [w_min, w_max] 内), 巩固不变。
+static void fused_replay_pass(float* w, float* elig, float* consol, size_t n,
+                              float sign, float lr, float da_error,
+                              float c_keep, float c_str, float c_gain, float c_erode, float c_mul,
+                              float elig_decay, float w_min, float w_max) {
+#ifdef WUYUN_OPENMP
+    #pragma omp simd
+#endif
+    for (size_t q = 0; q < n; ++q) {
+        float e  = elig[q];
+        float e_on = e > 0.001f ? e : 0.0f;
+        float c0 = consol[q];
+        float eff_lr = lr / (1.0f + (c0 * c_keep) * c_str);
+        float dw = sign * (eff_lr * da_error * e_on);
+        float wn = w[q] + dw;                     // std::clamp(w + dw, w_min, w_max)
+        wn = wn < w_min ? w_min : wn;
+        wn = w_max < wn ? w_max : wn;
+        float prod = dw * (wn - 1.0f);
+        // 同向: c += |dw|·rate; 反向: c = max(c - 2|dw|·rate, 0); 不变: c + 0 (均精确)
+        float k = prod > 0 ? c_gain : (prod < 0 ? c_erode : 0.0f);
+        float cn = c0 + std::abs(dw) * k;
+        cn = cn < 0.0f ? 0.0f : cn;
+        w[q] = wn;
+        consol[q] = cn * c_mul;
+        elig[q] = e * elig_decay;
+    }
+}
+
+void BasalGanglia::FlatInputs::gather(const std::vector<std::vector<uint32_t>>& map,
+                                      const std::vector<std::vector<float>>& w_rows,
+                                      const std::vector<std::vector<float>>& elig_rows,
+                                      const std::vector<std::vector<float>>& consol_rows) {
+    ptr.assign(1, 0);
+    tgt.clear(); w.clear(); elig.clear(); consol.clear();
+    for (size_t src = 0; src < w_rows.size(); ++src) {
+        tgt.insert(tgt.end(), map[src].begin(), map[src].end());
+        w.insert(w.end(), w_rows[src].begin(), w_rows[src].end());
+        elig.insert(elig.end(), elig_rows[src].begin(), elig_rows[src].end());
+        consol.insert(consol.end(), consol_rows[src].begin(), consol_rows[src].end());
+        ptr.push_back(static_cast<uint32_t>(w.size()));
+    }
+}
+
+void BasalGanglia::FlatInputs::scatter(std::vector<std::vector<float>>& w_rows,
+                                       std::vector<std::vector<float>>& elig_rows,
+                                       std::vector<std::vector<float>>& consol_rows) const {
+    for (size_t src = 0; src < w_rows.size(); ++src) {
+        std::copy(w.begin() + ptr[src],      w.begin() + ptr[src + 1],      w_rows[src].begin());
+        std::copy(elig.begin() + ptr[src],   elig.begin() + ptr[src + 1],   elig_rows[src].begin());
+        std::copy(consol.begin() + ptr[src], consol.begin() + ptr[src + 1], consol_rows[src].begin());
+    }
+}
+
+void BasalGanglia::replay_batch(const ReplaySchedule& schedule) {
+    if (schedule.steps.empty()) return;
+    bool  saved_mode = replay_mode_;
+    float saved_da   = da_level_;
+    replay_mode_ = true;
+
+    if (!config_.da_stdp_enabled) {
+        // 无可学习权重: 逐步路径即可 (只有 MSN 动力学)
+        for (const auto& seg : schedule.segments) {
+            set_da_level(seg.da_level);
+            for (uint32_t k = seg.first; k < seg.first + seg.count; ++k) {
+                const ReplaySchedule::Step& st = schedule.steps[k];
+                replay_events_.resize(st.n);
+                for (uint32_t e = 0; e < st.n; ++e) {
+                    replay_events_[e] = SpikeEvent{st.region_id, 0, st.ids[e], st.types[e], 0};
+                }
+                if (st.n > 0) receive_spikes(replay_events_);
+                replay_learning_step(0, 1.0f);
+            }
+        }
+        replay_mode_ = saved_mode;
+        da_level_    = saved_da;
+        return;
+    }
+
+    replay_d1_.gather(ctx_to_d1_map_, ctx_d1_w_, elig_d1_, consol_d1_);
+    replay_d2_.gather(ctx_to_d2_map_, ctx_d2_w_, elig_d2_, consol_d2_);
+    // 重放前已到达的输入 (尚未被 DA-STDP 消费) 同样参与第一步
+    replay_active_.clear();
+    for (size_t src = 0; src < input_active_.size(); ++src) {
+        if (input_active_[src]) replay_active_.push_back(static_cast<uint32_t>(src));
+    }
+    auto activate = [&](size_t src) {
+        if (!input_active_[src]) {
+            input_active_[src] = 1;
+            replay_active_.push_back(static_cast<uint32_t>(src));
+        }
+        total_cortical_inputs_++;
+    };
+
+    const size_t n_rows = replay_d1_.ptr.size() - 1;
+    for (const auto& seg : schedule.segments) {
+        set_da_level(seg.da_level);
+        for (uint32_t k = seg.first; k < seg.first + seg.count; ++k) {
+            const ReplaySchedule::Step& st = schedule.steps[k];
+
+            // receive_spikes(): 只展开路由, 不构造 SpikeEvent
+            for (uint32_t e = 0; e < st.n; ++e) {
+                if (st.region_id == da_source_region_) { da_spike_accum_ += 1.0f; continue; }
+                if (st.region_id == thalamic_source_) {
+                    float thal_current = THAL_MSN_CURRENT;
+                    if (is_burst(static_cast<SpikeType>(st.types[e]))) thal_current *= 1.5f;
+                    for (size_t j = 0; j < d1_msn_.size(); ++j) psp_d1_[j] += thal_current;
+                    for (size_t j = 0; j < d2_msn_.size(); ++j) psp_d2_[j] += thal_current;
+                    continue;
+                }
+                float base_current = is_burst(static_cast<SpikeType>(st.types[e])) ? 50.0f : 30.0f;
+                size_t src = st.ids[e] % input_map_size_;
+                if (src < input_active_.size()) activate(src);
+                uint32_t a1 = replay_d1_.ptr[src], a2 = replay_d2_.ptr[src];
+                route_cortical(src, base_current,
+                               replay_d1_.tgt.data() + a1, replay_d1_.w.data() + a1,
+                               replay_d1_.ptr[src + 1] - a1,
+                               replay_d2_.tgt.data() + a2, replay_d2_.w.data() + a2,
+                               replay_d2_.ptr[src + 1] - a2);
+            }
+
+            // mark_motor_efference()
+            if (st.action_group >= 0 && st.action_group < 4) {
+                size_t slot = SENSORY_SLOT_BASE + static_cast<size_t>(st.action_group);
+                if (slot < input_active_.size()) activate(slot);
+                if (slot < n_rows) {
+                    float base_psp = 5.0f;
+                    for (uint32_t q = replay_d1_.ptr[slot]; q < replay_d1_.ptr[slot + 1]; ++q) {
+                        psp_d1_[replay_d1_.tgt[q]] += base_psp * replay_d1_.w[q];
+                    }
+                }
+            }
+
+            step_msn_replay(0, 1.0f);
+            replay_da_stdp_flat();
+        }
+    }
+
+    replay_d1_.scatter(ctx_d1_w_, elig_d1_, consol_d1_);
+    replay_d2_.scatter(ctx_d2_w_, elig_d2_, consol_d2_);
+    replay_mode_ = saved_mode;
+    da_level_    = saved_da;
+}
+
+void BasalGanglia::replay_da_stdp_flat() {
+    // apply_da_stdp() 的重放特化 (replay_mode_: 无权重衰减), 作用于展平数组:
+    // Phase 1 只访问活跃槽; Phase 2 (权重/巩固) 与 Phase 3 (痕迹/巩固衰减)
+    // 逐突触独立, 合并为一次连续遍历。算术与 apply_da_stdp 逐项相同。
+    float da_error = da_level_ - config_.da_stdp_baseline;
+    float lr = config_.da_stdp_lr;
+    float elig_decay = config_.da_stdp_elig_decay;
+    bool use_consol = config_.synaptic_consolidation;
+    float c_rate = config_.consol_rate;
+    float ach_gate = std::clamp(1.0f - (ach_level_ - 0.2f) * 2.0f, 0.1f, 1.0f);
+    float c_str  = config_.consol_strength * ach_gate;
+    float c_decay = config_.consol_decay;
+    float max_elig = config_.da_stdp_max_elig;
+    float w_min = config_.da_stdp_w_min, w_max = config_.da_stdp_w_max;
+
+    // Phase 1: co-activation → eligibility
+    const auto& d1_fired = d1_msn_.fired();
+    const auto& d2_fired = d2_msn_.fired();
+    for (uint32_t src : replay_active_) {
+        for (uint32_t q = replay_d1_.ptr[src]; q < replay_d1_.ptr[src + 1]; ++q) {
+            if (d1_fired[replay_d1_.tgt[q]])
+                replay_d1_.elig[q] = std::min(replay_d1_.elig[q] + 1.0f, max_elig);
+        }
+        for (uint32_t q = replay_d2_.ptr[src]; q < replay_d2_.ptr[src + 1]; ++q) {
+            if (d2_fired[replay_d2_.tgt[q]])
+                replay_d2_.elig[q] = std::min(replay_d2_.elig[q] + 1.0f, max_elig);
+        }
+        input_active_[src] = 0;
+    }
+    replay_active_.clear();
+
+    bool learn = std::abs(da_error) > 0.001f;
+    bool consol_tick = false;
+    if (use_consol && ++consol_decay_count_ >= config_.consol_decay_interval) {
+        c_decay = std::pow(c_decay, static_cast<float>(consol_decay_count_));
+        consol_decay_count_ = 0;
+        consol_tick = true;
+    }
+
+    // Phase 2+3 fused
+    if (!learn) {
+        for (FlatInputs* f : {&replay_d1_, &replay_d2_}) {
+            for (float& e : f->elig) e *= elig_decay;
+            if (consol_tick) for (float& c : f->consol) c *= c_decay;
+        }
+        return;
+    }
+    // 循环不变的开关折算为乘数 (×1 / +0 精确)
+    float c_keep = use_consol ? 1.0f : 0.0f;     // 关闭巩固: c = 0
+    float c_gain = use_consol ? c_rate : 0.0f;   // 关闭巩固: 分数不变
+    float c_erode = -(c_gain * 2.0f);             // 反向更新: 2× 侵蚀
+    float c_mul  = consol_tick ? c_decay : 1.0f;
+    for (int d = 0; d < 2; ++d) {
+        FlatInputs& f = d == 0 ? replay_d1_ : replay_d2_;
+        fused_replay_pass(f.w.data(), f.elig.data(), f.consol.data(), f.w.size(),
+                          d == 0 ? 1.0f : -1.0f, lr, da_error, c_keep, c_str, c_gain, c_erode,
+                          c_mul, elig_decay, w_min, w_max);
+    }
+}
+
+static void flatten_rows(const std::vector<std::vector<float>>& rows, std::vector<float>& out) {
+    out.clear();
+    for (const auto& r : rows) out.insert(out.end(), r.begin(), r.end());
+}
+
+BasalGanglia::LearningState BasalGanglia::learning_state() const {
+    LearningState st;
+    flatten_rows(ctx_d1_w_,  st.w_d1);
+    flatten_rows(ctx_d2_w_,  st.w_d2);
+    flatten_rows(consol_d1_, st.consol_d1);
+    flatten_rows(consol_d2_, st.consol_d2);
+    return st;
+}
+
+bool BasalGanglia::apply_learning_delta(const LearningState& before, const LearningState& after) {
+    auto merge = [](std::vector<std::vector<float>>& rows,
+                    const std::vector<float>& b, const std::vector<float>& a,
+                    float lo, float hi) {
+        size_t k = 0;
+        for (auto& r : rows) {
+            for (float& x : r) {
+                x = std::clamp(x + (a[k] - b[k]), lo, hi);
+                ++k;
+            }
+        }
+    };
+    auto total = [](const std::vector<std::vector<float>>& rows) {
+        size_t n = 0;
+        for (const auto& r : rows) n += r.size();
+        return n;
+    };
+    size_t n1 = total(ctx_d1_w_), n2 = total(ctx_d2_w_);
+    if (before.w_d1.size() != n1 || after.w_d1.size() != n1 ||
+        before.w_d2.size() != n2 || after.w_d2.size() != n2 ||
+        before.consol_d1.size() != n1 || after.consol_d1.size() != n1 ||
+        before.consol_d2.size() != n2 || after.consol_d2.size() != n2) {
+        return false;
     }
+    float w_lo = config_.da_stdp_w_min, w_hi = config_.da_stdp_w_max;
+    float c_hi = std::numeric_limits<float>::max();
+    merge(ctx_d1_w_,  before.w_d1,      after.w_d1,      w_lo, w_hi);
+    merge(ctx_d2_w_,  before.w_d2,      after.w_d2,      w_lo, w_hi);
+    merge(consol_d1_, before.consol_d1, after.consol_d1, 0.0f, c_hi);
+    merge(consol_d2_, before.consol_d2, after.consol_d2, 0.0f, c_hi);
+    return true;
 }
 
 void BasalGanglia::submit_spikes(SpikeBus& bus, int32_t t) {
@@ -665,12 +932,14 @@ void BasalGanglia::apply_da_stdp(int32_t t) {
     // Phase 2: Apply weight changes = eff_lr * da_error * elig
     // Consolidation gates learning: hardened synapses resist change
     if (std::abs(da_error) > 0.001f) {
+        [[maybe_unused]] uint64_t n_updates = 0;
         for (size_t src = 0; src < elig_d1_.size(); ++src) {
             for (size_t idx = 0; idx < elig_d1_[src].size(); ++idx) {
                 if (elig_d1_[src][idx] > 0.001f) {
                     float c = use_consol ? consol_d1_[src][idx] : 0.0f;
                     float eff_lr = lr / (1.0f + c * c_str);
                     float dw = eff_lr * da_error * elig_d1_[src][idx];
+                    ++n_updates;
                     ctx_d1_w_[src][idx] += dw;
                     ctx_d1_w_[src][idx] = std::clamp(ctx_d1_w_[src][idx],
                         config_.da_stdp_w_min, config_.da_stdp_w_max);
@@ -696,6 +965,7 @@ void BasalGanglia::apply_da_stdp(int32_t t) {
                     float eff_lr = lr / (1.0f + c * c_str);
                     // D2: reverse sign
                     float dw = -(eff_lr * da_error * elig_d2_[src][idx]);
+                    ++n_updates;
                     ctx_d2_w_[src][idx] += dw;
                     ctx_d2_w_[src][idx] = std::clamp(ctx_d2_w_[src][idx],
                         config_.da_stdp_w_min, config_.da_stdp_w_max);
@@ -712,11 +982,20 @@ void BasalGanglia::apply_da_stdp(int32_t t) {
                 }
             }
         }
+        WUYUN_PROF_PLASTICITY(n_updates);
     }
 
     // Phase 3: Decay eligibility traces + consolidation-protected weight decay
     // During replay mode: skip weight decay but still decay elig traces
     float w_decay = replay_mode_ ? 0.0f : config_.da_stdp_w_decay;
+    // Consolidation decay is slow (~1400 step half-life): run it on its own
+    // clock, applying consol_decay^N once every N steps.
+    bool consol_tick = false;
+    if (use_consol && ++consol_decay_count_ >= config_.consol_decay_interval) {
+        c_decay = std::pow(c_decay, static_cast<float>(consol_decay_count_));
+        consol_decay_count_ = 0;
+        consol_tick = true;
+    }
     for (size_t src = 0; src < elig_d1_.size(); ++src) {
         for (size_t idx = 0; idx < elig_d1_[src].size(); ++idx) {
             elig_d1_[src][idx] *= elig_decay;
@@ -731,15 +1010,15 @@ void BasalGanglia::apply_da_stdp(int32_t t) {
                 float c = use_consol ? consol_d1_[src][idx] : 0.0f;
                 float eff_decay = w_decay / (1.0f + c * c_str);
                 ctx_d1_w_[src][idx] += eff_decay * (1.0f - ctx_d1_w_[src][idx]);
-                if (use_consol) consol_d1_[src][idx] *= c_decay;
+                if (consol_tick) consol_d1_[src][idx] *= c_decay;
             }
             for (size_t idx = 0; idx < ctx_d2_w_[src].size(); ++idx) {
                 float c = use_consol ? consol_d2_[src][idx] : 0.0f;
                 float eff_decay = w_decay / (1.0f + c * c_str);
                 ctx_d2_w_[src][idx] += eff_decay * (1.0f - ctx_d2_w_[src][idx]);
-                if (use_consol) consol_d2_[src][idx] *= c_decay;
+                if (consol_tick) consol_d2_[src][idx] *= c_decay;
             }
-        } else if (use_consol) {
+        } else if (consol_tick) {
             // Still decay consolidation during replay (very slow natural decay)
             for (size_t idx = 0; idx < consol_d1_[src].size(); ++idx)
                 consol_d1_[src][idx] *= c_decay;
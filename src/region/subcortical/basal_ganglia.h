@@ -81,6 +81,7 @@ struct BasalGangliaConfig {
     bool  synaptic_consolidation = true;
     float consol_rate     = 10.0f;    // Build rate: c += |Δw| × consol_rate per DA-STDP update
     float consol_decay    = 0.9995f;  // Natural decay per step (~1400 step half-life)
+    uint32_t consol_decay_interval = 10; // Slow clock: apply consol_decay^N once every N steps
     float consol_strength = 5.0f;     // Protection divisor: lr/(1+c×5), decay/(1+c×5)
 
     // D1/D2 lateral inhibition (MSN collateral GABA, Humphries et al. 2009)
@@ -92,6 +93,35 @@ struct BasalGangliaConfig {
     float lateral_inh_strength = 8.0f; // GABA-mediated inhibitory current to losing subgroups
 };
 
+/**
+ * 批量重放计划 (awake SWR replay)
+ *
+ * 每段 = 一个经验片段: 重放 DA 水平 + 连续若干 brain step;
+ * 每个 step 引用外部存储的皮层脉冲 (ID/类型数组, 需在 replay_batch 期间有效)。
+ */
+struct ReplaySchedule {
+    struct Step {
+        uint32_t        region_id    = 0;
+        const uint16_t* ids          = nullptr;
+        const int8_t*   types        = nullptr;
+        uint32_t        n            = 0;
+        int             action_group = -1;   // 运动传出副本 (<0 = 无)
+    };
+    struct Segment {
+        float    da_level;
+        uint32_t first;   // steps 中的起始下标
+        uint32_t count;
+    };
+    std::vector<Step>    steps;
+    std::vector<Segment> segments;
+
+    void clear() { steps.clear(); segments.clear(); }
+    void begin_segment(float da_level) {
+        segments.push_back({da_level, static_cast<uint32_t>(steps.size()), 0});
+    }
+    void add_step(const Step& st) { steps.push_back(st); ++segments.back().count; }
+};
+
 class BasalGanglia : public BrainRegion {
 public:
     BasalGanglia(const BasalGangliaConfig& config);
@@ -157,11 +187,34 @@ public:
      *  Call receive_spikes() first to inject cortical spikes, then this. */
     void replay_learning_step(int32_t t, float dt = 1.0f);
 
+    /** Batched replay: run a whole schedule in one call.
+     *  Equivalent (bit-exact) to, per segment, set_da_level(da) and per step
+     *  receive_spikes() + mark_motor_efference() + replay_learning_step(0),
+     *  inside set_replay_mode(true); replay mode and DA level are restored after.
+     *  Cortical→MSN weights/traces/consolidation are gathered once into flat
+     *  arrays and DA-STDP runs as one fused pass per step over them. */
+    void replay_batch(const ReplaySchedule& schedule);
+
+    /** 持久学习状态 (cortical→MSN 权重 + 巩固分数, 按输入槽展平)。
+     *  后台巩固: 影子 BG 重放前后各取一份, 差值合并回在线 BG。
+     *  资格痕迹是短时状态, 不在其中。 */
+    struct LearningState {
+        std::vector<float> w_d1, w_d2, consol_d1, consol_d2;
+    };
+    LearningState learning_state() const;
+
+    /** live += (after - before): 权重钳位到 [w_min, w_max], 巩固分数 ≥ 0。
+     *  连接结构不一致 (期间重建过映射) 时不合并, 返回 false。 */
+    bool apply_learning_delta(const LearningState& before, const LearningState& after);
+
     /** DA-STDP 权重诊断 */
     size_t d1_weight_count() const { return ctx_d1_w_.size(); }
     const std::vector<float>& d1_weights_for(size_t src) const { return ctx_d1_w_[src]; }
     size_t d2_weight_count() const { return ctx_d2_w_.size(); }
     const std::vector<float>& d2_weights_for(size_t src) const { return ctx_d2_w_[src]; }
+    /** 输入槽 src 的 D1/D2 目标 (与 d1/d2_weights_for(src) 逐项对应) */
+    const std::vector<uint32_t>& d1_targets_for(size_t src) const { return ctx_to_d1_map_[src]; }
+    const std::vector<uint32_t>& d2_targets_for(size_t src) const { return ctx_to_d2_map_[src]; }
     float da_level() const { return da_level_; }
     float da_spike_accum() const { return da_spike_accum_; }
 
@@ -250,9 +303,35 @@ private:
     // Parallel to ctx_d1_w_ / ctx_d2_w_, tracks how "hardened" each synapse is
     std::vector<std::vector<float>> consol_d1_;  // [src][idx]
     std::vector<std::vector<float>> consol_d2_;  // [src][idx]
+    uint32_t consol_decay_count_ = 0;            // steps since last consolidation decay
 
     void apply_da_stdp(int32_t t);
 
+    // Cortical spike → D1/D2/STN PSP (w == nullptr → 未学习权重 1.0)
+    void route_cortical(size_t src, float base_current,
+                        const uint32_t* d1_tgt, const float* d1_w, size_t n_d1,
+                        const uint32_t* d2_tgt, const float* d2_w, size_t n_d2);
+    // Replay MSN dynamics: DA drive + PSP injection + D1/D2 step (no GPi/GPe/STN)
+    void step_msn_replay(int32_t t, float dt);
+
+    // Batched replay workspace: [src][idx] arrays flattened by input slot (CSR)
+    struct FlatInputs {
+        std::vector<uint32_t> ptr;             // [n_input + 1]
+        std::vector<uint32_t> tgt;
+        std::vector<float>    w, elig, consol;
+        void gather(const std::vector<std::vector<uint32_t>>& map,
+                    const std::vector<std::vector<float>>& w_rows,
+                    const std::vector<std::vector<float>>& elig_rows,
+                    const std::vector<std::vector<float>>& consol_rows);
+        void scatter(std::vector<std::vector<float>>& w_rows,
+                     std::vector<std::vector<float>>& elig_rows,
+                     std::vector<std::vector<float>>& consol_rows) const;
+    };
+    FlatInputs replay_d1_, replay_d2_;
+    std::vector<uint32_t> replay_active_;      // input_active_ 中置位的槽
+    std::vector<SpikeEvent> replay_events_;    // DA-STDP 关闭时的逐步回退路径
+    void replay_da_stdp_flat();
+
     bool replay_mode_ = false;  // Suppress weight decay during awake replay
 };
 
@@ -148,14 +148,19 @@ Cerebellum::Cerebellum(const CerebellumConfig& config)
              config.n_mli + config.n_golgi, 0)
     , spike_type_(config.n_granule + config.n_purkinje + config.n_dcn +
                   config.n_mli + config.n_golgi, 0)
-{}
+{
+    steps_neuromod_ = false;
+    // 大扇入组 (PC 接收成百上千条平行纤维): 按 post 行归约, 无散射写冲突
+    syn_mf_to_grc_.enable_post_major();
+    syn_pf_to_pc_.enable_post_major();
+}
 
 // =============================================================================
 // Step
 // =============================================================================
 
 void Cerebellum::step(int32_t t, float dt) {
-    oscillation_.step(dt);
+    advance_local_clocks(dt);
 
     // 1. Inject PSP buffer into granule cells (from SpikeBus mossy fibers)
     for (size_t i = 0; i < psp_grc_.size(); ++i) {
@@ -308,6 +313,13 @@ void Cerebellum::aggregate_firing_state() {
     }
 }
 
+void Cerebellum::set_weight_format(WeightFormat fmt) {
+    for (SynapseGroup* sg : {&syn_mf_to_grc_, &syn_pf_to_pc_, &syn_pf_to_mli_, &syn_grc_to_golgi_,
+                             &syn_mli_to_pc_, &syn_pc_to_dcn_, &syn_golgi_to_grc_}) {
+        sg->set_weight_format(fmt);
+    }
+}
+
 void Cerebellum::apply_climbing_fiber_plasticity(int32_t t) {
     // Climbing fiber LTD/LTP on PF→PC synapses
     // CF active + GrC active → LTD (weaken wrong movement)
@@ -315,7 +327,7 @@ void Cerebellum::apply_climbing_fiber_plasticity(int32_t t) {
 
     bool cf_active = cf_error_ > 0.1f;
 
-    auto& weights = syn_pf_to_pc_.weights();
+    auto& syn = syn_pf_to_pc_;  // weight()/set_weight(): 兼容 BF16 存储 (随机舍入)
     const auto& row_ptr = syn_pf_to_pc_.row_ptr();
     const auto& col_idx = syn_pf_to_pc_.col_idx();
 
@@ -326,16 +338,17 @@ void Cerebellum::apply_climbing_fiber_plasticity(int32_t t) {
             size_t post = col_idx[j];
             bool pc_active = pc_.fired()[post];
 
+            float w = syn.weight(j);
             if (cf_active && pc_active) {
                 // CF + PF + PC → LTD (heterosynaptic)
-                weights[j] -= config_.cf_ltd_rate;
+                w -= config_.cf_ltd_rate;
             } else if (!cf_active) {
                 // PF alone (no error) → LTP
-                weights[j] += config_.cf_ltp_rate;
+                w += config_.cf_ltp_rate;
             }
 
             // Clamp weights
-            weights[j] = std::clamp(weights[j], config_.pf_pc_w_min, config_.pf_pc_w_max);
+            syn.set_weight(j, std::clamp(w, config_.pf_pc_w_min, config_.pf_pc_w_max));
         }
     }
 }
@@ -73,6 +73,7 @@ public:
     void receive_spikes(const std::vector<SpikeEvent>& events) override;
     void submit_spikes(SpikeBus& bus, int32_t t) override;
     void inject_external(const std::vector<float>& currents) override;
+    void set_weight_format(WeightFormat fmt) override;
 
     const std::vector<uint8_t>& fired()      const override { return fired_; }
     const std::vector<int8_t>&  spike_type()  const override { return spike_type_; }
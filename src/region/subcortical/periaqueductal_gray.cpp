@@ -119,6 +119,25 @@ void PeriaqueductalGray::inject_external(const std::vector<float>& currents) {
     }
 }
 
+bool PeriaqueductalGray::quiescent() const {
+    for (float v : psp_dl_) if (v >= QUIESCENT_PSP) return false;
+    for (float v : psp_vl_) if (v >= QUIESCENT_PSP) return false;
+    return dlpag_.quiescent() && vlpag_.quiescent();
+}
+
+void PeriaqueductalGray::catch_up(int32_t n_steps, float dt) {
+    float n = static_cast<float>(n_steps);
+    float psp_factor = std::pow(PSP_DECAY, n);
+    for (auto& v : psp_dl_) v *= psp_factor;
+    for (auto& v : psp_vl_) v *= psp_factor;
+    dlpag_.relax(n_steps, dt);
+    vlpag_.relax(n_steps, dt);
+
+    defense_level_ *= std::pow(0.8f, n);
+    freeze_level_  *= std::pow(0.8f, n);
+    arousal_       *= std::pow(0.9f, n);
+}
+
 void PeriaqueductalGray::aggregate_state() {
     size_t offset = 0;
     auto copy_pop = [&](const NeuronPopulation& pop) {
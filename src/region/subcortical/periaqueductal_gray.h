@@ -44,6 +44,9 @@ public:
     void submit_spikes(SpikeBus& bus, int32_t t) override;
     void inject_external(const std::vector<float>& currents) override;
 
+    bool quiescent() const override;
+    void catch_up(int32_t n_steps, float dt) override;
+
     const std::vector<uint8_t>& fired()      const override { return fired_; }
     const std::vector<int8_t>&  spike_type()  const override { return spike_type_; }
 
@@ -77,6 +80,7 @@ private:
     std::vector<int8_t>  spike_type_;
 
     static constexpr float PSP_DECAY = 0.8f;
+    static constexpr float QUIESCENT_PSP = 0.05f;  // 残余 PSP 低于此值视为无输入
     // Threshold: fear must exceed this to activate PAG (prevents noise)
     static constexpr float FEAR_THRESHOLD = 0.03f;
 
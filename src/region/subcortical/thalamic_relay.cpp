@@ -1,4 +1,5 @@
 #include "region/subcortical/thalamic_relay.h"
+#include "core/random_connect.h"
 #include <random>
 #include <algorithm>
 
@@ -14,17 +15,12 @@ static void build_sparse_connections(
     unsigned seed = 42
 ) {
     std::mt19937 rng(seed);
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    for (size_t i = 0; i < n_pre; ++i) {
-        for (size_t j = 0; j < n_post; ++j) {
-            if (dist(rng) < prob) {
-                pre_ids.push_back(static_cast<int32_t>(i));
-                post_ids.push_back(static_cast<int32_t>(j));
-                weights.push_back(weight);
-                delays.push_back(1);
-            }
-        }
-    }
+    for_each_random_pair(n_pre, n_post, prob, rng, [&](size_t i, size_t j) {
+        pre_ids.push_back(static_cast<int32_t>(i));
+        post_ids.push_back(static_cast<int32_t>(j));
+        weights.push_back(weight);
+        delays.push_back(1);
+    });
 }
 
 static SynapseGroup make_empty_synapse(size_t n_pre, size_t n_post,
@@ -78,8 +74,7 @@ void ThalamicRelay::build_synapses() {
 }
 
 void ThalamicRelay::step(int32_t t, float dt) {
-    oscillation_.step(dt);
-    neuromod_.step(dt);
+    advance_local_clocks(dt);
 
     // v30: Context-dependent gating via neuromodulator levels
     // Biology (2024 Nature): higher-order thalamic nuclei selectively convey
@@ -0,0 +1,637 @@
+#include "verify/differential.h"
+#include "verify/reference_kernels.h"
+#include "core/population.h"
+#include "core/synapse_group.h"
+#include "core/worker_pool.h"
+#include "region/subcortical/basal_ganglia.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace wuyun {
+
+using Clock = std::chrono::steady_clock;
+
+// =============================================================================
+// 内置后端
+// =============================================================================
+
+namespace {
+
+class RefPopulationBackend : public PopulationBackend {
+public:
+    RefPopulationBackend(size_t n, const NeuronParams& p) : pop_(n, p) {}
+    void inject_basal(size_t i, float c) override  { pop_.inject_basal(i, c); }
+    void inject_apical(size_t i, float c) override { pop_.inject_apical(i, c); }
+    size_t step(int t, float dt) override { return pop_.step(t, dt); }
+    const std::vector<float>&   v_soma() const override     { return pop_.v_soma(); }
+    const std::vector<float>&   v_apical() const override   { return pop_.v_apical(); }
+    const std::vector<float>&   w_adapt() const override    { return pop_.w_adapt(); }
+    const std::vector<uint8_t>& fired() const override      { return pop_.fired(); }
+    const std::vector<int8_t>&  spike_type() const override { return pop_.spike_type(); }
+private:
+    ref::Population pop_;
+};
+
+/**
+ * 在线 NeuronPopulation
+ *   pool_threads > 0: 神经元循环交给 WorkerPool (IntraScope, 同 use_worker_pool 的大区域路径)
+ *   skip_quiescent:   静息步用 relax(1) 代替 step (同引擎静息跳过的解析补齐)
+ */
+class CurrentPopulationBackend : public PopulationBackend {
+public:
+    CurrentPopulationBackend(size_t n, const NeuronParams& p, int pool_threads, bool skip_quiescent)
+        : pop_(n, p), skip_(skip_quiescent) {
+        if (pool_threads > 0) pool_ = std::make_unique<WorkerPool>(pool_threads, false);
+    }
+    void inject_basal(size_t i, float c) override  { pop_.inject_basal(i, c); }
+    void inject_apical(size_t i, float c) override { pop_.inject_apical(i, c); }
+    size_t step(int t, float dt) override {
+        if (skip_ && pop_.quiescent()) {
+            pop_.relax(1, dt);
+            return 0;
+        }
+        if (pool_) {
+            WorkerPool::IntraScope scope(pool_.get());
+            return pop_.step(t, dt);
+        }
+        return pop_.step(t, dt);
+    }
+    const std::vector<float>&   v_soma() const override     { return pop_.v_soma(); }
+    const std::vector<float>&   v_apical() const override   { return pop_.v_apical(); }
+    const std::vector<float>&   w_adapt() const override    { return pop_.w_adapt(); }
+    const std::vector<uint8_t>& fired() const override      { return pop_.fired(); }
+    const std::vector<int8_t>&  spike_type() const override { return pop_.spike_type(); }
+private:
+    NeuronPopulation pop_;
+    bool skip_;
+    std::unique_ptr<WorkerPool> pool_;
+};
+
+class RefSynapseBackend : public SynapseBackend {
+public:
+    explicit RefSynapseBackend(const SynapseSpec& s)
+        : syn_(s.n_pre, s.n_post, s.pre_ids, s.post_ids, s.weights, s.delays, s.params) {
+        if (s.stp)  syn_.enable_stp(s.stp_params);
+        if (s.nmda) syn_.enable_nmda_channel(s.nmda_params, s.nmda_weight);
+        if (s.stdp) syn_.enable_stdp(s.stdp_params);
+    }
+    void deliver(const std::vector<uint8_t>& f, const std::vector<int8_t>& st) override {
+        syn_.deliver_spikes(f, st);
+    }
+    const std::vector<float>& compute(const std::vector<float>& v, float dt) override {
+        return syn_.step_and_compute(v, dt);
+    }
+    void apply_stdp(const std::vector<uint8_t>& pre, const std::vector<uint8_t>& post, int32_t t) override {
+        syn_.apply_stdp(pre, post, t);
+    }
+    std::vector<float> weights() const override { return syn_.weights(); }
+private:
+    ref::Synapse syn_;
+};
+
+class GroupSynapseBackend : public SynapseBackend {
+public:
+    GroupSynapseBackend(const SynapseSpec& s, bool post_major, bool bf16)
+        : syn_(s.n_pre, s.n_post, s.pre_ids, s.post_ids, s.weights, s.delays, s.params) {
+        if (s.stp)  syn_.enable_stp(s.stp_params);
+        if (s.nmda) syn_.enable_nmda_channel(s.nmda_params, s.nmda_weight);
+        if (s.stdp) syn_.enable_stdp(s.stdp_params);
+        if (post_major) syn_.enable_post_major();
+        if (bf16) syn_.set_weight_format(WeightFormat::BF16);
+    }
+    void deliver(const std::vector<uint8_t>& f, const std::vector<int8_t>& st) override {
+        syn_.deliver_spikes(f, st);
+    }
+    const std::vector<float>& compute(const std::vector<float>& v, float dt) override {
+        return syn_.step_and_compute(v, dt);
+    }
+    void apply_stdp(const std::vector<uint8_t>& pre, const std::vector<uint8_t>& post, int32_t t) override {
+        syn_.apply_stdp(pre, post, t);
+    }
+    std::vector<float> weights() const override { return syn_.weights(); }
+private:
+    SynapseGroup syn_;
+};
+
+template <typename Factory>
+struct Entry {
+    std::string name, description;
+    Factory factory;
+};
+
+struct Registry {
+    std::vector<Entry<PopulationFactory>> populations;
+    std::vector<Entry<SynapseFactory>>    synapses;
+};
+
+template <typename Factory>
+void upsert(std::vector<Entry<Factory>>& list, const std::string& name, const std::string& desc,
+            Factory factory) {
+    for (auto& e : list) {
+        if (e.name == name) { e.description = desc; e.factory = std::move(factory); return; }
+    }
+    list.push_back({name, desc, std::move(factory)});
+}
+
+Registry& registry() {
+    static Registry r = [] {
+        Registry reg;
+        upsert<PopulationFactory>(reg.populations, "reference", "冻结标量参考 (ref::Population)",
+            [](size_t n, const NeuronParams& p) { return std::make_unique<RefPopulationBackend>(n, p); });
+        upsert<PopulationFactory>(reg.populations, "current", "NeuronPopulation::step (单线程)",
+            [](size_t n, const NeuronParams& p) {
+                return std::make_unique<CurrentPopulationBackend>(n, p, 0, false); });
+        upsert<PopulationFactory>(reg.populations, "pool2", "NeuronPopulation, 神经元循环交给 2 线程 WorkerPool",
+            [](size_t n, const NeuronParams& p) {
+                return std::make_unique<CurrentPopulationBackend>(n, p, 2, false); });
+        upsert<PopulationFactory>(reg.populations, "quiescent", "NeuronPopulation, 静息步 relax(1) 解析补齐",
+            [](size_t n, const NeuronParams& p) {
+                return std::make_unique<CurrentPopulationBackend>(n, p, 0, true); });
+
+        upsert<SynapseFactory>(reg.synapses, "reference", "冻结标量参考 (ref::Synapse, 逐突触延迟队列)",
+            [](const SynapseSpec& s) { return std::make_unique<RefSynapseBackend>(s); });
+        upsert<SynapseFactory>(reg.synapses, "csr", "SynapseGroup pre 主序 (FP32)",
+            [](const SynapseSpec& s) { return std::make_unique<GroupSynapseBackend>(s, false, false); });
+        upsert<SynapseFactory>(reg.synapses, "csc", "SynapseGroup post 主序归约 (FP32)",
+            [](const SynapseSpec& s) { return std::make_unique<GroupSynapseBackend>(s, true, false); });
+        upsert<SynapseFactory>(reg.synapses, "bf16", "SynapseGroup pre 主序, BF16 权重",
+            [](const SynapseSpec& s) { return std::make_unique<GroupSynapseBackend>(s, false, true); });
+        upsert<SynapseFactory>(reg.synapses, "bf16_csc", "SynapseGroup post 主序, BF16 权重",
+            [](const SynapseSpec& s) { return std::make_unique<GroupSynapseBackend>(s, true, true); });
+        return reg;
+    }();
+    return r;
+}
+
+template <typename Factory>
+std::vector<std::pair<std::string, std::string>> names(const std::vector<Entry<Factory>>& list) {
+    std::vector<std::pair<std::string, std::string>> out;
+    for (const auto& e : list) out.emplace_back(e.name, e.description);
+    return out;
+}
+
+} // namespace
+
+void register_population_backend(const std::string& name, const std::string& description,
+                                 PopulationFactory factory) {
+    upsert(registry().populations, name, description, std::move(factory));
+}
+
+void register_synapse_backend(const std::string& name, const std::string& description,
+                              SynapseFactory factory) {
+    upsert(registry().synapses, name, description, std::move(factory));
+}
+
+std::unique_ptr<PopulationBackend> make_population_backend(const std::string& name, size_t n,
+                                                           const NeuronParams& params) {
+    for (const auto& e : registry().populations) {
+        if (e.name == name) return e.factory(n, params);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<SynapseBackend> make_synapse_backend(const std::string& name, const SynapseSpec& spec) {
+    for (const auto& e : registry().synapses) {
+        if (e.name == name) return e.factory(spec);
+    }
+    return nullptr;
+}
+
+std::vector<std::pair<std::string, std::string>> population_backends() { return names(registry().populations); }
+std::vector<std::pair<std::string, std::string>> synapse_backends()    { return names(registry().synapses); }
+
+std::vector<std::pair<std::string, std::string>> bg_replay_backends() {
+    return {{"stepwise", "receive_spikes + mark_motor_efference + replay_learning_step 逐步循环"},
+            {"batch",    "BasalGanglia::replay_batch 展平批核"}};
+}
+
+// =============================================================================
+// 场景
+// =============================================================================
+
+DiffScenario random_scenario(uint32_t seed) {
+    std::mt19937 rng(seed * 2654435761u + 0x5bd1e995u);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    auto jitter = [&](float x) { return x * (0.8f + 0.4f * u01(rng)); };
+
+    DiffScenario sc;
+    sc.seed = seed;
+    const NeuronParams presets[] = {L23_PYRAMIDAL_PARAMS(), L5_PYRAMIDAL_PARAMS(), PV_BASKET_PARAMS(),
+                                    THALAMIC_RELAY_BURST_PARAMS(), MSN_D1_PARAMS()};
+    sc.params = presets[rng() % (sizeof(presets) / sizeof(presets[0]))];
+    sc.params.somatic.tau_m = jitter(sc.params.somatic.tau_m);
+    sc.params.somatic.tau_w = jitter(sc.params.somatic.tau_w);
+    sc.params.somatic.a     = jitter(sc.params.somatic.a);
+    sc.params.somatic.b     = jitter(sc.params.somatic.b);
+    sc.params.kappa         = jitter(sc.params.kappa);
+
+    sc.n        = 128 + rng() % 257;
+    sc.drive_p  = 0.3f + 0.4f * u01(rng);
+    sc.drive_current = 50.0f + 50.0f * u01(rng);
+    sc.apical_p = 0.3f * u01(rng);
+
+    sc.n_pre     = 128 + rng() % 257;
+    sc.density   = 0.05f + 0.15f * u01(rng);
+    sc.pre_rate  = 0.02f + 0.08f * u01(rng);
+    sc.max_delay = (rng() % 3 == 0) ? 1 : 2 + static_cast<int>(rng() % 4);
+    sc.stp       = rng() % 2 == 0;
+    sc.nmda      = rng() % 3 == 0;
+    return sc;
+}
+
+namespace {
+
+SynapseSpec build_spec(const DiffScenario& sc, std::mt19937& rng) {
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    SynapseSpec s;
+    s.n_pre  = sc.n_pre;
+    s.n_post = sc.n;
+    for (size_t i = 0; i < sc.n_pre; ++i) {
+        for (size_t j = 0; j < sc.n; ++j) {
+            if (u01(rng) >= sc.density) continue;
+            s.pre_ids.push_back(static_cast<int32_t>(i));
+            s.post_ids.push_back(static_cast<int32_t>(j));
+            s.weights.push_back(std::min(1.0f, 2.0f * sc.w_init * u01(rng)));
+            s.delays.push_back(1 + static_cast<int32_t>(rng() % static_cast<uint32_t>(std::max(sc.max_delay, 1))));
+        }
+    }
+    s.params = AMPA_PARAMS;
+    s.stp = sc.stp;
+    s.stp_params = STP_DEPRESSION;
+    s.nmda = sc.nmda;
+    s.nmda_params = NMDA_PARAMS;
+    s.stdp = sc.stdp;
+    return s;
+}
+
+/** 逐步比较两后端的状态与栅格, 并收集统计量 */
+class Tracker {
+public:
+    Tracker(DiffReport& r, const DiffTolerance& tol, size_t n)
+        : r_(r), tol_(tol), n_(n), spikes_a_(n), spikes_b_(n) {
+        r_.n = n;
+    }
+
+    void state(int t, const std::vector<float>& a, const std::vector<float>& b) {
+        size_t m = std::min(a.size(), b.size());
+        for (size_t i = 0; i < m; ++i) {
+            double d = std::fabs(static_cast<double>(a[i]) - static_cast<double>(b[i]));
+            if (d > r_.max_abs_state || std::isnan(d)) r_.max_abs_state = std::isnan(d) ? INFINITY : d;
+            // 栅格分叉后逐元素轨迹不再可比 (发放/复位错开), 只由栅格与统计判据把关
+            if (tol_.state_abs < 0.0f || r_.first_raster_divergence >= 0) continue;
+            if (!(d <= tol_.state_abs + tol_.state_rel * std::fabs(a[i]))) {
+                ++r_.state_violations;
+                if (r_.first_state_divergence < 0) r_.first_state_divergence = t;
+            }
+        }
+    }
+
+    void raster(int t, const std::vector<int8_t>& a, const std::vector<int8_t>& b) {
+        for (size_t i = 0; i < n_; ++i) {
+            if (a[i] != static_cast<int8_t>(SpikeType::NONE)) spikes_a_[i].push_back(t);
+            if (b[i] != static_cast<int8_t>(SpikeType::NONE)) spikes_b_[i].push_back(t);
+            if (a[i] != b[i]) {
+                ++r_.raster_mismatch;
+                if (r_.first_raster_divergence < 0) r_.first_raster_divergence = t;
+            }
+        }
+        ++steps_;
+    }
+
+    void weights(const std::vector<float>& a, const std::vector<float>& b) {
+        r_.n_weights = std::min(a.size(), b.size());
+        double sum = 0.0;
+        for (size_t s = 0; s < r_.n_weights; ++s) {
+            double d = std::fabs(static_cast<double>(a[s]) - static_cast<double>(b[s]));
+            r_.max_abs_weight = std::max(r_.max_abs_weight, d);
+            sum += d;
+        }
+        r_.mean_abs_weight = r_.n_weights ? sum / static_cast<double>(r_.n_weights) : 0.0;
+        if (a.size() != b.size()) r_.max_abs_weight = INFINITY;
+    }
+
+    void finish(double ns_a, double ns_b, float dt) {
+        r_.steps = steps_;
+        r_.ns_per_step_a = steps_ ? ns_a / steps_ : 0.0;
+        r_.ns_per_step_b = steps_ ? ns_b / steps_ : 0.0;
+        double cells = static_cast<double>(n_) * steps_;
+        r_.raster_mismatch_frac = cells > 0 ? r_.raster_mismatch / cells : 0.0;
+
+        // 发放率 (Hz, dt 以 ms 计) 与 ISI 分布
+        double sec = steps_ * dt * 1e-3;
+        std::vector<double> rate_a, rate_b, isi_a, isi_b;
+        double total_a = 0.0, total_b = 0.0;
+        auto collect = [sec](const std::vector<std::vector<int>>& spikes, std::vector<double>& rate,
+                             std::vector<double>& isi, double& total) {
+            for (const auto& s : spikes) {
+                rate.push_back(sec > 0 ? s.size() / sec : 0.0);
+                total += static_cast<double>(s.size());
+                for (size_t k = 1; k < s.size(); ++k) isi.push_back(s[k] - s[k - 1]);
+            }
+        };
+        collect(spikes_a_, rate_a, isi_a, total_a);
+        collect(spikes_b_, rate_b, isi_b, total_b);
+        r_.rate_a_hz = cells > 0 ? total_a / (n_ * sec) : 0.0;
+        r_.rate_b_hz = cells > 0 ? total_b / (n_ * sec) : 0.0;
+        r_.rate_ks = ks_statistic(std::move(rate_a), std::move(rate_b));
+        r_.isi_ks  = ks_statistic(std::move(isi_a), std::move(isi_b));
+
+        std::string why;
+        auto fail = [&why](const char* what) { why += why.empty() ? what : std::string(", ") + what; };
+        if (tol_.state_abs >= 0.0f && r_.state_violations > 0) fail("state");
+        if (r_.raster_mismatch_frac > tol_.raster_mismatch) fail("raster");
+        if (r_.rate_ks > tol_.rate_ks) fail("rate_ks");
+        if (r_.isi_ks > tol_.isi_ks) fail("isi_ks");
+        // 同理: 栅格一致时比最大差, 分叉后个别 STDP 事件错开 → 比平均差
+        double w_err = r_.raster_mismatch == 0 ? r_.max_abs_weight : r_.mean_abs_weight;
+        if (tol_.weight_abs >= 0.0f && !(w_err <= tol_.weight_abs)) fail("weights");
+        r_.passed = why.empty();
+        r_.failure = why;
+    }
+
+private:
+    DiffReport& r_;
+    DiffTolerance tol_;
+    size_t n_;
+    int steps_ = 0;
+    std::vector<std::vector<int>> spikes_a_, spikes_b_;
+};
+
+DiffReport make_report(const char* kernel, const std::string& a, const std::string& b, uint32_t seed) {
+    DiffReport r;
+    r.kernel = kernel;
+    r.backend_a = a;
+    r.backend_b = b;
+    r.seed = seed;
+    return r;
+}
+
+void unknown_backend(DiffReport& r, const std::string& name) {
+    r.passed = false;
+    r.failure = "unknown backend '" + name + "'";
+}
+
+double elapsed_ns(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+} // namespace
+
+double ks_statistic(std::vector<double> a, std::vector<double> b) {
+    if (a.empty() && b.empty()) return 0.0;
+    if (a.empty() || b.empty()) return 1.0;
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    double na = static_cast<double>(a.size()), nb = static_cast<double>(b.size());
+    size_t i = 0, j = 0;
+    double d = 0.0;
+    while (i < a.size() && j < b.size()) {
+        double x = std::min(a[i], b[j]);
+        while (i < a.size() && a[i] <= x) ++i;
+        while (j < b.size() && b[j] <= x) ++j;
+        d = std::max(d, std::fabs(i / na - j / nb));
+    }
+    return d;
+}
+
+std::string DiffReport::summary() const {
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "%s %s vs %s seed=%u n=%zu steps=%d: state max|d|=%.3g (%llu viol)  raster %llu (%.4f%%)  "
+             "rate %.2f/%.2f Hz  KS rate %.3f isi %.3f  w max|d|=%.3g  %.0f/%.0f ns/step  %s%s",
+             kernel.c_str(), backend_a.c_str(), backend_b.c_str(), seed, n, steps, max_abs_state,
+             static_cast<unsigned long long>(state_violations), static_cast<unsigned long long>(raster_mismatch),
+             raster_mismatch_frac * 100.0, rate_a_hz, rate_b_hz, rate_ks, isi_ks, max_abs_weight,
+             ns_per_step_a, ns_per_step_b, passed ? "PASS" : "FAIL: ", failure.c_str());
+    return buf;
+}
+
+// =============================================================================
+// 群体差分
+// =============================================================================
+
+DiffReport diff_population(const std::string& a, const std::string& b,
+                           const DiffScenario& sc, const DiffTolerance& tol) {
+    DiffReport r = make_report("population", a, b, sc.seed);
+    auto pa = make_population_backend(a, sc.n, sc.params);
+    auto pb = make_population_backend(b, sc.n, sc.params);
+    if (!pa) { unknown_backend(r, a); return r; }
+    if (!pb) { unknown_backend(r, b); return r; }
+
+    std::mt19937 rng(sc.seed);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    std::vector<float> basal(sc.n), apical(sc.n);
+    Tracker tr(r, tol, sc.n);
+    double ns_a = 0.0, ns_b = 0.0;
+
+    for (int t = 0; t < sc.steps; ++t) {
+        for (size_t i = 0; i < sc.n; ++i) {
+            basal[i]  = u01(rng) < sc.drive_p  ? sc.drive_current  * u01(rng) : 0.0f;
+            apical[i] = u01(rng) < sc.apical_p ? sc.apical_current * u01(rng) : 0.0f;
+        }
+        auto drive = [&](PopulationBackend& p) {
+            for (size_t i = 0; i < sc.n; ++i) {
+                if (basal[i] != 0.0f)  p.inject_basal(i, basal[i]);
+                if (apical[i] != 0.0f) p.inject_apical(i, apical[i]);
+            }
+        };
+        drive(*pa);
+        auto t0 = Clock::now();
+        pa->step(t, sc.dt);
+        ns_a += elapsed_ns(t0);
+        drive(*pb);
+        t0 = Clock::now();
+        pb->step(t, sc.dt);
+        ns_b += elapsed_ns(t0);
+
+        tr.raster(t, pa->spike_type(), pb->spike_type());
+        tr.state(t, pa->v_soma(), pb->v_soma());
+        tr.state(t, pa->v_apical(), pb->v_apical());
+        tr.state(t, pa->w_adapt(), pb->w_adapt());
+    }
+    tr.finish(ns_a, ns_b, sc.dt);
+    return r;
+}
+
+// =============================================================================
+// 突触差分 (闭环)
+// =============================================================================
+
+DiffReport diff_synapse(const std::string& a, const std::string& b,
+                        const DiffScenario& sc, const DiffTolerance& tol) {
+    DiffReport r = make_report("synapse", a, b, sc.seed);
+    std::mt19937 rng(sc.seed);
+    SynapseSpec spec = build_spec(sc, rng);
+    auto sa = make_synapse_backend(a, spec);
+    auto sb = make_synapse_backend(b, spec);
+    if (!sa) { unknown_backend(r, a); return r; }
+    if (!sb) { unknown_backend(r, b); return r; }
+
+    // 突触后群体两边都用冻结参考, 差异只来自突触后端
+    ref::Population post_a(sc.n, sc.params), post_b(sc.n, sc.params);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    std::vector<uint8_t> pre_fired(sc.n_pre);
+    std::vector<int8_t>  pre_type(sc.n_pre);
+    Tracker tr(r, tol, sc.n);
+    double ns_a = 0.0, ns_b = 0.0;
+
+    auto run = [&](SynapseBackend& syn, ref::Population& post, int t, double& ns) -> const std::vector<float>& {
+        auto t0 = Clock::now();
+        syn.deliver(pre_fired, pre_type);
+        const std::vector<float>& i_syn = syn.compute(post.v_soma(), sc.dt);
+        ns += elapsed_ns(t0);
+        for (size_t j = 0; j < sc.n; ++j) post.inject_basal(j, i_syn[j] + sc.bg_current);
+        post.step(t, sc.dt);
+        t0 = Clock::now();
+        syn.apply_stdp(pre_fired, post.fired(), t);
+        ns += elapsed_ns(t0);
+        return i_syn;
+    };
+
+    for (int t = 0; t < sc.steps; ++t) {
+        for (size_t i = 0; i < sc.n_pre; ++i) {
+            pre_fired[i] = u01(rng) < sc.pre_rate;
+            pre_type[i] = static_cast<int8_t>(!pre_fired[i] ? SpikeType::NONE
+                                              : u01(rng) < sc.burst_frac ? SpikeType::BURST_START
+                                                                         : SpikeType::REGULAR);
+        }
+        const std::vector<float>& ia = run(*sa, post_a, t, ns_a);
+        const std::vector<float>& ib = run(*sb, post_b, t, ns_b);
+
+        tr.raster(t, post_a.spike_type(), post_b.spike_type());
+        tr.state(t, ia, ib);
+        tr.state(t, post_a.v_soma(), post_b.v_soma());
+    }
+    tr.weights(sa->weights(), sb->weights());
+    tr.finish(ns_a, ns_b, sc.dt);
+    return r;
+}
+
+// =============================================================================
+// BG 重放学习差分
+// =============================================================================
+
+DiffReport diff_bg_replay(const std::string& a, const std::string& b,
+                          const DiffScenario& sc, const DiffTolerance& tol) {
+    DiffReport r = make_report("bg_replay", a, b, sc.seed);
+    auto known = [](const std::string& name) { return name == "stepwise" || name == "batch"; };
+    if (!known(a)) { unknown_backend(r, a); return r; }
+    if (!known(b)) { unknown_backend(r, b); return r; }
+
+    const uint32_t CTX = 999;
+    const size_t n_ctx = 256, n_seg = 4, seg_steps = 12;
+    std::mt19937 rng(sc.seed);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+
+    // 重放计划: 每段一个 DA 水平, 每步 ~pre_rate·256 个皮层脉冲 + 运动传出副本
+    std::vector<std::vector<uint16_t>> ids(n_seg * seg_steps);
+    std::vector<std::vector<int8_t>>   types(n_seg * seg_steps);
+    for (size_t k = 0; k < ids.size(); ++k) {
+        for (uint16_t i = 0; i < n_ctx; ++i) {
+            if (u01(rng) >= std::max(sc.pre_rate, 0.1f)) continue;
+            ids[k].push_back(i);
+            types[k].push_back(static_cast<int8_t>(u01(rng) < sc.burst_frac ? SpikeType::BURST_START
+                                                                            : SpikeType::REGULAR));
+        }
+    }
+    std::vector<float> seg_da(n_seg);
+    for (auto& da : seg_da) da = u01(rng);
+    ReplaySchedule sched;
+    for (size_t s = 0; s < n_seg; ++s) {
+        sched.begin_segment(seg_da[s]);
+        for (size_t i = 0; i < seg_steps; ++i) {
+            size_t k = s * seg_steps + i;
+            sched.add_step({CTX, ids[k].data(), types[k].data(), static_cast<uint32_t>(ids[k].size()),
+                            static_cast<int>(k % 4)});
+        }
+    }
+
+    // 预热输入 (两边相同), 重放后继续用同一输入在线步进
+    std::vector<SpikeEvent> drive;
+    for (uint32_t i = 0; i < n_ctx; ++i) {
+        if (u01(rng) < 0.25f) drive.push_back({CTX, 0, i, static_cast<int8_t>(SpikeType::REGULAR), 0});
+    }
+
+    BasalGangliaConfig cfg;
+    cfg.da_stdp_enabled = true;
+    BasalGanglia bg_a(cfg), bg_b(cfg);
+    for (BasalGanglia* bg : {&bg_a, &bg_b}) {
+        bg->set_da_level(0.7f);
+        bg->set_ach_level(0.4f);
+        for (int t = 0; t < 50; ++t) { bg->receive_spikes(drive); bg->step(t); }
+        bg->receive_spikes(drive);
+    }
+
+    auto replay = [&](BasalGanglia& bg, const std::string& mode) {
+        auto t0 = Clock::now();
+        if (mode == "batch") {
+            bg.replay_batch(sched);
+        } else {
+            float saved_da = bg.da_level();
+            bg.set_replay_mode(true);
+            std::vector<SpikeEvent> evts;
+            for (const auto& seg : sched.segments) {
+                bg.set_da_level(seg.da_level);
+                for (uint32_t k = seg.first; k < seg.first + seg.count; ++k) {
+                    const auto& st = sched.steps[k];
+                    evts.clear();
+                    for (uint32_t e = 0; e < st.n; ++e) evts.push_back({st.region_id, 0, st.ids[e], st.types[e], 0});
+                    bg.receive_spikes(evts);
+                    bg.mark_motor_efference(st.action_group);
+                    bg.replay_learning_step(0, 1.0f);
+                }
+            }
+            bg.set_replay_mode(false);
+            bg.set_da_level(saved_da);
+        }
+        return elapsed_ns(t0);
+    };
+    double ns_a = replay(bg_a, a);
+    double ns_b = replay(bg_b, b);
+
+    auto flat = [](const BasalGanglia& bg) {
+        std::vector<float> w;
+        for (size_t s = 0; s < bg.d1_weight_count(); ++s) {
+            const auto& v = bg.d1_weights_for(s);
+            w.insert(w.end(), v.begin(), v.end());
+        }
+        for (size_t s = 0; s < bg.d2_weight_count(); ++s) {
+            const auto& v = bg.d2_weights_for(s);
+            w.insert(w.end(), v.begin(), v.end());
+        }
+        return w;
+    };
+
+    // 栅格 = 重放后在线步进的全部 BG 神经元; 计时只计重放 (按计划步数摊)
+    int online = std::max(sc.steps / 4, 20);
+    Tracker tr(r, tol, bg_a.fired().size());
+    for (int t = 100; t < 100 + online; ++t) {
+        bg_a.receive_spikes(drive);
+        bg_b.receive_spikes(drive);
+        bg_a.step(t);
+        bg_b.step(t);
+        tr.raster(t, bg_a.spike_type(), bg_b.spike_type());
+        tr.state(t, bg_a.d1().v_soma(), bg_b.d1().v_soma());
+        tr.state(t, bg_a.d2().v_soma(), bg_b.d2().v_soma());
+    }
+    tr.weights(flat(bg_a), flat(bg_b));
+    double per = static_cast<double>(online) / static_cast<double>(sched.steps.size());
+    tr.finish(ns_a * per, ns_b * per, 1.0f);
+    return r;
+}
+
+DiffReport run_differential(const std::string& kernel, const std::string& a, const std::string& b,
+                            const DiffScenario& sc, const DiffTolerance& tol) {
+    if (kernel == "population") return diff_population(a, b, sc, tol);
+    if (kernel == "synapse")    return diff_synapse(a, b, sc, tol);
+    if (kernel == "bg_replay")  return diff_bg_replay(a, b, sc, tol);
+    DiffReport r = make_report(kernel.c_str(), a, b, sc.seed);
+    r.passed = false;
+    r.failure = "unknown kernel '" + kernel + "'";
+    return r;
+}
+
+} // namespace wuyun
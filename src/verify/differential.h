@@ -0,0 +1,201 @@
+#pragma once
+/**
+ * 差分测试 — 快速路径 vs 冻结参考实现
+ *
+ * 每个可替换的内核 (神经元群体、突触组 + STDP、BG 重放学习) 有若干命名后端,
+ * 运行时按名称选择 (注册表, 可在测试/工具中追加新后端):
+ *
+ *   population: reference | current | pool2 | quiescent
+ *   synapse:    reference | csr | csc | bf16 | bf16_csc
+ *   bg_replay:  stepwise | batch
+ *
+ * 差分运行器用同一种子生成随机场景 (参数扰动、输入序列、连接、延迟、STP/NMDA/STDP 开关),
+ * 两个后端吃完全相同的输入, 逐步比较:
+ *   - 状态轨迹: 胞体/顶端电压、适应变量、突触电流 (allclose: |a-b| ≤ abs + rel·|a|,
+ *     只计首个栅格分叉之前 — 之后发放/复位错开, 逐元素比较无意义)
+ *   - 脉冲栅格: (神经元, 步) 不一致比例、首个分叉步
+ *   - 权重演化: 最终权重最大绝对差 (栅格分叉时改比平均绝对差)
+ *   - 统计等价: 每神经元发放率分布与汇总 ISI 分布的两样本 KS 统计量
+ * 以及两边每步耗时 (同一报告里并排给出, 新快速路径的验证与测速一次完成)。
+ *
+ * 精确后端 (同运算顺序) 用 DiffTolerance::exact(); 改变求和顺序的用 close();
+ * 降精度 / 解析补齐等轨迹必然分叉的后端用 statistical()。
+ * 注意 NMDA B(V) 为 256 项查表: 舍入级电压差跨过表格边界会让电流跳变 ~1%,
+ * 含 NMDA 的场景在 close() 下可能报 state, 宜关掉 nmda 或用 statistical()。
+ */
+
+#include "core/types.h"
+#include "plasticity/stdp.h"
+#include "plasticity/stp.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wuyun {
+
+// =============================================================================
+// 后端接口
+// =============================================================================
+
+class PopulationBackend {
+public:
+    virtual ~PopulationBackend() = default;
+    virtual void inject_basal(size_t idx, float current) = 0;
+    virtual void inject_apical(size_t idx, float current) = 0;
+    virtual size_t step(int t, float dt) = 0;
+    virtual const std::vector<float>&   v_soma() const = 0;
+    virtual const std::vector<float>&   v_apical() const = 0;
+    virtual const std::vector<float>&   w_adapt() const = 0;
+    virtual const std::vector<uint8_t>& fired() const = 0;
+    virtual const std::vector<int8_t>&  spike_type() const = 0;
+};
+
+/** 突触组构造规格 (COO 连接 + 可选机制), 各后端按同一规格构建 */
+struct SynapseSpec {
+    size_t n_pre = 0, n_post = 0;
+    std::vector<int32_t> pre_ids, post_ids, delays;
+    std::vector<float> weights;
+    SynapseParams params;
+    bool stp = false;
+    STPParams stp_params;
+    bool nmda = false;
+    SynapseParams nmda_params;
+    float nmda_weight = 0.5f;
+    bool stdp = false;
+    STDPParams stdp_params;
+};
+
+class SynapseBackend {
+public:
+    virtual ~SynapseBackend() = default;
+    virtual void deliver(const std::vector<uint8_t>& pre_fired, const std::vector<int8_t>& pre_type) = 0;
+    virtual const std::vector<float>& compute(const std::vector<float>& v_post, float dt) = 0;
+    virtual void apply_stdp(const std::vector<uint8_t>& pre_fired,
+                            const std::vector<uint8_t>& post_fired, int32_t t) = 0;
+    /** CSR 顺序的 FP32 权重 */
+    virtual std::vector<float> weights() const = 0;
+};
+
+using PopulationFactory =
+    std::function<std::unique_ptr<PopulationBackend>(size_t n, const NeuronParams& params)>;
+using SynapseFactory = std::function<std::unique_ptr<SynapseBackend>(const SynapseSpec& spec)>;
+
+/** 注册/覆盖命名后端 (内置后端在首次查询时注册) */
+void register_population_backend(const std::string& name, const std::string& description,
+                                 PopulationFactory factory);
+void register_synapse_backend(const std::string& name, const std::string& description,
+                              SynapseFactory factory);
+
+/** 未知名称返回 nullptr */
+std::unique_ptr<PopulationBackend> make_population_backend(const std::string& name, size_t n,
+                                                           const NeuronParams& params);
+std::unique_ptr<SynapseBackend> make_synapse_backend(const std::string& name, const SynapseSpec& spec);
+
+/** (名称, 说明), 按注册顺序 */
+std::vector<std::pair<std::string, std::string>> population_backends();
+std::vector<std::pair<std::string, std::string>> synapse_backends();
+std::vector<std::pair<std::string, std::string>> bg_replay_backends();
+
+// =============================================================================
+// 场景 / 容差 / 报告
+// =============================================================================
+
+struct DiffScenario {
+    uint32_t seed = 1;
+    int steps = 400;
+    float dt = 1.0f;
+
+    // 群体: 每步每神经元以 drive_p 概率收到 U(0, drive_current) 基底电流 (顶端同理)
+    size_t n = 256;
+    NeuronParams params;
+    float drive_p = 0.5f;
+    float drive_current = 70.0f;
+    float apical_p = 0.1f;
+    float apical_current = 30.0f;
+
+    // 突触 (闭环: 随机前突触脉冲 → 突触后端 → 参考群体 → STDP)
+    size_t n_pre = 256;
+    float density = 0.1f;
+    float pre_rate = 0.05f;       // 每步发放概率
+    float burst_frac = 0.2f;      // 前突触脉冲中 burst 类型比例
+    int   max_delay = 1;          // 延迟 ∈ [1, max_delay]
+    float w_init = 0.5f;          // 权重 U(0, 2·w_init) 截断到 [0, 1]
+    float bg_current = 12.0f;     // 突触后群体背景基底电流
+    bool stp = false, nmda = false, stdp = true;
+};
+
+/** 由种子随机化: 神经元参数 (在各预设附近扰动)、驱动强度、延迟、STP/NMDA 开关 */
+DiffScenario random_scenario(uint32_t seed);
+
+struct DiffTolerance {
+    float  state_abs = 0.0f;         // allclose 绝对项
+    float  state_rel = 0.0f;         // allclose 相对项; state_abs < 0 = 不比较状态
+    double raster_mismatch = 0.0;    // 允许的 (神经元, 步) 不一致比例
+    double rate_ks = 0.0;            // 每神经元发放率分布 KS 上限
+    double isi_ks  = 0.0;            // 汇总 ISI 分布 KS 上限
+    float  weight_abs = 0.0f;        // 最终权重差上限 (栅格一致: 最大差, 否则平均差); < 0 = 不比较
+
+    /** 逐位一致 */
+    static DiffTolerance exact() { return {}; }
+    /** 求和顺序不同: 状态/权重 1e-4 量级, 栅格几乎一致 */
+    static DiffTolerance close() { return {1e-3f, 1e-4f, 1e-3, 0.05, 0.05, 1e-3f}; }
+    /** 轨迹允许分叉: 只比较发放率/ISI 分布与权重漂移 */
+    static DiffTolerance statistical() { return {-1.0f, 0.0f, 1.0, 0.2, 0.2, 0.1f}; }
+};
+
+struct DiffReport {
+    std::string kernel, backend_a, backend_b;
+    uint32_t seed = 0;
+    int steps = 0;
+    size_t n = 0;                     // 比较的神经元数
+
+    double max_abs_state = 0.0;
+    uint64_t state_violations = 0;    // 栅格分叉前超出 allclose 的 (变量, 步) 数
+    int first_state_divergence = -1;
+
+    uint64_t raster_mismatch = 0;
+    double raster_mismatch_frac = 0.0;
+    int first_raster_divergence = -1;
+
+    double rate_a_hz = 0.0, rate_b_hz = 0.0;
+    double rate_ks = 0.0, isi_ks = 0.0;
+
+    double max_abs_weight = 0.0, mean_abs_weight = 0.0;
+    size_t n_weights = 0;
+
+    double ns_per_step_a = 0.0, ns_per_step_b = 0.0;
+
+    bool passed = true;
+    std::string failure;              // 未通过的判据 (逗号分隔)
+
+    std::string summary() const;
+};
+
+/** 两样本 Kolmogorov–Smirnov 统计量 sup|F_a - F_b| (两边皆空 = 0, 一边空 = 1) */
+double ks_statistic(std::vector<double> a, std::vector<double> b);
+
+/** 神经元群体差分: 同输入序列, 比较 V_s/V_a/w 轨迹与栅格 */
+DiffReport diff_population(const std::string& a, const std::string& b,
+                           const DiffScenario& sc, const DiffTolerance& tol);
+
+/** 突触差分 (闭环): 比较突触电流、突触后电压与栅格、最终权重 */
+DiffReport diff_synapse(const std::string& a, const std::string& b,
+                        const DiffScenario& sc, const DiffTolerance& tol);
+
+/**
+ * BG 重放学习差分: 同一预热状态的两个 BasalGanglia 分别以 a/b 方式跑同一重放计划
+ * (stepwise = receive_spikes + replay_learning_step 循环, batch = replay_batch),
+ * 比较 cortical→MSN 权重与随后在线步进的 D1/D2 栅格
+ */
+DiffReport diff_bg_replay(const std::string& a, const std::string& b,
+                          const DiffScenario& sc, const DiffTolerance& tol);
+
+/** 按内核名分派 ("population" | "synapse" | "bg_replay"); 未知内核/后端时 passed=false */
+DiffReport run_differential(const std::string& kernel, const std::string& a, const std::string& b,
+                            const DiffScenario& sc, const DiffTolerance& tol);
+
+} // namespace wuyun
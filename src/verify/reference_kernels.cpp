@@ -0,0 +1,281 @@
+#include "verify/reference_kernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace wuyun {
+namespace ref {
+
+// =============================================================================
+// 单点公式
+// =============================================================================
+
+float stp_step(STPState& s, const STPParams& p, bool spiked, float dt) {
+    s.x += (1.0f - s.x) / p.tau_D * dt;
+    s.u += (p.U - s.u) / p.tau_F * dt;
+    float gain = s.u * s.x;
+    if (spiked) {
+        s.u += p.U * (1.0f - s.u);
+        s.x -= s.u * s.x;
+        s.x = std::clamp(s.x, 0.0f, 1.0f);
+        s.u = std::clamp(s.u, 0.0f, 1.0f);
+    }
+    return gain;
+}
+
+float stdp_delta_w(float t_pre, float t_post, const STDPParams& p) {
+    float dt = t_post - t_pre;
+    if (dt > 0.0f) return p.a_plus * std::exp(-dt / p.tau_plus);
+    if (dt < 0.0f) return p.a_minus * std::exp(dt / p.tau_minus);
+    return 0.0f;
+}
+
+float nmda_b(float v) {
+    static const std::vector<float> table = [] {
+        std::vector<float> t(256);
+        for (int i = 0; i < 256; ++i) {
+            float vi = -100.0f + i * (150.0f / 255.0f);
+            t[static_cast<size_t>(i)] = 1.0f / (1.0f + (1.0f / 3.57f) * std::exp(-0.062f * vi));
+        }
+        return t;
+    }();
+    int idx = static_cast<int>((v + 100.0f) * (255.0f / 150.0f));
+    idx = std::clamp(idx, 0, 255);
+    return table[static_cast<size_t>(idx)];
+}
+
+// =============================================================================
+// Population
+// =============================================================================
+
+Population::Population(size_t n, const NeuronParams& params)
+    : n_(n)
+    , p_(params)
+    , has_apical_(params.kappa > 0.0f)
+    , v_soma_(n, params.somatic.v_rest)
+    , v_apical_(n, params.somatic.v_rest)
+    , w_adapt_(n, 0.0f)
+    , refrac_(n, 0)
+    , ca_timer_(n, 0)
+    , burst_remain_(n, 0)
+    , burst_isi_ct_(n, 0)
+    , ca_spike_(n, 0)
+    , i_basal_(n, 0.0f)
+    , i_apical_(n, 0.0f)
+    , i_soma_(n, 0.0f)
+    , fired_(n, 0)
+    , spike_type_(n, static_cast<int8_t>(SpikeType::NONE))
+{
+}
+
+size_t Population::step(int /*t*/, float dt) {
+    const SomaticParams& s = p_.somatic;
+    const ApicalParams&  a = p_.apical;
+    size_t count = 0;
+
+    for (size_t i = 0; i < n_; ++i) {
+        fired_[i] = 0;
+        spike_type_[i] = static_cast<int8_t>(SpikeType::NONE);
+    }
+
+    // 1. 顶端树突 + Ca²⁺ 状态机 (全部神经元先于胞体)
+    if (has_apical_) {
+        for (size_t i = 0; i < n_; ++i) {
+            float leak     = -(v_apical_[i] - s.v_rest);
+            float inp      = a.r_a * i_apical_[i];
+            float coupling = p_.kappa_backward * (v_soma_[i] - v_apical_[i]);
+            v_apical_[i] += (leak + inp + coupling) / a.tau_a * dt;
+
+            if (ca_timer_[i] > 0) {
+                if (--ca_timer_[i] == 0) ca_spike_[i] = 0;
+            } else if (v_apical_[i] >= a.v_ca_threshold) {
+                ca_spike_[i] = 1;
+                ca_timer_[i] = a.ca_duration;
+                v_apical_[i] += a.ca_boost;
+            }
+        }
+    }
+
+    // 2-3. 胞体
+    for (size_t i = 0; i < n_; ++i) {
+        bool bursting = burst_remain_[i] > 0;
+        if (bursting) burst_isi_ct_[i] -= 1;
+
+        if (refrac_[i] > 0) {
+            refrac_[i] -= 1;
+        } else {
+            float v   = v_soma_[i];
+            float v_a = has_apical_ ? v_apical_[i] : s.v_rest;
+            float leak     = -(v - s.v_rest);
+            float inp      = s.r_s * (i_basal_[i] + i_soma_[i]);
+            float coupling = p_.kappa * (v_a - v);
+            v_soma_[i]  += (leak + inp - w_adapt_[i] + coupling) / s.tau_m * dt;
+            w_adapt_[i] += (s.a * (v_soma_[i] - s.v_rest) - w_adapt_[i]) / s.tau_w * dt;
+
+            if (!bursting && v_soma_[i] >= s.v_threshold) {
+                v_soma_[i]   = s.v_reset;
+                w_adapt_[i] += s.b;
+                refrac_[i]   = s.refractory_period;
+                if (has_apical_ && ca_spike_[i]) {
+                    spike_type_[i]   = static_cast<int8_t>(SpikeType::BURST_START);
+                    burst_remain_[i] = p_.burst_spike_count - 1;
+                    burst_isi_ct_[i] = p_.burst_isi;
+                } else {
+                    spike_type_[i] = static_cast<int8_t>(SpikeType::REGULAR);
+                }
+                fired_[i] = 1;
+            }
+        }
+
+        // burst 内: ISI 到期强制发放 (不看阈值)
+        if (bursting && burst_isi_ct_[i] <= 0) {
+            burst_remain_[i] -= 1;
+            burst_isi_ct_[i]  = p_.burst_isi;
+            v_soma_[i]   = s.v_reset;
+            w_adapt_[i] += s.b * 0.5f;
+            spike_type_[i] = static_cast<int8_t>(burst_remain_[i] <= 0 ? SpikeType::BURST_END
+                                                                       : SpikeType::BURST_CONTINUE);
+            fired_[i] = 1;
+        }
+        count += fired_[i];
+    }
+
+    std::fill(i_basal_.begin(), i_basal_.end(), 0.0f);
+    std::fill(i_soma_.begin(), i_soma_.end(), 0.0f);
+    std::fill(i_apical_.begin(), i_apical_.end(), 0.0f);
+    return count;
+}
+
+// =============================================================================
+// Synapse
+// =============================================================================
+
+Synapse::Synapse(size_t n_pre, size_t n_post,
+                 const std::vector<int32_t>& pre_ids,
+                 const std::vector<int32_t>& post_ids,
+                 const std::vector<float>& weights,
+                 const std::vector<int32_t>& delays,
+                 const SynapseParams& params)
+    : n_pre_(n_pre)
+    , n_post_(n_post)
+    , p_(params)
+    , i_post_(n_post, 0.0f)
+{
+    // 稳定计数排序: 同一 pre 内保持 COO 输入顺序 (与 SynapseGroup 下标一致)
+    size_t n_syn = pre_ids.size();
+    row_ptr_.assign(n_pre + 1, 0);
+    for (int32_t pre : pre_ids) row_ptr_[static_cast<size_t>(pre) + 1] += 1;
+    for (size_t i = 1; i <= n_pre; ++i) row_ptr_[i] += row_ptr_[i - 1];
+
+    col_idx_.resize(n_syn);
+    weights_.resize(n_syn);
+    delays_.resize(n_syn);
+    std::vector<int32_t> fill(row_ptr_.begin(), row_ptr_.end() - 1);
+    for (size_t s = 0; s < n_syn; ++s) {
+        size_t pos = static_cast<size_t>(fill[static_cast<size_t>(pre_ids[s])]++);
+        col_idx_[pos] = post_ids[s];
+        weights_[pos] = weights[s];
+        delays_[pos]  = delays[s];
+    }
+    g_.assign(n_syn, 0.0f);
+    gd_.assign(n_syn, 0.0f);
+}
+
+void Synapse::enable_stp(const STPParams& params) {
+    stp_ = true;
+    stp_params_ = params;
+    stp_state_.assign(n_pre_, STPState{1.0f, params.U});
+}
+
+void Synapse::enable_nmda_channel(const SynapseParams& params, float weight) {
+    nmda_ = true;
+    nmda_params_ = params;
+    w_nmda_ = weight;
+    g_nmda_.assign(col_idx_.size(), 0.0f);
+}
+
+void Synapse::enable_stdp(const STDPParams& params) {
+    stdp_ = true;
+    stdp_params_ = params;
+    last_pre_.assign(n_pre_, -1000.0f);
+    last_post_.assign(n_post_, -1000.0f);
+}
+
+void Synapse::deliver_spikes(const std::vector<uint8_t>& pre_fired,
+                             const std::vector<int8_t>& pre_spike_type) {
+    for (size_t pre = 0; pre < n_pre_; ++pre) {
+        float stp_gain = stp_ ? ref::stp_step(stp_state_[pre], stp_params_, pre_fired[pre] != 0) : 1.0f;
+        if (!pre_fired[pre]) continue;
+
+        auto st = static_cast<SpikeType>(pre_spike_type[pre]);
+        bool burst = st == SpikeType::BURST_START || st == SpikeType::BURST_CONTINUE ||
+                     st == SpikeType::BURST_END;
+        float gain = (burst ? 2.0f : 1.0f) * stp_gain;
+
+        for (int32_t s = row_ptr_[pre]; s < row_ptr_[pre + 1]; ++s) {
+            int32_t d = delays_[static_cast<size_t>(s)];
+            if (d <= 1) {
+                g_[static_cast<size_t>(s)] += gain;
+                if (nmda_) g_nmda_[static_cast<size_t>(s)] += gain;
+            } else {
+                pending_.push_back({d - 1, s, gain, weights_[static_cast<size_t>(s)] * gain});
+            }
+        }
+    }
+}
+
+const std::vector<float>& Synapse::step_and_compute(const std::vector<float>& v_post, float dt) {
+    // 到期的延迟增量并入本突触门控, 未到期的倒计时
+    size_t keep = 0;
+    for (const Pending& e : pending_) {
+        if (e.remain == 0) {
+            gd_[static_cast<size_t>(e.syn)] += e.w_gain;
+            if (nmda_) g_nmda_[static_cast<size_t>(e.syn)] += e.gain;
+        } else {
+            pending_[keep++] = {e.remain - 1, e.syn, e.gain, e.w_gain};
+        }
+    }
+    pending_.resize(keep);
+
+    std::fill(i_post_.begin(), i_post_.end(), 0.0f);
+    float decay   = dt / p_.tau_decay;
+    float decay_n = nmda_ ? dt / nmda_params_.tau_decay : 0.0f;
+    for (size_t s = 0; s < col_idx_.size(); ++s) {
+        g_[s]  -= g_[s] * decay;
+        gd_[s] -= gd_[s] * decay;
+        size_t post = static_cast<size_t>(col_idx_[s]);
+        float v = v_post[post];
+        float b_v = p_.mg_conc > 0.0f ? nmda_b(v) : 1.0f;
+        float i_syn = p_.g_max * weights_[s] * g_[s] * b_v * (p_.e_rev - v)
+                    + p_.g_max * gd_[s] * b_v * (p_.e_rev - v);
+        if (nmda_) {
+            g_nmda_[s] -= g_nmda_[s] * decay_n;
+            i_syn += nmda_params_.g_max * w_nmda_ * g_nmda_[s] * nmda_b(v) * (nmda_params_.e_rev - v);
+        }
+        i_post_[post] += i_syn;
+    }
+    return i_post_;
+}
+
+void Synapse::apply_stdp(const std::vector<uint8_t>& pre_fired,
+                         const std::vector<uint8_t>& post_fired, int32_t t) {
+    if (!stdp_) return;
+    float tf = static_cast<float>(t);
+    for (size_t i = 0; i < n_pre_; ++i)  if (pre_fired[i])  last_pre_[i]  = tf;
+    for (size_t j = 0; j < n_post_; ++j) if (post_fired[j]) last_post_[j] = tf;
+
+    for (size_t pre = 0; pre < n_pre_; ++pre) {
+        for (int32_t s = row_ptr_[pre]; s < row_ptr_[pre + 1]; ++s) {
+            size_t si = static_cast<size_t>(s);
+            size_t post = static_cast<size_t>(col_idx_[si]);
+            float dw = 0.0f;
+            if (pre_fired[pre])   dw += ref::stdp_delta_w(tf, last_post_[post], stdp_params_);
+            if (post_fired[post]) dw += ref::stdp_delta_w(last_pre_[pre], tf, stdp_params_);
+            if (dw != 0.0f) {
+                weights_[si] = std::clamp(weights_[si] + dw, stdp_params_.w_min, stdp_params_.w_max);
+            }
+        }
+    }
+}
+
+} // namespace ref
+} // namespace wuyun
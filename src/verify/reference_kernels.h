@@ -0,0 +1,132 @@
+#pragma once
+/**
+ * 参考内核 — 冻结的标量实现 (差分测试基准)
+ *
+ * NeuronPopulation / SynapseGroup / STDP 的快速路径 (CSC 归约、BF16 权重、
+ * 延迟环、线程池分块、静息解析补齐…) 都以本文件为对照。这里的代码是
+ * 这些路径引入前的逐神经元/逐突触标量循环的逐行副本, 刻意不调用
+ * core/ 与 plasticity/ 中的任何计算函数 — 后者被改写时参考行为不随之漂移。
+ *
+ * 规则: 只在确认模型语义 (不是实现) 变更时修改本文件, 并在提交中说明。
+ *
+ * 与在线实现的已知差别 (均为实现细节, 数学上等价):
+ *   - 延迟突触逐突触排队, 到达时把投递时刻的 w·gain 并入本突触的延迟门控;
+ *     延迟环按 post 聚合同一量 → 求和顺序不同, 只到舍入误差一致
+ *   - 无 quiescent/relax, 每步完整积分
+ */
+
+#include "core/types.h"
+#include "plasticity/stdp.h"
+#include "plasticity/stp.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wuyun {
+namespace ref {
+
+/** 双区室 AdLIF+ 群体: 逐神经元标量欧拉积分 (同 NeuronPopulation::step 的语义) */
+class Population {
+public:
+    Population(size_t n, const NeuronParams& params);
+
+    size_t size() const { return n_; }
+
+    void inject_basal(size_t idx, float current)  { if (idx < n_) i_basal_[idx]  += current; }
+    void inject_apical(size_t idx, float current) { if (idx < n_) i_apical_[idx] += current; }
+    void inject_soma(size_t idx, float current)   { if (idx < n_) i_soma_[idx]   += current; }
+
+    /** 推进一步, 返回发放数 */
+    size_t step(int t, float dt = 1.0f);
+
+    const std::vector<float>&  v_soma()     const { return v_soma_; }
+    const std::vector<float>&  v_apical()   const { return v_apical_; }
+    const std::vector<float>&  w_adapt()    const { return w_adapt_; }
+    const std::vector<uint8_t>& fired()     const { return fired_; }
+    const std::vector<int8_t>&  spike_type() const { return spike_type_; }
+
+private:
+    size_t n_;
+    NeuronParams p_;
+    bool has_apical_;
+
+    std::vector<float> v_soma_, v_apical_, w_adapt_;
+    std::vector<int32_t> refrac_, ca_timer_, burst_remain_, burst_isi_ct_;
+    std::vector<uint8_t> ca_spike_;
+    std::vector<float> i_basal_, i_apical_, i_soma_;
+    std::vector<uint8_t> fired_;
+    std::vector<int8_t>  spike_type_;
+};
+
+/**
+ * 突触组: COO→CSR 同序构建, 逐突触门控 + 逐突触待到达队列 (延迟),
+ * 可选 STP / NMDA 共受体 / 对称 STDP。权重始终 FP32。
+ */
+class Synapse {
+public:
+    Synapse(size_t n_pre, size_t n_post,
+            const std::vector<int32_t>& pre_ids,
+            const std::vector<int32_t>& post_ids,
+            const std::vector<float>& weights,
+            const std::vector<int32_t>& delays,
+            const SynapseParams& params);
+
+    void enable_stp(const STPParams& params);
+    void enable_nmda_channel(const SynapseParams& params, float weight);
+    void enable_stdp(const STDPParams& params);
+
+    void deliver_spikes(const std::vector<uint8_t>& pre_fired,
+                        const std::vector<int8_t>& pre_spike_type);
+    const std::vector<float>& step_and_compute(const std::vector<float>& v_post, float dt = 1.0f);
+    void apply_stdp(const std::vector<uint8_t>& pre_fired,
+                    const std::vector<uint8_t>& post_fired, int32_t t);
+
+    size_t n_synapses() const { return col_idx_.size(); }
+    /** CSR 顺序权重 (与 SynapseGroup::weights() 下标一致) */
+    const std::vector<float>& weights() const { return weights_; }
+
+private:
+    struct Pending {
+        int32_t remain;   // 还需经过的 step_and_compute 次数
+        int32_t syn;
+        float   gain;
+        float   w_gain;   // 投递时刻的 w·gain (延迟传递不受途中 STDP 影响)
+    };
+
+    size_t n_pre_, n_post_;
+    std::vector<int32_t> row_ptr_, col_idx_, delays_;
+    std::vector<float> weights_;
+    SynapseParams p_;
+
+    std::vector<float> g_, g_nmda_;
+    std::vector<float> gd_;           // 已到达的延迟门控 (已含权重), 逐突触
+    std::vector<Pending> pending_;
+
+    bool stp_ = false;
+    STPParams stp_params_;
+    std::vector<STPState> stp_state_;
+
+    bool nmda_ = false;
+    SynapseParams nmda_params_;
+    float w_nmda_ = 0.0f;
+
+    bool stdp_ = false;
+    STDPParams stdp_params_;
+    std::vector<float> last_pre_, last_post_;
+
+    std::vector<float> i_post_;
+};
+
+// --- 冻结的单点公式 (供上面两个类与差分测试直接对照) ---
+
+/** Tsodyks-Markram 一步, 返回 u·x (发放前) */
+float stp_step(STPState& s, const STPParams& p, bool spiked, float dt = 1.0f);
+
+/** 经典成对 STDP Δw */
+float stdp_delta_w(float t_pre, float t_post, const STDPParams& p);
+
+/** NMDA Mg²⁺ 门控 B(V) (256 项查表, 与在线实现同一离散化) */
+float nmda_b(float v);
+
+} // namespace ref
+} // namespace wuyun
@@ -8,14 +8,19 @@
  *   2. Go/NoGo 偏好学习: 高DA增强D1(Go), 低DA增强D2(NoGo)
  *   3. 动作选择学习: 奖励动作A → GPi对A的抑制增强 → A被选择
  *   4. 反转学习: 奖励从A切换到B → 权重应逐渐反转
+ *   5. 批量重放: replay_batch 与逐步 replay_learning_step 逐位一致
+ *   6. 后台巩固: 影子 BG 重放, 在确定的同步点增量合并 (保留期间的在线学习)
  */
 
 #include "region/subcortical/basal_ganglia.h"
+#include "engine/background_consolidator.h"
 #include <cstdio>
 #include <cmath>
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include <chrono>
+#include <random>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -386,6 +391,208 @@ void test_reversal_learning() {
     PASS("反转学习 (ACh门控巩固)");
 }
 
+// =============================================================================
+// 测试5: 批量重放 = 逐步重放
+// =============================================================================
+void test_replay_batch_equivalence() {
+    printf("\n--- 测试5: 批量 DA-STDP 重放 vs 逐步重放 ---\n");
+
+    BasalGangliaConfig cfg;
+    cfg.da_stdp_enabled = true;
+    const uint32_t CTX = 999;
+
+    // 片段: 4 段 × 12 step, 每步 ~40 个皮层脉冲 + 运动传出副本
+    std::mt19937 rng(2024);
+    const size_t n_seg = 4, n_steps = 12;
+    std::vector<std::vector<uint16_t>> ids(n_seg * n_steps);
+    std::vector<std::vector<int8_t>>   types(n_seg * n_steps);
+    for (size_t k = 0; k < ids.size(); ++k) {
+        for (uint16_t i = 0; i < 256; ++i) {
+            if (rng() % 6 == 0) {
+                ids[k].push_back(i);
+                types[k].push_back(static_cast<int8_t>(rng() % 5 == 0 ? SpikeType::BURST_START
+                                                                       : SpikeType::REGULAR));
+            }
+        }
+    }
+    const float seg_da[n_seg] = {0.8f, 0.1f, 0.6f, 0.05f};
+
+    auto warm_up = [&](BasalGanglia& bg) {
+        std::vector<SpikeEvent> evts;
+        for (uint32_t i = 0; i < 60; ++i)
+            evts.push_back({CTX, 0, i * 3, static_cast<int8_t>(SpikeType::REGULAR), 0});
+        bg.set_da_level(0.7f);
+        bg.set_ach_level(0.4f);
+        for (int t = 0; t < 50; ++t) { bg.receive_spikes(evts); bg.step(t); }
+        bg.receive_spikes(evts);   // 待消费的输入也应参与重放第一步
+    };
+
+    BasalGanglia bg_step(cfg), bg_batch(cfg);
+    warm_up(bg_step);
+    warm_up(bg_batch);
+
+    // 逐步路径 (原 agent 重放循环)
+    auto run_stepwise = [&](BasalGanglia& bg) {
+        float saved_da = bg.da_level();
+        bg.set_replay_mode(true);
+        for (size_t s = 0; s < n_seg; ++s) {
+            bg.set_da_level(seg_da[s]);
+            for (size_t i = 0; i < n_steps; ++i) {
+                size_t k = s * n_steps + i;
+                std::vector<SpikeEvent> evts;
+                for (size_t e = 0; e < ids[k].size(); ++e)
+                    evts.push_back({CTX, 0, ids[k][e], types[k][e], 0});
+                bg.receive_spikes(evts);
+                bg.mark_motor_efference(static_cast<int>(k % 4));
+                bg.replay_learning_step(0, 1.0f);
+            }
+        }
+        bg.set_replay_mode(false);
+        bg.set_da_level(saved_da);
+    };
+    ReplaySchedule sched;
+    for (size_t s = 0; s < n_seg; ++s) {
+        sched.begin_segment(seg_da[s]);
+        for (size_t i = 0; i < n_steps; ++i) {
+            size_t k = s * n_steps + i;
+            sched.add_step({CTX, ids[k].data(), types[k].data(),
+                            static_cast<uint32_t>(ids[k].size()), static_cast<int>(k % 4)});
+        }
+    }
+
+    run_stepwise(bg_step);
+    bg_batch.replay_batch(sched);
+
+    size_t n_diff = 0, n_changed = 0;
+    for (size_t src = 0; src < bg_step.d1_weight_count(); ++src) {
+        const auto& a1 = bg_step.d1_weights_for(src);
+        const auto& b1 = bg_batch.d1_weights_for(src);
+        const auto& a2 = bg_step.d2_weights_for(src);
+        const auto& b2 = bg_batch.d2_weights_for(src);
+        for (size_t i = 0; i < a1.size(); ++i) { n_diff += a1[i] != b1[i]; n_changed += a1[i] != 1.0f; }
+        for (size_t i = 0; i < a2.size(); ++i) { n_diff += a2[i] != b2[i]; n_changed += a2[i] != 1.0f; }
+    }
+    printf("    %zu 个已学习突触, 逐位差异 %zu\n", n_changed, n_diff);
+    CHECK(n_changed > 0, "重放应改变权重");
+    CHECK(n_diff == 0, "批量重放权重应与逐步路径逐位一致");
+    CHECK(bg_step.total_elig_d1() == bg_batch.total_elig_d1() &&
+          bg_step.total_elig_d2() == bg_batch.total_elig_d2(), "资格痕迹应一致");
+    CHECK(bg_step.da_level() == bg_batch.da_level() && !bg_batch.replay_mode(),
+          "重放后 DA 水平与模式应恢复");
+
+    // 后续正常仿真 (含 PSP/MSN 状态/巩固) 也应一致
+    size_t fired_diff = 0;
+    for (int t = 100; t < 130; ++t) {
+        bg_step.step(t);
+        bg_batch.step(t);
+        for (size_t i = 0; i < bg_step.fired().size(); ++i)
+            fired_diff += bg_step.fired()[i] != bg_batch.fired()[i];
+    }
+    CHECK(fired_diff == 0, "重放后续仿真发放应一致");
+
+    // 计时 (同一状态反复重放)
+    const int reps = 50;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) run_stepwise(bg_step);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) bg_batch.replay_batch(sched);
+    auto t2 = std::chrono::steady_clock::now();
+    double us_step  = std::chrono::duration<double, std::micro>(t1 - t0).count() / reps;
+    double us_batch = std::chrono::duration<double, std::micro>(t2 - t1).count() / reps;
+    printf("    每次重放 (%zu step): 逐步 %.1f us, 批量 %.1f us (%.2fx)\n",
+           n_seg * n_steps, us_step, us_batch, us_step / us_batch);
+
+    PASS("批量重放等价");
+}
+
+// =============================================================================
+// 测试6: 后台异步巩固
+// =============================================================================
+void test_background_consolidation() {
+    printf("\n--- 测试6: 后台巩固 (影子 BG + 增量合并) ---\n");
+
+    BasalGangliaConfig cfg;
+    cfg.da_stdp_enabled = true;
+    const uint32_t CTX = 999;
+
+    std::vector<SpikeEvent> evts;
+    for (uint32_t i = 0; i < 60; ++i)
+        evts.push_back({CTX, 0, i * 3, static_cast<int8_t>(SpikeType::REGULAR), 0});
+    BasalGanglia live(cfg);
+    live.set_da_level(0.7f);
+    for (int t = 0; t < 50; ++t) { live.receive_spikes(evts); live.step(t); }
+
+    // 重放计划: 2 段 × 10 step (奖励 + 惩罚)
+    std::vector<std::vector<uint16_t>> ids(20);
+    std::vector<std::vector<int8_t>>   types(20);
+    ReplaySchedule sched;
+    for (size_t k = 0; k < 20; ++k) {
+        for (uint16_t i = static_cast<uint16_t>(k); i < 256; i += 5) {
+            ids[k].push_back(i);
+            types[k].push_back(static_cast<int8_t>(SpikeType::REGULAR));
+        }
+        if (k % 10 == 0) sched.begin_segment(k == 0 ? 0.8f : 0.1f);
+        sched.add_step({CTX, ids[k].data(), types[k].data(),
+                        static_cast<uint32_t>(ids[k].size()), static_cast<int>(k % 4)});
+    }
+
+    // 参考: 派发时刻的 BG 拷贝上同步重放
+    BasalGanglia ref(live);
+    auto s0 = ref.learning_state();
+    ref.replay_batch(sched);
+    auto s1 = ref.learning_state();
+
+    const int lag = 2;
+    BackgroundConsolidator cons(lag);
+    cons.enqueue(sched);
+    for (auto& v : ids) std::fill(v.begin(), v.end(), 0);   // 入队已拷贝, 原存储可复用
+    cons.sync(live);                                          // 派发
+    CHECK(cons.busy() && cons.pending_steps() == 0, "sync 应派发排队的计划");
+
+    // 作业期间在线 BG 继续学习 (不同 DA)
+    live.set_da_level(0.2f);
+    bool merged_early = false;
+    for (int s = 1; s < lag; ++s) {
+        for (int t = 0; t < 20; ++t) { live.receive_spikes(evts); live.step(100 + t); }
+        cons.sync(live);
+        merged_early = merged_early || cons.jobs_merged() > 0;
+    }
+    for (int t = 0; t < 20; ++t) { live.receive_spikes(evts); live.step(200 + t); }
+    auto mid = live.learning_state();
+    cons.sync(live);                                          // 第 lag 次: 合并点
+    CHECK(!merged_early, "合并只应发生在第 lag 次同步点");
+    CHECK(cons.jobs_merged() == 1 && !cons.busy(), "到期作业应已合并");
+
+    // 期望: 在线状态 + (影子重放后 - 重放前), 钳位
+    auto out = live.learning_state();
+    size_t n_bad = 0, n_delta = 0;
+    for (size_t k = 0; k < out.w_d1.size(); ++k) {
+        float e = std::clamp(mid.w_d1[k] + (s1.w_d1[k] - s0.w_d1[k]), cfg.da_stdp_w_min, cfg.da_stdp_w_max);
+        n_bad += out.w_d1[k] != e;
+        n_delta += s1.w_d1[k] != s0.w_d1[k];
+    }
+    for (size_t k = 0; k < out.w_d2.size(); ++k) {
+        float e = std::clamp(mid.w_d2[k] + (s1.w_d2[k] - s0.w_d2[k]), cfg.da_stdp_w_min, cfg.da_stdp_w_max);
+        n_bad += out.w_d2[k] != e;
+    }
+    for (size_t k = 0; k < out.consol_d1.size(); ++k) {
+        float e = std::max(mid.consol_d1[k] + (s1.consol_d1[k] - s0.consol_d1[k]), 0.0f);
+        n_bad += out.consol_d1[k] != e;
+    }
+    printf("    重放改变 %zu 个 D1 权重, 合并偏差 %zu\n", n_delta, n_bad);
+    CHECK(n_delta > 0, "影子重放应产生权重增量");
+    CHECK(n_bad == 0, "合并结果应为 在线 + 影子增量");
+
+    // drain: 排队计划就地完成
+    for (size_t k = 0; k < 20; ++k) sched.steps[k].ids = ids[k].data();
+    cons.enqueue(sched);
+    cons.drain(live);
+    CHECK(cons.jobs_merged() == 2 && !cons.busy() && cons.pending_steps() == 0,
+          "drain 应完成全部作业");
+
+    PASS("后台巩固");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -402,6 +609,8 @@ int main() {
     test_go_nogo_preference();
     test_action_selection_learning();
     test_reversal_learning();
+    test_replay_batch_equivalence();
+    test_background_consolidation();
 
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
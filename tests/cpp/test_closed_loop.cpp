@@ -9,6 +9,8 @@
  * 5. 动作多样性 (M1产生非全STAY的动作)
  * 6. DA奖励信号 (食物→VTA DA burst)
  * 7. 学习效果 (训练后食物收集率提升)
+ * 8. 连续移动
+ * 9. 实例独立: 先后构造 / 并发线程运行的同配置智能体轨迹逐位相同 (无共享随机流)
  */
 
 #include "engine/grid_world.h"
@@ -19,6 +21,7 @@
 #include <cmath>
 #include <vector>
 #include <map>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -347,6 +350,45 @@ static void test_continuous_movement() {
     printf("  [PASS]\n"); g_pass++;
 }
 
+// =========================================================================
+// Test 9: 实例独立 (睡眠巩固 + SWR 重放路径, 顺序 / 并发)
+// =========================================================================
+static std::vector<float> run_agent_trace(int n_steps) {
+    AgentConfig cfg;
+    cfg.brain_steps_per_action = 6;
+    cfg.wake_steps_before_sleep = 100;   // 多次睡眠巩固 (海马 SWR 噪声)
+    cfg.sleep_nrem_steps = 200;
+    ClosedLoopAgent agent(std::make_unique<GridWorldEnv>(GridWorldConfig{}), cfg);
+    std::vector<float> trace;
+    for (int i = 0; i < n_steps; ++i) {
+        auto r = agent.agent_step();
+        trace.push_back(r.reward);
+        trace.push_back(agent.env().pos_x());
+        trace.push_back(agent.env().pos_y());
+    }
+    trace.push_back(static_cast<float>(agent.hipp()->swr_count()));
+    return trace;
+}
+
+static void test_instance_independence() {
+    printf("\n--- 测试9: 实例独立 (顺序 / 并发) ---\n");
+
+    const int n_steps = 350;
+    auto ref = run_agent_trace(n_steps);
+    auto again = run_agent_trace(n_steps);
+    printf("  %d 步 (含 %d 次睡眠巩固), SWR 事件 %.0f\n", n_steps, n_steps / 100, ref.back());
+    TEST_ASSERT(again == ref, "先后构造的同配置智能体轨迹应相同");
+
+    std::vector<float> a, b;
+    std::thread ta([&] { a = run_agent_trace(n_steps); });
+    std::thread tb([&] { b = run_agent_trace(n_steps); });
+    ta.join();
+    tb.join();
+    TEST_ASSERT(a == ref && b == ref, "并发线程运行的智能体轨迹应与单独运行相同");
+
+    printf("  [PASS]\n"); g_pass++;
+}
+
 // =========================================================================
 // main
 // =========================================================================
@@ -364,6 +406,7 @@ int main() {
     test_da_reward();
     test_long_run_stability();
     test_continuous_movement();
+    test_instance_independence();
 
     printf("\n========================================\n");
     printf("  通过: %d / %d\n", g_pass, g_pass + g_fail);
@@ -8,6 +8,8 @@
  *   4. 前馈+反馈 — 同时输入 → L2/3 BURST (预测匹配)
  *   5. 注意力门控 — VIP激活 → 抑制SST → 释放burst
  *   6. L5驱动输出 — 只有burst才传到皮层下
+ *   7. 局部性重排 — RCM 重排后按外部 ID 的发放与原顺序一致
+ *   8. 按名称访问突触组 — find_synapse / synapse_names (预测突触启用后才出现)
  */
 
 #include "circuit/cortical_column.h"
@@ -275,6 +277,88 @@ static bool test_l5_drive() {
     return cumul.drive > 0;
 }
 
+// =============================================================================
+// 测试 7: 局部性重排 — 内部下标置换, 外部 ID 语义不变
+// =============================================================================
+
+static bool test_locality_reorder() {
+    printf("\n--- 测试7: 局部性重排 (RCM) ---\n");
+
+    auto cfg = small_cfg();
+    CorticalColumn ref(cfg);
+    cfg.locality_reorder = true;
+    CorticalColumn rcm(cfg);
+
+    bool permuted = !rcm.l4_order().identity() && !rcm.l23_order().identity();
+    for (size_t i = 0; i < cfg.n_l23_pyramidal; ++i) {
+        if (rcm.l23_order().to_id(rcm.l23_order().to_internal(i)) != i) permuted = false;
+    }
+
+    // 空间不均匀输入 (按外部 ID): 前半 L4 / 前 1/3 L2/3 有驱动
+    std::vector<float> ff(cfg.n_l4_stellate, 0.0f), fb_l23(cfg.n_l23_pyramidal, 0.0f), fb_l5;
+    for (size_t i = 0; i < ff.size() / 2; ++i) ff[i] = 25.0f;
+    for (size_t i = 0; i < fb_l23.size() / 3; ++i) fb_l23[i] = 20.0f;
+
+    std::vector<size_t> l4_ref(cfg.n_l4_stellate, 0), l4_rcm(cfg.n_l4_stellate, 0);
+    std::vector<size_t> l23_ref(cfg.n_l23_pyramidal, 0), l23_rcm(cfg.n_l23_pyramidal, 0);
+    for (int t = 0; t < 300; ++t) {
+        ref.inject_feedforward(ff);  ref.inject_feedback(fb_l23, fb_l5);
+        rcm.inject_feedforward(ff);  rcm.inject_feedback(fb_l23, fb_l5);
+        ref.step(t);
+        rcm.step(t);
+        for (size_t i = 0; i < l4_ref.size(); ++i) {
+            l4_ref[i] += ref.l4().fired()[i];
+            l4_rcm[i] += rcm.l4().fired()[rcm.l4_order().to_internal(i)];
+        }
+        for (size_t i = 0; i < l23_ref.size(); ++i) {
+            l23_ref[i] += ref.l23().fired()[i];
+            l23_rcm[i] += rcm.l23().fired()[rcm.l23_order().to_internal(i)];
+        }
+    }
+
+    size_t total_ref = 0, total_diff = 0;
+    for (size_t i = 0; i < l4_ref.size(); ++i) {
+        total_ref  += l4_ref[i];
+        total_diff += l4_ref[i] > l4_rcm[i] ? l4_ref[i] - l4_rcm[i] : l4_rcm[i] - l4_ref[i];
+    }
+    for (size_t i = 0; i < l23_ref.size(); ++i) {
+        total_ref  += l23_ref[i];
+        total_diff += l23_ref[i] > l23_rcm[i] ? l23_ref[i] - l23_rcm[i] : l23_rcm[i] - l23_ref[i];
+    }
+    printf("    突触 %zu / %zu   L4+L2/3 发放 %zu, 按外部 ID 逐神经元差异 %zu\n",
+           ref.total_synapses(), rcm.total_synapses(), total_ref, total_diff);
+
+    return permuted && ref.total_synapses() == rcm.total_synapses()
+        && total_ref > 0 && total_diff * 20 <= total_ref;
+}
+
+// =============================================================================
+// 测试 8: 按名称访问突触组 (Python 零拷贝视图的入口)
+// =============================================================================
+
+static bool test_named_synapses() {
+    printf("\n--- 测试8: 按名称访问突触组 ---\n");
+
+    CorticalColumn col(ColumnConfig{});
+    auto names = col.synapse_names();
+    size_t total = 0;
+    bool ok = true;
+    for (const auto& n : names) {
+        SynapseGroup* sg = col.find_synapse(n);
+        ok = ok && sg != nullptr && sg->weights().size() == sg->n_synapses();
+        if (sg) total += sg->n_synapses();
+    }
+    bool predict_hidden = col.find_synapse("l6_to_l23_predict") == nullptr
+                       && col.find_synapse("nonexistent") == nullptr;
+    col.enable_predictive_learning();
+    bool predict_shown = col.find_synapse("l6_to_l23_predict") != nullptr
+                      && col.synapse_names().size() == names.size() + 1;
+
+    printf("    %zu 个突触组, %zu 突触 (total_synapses=%zu)\n",
+           names.size(), total, col.total_synapses());
+    return ok && names.size() == 15 && total > 0 && predict_hidden && predict_shown;
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -294,6 +378,8 @@ int main() {
     report("前馈+反馈→BURST",  test_feedforward_feedback_burst());
     report("注意力门控(VIP)",   test_attention_gating());
     report("L5驱动输出",       test_l5_drive());
+    report("局部性重排(RCM)",   test_locality_reorder());
+    report("按名称访问突触组",   test_named_synapses());
 
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n", g_pass, g_fail, g_pass + g_fail);
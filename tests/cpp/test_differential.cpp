@@ -0,0 +1,164 @@
+/**
+ * 悟韵 (WuYun) 差分测试框架测试
+ *
+ * 测试项:
+ *   1. 群体: 在线 NeuronPopulation (单线程 / WorkerPool 分块) 与冻结参考逐位一致
+ *   2. 突触: CSR 与参考逐位一致; CSC 归约与延迟环在舍入级容差内一致
+ *   3. 统计判据: BF16 权重通过统计等价; 运行时注册的错误后端被识别
+ *   4. BG 重放: 批核与逐步路径逐位一致; KS 统计量与未知后端
+ */
+
+#include "verify/differential.h"
+#include "core/population.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+static constexpr uint32_t SEEDS = 4;
+
+/** 无延迟 / 无 NMDA 的随机场景 (逐位一致的前提) */
+static DiffScenario plain_scenario(uint32_t seed) {
+    DiffScenario sc = random_scenario(seed);
+    sc.steps = 300;
+    sc.max_delay = 1;
+    sc.nmda = false;
+    return sc;
+}
+
+// =============================================================================
+// 测试1: 群体
+// =============================================================================
+void test_population() {
+    printf("\n--- 测试1: 神经元群体 vs 参考 ---\n");
+
+    for (uint32_t seed = 1; seed <= SEEDS; ++seed) {
+        DiffScenario sc = plain_scenario(seed);
+        for (const char* b : {"current", "pool2"}) {
+            DiffReport r = diff_population("reference", b, sc, DiffTolerance::exact());
+            printf("  %s\n", r.summary().c_str());
+            CHECK(r.passed, "在线群体应与参考逐位一致");
+            CHECK(r.rate_a_hz > 0.0, "场景应有发放");
+        }
+    }
+    PASS("NeuronPopulation (单线程 / 线程池) 逐位一致");
+}
+
+// =============================================================================
+// 测试2: 突触
+// =============================================================================
+void test_synapse() {
+    printf("\n--- 测试2: 突触组 + STDP vs 参考 ---\n");
+
+    for (uint32_t seed = 1; seed <= SEEDS; ++seed) {
+        DiffScenario sc = plain_scenario(seed);
+        DiffReport r = diff_synapse("reference", "csr", sc, DiffTolerance::exact());
+        printf("  %s\n", r.summary().c_str());
+        CHECK(r.passed, "CSR 突触应与参考逐位一致 (电流、突触后栅格、权重)");
+        CHECK(r.n_weights > 0, "应比较权重");
+
+        r = diff_synapse("reference", "csc", sc, DiffTolerance::close());
+        CHECK(r.passed, "CSC 归约应在舍入级容差内一致");
+
+        sc.max_delay = 4;
+        r = diff_synapse("reference", "csr", sc, DiffTolerance::close());
+        printf("  %s\n", r.summary().c_str());
+        CHECK(r.passed, "延迟环应与逐突触延迟队列在舍入级容差内一致");
+    }
+    PASS("CSR 逐位一致, CSC / 延迟环舍入级一致");
+}
+
+// =============================================================================
+// 测试3: 统计判据
+// =============================================================================
+void test_statistical() {
+    printf("\n--- 测试3: 统计等价 + 错误后端识别 ---\n");
+
+    DiffScenario sc = plain_scenario(7);
+    DiffReport r = diff_synapse("reference", "bf16", sc, DiffTolerance::statistical());
+    printf("  %s\n", r.summary().c_str());
+    CHECK(r.passed, "BF16 权重应通过统计等价判据");
+    CHECK(r.max_abs_weight > 0.0, "BF16 权重应有量化差异");
+
+    // 运行时注册一个 "优化错了" 的后端: 阈值被改低 3 mV
+    register_population_backend("broken", "阈值 -3 mV (故意错误)", [](size_t n, const NeuronParams& p) {
+        struct Broken : PopulationBackend {
+            NeuronPopulation pop;
+            Broken(size_t n, NeuronParams p) : pop(n, (p.somatic.v_threshold -= 3.0f, p)) {}
+            void inject_basal(size_t i, float c) override  { pop.inject_basal(i, c); }
+            void inject_apical(size_t i, float c) override { pop.inject_apical(i, c); }
+            size_t step(int t, float dt) override { return pop.step(t, dt); }
+            const std::vector<float>&   v_soma() const override     { return pop.v_soma(); }
+            const std::vector<float>&   v_apical() const override   { return pop.v_apical(); }
+            const std::vector<float>&   w_adapt() const override    { return pop.w_adapt(); }
+            const std::vector<uint8_t>& fired() const override      { return pop.fired(); }
+            const std::vector<int8_t>&  spike_type() const override { return pop.spike_type(); }
+        };
+        return std::unique_ptr<PopulationBackend>(new Broken(n, p));
+    });
+    bool listed = false;
+    for (const auto& [name, desc] : population_backends()) listed |= name == "broken";
+    CHECK(listed, "注册的后端应出现在列表中");
+
+    r = diff_population("reference", "broken", plain_scenario(2), DiffTolerance::statistical());
+    printf("  %s\n", r.summary().c_str());
+    CHECK(!r.passed, "改变阈值的后端应被统计判据识别");
+    CHECK(r.rate_b_hz > r.rate_a_hz, "阈值降低 → 发放率升高");
+    PASS("统计等价通过 / 错误后端失败");
+}
+
+// =============================================================================
+// 测试4: BG 重放 + 工具函数
+// =============================================================================
+void test_bg_and_helpers() {
+    printf("\n--- 测试4: BG 重放批核 + KS / 未知后端 ---\n");
+
+    DiffReport r = diff_bg_replay("stepwise", "batch", plain_scenario(3), DiffTolerance::exact());
+    printf("  %s\n", r.summary().c_str());
+    CHECK(r.passed, "批量重放应与逐步重放逐位一致");
+    CHECK(r.n_weights > 0 && r.rate_a_hz > 0.0, "应比较权重且重放后有发放");
+
+    CHECK(ks_statistic({1, 2, 3}, {1, 2, 3}) == 0.0, "相同样本 KS = 0");
+    CHECK(ks_statistic({1, 2, 3}, {4, 5, 6}) == 1.0, "不相交样本 KS = 1");
+    CHECK(ks_statistic({}, {}) == 0.0 && ks_statistic({1}, {}) == 1.0, "空样本约定");
+
+    r = run_differential("synapse", "reference", "no_such_backend", plain_scenario(1), DiffTolerance::exact());
+    CHECK(!r.passed && r.failure.find("no_such_backend") != std::string::npos, "未知后端应报错");
+    r = run_differential("no_such_kernel", "a", "b", plain_scenario(1), DiffTolerance::exact());
+    CHECK(!r.passed, "未知内核应报错");
+    PASS("BG 重放逐位一致 + 辅助函数");
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 差分测试框架测试\n");
+    printf("============================================\n");
+
+    test_population();
+    test_synapse();
+    test_statistical();
+    test_bg_and_helpers();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
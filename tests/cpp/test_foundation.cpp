@@ -8,16 +8,25 @@
  *   4. DA-STDP 三因子学习
  *   5. 神经调质系统
  *   6. 特化神经元参数集验证
+ *   7. AMPA+NMDA 双受体共享 CSR = 两个独立突触组之和
+ *   8. CSC 突触后主序镜像: 行归约电流 = pre 主序散射
+ *   9. 异质突触延迟: 延迟环累加器 = 时移的即时投递
+ *  10. BF16 权重存储: 电流误差 + 随机舍入无偏
+ *  11. 结构可塑性: 持续弱突触剪除 + 压缩 = 只含存活突触的组; 共同活跃对生长
+ *  12. RCM 重排: 打乱标号的环形格子恢复窄带宽
+ *  13. EpisodeBuffer arena: 记录/重放往返, 环形淘汰, 预热后无分配
  */
 
 #include "core/types.h"
 #include "core/population.h"
 #include "core/synapse_group.h"
+#include "core/reorder.h"
 #include "core/spike_bus.h"
 #include "core/neuromodulator.h"
 #include "plasticity/stdp.h"
 #include "plasticity/stp.h"
 #include "plasticity/da_stdp.h"
+#include "engine/episode_buffer.h"
 #include <cstdio>
 #include <cmath>
 #include <vector>
@@ -359,6 +368,506 @@ void test_specialized_params() {
     PASS("特化神经元参数集");
 }
 
+// =============================================================================
+// 测试7: 双受体突触组
+// =============================================================================
+void test_dual_receptor() {
+    printf("\n--- 测试7: AMPA+NMDA 双受体共享 CSR ---\n");
+
+    size_t n_pre = 20, n_post = 15;
+    std::vector<int32_t> pre, post, d;
+    std::vector<float> w;
+    for (size_t i = 0; i < n_pre; ++i) {
+        for (size_t j = 0; j < n_post; ++j) {
+            if ((i * 7 + j * 3) % 5 == 0) {
+                pre.push_back(static_cast<int32_t>(i));
+                post.push_back(static_cast<int32_t>(j));
+                w.push_back(0.5f);
+                d.push_back(1);
+            }
+        }
+    }
+
+    SynapseGroup ampa(n_pre, n_post, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+    SynapseGroup nmda(n_pre, n_post, pre, post, std::vector<float>(w.size(), 0.3f), d,
+                      NMDA_PARAMS, CompartmentType::BASAL);
+    SynapseGroup dual(n_pre, n_post, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+    dual.enable_nmda_channel(NMDA_PARAMS, 0.3f);
+    CHECK(dual.has_nmda_channel() && dual.n_synapses() == ampa.n_synapses(),
+          "双受体组应共享同一拓扑");
+
+    float max_err = 0.0f;
+    std::vector<float> v(n_post);
+    for (int t = 0; t < 200; ++t) {
+        std::vector<uint8_t> fired(n_pre, 0);
+        std::vector<int8_t> st(n_pre, 0);
+        for (size_t i = 0; i < n_pre; ++i) {
+            fired[i] = ((t + static_cast<int>(i)) % 13 == 0) ? 1 : 0;
+            if (fired[i] && i % 4 == 0) st[i] = static_cast<int8_t>(SpikeType::BURST_START);
+        }
+        for (size_t j = 0; j < n_post; ++j) v[j] = -70.0f + static_cast<float>((t + j) % 30);
+
+        ampa.deliver_spikes(fired, st);
+        nmda.deliver_spikes(fired, st);
+        dual.deliver_spikes(fired, st);
+        const auto& ia = ampa.step_and_compute(v);
+        const auto& in = nmda.step_and_compute(v);
+        const auto& id = dual.step_and_compute(v);
+        for (size_t j = 0; j < n_post; ++j) {
+            max_err = std::max(max_err, std::abs(id[j] - (ia[j] + in[j])));
+        }
+    }
+    printf("    200 步融合电流 vs 分离组之和: max|Δ|=%.2e\n", max_err);
+    CHECK(max_err < 1e-3f, "融合双受体电流应等于 AMPA + NMDA 两组之和");
+
+    // NMDA 长尾使双受体组比纯 AMPA 组更晚进入静息
+    for (int t = 0; t < 60; ++t) {
+        std::vector<uint8_t> none(n_pre, 0);
+        std::vector<int8_t> st(n_pre, 0);
+        ampa.deliver_spikes(none, st); ampa.step_and_compute(v);
+        dual.deliver_spikes(none, st); dual.step_and_compute(v);
+    }
+    CHECK(ampa.quiescent() && !dual.quiescent(), "NMDA 通道门控应延长静息判定");
+
+    PASS("AMPA+NMDA 双受体共享 CSR");
+}
+
+// =============================================================================
+// 测试8: CSC 突触后主序镜像
+// =============================================================================
+void test_post_major() {
+    printf("\n--- 测试8: CSC 突触后主序行归约 ---\n");
+
+    // 大扇入: 600 pre → 40 post, 足以触发行归约并行
+    size_t n_pre = 600, n_post = 40;
+    std::vector<int32_t> pre, post, d;
+    std::vector<float> w;
+    for (size_t i = 0; i < n_pre; ++i) {
+        for (size_t j = 0; j < n_post; ++j) {
+            if ((i * 11 + j * 5) % 3 == 0) {
+                pre.push_back(static_cast<int32_t>(i));
+                post.push_back(static_cast<int32_t>(j));
+                w.push_back(0.2f + 0.001f * static_cast<float>(i % 100));
+                d.push_back(1);
+            }
+        }
+    }
+
+    SynapseGroup csr(n_pre, n_post, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+    SynapseGroup csc(n_pre, n_post, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+    csr.enable_nmda_channel(NMDA_PARAMS, 0.3f);
+    csc.enable_nmda_channel(NMDA_PARAMS, 0.3f);
+    csc.enable_post_major();
+    CHECK(csc.post_major() && csc.n_synapses() >= SynapseGroup::POST_MAJOR_MIN_SYNAPSES,
+          "镜像应建立且组规模应超过并行阈值");
+    CHECK(csc.csc_ptr().back() == static_cast<int32_t>(csc.n_synapses()),
+          "CSC 行指针应覆盖全部突触");
+
+    float max_rel = 0.0f;
+    std::vector<float> v(n_post);
+    for (int t = 0; t < 100; ++t) {
+        std::vector<uint8_t> fired(n_pre, 0);
+        std::vector<int8_t> st(n_pre, 0);
+        for (size_t i = 0; i < n_pre; ++i) fired[i] = ((t * 7 + static_cast<int>(i)) % 17 == 0) ? 1 : 0;
+        for (size_t j = 0; j < n_post; ++j) v[j] = -68.0f + static_cast<float>((t + j) % 25);
+
+        csr.deliver_spikes(fired, st);
+        csc.deliver_spikes(fired, st);
+        const auto& a = csr.step_and_compute(v);
+        const auto& b = csc.step_and_compute(v);
+        for (size_t j = 0; j < n_post; ++j) {
+            float rel = std::abs(a[j] - b[j]) / (std::abs(a[j]) + 1e-3f);
+            max_rel = std::max(max_rel, rel);
+        }
+    }
+    printf("    %zu 突触, 100 步: max 相对误差 = %.2e\n", csc.n_synapses(), max_rel);
+    CHECK(max_rel < 1e-4f, "行归约电流应与 pre 主序散射一致");
+
+    PASS("CSC 突触后主序行归约");
+}
+
+// =============================================================================
+// 测试9: 异质突触延迟 (post 环形累加器)
+// =============================================================================
+void test_synaptic_delays() {
+    printf("\n--- 测试9: 异质突触延迟环 ---\n");
+
+    // 同一拓扑: 延迟全为 1 的参考组 vs 延迟 1..4 的组 (pre i 的延迟 = 1 + i%4)
+    size_t n_pre = 8, n_post = 6;
+    std::vector<int32_t> pre, post, d1, dk;
+    std::vector<float> w;
+    for (size_t i = 0; i < n_pre; ++i) {
+        for (size_t j = 0; j < n_post; ++j) {
+            if ((i + j) % 2 == 0) {
+                pre.push_back(static_cast<int32_t>(i));
+                post.push_back(static_cast<int32_t>(j));
+                w.push_back(0.4f + 0.05f * static_cast<float>(i));
+                d1.push_back(1);
+                dk.push_back(1 + static_cast<int32_t>(i % 4));
+            }
+        }
+    }
+
+    const int T = 80;
+    std::vector<float> v(n_post, -65.0f);
+    std::vector<int8_t> st(n_pre, 0);
+
+    // 参考: 每个延迟类别单独一组即时投递, 脉冲人为推迟 d-1 步
+    std::vector<std::vector<float>> expect(T, std::vector<float>(n_post, 0.0f));
+    for (int32_t dly = 1; dly <= 4; ++dly) {
+        std::vector<int32_t> p2, q2, dd;
+        std::vector<float> w2;
+        for (size_t s = 0; s < pre.size(); ++s) {
+            if (dk[s] != dly) continue;
+            p2.push_back(pre[s]); q2.push_back(post[s]); w2.push_back(w[s]); dd.push_back(1);
+        }
+        SynapseGroup ref(n_pre, n_post, p2, q2, w2, dd, AMPA_PARAMS, CompartmentType::BASAL);
+        for (int t = 0; t < T; ++t) {
+            std::vector<uint8_t> fired(n_pre, 0);
+            int src = t - (dly - 1);
+            if (src == 3 || src == 20) std::fill(fired.begin(), fired.end(), 1);
+            ref.deliver_spikes(fired, st);
+            const auto& i_ref = ref.step_and_compute(v);
+            for (size_t j = 0; j < n_post; ++j) expect[static_cast<size_t>(t)][j] += i_ref[j];
+        }
+    }
+
+    SynapseGroup delayed(n_pre, n_post, pre, post, w, dk, AMPA_PARAMS, CompartmentType::BASAL);
+    CHECK(delayed.has_delay_ring() && delayed.max_delay() == 4, "延迟 > 1 应建立 post 环");
+    SynapseGroup flat(n_pre, n_post, pre, post, w, d1, AMPA_PARAMS, CompartmentType::BASAL);
+    CHECK(!flat.has_delay_ring(), "统一 1 步延迟不应建环");
+
+    float max_err = 0.0f;
+    bool pending_seen = false;
+    for (int t = 0; t < T; ++t) {
+        std::vector<uint8_t> fired(n_pre, 0);
+        if (t == 3 || t == 20) std::fill(fired.begin(), fired.end(), 1);
+        delayed.deliver_spikes(fired, st);
+        const auto& i_d = delayed.step_and_compute(v);
+        for (size_t j = 0; j < n_post; ++j) {
+            max_err = std::max(max_err, std::abs(i_d[j] - expect[static_cast<size_t>(t)][j]));
+        }
+        if (t == 4 && !delayed.quiescent(1e9f)) pending_seen = true;
+    }
+    printf("    延迟 1..4 步, %d 步电流 max|Δ| = %.2e\n", T, max_err);
+    CHECK(max_err < 1e-4f, "延迟环电流应等于按延迟推迟的即时投递");
+    CHECK(pending_seen, "环内未到期增量应阻止静息判定");
+
+    PASS("异质突触延迟环");
+}
+
+// =============================================================================
+// 测试10: BF16 权重存储
+// =============================================================================
+void test_bf16_weights() {
+    printf("\n--- 测试10: BF16 权重存储 ---\n");
+
+    size_t n_pre = 50, n_post = 30;
+    std::vector<int32_t> pre, post, d;
+    std::vector<float> w;
+    for (size_t i = 0; i < n_pre; ++i) {
+        for (size_t j = 0; j < n_post; ++j) {
+            if ((i * 3 + j) % 4 == 0) {
+                pre.push_back(static_cast<int32_t>(i));
+                post.push_back(static_cast<int32_t>(j));
+                w.push_back(0.3f + 0.0137f * static_cast<float>((i + j) % 50));
+                d.push_back(1);
+            }
+        }
+    }
+    SynapseGroup f32(n_pre, n_post, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+    SynapseGroup b16(n_pre, n_post, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+    b16.set_weight_format(WeightFormat::BF16);
+    CHECK(b16.weight_bytes() * 2 == f32.weight_bytes(), "BF16 权重存储应为 FP32 的一半");
+
+    float max_rel = 0.0f;
+    std::vector<float> v(n_post, -60.0f);
+    for (int t = 0; t < 50; ++t) {
+        std::vector<uint8_t> fired(n_pre, 0);
+        std::vector<int8_t> st(n_pre, 0);
+        for (size_t i = 0; i < n_pre; ++i) fired[i] = ((t + static_cast<int>(i)) % 7 == 0) ? 1 : 0;
+        f32.deliver_spikes(fired, st);
+        b16.deliver_spikes(fired, st);
+        const auto& a = f32.step_and_compute(v);
+        const auto& b = b16.step_and_compute(v);
+        for (size_t j = 0; j < n_post; ++j) {
+            max_rel = std::max(max_rel, std::abs(a[j] - b[j]) / (std::abs(a[j]) + 1e-3f));
+        }
+    }
+
+    // 随机舍入: 1000 次 +0.0005 (远小于 0.5 附近的 BF16 最小间隔 2^-8), 期望 +0.5
+    for (size_t s = 0; s < b16.n_synapses(); ++s) b16.set_weight(s, 0.5f);
+    for (int k = 0; k < 1000; ++k) {
+        for (size_t s = 0; s < b16.n_synapses(); ++s) b16.set_weight(s, b16.weight(s) + 0.0005f);
+    }
+    double mean = 0.0;
+    for (size_t s = 0; s < b16.n_synapses(); ++s) mean += b16.weight(s);
+    mean /= static_cast<double>(b16.n_synapses());
+
+    printf("    电流 max 相对误差 = %.2e   随机舍入累加: 0.5 + 1000×0.0005 → %.4f\n",
+           max_rel, mean);
+    CHECK(max_rel < 0.01f, "BF16 电流相对误差应 < 1%");
+    CHECK(std::abs(mean - 1.0) < 0.02, "随机舍入下小增量累加应无偏");
+
+    auto snap = b16.weights();
+    bool snap_ok = snap.size() == b16.n_synapses() && b16.fp32_weights().empty();
+    for (size_t s = 0; snap_ok && s < snap.size(); ++s) snap_ok = snap[s] == b16.weight(s);
+    CHECK(snap_ok, "BF16 weights() 快照 = 逐突触解码, 无 fp32 存储");
+
+    b16.set_weight_format(WeightFormat::FP32);
+    CHECK(b16.weight_format() == WeightFormat::FP32 && b16.weights().size() == b16.n_synapses(),
+          "BF16 → FP32 应恢复 fp32 权重数组");
+
+    PASS("BF16 权重存储");
+}
+
+// =============================================================================
+// 测试11: 结构可塑性 (剪除 + 压缩 + 生长)
+// =============================================================================
+void test_structural_plasticity() {
+    printf("\n--- 测试11: 结构可塑性 ---\n");
+
+    // 一半突触权重 0.01 (< 阈值 0.02), 其余 0.5
+    size_t n_pre = 80, n_post = 60;
+    std::vector<int32_t> pre, post, d, pre_live, post_live, d_live;
+    std::vector<float> w, w_live;
+    for (size_t i = 0; i < n_pre; ++i) {
+        for (size_t j = 0; j < n_post; ++j) {
+            if ((i * 7 + j * 3) % 5 != 0) continue;
+            bool weak = (i + j) % 2 == 0;
+            pre.push_back(static_cast<int32_t>(i));
+            post.push_back(static_cast<int32_t>(j));
+            w.push_back(weak ? 0.01f : 0.5f);
+            d.push_back(1);
+            if (!weak) {
+                pre_live.push_back(static_cast<int32_t>(i));
+                post_live.push_back(static_cast<int32_t>(j));
+                w_live.push_back(0.5f);
+                d_live.push_back(1);
+            }
+        }
+    }
+
+    StructuralParams sp;
+    sp.prune_threshold = 0.02f;
+    sp.prune_window    = 300;
+    sp.check_interval  = 100;
+
+    SynapseGroup sg(n_pre, n_post, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+    SynapseGroup ref(n_pre, n_post, pre_live, post_live, w_live, d_live, AMPA_PARAMS, CompartmentType::BASAL);
+    sg.enable_nmda_channel(NMDA_PARAMS, 0.3f);
+    ref.enable_nmda_channel(NMDA_PARAMS, 0.3f);
+    sg.enable_post_major();
+    sg.enable_structural(sp);
+
+    std::vector<float> v(n_post, -60.0f);
+    std::vector<int8_t> st(n_pre, 0);
+    std::vector<uint8_t> post_fired(n_post, 0);
+    auto drive = [&](int t) {
+        std::vector<uint8_t> fired(n_pre, 0);
+        for (size_t i = 0; i < n_pre; ++i) fired[i] = ((t + static_cast<int>(i)) % 9 == 0) ? 1 : 0;
+        return fired;
+    };
+
+    for (int t = 0; t < 299; ++t) {
+        auto fired = drive(t);
+        sg.deliver_spikes(fired, st);  sg.step_and_compute(v);
+        ref.deliver_spikes(fired, st); ref.step_and_compute(v);
+        sg.update_structural(fired, post_fired);
+    }
+    CHECK(sg.pending_prunes() == 0, "未满 prune_window 不应剪除");
+    {
+        auto fired = drive(299);
+        sg.deliver_spikes(fired, st);  sg.step_and_compute(v);
+        ref.deliver_spikes(fired, st); ref.step_and_compute(v);
+        sg.update_structural(fired, post_fired);
+    }
+    size_t n_weak = pre.size() - pre_live.size();
+    CHECK(sg.pending_prunes() == n_weak, "持续弱突触应全部标记剪除");
+
+    size_t removed = sg.compact();
+    CHECK(removed == n_weak && sg.n_synapses() == ref.n_synapses(), "压缩应移出全部已标记突触");
+    CHECK(sg.csc_ptr().back() == static_cast<int32_t>(sg.n_synapses()), "CSC 镜像应随压缩重建");
+
+    float max_rel = 0.0f;
+    for (int t = 300; t < 400; ++t) {
+        auto fired = drive(t);
+        sg.deliver_spikes(fired, st);
+        ref.deliver_spikes(fired, st);
+        const auto& a = sg.step_and_compute(v);
+        const auto& b = ref.step_and_compute(v);
+        for (size_t j = 0; j < n_post; ++j) {
+            max_rel = std::max(max_rel, std::abs(a[j] - b[j]) / (std::abs(a[j]) + 1e-3f));
+        }
+    }
+    printf("    %zu → %zu 突触, 压缩后电流 max 相对误差 = %.2e\n",
+           pre.size(), sg.n_synapses(), max_rel);
+    CHECK(max_rel < 1e-4f, "压缩后电流应等于只含存活突触的组");
+
+    // 生长: pre/post 0..4 每 2 步共同发放, 其余沉默 → 新突触只应落在活跃对上
+    StructuralParams gp;
+    gp.grow_enabled   = true;
+    gp.grow_threshold = 0.05f;
+    gp.grow_samples   = 4000;
+    gp.rate_tau       = 50.0f;
+    SynapseGroup grow(20, 20, {0, 10}, {10, 0}, {0.5f, 0.5f}, {1, 1}, AMPA_PARAMS, CompartmentType::BASAL);
+    grow.enable_structural(gp);
+    for (int t = 0; t < 300; ++t) {
+        std::vector<uint8_t> f(20, 0);
+        if (t % 2 == 0) for (size_t i = 0; i < 5; ++i) f[i] = 1;
+        grow.update_structural(f, f);
+    }
+    grow.compact();
+    bool only_active = true;
+    for (size_t p = 0; p < 20; ++p) {
+        for (int32_t s = grow.row_ptr()[p]; s < grow.row_ptr()[p + 1]; ++s) {
+            size_t q = static_cast<size_t>(grow.col_idx()[static_cast<size_t>(s)]);
+            bool original = (p == 0 && q == 10) || (p == 10 && q == 0);
+            if (!original && (p >= 5 || q >= 5 || p == q)) only_active = false;
+        }
+    }
+    printf("    生长: %llu 个新突触 (活跃 5×5 块, 无自突触 → 上限 20)\n",
+           static_cast<unsigned long long>(grow.grown_total()));
+    CHECK(grow.grown_total() == 20 && grow.n_synapses() == 22, "活跃对应全部生长且不重复");
+    CHECK(only_active, "新突触只应连接共同活跃的神经元");
+
+    PASS("结构可塑性");
+}
+
+// =============================================================================
+// 测试12: RCM 局部性重排
+// =============================================================================
+void test_rcm_reorder() {
+    printf("\n--- 测试12: RCM 局部性重排 ---\n");
+
+    // 环形格子 (每个节点连 ±1..3 邻居), 标号用固定置换打乱
+    const size_t n = 400;
+    std::vector<int32_t> label(n);
+    for (size_t i = 0; i < n; ++i) label[i] = static_cast<int32_t>((i * 173) % n);
+    std::vector<std::pair<int32_t, int32_t>> edges;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 1; k <= 3; ++k) edges.emplace_back(label[i], label[(i + k) % n]);
+    }
+
+    auto span_of = [&](const NeuronOrder& order) {
+        std::vector<int32_t> pre, post, d;
+        std::vector<float> w;
+        for (const auto& e : edges) {
+            pre.push_back(static_cast<int32_t>(order.to_internal(static_cast<size_t>(e.first))));
+            post.push_back(static_cast<int32_t>(order.to_internal(static_cast<size_t>(e.second))));
+            w.push_back(0.5f);
+            d.push_back(1);
+        }
+        SynapseGroup sg(n, n, pre, post, w, d, AMPA_PARAMS, CompartmentType::BASAL);
+        return mean_row_span(sg.row_ptr(), sg.col_idx());
+    };
+
+    NeuronOrder order = NeuronOrder::from_sequence(rcm_order(n, edges));
+    bool bijective = order.id_of_internal.size() == n;
+    for (size_t i = 0; i < n && bijective; ++i) bijective = order.to_id(order.to_internal(i)) == i;
+
+    double before = span_of(NeuronOrder{});
+    double after  = span_of(order);
+    printf("    %zu 节点环形格子: 行平均跨度 %.1f → %.1f\n", n, before, after);
+    CHECK(bijective, "RCM 顺序应为置换");
+    CHECK(after * 10.0 < before, "RCM 应恢复窄带宽");
+
+    PASS("RCM 局部性重排");
+}
+
+// =============================================================================
+// 测试13: EpisodeBuffer arena
+// =============================================================================
+void test_episode_arena() {
+    printf("\n--- 测试13: EpisodeBuffer arena (uint16 ID + 1 字节类型) ---\n");
+
+    const size_t n_ctx = 300, n_sen = 900, n_steps = 15, max_ep = 4;
+    EpisodeBuffer buf(max_ep, n_steps);
+    std::vector<uint8_t> ctx_fired(n_ctx), sen_fired(n_sen);
+    std::vector<int8_t>  ctx_types(n_ctx), sen_types(n_sen);
+
+    // 确定性发放模式: episode e, step s 下神经元 i 是否发放
+    auto fires = [](size_t e, size_t s, size_t i) { return (i * 7 + s * 3 + e * 11) % 10 == 0; };
+    auto fill = [&](size_t e, size_t s) {
+        for (size_t i = 0; i < n_ctx; ++i) {
+            ctx_fired[i] = fires(e, s, i) ? 1 : 0;
+            ctx_types[i] = static_cast<int8_t>(ctx_fired[i] ? 1 + (i % 3) : 0);
+        }
+        for (size_t i = 0; i < n_sen; ++i) {
+            sen_fired[i] = fires(e, s + 1, i) ? 1 : 0;
+            sen_types[i] = static_cast<int8_t>(sen_fired[i] ? 1 : 0);
+        }
+    };
+
+    size_t events = 0;
+    size_t warm_bytes = 0;
+    bool stable = true;
+    const size_t n_episodes = 12;
+    buf.begin_episode();
+    for (size_t e = 0; e < n_episodes; ++e) {
+        for (size_t s = 0; s < n_steps; ++s) {
+            fill(e, s);
+            buf.record_step(7, ctx_fired, ctx_types, static_cast<int>(s % 4),
+                            3, &sen_fired, &sen_types);
+        }
+        buf.end_episode(static_cast<float>(e), static_cast<int>(e % 5));
+        if (e == max_ep + 1) warm_bytes = buf.arena_bytes();
+        if (e > max_ep + 1 && buf.arena_bytes() != warm_bytes) stable = false;
+    }
+    CHECK(buf.size() == max_ep, "环形缓冲应保留 max_episodes 个片段");
+
+    // 往返: 最新片段在前, 逐 step 与原发放模式一致
+    auto recent = buf.recent(10);
+    bool order_ok = recent.size() == max_ep;
+    bool roundtrip = true;
+    std::vector<SpikeEvent> evts;
+    for (size_t r = 0; r < recent.size(); ++r) {
+        size_t e = n_episodes - 1 - r;
+        order_ok = order_ok && recent[r].reward == static_cast<float>(e)
+                            && recent[r].action == static_cast<int>(e % 5)
+                            && recent[r].size() == n_steps;
+        for (size_t s = 0; s < recent[r].size(); ++s) {
+            SpikeSnapshot snap = recent[r].step(s);
+            fill(e, s);
+            snap.cortical_events(evts);
+            size_t k = 0;
+            for (size_t i = 0; i < n_ctx; ++i) {
+                if (!ctx_fired[i]) continue;
+                roundtrip = roundtrip && k < evts.size() && evts[k].neuron_id == i
+                          && evts[k].region_id == 7 && evts[k].spike_type == ctx_types[i];
+                ++k;
+            }
+            roundtrip = roundtrip && k == evts.size() && snap.action_group == static_cast<int>(s % 4);
+            snap.sensory_events(evts);
+            k = 0;
+            for (size_t i = 0; i < n_sen; ++i) {
+                if (!sen_fired[i]) continue;
+                roundtrip = roundtrip && k < evts.size() && evts[k].neuron_id == i && evts[k].region_id == 3;
+                ++k;
+            }
+            roundtrip = roundtrip && k == evts.size();
+            events += snap.n_cortical + snap.n_sensory;
+        }
+    }
+    auto last = buf.last_rewarded(0.5f);
+    CHECK(order_ok, "recent() 应从新到旧, 奖励/动作/步数一致");
+    CHECK(roundtrip, "重放展开的脉冲应与记录完全一致");
+    CHECK(last && last->reward == static_cast<float>(n_episodes - 1), "last_rewarded 应返回最新显著片段");
+    CHECK(stable, "预热后 arena 容量不再增长 (记录无分配)");
+
+    size_t legacy_bytes = events * sizeof(SpikeEvent);
+    size_t packed_bytes = events * (sizeof(uint16_t) + sizeof(int8_t));
+    printf("    %zu 事件: SpikeEvent %zu B → arena %zu B (总容量 %zu B)\n",
+           events, legacy_bytes, packed_bytes, buf.arena_bytes());
+    CHECK(packed_bytes * 6 < legacy_bytes, "打包事件应比 SpikeEvent 小 6 倍以上");
+    CHECK(buf.dropped_events() == 0, "ID < 65536 时不应丢弃事件");
+
+    buf.clear();
+    CHECK(buf.empty() && buf.recent(5).empty(), "clear() 后应为空");
+
+    PASS("EpisodeBuffer arena");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -377,6 +886,13 @@ int main() {
     test_da_stdp();
     test_neuromodulator();
     test_specialized_params();
+    test_dual_receptor();
+    test_post_major();
+    test_synaptic_delays();
+    test_bf16_weights();
+    test_structural_plasticity();
+    test_rcm_reorder();
+    test_episode_arena();
 
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
@@ -0,0 +1,229 @@
+/**
+ * 悟韵 (WuYun) 输入录制/回放测试
+ *
+ * 测试项:
+ *   1. 录制: 智能体运行时每个 brain step 一条步边界, 区域表与引擎一致
+ *   2. 回放 = 原运行: 新建同配置的脑, 按 trace 驱动, 每步各区域发放逐位一致
+ *   3. 存取: save/load 往返后记录流相同, 区域表不符时拒绝回放
+ *   4. 损坏 trace: 区域下标越界/稀疏下标越界在 load 时拒绝, 区域类型不符时回放停止
+ */
+
+#include "engine/closed_loop_agent.h"
+#include "engine/grid_world_env.h"
+#include "engine/input_trace.h"
+#include "region/cortical_region.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+static constexpr int AGENT_STEPS = 100;
+
+// 离线 BG 回放 (引擎外改写权重) 不在 trace 中: 关闭后回放应逐位复现
+static AgentConfig trace_config() {
+    AgentConfig cfg;
+    cfg.enable_replay = false;
+    return cfg;
+}
+
+static std::unique_ptr<ClosedLoopAgent> make_agent() {
+    return std::make_unique<ClosedLoopAgent>(
+        std::make_unique<GridWorldEnv>(GridWorldConfig{}), trace_config());
+}
+
+/** 每步所有区域发放向量的指纹 (FNV-1a) */
+static void record_fingerprints(SimulationEngine& engine, std::vector<uint64_t>& out) {
+    engine.set_callback([&out](int32_t, SimulationEngine& e) {
+        uint64_t h = 1469598103934665603ull;
+        for (size_t i = 0; i < e.num_regions(); ++i) {
+            const auto& f = e.region(i).fired();
+            for (size_t j = 0; j < f.size(); ++j) {
+                if (f[j]) { h ^= (i << 32) | j; h *= 1099511628211ull; }
+            }
+        }
+        out.push_back(h);
+    });
+}
+
+static InputTrace g_trace;
+static std::vector<uint64_t> g_recorded;
+
+// =============================================================================
+// 测试1: 录制
+// =============================================================================
+void test_record() {
+    printf("\n--- 测试1: 录制 ---\n");
+
+    auto agent = make_agent();
+    g_trace.begin(agent->brain(), "brain_scale=1");
+    agent->set_input_trace(&g_trace);
+    record_fingerprints(agent->brain(), g_recorded);
+    agent->run(AGENT_STEPS);
+    agent->set_input_trace(nullptr);
+
+    printf("  %d agent steps → %llu brain steps, %zu records, %zu bytes\n", AGENT_STEPS,
+           static_cast<unsigned long long>(g_trace.num_steps()), g_trace.num_records(), g_trace.bytes());
+    CHECK(g_trace.num_steps() == g_recorded.size(), "trace 步数应等于引擎实际步数");
+    CHECK(g_trace.num_steps() >= static_cast<uint64_t>(AGENT_STEPS) * AgentConfig{}.brain_steps_per_action,
+          "每个 agent step 至少 brain_steps_per_action 步");
+    CHECK(g_trace.matches(agent->brain()), "区域表应与录制引擎一致");
+    CHECK(g_trace.num_records() > g_trace.num_steps(), "除步边界外应有输入记录");
+    PASS("录制步边界 + 输入");
+}
+
+// =============================================================================
+// 测试2: 回放 = 原运行
+// =============================================================================
+void test_replay_matches() {
+    printf("\n--- 测试2: 回放逐位复现 ---\n");
+
+    auto fresh = make_agent();
+    std::vector<uint64_t> replayed;
+    record_fingerprints(fresh->brain(), replayed);
+    InputTraceReplayer replayer(g_trace, fresh->brain());
+    uint64_t n = replayer.run();
+
+    CHECK(n == g_trace.num_steps(), "应回放全部步");
+    CHECK(replayed.size() == g_recorded.size(), "回放步数应等于录制步数");
+    size_t first_diff = replayed.size();
+    for (size_t i = 0; i < replayed.size(); ++i) {
+        if (replayed[i] != g_recorded[i]) { first_diff = i; break; }
+    }
+    if (first_diff < replayed.size()) printf("  首个不一致步: %zu\n", first_diff);
+    CHECK(first_diff == replayed.size(), "每步各区域发放应与原运行逐位一致");
+
+    CHECK(!replayer.step(), "trace 结束后 step() 应返回 false");
+    PASS("回放与闭环运行逐位一致");
+}
+
+// =============================================================================
+// 测试3: 存取
+// =============================================================================
+void test_save_load() {
+    printf("\n--- 测试3: 存取 ---\n");
+
+    const std::string path = "test_input_trace.wyit";
+    CHECK(g_trace.save(path), "保存应成功");
+    InputTrace loaded;
+    CHECK(loaded.load(path), "读取应成功");
+    std::remove(path.c_str());
+
+    CHECK(loaded.num_steps() == g_trace.num_steps(), "步数应相同");
+    CHECK(loaded.num_records() == g_trace.num_records(), "记录数应相同");
+    CHECK(loaded.meta() == "brain_scale=1", "meta 应保留");
+
+    auto agent = make_agent();
+    std::vector<uint64_t> replayed;
+    record_fingerprints(agent->brain(), replayed);
+    InputTraceReplayer(loaded, agent->brain()).run();
+    CHECK(replayed == g_recorded, "读回的 trace 回放应同样逐位一致");
+
+    AgentConfig big = trace_config();
+    big.brain_scale = 2;
+    ClosedLoopAgent other(std::make_unique<GridWorldEnv>(GridWorldConfig{}), big);
+    std::string why;
+    CHECK(!loaded.matches(other.brain(), &why), "不同规模的脑应被拒绝");
+    printf("  拒绝原因: %s\n", why.c_str());
+    PASS("save/load 往返 + 结构校验");
+}
+
+// =============================================================================
+// 测试4: 损坏 trace
+// =============================================================================
+void test_corrupt() {
+    printf("\n--- 测试4: 损坏 trace 的校验 ---\n");
+
+    auto agent = make_agent();
+    SimulationEngine& eng = agent->brain();
+    const std::string path = "test_input_trace_bad.wyit";
+    std::string why;
+    InputTrace loaded;
+
+    // (a) 区域下标越界: 录制中的 trace 回放即停, 存盘后 load 拒绝
+    InputTrace bad_region;
+    bad_region.begin(eng);
+    bad_region.scalar(TraceOp::HYPO_HEDONIC, static_cast<uint32_t>(eng.num_regions()) + 3, 1.0f);
+    bad_region.step();
+    InputTraceReplayer r1(bad_region, eng);
+    CHECK(r1.run() == 0 && !r1.ok(), "越界区域下标应停止回放");
+    CHECK(bad_region.save(path), "保存应成功");
+    CHECK(!loaded.load(path, &why), "越界区域下标应在 load 时被拒绝");
+    printf("  区域下标: %s\n", why.c_str());
+
+    // (b) 稀疏下标越界: 写出一条稀疏记录, 再改写文件中的下标
+    InputTrace sparse;
+    sparse.begin(eng);
+    std::vector<float> v(16, 0.0f);
+    v[3] = 1.0f;
+    sparse.values(TraceOp::EXTERNAL, 0, v);
+    sparse.step();
+    CHECK(sparse.save(path), "保存应成功");
+    CHECK(loaded.load(path), "未改写的稀疏 trace 应能读取");
+    {
+        // 文件尾: 稀疏记录 {hdr 8, n 4, idx 4, v 4} + STEP 记录 {hdr 8, count 4}
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-20, std::ios::end);
+        uint32_t idx = 1000;
+        f.write(reinterpret_cast<const char*>(&idx), 4);
+    }
+    CHECK(!loaded.load(path, &why), "稀疏下标越界应在 load 时被拒绝");
+    printf("  稀疏下标: %s\n", why.c_str());
+
+    // (c) 区域类型不符: 对非皮层区域记录 CTX_ACH_STDP_GAIN
+    uint32_t non_ctx = 0;
+    while (dynamic_cast<CorticalRegion*>(&eng.region(non_ctx))) ++non_ctx;
+    InputTrace wrong_kind;
+    wrong_kind.begin(eng);
+    wrong_kind.scalar(TraceOp::CTX_ACH_STDP_GAIN, non_ctx, 0.5f);
+    wrong_kind.step();
+    CHECK(wrong_kind.save(path) && loaded.load(path), "结构合法的 trace 应能读取");
+    InputTraceReplayer r3(loaded, eng);
+    CHECK(r3.run() == 0 && !r3.ok(), "区域类型不符应停止回放");
+    printf("  区域类型: %s\n", r3.error().c_str());
+    std::remove(path.c_str());
+
+    // (d) 区域表不符: 回放器拒绝
+    AgentConfig big = trace_config();
+    big.brain_scale = 2;
+    ClosedLoopAgent other(std::make_unique<GridWorldEnv>(GridWorldConfig{}), big);
+    InputTraceReplayer r4(g_trace, other.brain());
+    CHECK(r4.run() == 0 && !r4.ok(), "区域表不符时不应回放");
+
+    PASS("损坏 trace 的校验");
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 输入录制/回放测试\n");
+    printf("============================================\n");
+
+    test_record();
+    test_replay_matches();
+    test_save_load();
+    test_corrupt();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
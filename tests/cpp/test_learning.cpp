@@ -9,6 +9,8 @@
  *   3. 模式补全: 部分线索 → CA3重建完整模式
  *   4. 模式分离: 不同模式编码到不同CA3子集
  *   5. BG DA-STDP: 奖励改变动作选择偏好
+ *
+ * 海马测试 (1/2/3/5) 再以 BF16 权重存储运行一遍: 随机舍入下学习仍应收敛
  */
 
 #include "region/limbic/hippocampus.h"
@@ -28,6 +30,7 @@
 using namespace wuyun;
 
 static int g_pass = 0, g_fail = 0;
+static WeightFormat g_weight_format = WeightFormat::FP32;
 
 #define CHECK(cond, msg) do { \
     if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
@@ -84,6 +87,7 @@ void test_ca3_stdp_weight_change() {
 
     auto cfg = make_learning_config();
     Hippocampus hipp(cfg);
+    hipp.set_weight_format(g_weight_format);
 
     // Phase 1: Drive EC with a strong pattern to activate DG→CA3
     std::vector<size_t> pattern_a;
@@ -116,6 +120,7 @@ void test_ca3_stdp_weight_change() {
     auto cfg_noplast = make_learning_config();
     cfg_noplast.ca3_stdp_enabled = false;
     Hippocampus hipp_no(cfg_noplast);
+    hipp_no.set_weight_format(g_weight_format);
 
     // Skip encoding, go straight to test
     size_t ca3_no_learning = 0;
@@ -147,6 +152,7 @@ void test_memory_encode_recall() {
 
     auto cfg = make_learning_config();
     Hippocampus hipp(cfg);
+    hipp.set_weight_format(g_weight_format);
 
     // Pattern A: EC neurons 0-49 active (~62% of EC)
     std::vector<size_t> pattern_a;
@@ -220,6 +226,7 @@ void test_pattern_separation() {
 
     auto cfg = make_learning_config();
     Hippocampus hipp(cfg);
+    hipp.set_weight_format(g_weight_format);
 
     // Pattern A: EC 0-39 (50%)
     std::vector<size_t> pat_a_ids;
@@ -357,6 +364,7 @@ void test_memory_capacity() {
 
     auto cfg = make_learning_config();
     Hippocampus hipp(cfg);
+    hipp.set_weight_format(g_weight_format);
 
     // Encode 3 overlapping patterns (each 50% of EC, with partial overlap)
     // In biology, overlapping inputs are the norm
@@ -428,6 +436,14 @@ int main() {
     test_bg_reinforcement_learning();
     test_memory_capacity();
 
+    // 精度研究: BF16 权重 (STDP 随机舍入) 下重跑海马学习测试
+    printf("\n--- BF16 权重存储 ---\n");
+    g_weight_format = WeightFormat::BF16;
+    test_ca3_stdp_weight_change();
+    test_memory_encode_recall();
+    test_pattern_separation();
+    test_memory_capacity();
+
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
            g_pass, g_fail, g_pass + g_fail);
@@ -11,6 +11,9 @@
  *   2. 信号传播: 视觉输入能逐级传递到 M1
  *   3. DA 调制: 奖励信号增强 BG Go 通路
  *   4. 沉默测试: 无输入时系统安静
+ *   5. 常驻线程池: 与 OpenMP 逐步结果一致
+ *   6. 热路径剖析: 阶段计时/区域计数/Chrome trace 导出
+ *   7. Chrome trace 名称转义 (不依赖 WUYUN_PROFILE)
  */
 
 #include "engine/simulation_engine.h"
@@ -48,7 +51,7 @@ static size_t count_spikes(const BrainRegion& r) {
 // =============================================================================
 // Build the minimal brain
 // =============================================================================
-static SimulationEngine build_minimal_brain() {
+static SimulationEngine build_minimal_brain(int32_t vta_delay = 1) {
     SimulationEngine engine(10);
 
     // --- Create regions ---
@@ -128,7 +131,7 @@ static SimulationEngine build_minimal_brain() {
     engine.add_projection("dlPFC", "BG", 2, "dlPFC→BG");       // 动作选择
     engine.add_projection("BG", "MotorThal", 2, "BG→MotorThal"); // GPi→丘脑
     engine.add_projection("MotorThal", "M1", 2, "MotorThal→M1"); // 丘脑→运动皮层
-    engine.add_projection("VTA", "BG", 1, "VTA→BG");           // DA调制(走SpikeBus)
+    engine.add_projection("VTA", "BG", vta_delay, "VTA→BG");           // DA调制(走SpikeBus)
 
     // Wire DA source: BG reads VTA spikes to auto-update DA level
     auto* bg_ptr = dynamic_cast<BasalGanglia*>(engine.find_region("BG"));
@@ -344,6 +347,196 @@ void test_thalamic_gating() {
     PASS("丘脑 TRN 门控");
 }
 
+// =============================================================================
+// 测试6: 保守同步窗口 (最小延迟 D=2 → 每 2 步交换一次脉冲)
+// =============================================================================
+void test_sync_window() {
+    printf("\n--- 测试6: 保守同步窗口 ---\n");
+
+    auto lockstep = build_minimal_brain(2);
+    auto windowed = build_minimal_brain(2);
+    CHECK(windowed.min_projection_delay() == 2, "最小投射延迟应为2");
+
+    // 无调质源 → 慢时钟不影响区域状态, 两种模式应逐位一致
+    size_t mismatches = 0, total = 0;
+    for (int chunk = 0; chunk < 100; ++chunk) {
+        if (chunk < 40) {
+            std::vector<float> visual(50, 35.0f);
+            lockstep.find_region("LGN")->inject_external(visual);
+            windowed.find_region("LGN")->inject_external(visual);
+        }
+        lockstep.run(2);
+        windowed.run_windowed(2);
+
+        for (size_t r = 0; r < lockstep.num_regions(); ++r) {
+            const auto& a = lockstep.region(r).fired();
+            const auto& b = windowed.region(r).fired();
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (a[i] != b[i]) mismatches++;
+                total += a[i];
+            }
+        }
+    }
+    auto* bg_a = dynamic_cast<BasalGanglia*>(lockstep.find_region("BG"));
+    auto* bg_b = dynamic_cast<BasalGanglia*>(windowed.find_region("BG"));
+    printf("    200步: 采样发放=%zu  不一致=%zu  BG皮层输入=%zu/%zu\n",
+           total, mismatches, bg_a->total_cortical_inputs(), bg_b->total_cortical_inputs());
+
+    CHECK(total > 0, "窗口末应采样到发放");
+    CHECK(windowed.current_time() == lockstep.current_time(), "时间步应一致");
+    CHECK(bg_a->total_cortical_inputs() == bg_b->total_cortical_inputs(),
+          "BG 累计收到的皮层脉冲应一致");
+    CHECK(mismatches == 0, "窗口模式发放应与逐步模式一致");
+
+    PASS("保守同步窗口");
+}
+
+// =============================================================================
+// 测试7: 常驻线程池 = OpenMP 逐步
+// =============================================================================
+void test_worker_pool() {
+    printf("\n--- 测试7: 常驻线程池 ---\n");
+
+    // 加一个大联合皮层 (群体 >= 256, 走池内神经元循环)
+    auto add_assoc = [](SimulationEngine& e) {
+        ColumnConfig c;
+        c.n_l4_stellate = 100; c.n_l23_pyramidal = 400;
+        c.n_l5_pyramidal = 100; c.n_l6_pyramidal = 80;
+        c.n_pv_basket = 30; c.n_sst_martinotti = 20; c.n_vip = 10;
+        e.add_region(std::make_unique<CorticalRegion>("Assoc", c));
+        e.add_projection("V1", "Assoc", 2);
+    };
+    auto ref = build_minimal_brain();
+    auto pooled = build_minimal_brain();
+    add_assoc(ref);
+    add_assoc(pooled);
+    pooled.use_worker_pool(4, 50);
+
+    size_t assoc = ref.num_regions() - 1;
+    CHECK(pooled.worker_threads() == 4, "线程池应有4个线程");
+    CHECK(pooled.region_thread(assoc) == SimulationEngine::WIDE_REGION,
+          "大区域应单独步进 (池内神经元循环)");
+
+    size_t mismatches = 0, total = 0;
+    for (int t = 0; t < 300; ++t) {
+        if (t < 100) {
+            std::vector<float> visual(50, 35.0f);
+            ref.find_region("LGN")->inject_external(visual);
+            pooled.find_region("LGN")->inject_external(visual);
+        }
+        ref.step();
+        pooled.step();
+        for (size_t r = 0; r < ref.num_regions(); ++r) {
+            const auto& a = ref.region(r).fired();
+            const auto& b = pooled.region(r).fired();
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (a[i] != b[i]) mismatches++;
+                total += a[i];
+            }
+        }
+    }
+
+    size_t measured = 0;
+    for (size_t r = 0; r < pooled.num_regions(); ++r) {
+        if (pooled.region_cost_ns(r) > 0.0) measured++;
+    }
+    printf("    300步: 发放=%zu  不一致=%zu  已测代价区域=%zu/%zu  Assoc=%.0f ns/步\n",
+           total, mismatches, measured, pooled.num_regions(), pooled.region_cost_ns(assoc));
+
+    CHECK(total > 0, "应有发放");
+    CHECK(measured == pooled.num_regions(), "所有区域应有在线代价");
+    CHECK(mismatches == 0, "线程池发放应与 OpenMP 逐步一致");
+
+    pooled.use_worker_pool(0);
+    CHECK(pooled.worker_threads() == 0, "关闭后回到 OpenMP");
+    pooled.run(10);
+
+    PASS("常驻线程池");
+}
+
+// =============================================================================
+// 测试8: 热路径剖析
+// =============================================================================
+void test_profiler() {
+    printf("\n--- 测试8: 热路径剖析 ---\n");
+#ifndef WUYUN_PROFILE
+    printf("    WUYUN_PROFILE 未编译, 跳过\n");
+    PASS("热路径剖析 (未编译)");
+#else
+    auto engine = build_minimal_brain();
+    Profiler& prof = engine.profiler();
+    CHECK(prof.num_regions() == engine.num_regions(), "剖析器区域表应与引擎一致");
+
+    engine.run(20);   // 未启用: 不记录
+    CHECK(prof.phases().empty(), "未启用时不应有阶段记录");
+
+    prof.enable();
+    const int n_steps = 200;
+    for (int t = 0; t < n_steps; ++t) {
+        if (t < 100) {
+            std::vector<float> visual(50, 35.0f);
+            engine.find_region("LGN")->inject_external(visual);
+        }
+        engine.step();
+    }
+    prof.disable();
+
+    double step_ns = 0.0, parts_ns = 0.0;
+    bool calls_ok = true;
+    for (const auto& p : prof.phases()) {
+        if (p.name == "engine.step") step_ns = p.total_ns;
+        if (p.name == "engine.deliver" || p.name == "engine.regions" || p.name == "engine.clocks" ||
+            p.name == "engine.submit"  || p.name == "engine.bus_advance") {
+            parts_ns += p.total_ns;
+            if (p.calls != static_cast<uint64_t>(n_steps)) calls_ok = false;
+        }
+    }
+    const auto& lgn = prof.region(0);
+    const auto& v1  = prof.region(1);
+    printf("%s", prof.summary().c_str());
+    printf("    step=%.1f us  阶段之和=%.1f us\n", step_ns * 1e-3, parts_ns * 1e-3);
+
+    std::string trace = prof.chrome_trace();
+    size_t n_events = 0;
+    for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos;
+         pos = trace.find("\"ph\":\"X\"", pos + 1)) ++n_events;
+    printf("    trace 事件 %zu, %zu 字节\n", n_events, trace.size());
+
+    CHECK(calls_ok, "每个引擎阶段每步记录一次");
+    CHECK(step_ns > 0.0 && parts_ns <= step_ns, "阶段耗时之和不超过整步");
+    CHECK(lgn.steps == static_cast<uint64_t>(n_steps) && lgn.spikes_out > 0, "LGN 步数/发放计数");
+    CHECK(v1.spikes_in > 0 && v1.synaptic_events > 0, "V1 收到脉冲并产生突触事件");
+    CHECK(trace.find("engine.deliver") != std::string::npos &&
+          trace.find("\"V1\"") != std::string::npos, "trace 含阶段与区域事件");
+    CHECK(n_events == static_cast<size_t>(n_steps) * (6 + engine.num_regions()) + n_steps / 10,
+          "trace 事件数 = 每步 6 阶段 + 每区域 1 次 + 调质时钟");
+
+    PASS("热路径剖析");
+#endif
+}
+
+// =============================================================================
+// 测试9: Chrome trace 名称转义
+// =============================================================================
+void test_trace_escape() {
+    printf("\n--- 测试9: Chrome trace 名称转义 ---\n");
+    // Profiler 类不依赖编译开关: 直接登记区域并手动记录
+    Profiler profiler;
+    profiler.set_regions({"say \"hi\"", "C:\\dir", "tab\there"});
+    profiler.enable();
+    uint64_t t0 = prof::ticks();
+    for (size_t i = 0; i < profiler.num_regions(); ++i) profiler.record_region(i, t0, t0 + 100);
+
+    std::string trace = profiler.chrome_trace();
+    printf("%s", trace.c_str());
+    CHECK(trace.find("\"name\":\"say \\\"hi\\\"\"") != std::string::npos, "引号应转义");
+    CHECK(trace.find("\"name\":\"C:\\\\dir\"") != std::string::npos, "反斜杠应转义");
+    CHECK(trace.find("\"name\":\"tab\\there\"") != std::string::npos, "控制字符应转义");
+    CHECK(trace.find('\t') == std::string::npos, "输出中不应有原始控制字符");
+
+    PASS("Chrome trace 名称转义");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -361,6 +554,10 @@ int main() {
     test_signal_propagation();
     test_da_modulation();
     test_thalamic_gating();
+    test_sync_window();
+    test_worker_pool();
+    test_profiler();
+    test_trace_escape();
 
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
@@ -389,6 +389,57 @@ void test_full_12_region_system() {
     PASS("12区域全系统");
 }
 
+// =============================================================================
+// 测试6: 多速率时钟 (慢时钟按周期触发, dt 按周期放大)
+// =============================================================================
+void test_multirate_clocks() {
+    printf("\n--- 测试6: 多速率时钟 ---\n");
+
+    SimulationEngine engine(10);
+    auto vta_cfg = VTAConfig{};
+    vta_cfg.n_da_neurons = 20;
+    engine.add_region(std::make_unique<VTA_DA>(vta_cfg));
+    engine.register_neuromod_source("VTA", SimulationEngine::NeuromodType::DA);
+
+    CHECK(engine.clock_period(SimulationEngine::CLOCK_OSCILLATION) == 10, "振荡时钟默认 10 步");
+    CHECK(engine.clock_period(SimulationEngine::CLOCK_NEUROMOD) == 10, "调质时钟默认 10 步");
+
+    int ticks = 0;
+    float last_dt = 0.0f;
+    engine.register_clock("probe", 25, [&](int32_t, float dt) { ticks++; last_dt = dt; });
+    engine.run(100);
+    printf("    probe: %d ticks, dt=%.1f\n", ticks, last_dt);
+    CHECK(ticks == 4, "周期25的时钟在100步内应触发4次");
+    CHECK(std::abs(last_dt - 25.0f) < 1e-4f, "慢时钟 dt 应为 25ms");
+
+    // 振荡相位: 100 步 = 10 个振荡时钟周期 = 100ms → theta 6Hz 走 0.6 周
+    float theta = engine.region(0).oscillation().phase(OscBand::THETA);
+    printf("    theta phase after 100ms: %.3f rad\n", theta);
+    CHECK(std::abs(theta - 0.6f * 6.2831853f) < 0.01f, "振荡时钟累计时长应等于仿真时长");
+
+    // 调质时钟改为逐步后仍然正确广播
+    CHECK(engine.set_clock_period(SimulationEngine::CLOCK_NEUROMOD, 1), "可修改调质时钟周期");
+    CHECK(!engine.set_clock_period("missing", 5), "未知时钟应返回 false");
+    engine.run(3);
+    auto* vta = dynamic_cast<VTA_DA*>(engine.find_region("VTA"));
+    CHECK(std::abs(engine.global_neuromod().da - vta->da_output()) < 1e-6f,
+          "逐步调质时钟: 全局 DA 应等于 VTA 输出");
+
+    // 调质时钟只推进原本自行衰减的区域: VTA 等调质核团的 phasic 不衰减
+    CHECK(!vta->steps_neuromod(), "VTA 不推进自身调质");
+    vta->neuromod().inject_phasic(0.5f, 0.0f, 0.0f, 0.0f);
+    engine.run(20);
+    CHECK(vta->neuromod().phasic().da == 0.5f, "VTA phasic DA 不被调质时钟衰减");
+
+    BasalGanglia bg(BasalGangliaConfig{});
+    CHECK(bg.steps_neuromod(), "基底节推进自身调质");
+    bg.neuromod().inject_phasic(0.5f, 0.0f, 0.0f, 0.0f);
+    bg.step(0);
+    CHECK(bg.neuromod().phasic().da < 0.5f, "独立运行的基底节 phasic DA 逐步衰减");
+
+    PASS("多速率时钟");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -406,6 +457,7 @@ int main() {
     test_ne_gain_modulation();
     test_neuromod_drive();
     test_full_12_region_system();
+    test_multirate_clocks();
 
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
@@ -0,0 +1,211 @@
+/**
+ * 悟韵 (WuYun) 多进程分区仿真测试
+ *
+ * 测试项:
+ *   1. ShmSpikeRing 无锁环: 满/空/回绕
+ *   2. 分区器: 负载均衡 + 调质源复制
+ *   3. 2/3 进程分区运行 vs 单进程: 每区域脉冲事件逐个一致
+ */
+
+#include "engine/partition.h"
+#include "region/cortical_region.h"
+#include "region/subcortical/thalamic_relay.h"
+#include "region/subcortical/basal_ganglia.h"
+#include "region/neuromod/vta_da.h"
+#include "region/neuromod/lc_ne.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+// LGN → V1 ⇄ dlPFC → BG → MotorThal → M1, VTA→BG, LC (调质源), 持续视觉驱动
+static void build_test_brain(SimulationEngine& engine) {
+    auto lgn_cfg = ThalamicConfig{};
+    lgn_cfg.name = "LGN"; lgn_cfg.n_relay = 50; lgn_cfg.n_trn = 15;
+    engine.add_region(std::make_unique<ThalamicRelay>(lgn_cfg));
+
+    auto ctx = [&](const std::string& name, size_t scale) {
+        ColumnConfig c;
+        c.n_l4_stellate = 15 * scale; c.n_l23_pyramidal = 30 * scale;
+        c.n_l5_pyramidal = 15 * scale; c.n_l6_pyramidal = 10 * scale;
+        c.n_pv_basket = 5 * scale; c.n_sst_martinotti = 3 * scale; c.n_vip = 2 * scale;
+        engine.add_region(std::make_unique<CorticalRegion>(name, c));
+    };
+    ctx("V1", 3);
+    ctx("dlPFC", 2);
+
+    auto bg_cfg = BasalGangliaConfig{};
+    bg_cfg.name = "BG";
+    bg_cfg.n_d1_msn = 40; bg_cfg.n_d2_msn = 40;
+    bg_cfg.n_gpi = 12; bg_cfg.n_gpe = 12; bg_cfg.n_stn = 8;
+    engine.add_region(std::make_unique<BasalGanglia>(bg_cfg));
+
+    auto mthal_cfg = ThalamicConfig{};
+    mthal_cfg.name = "MotorThal"; mthal_cfg.n_relay = 30; mthal_cfg.n_trn = 10;
+    engine.add_region(std::make_unique<ThalamicRelay>(mthal_cfg));
+    ctx("M1", 2);
+
+    auto vta_cfg = VTAConfig{};
+    vta_cfg.n_da_neurons = 20;
+    engine.add_region(std::make_unique<VTA_DA>(vta_cfg));
+    auto lc_cfg = LCConfig{};
+    lc_cfg.n_ne_neurons = 15;
+    engine.add_region(std::make_unique<LC_NE>(lc_cfg));
+
+    engine.add_projection("LGN", "V1", 2);
+    engine.add_projection("V1", "dlPFC", 3);
+    engine.add_projection("dlPFC", "V1", 3);
+    engine.add_projection("dlPFC", "BG", 2);
+    engine.add_projection("BG", "MotorThal", 2);
+    engine.add_projection("MotorThal", "M1", 2);
+    engine.add_projection("VTA", "BG", 2);
+    engine.add_projection("V1", "LC", 2);
+
+    auto* bg = dynamic_cast<BasalGanglia*>(engine.find_region("BG"));
+    bg->set_da_source_region(engine.find_region("VTA")->region_id());
+
+    using NM = SimulationEngine::NeuromodType;
+    engine.register_neuromod_source("VTA", NM::DA);
+    engine.register_neuromod_source("LC",  NM::NE);
+
+    // 持续视觉刺激: 作为慢时钟注入 (窗口边界处, 各分区一致)
+    auto* lgn = engine.find_region("LGN");
+    engine.register_clock("stimulus", 2, [lgn](int32_t t, float) {
+        if (t < 300) lgn->inject_external(std::vector<float>(50, 35.0f));
+    });
+}
+
+// =============================================================================
+// 测试1: ShmSpikeRing
+// =============================================================================
+void test_ring() {
+    printf("\n--- 测试1: ShmSpikeRing 无锁环 ---\n");
+
+    auto shm = SharedMemory::anonymous(ShmSpikeRing::bytes_for(8));
+    CHECK(shm.valid(), "共享内存段应创建成功");
+    ShmSpikeRing ring(shm.data(), 8, true);
+
+    ShmSpike rec{};
+    CHECK(!ring.try_pop(rec), "空环 pop 应失败");
+
+    int pushed = 0;
+    for (int i = 0; i < 10; ++i) {
+        rec.evt.neuron_id = static_cast<uint32_t>(i);
+        if (ring.try_push(rec)) pushed++;
+    }
+    CHECK(pushed == 8, "容量 8 的环应只接受 8 条");
+
+    // 回绕: 弹出 5 条再压入 5 条, 顺序保持
+    for (int i = 0; i < 5; ++i) ring.try_pop(rec);
+    CHECK(rec.evt.neuron_id == 4, "FIFO 顺序");
+    for (int i = 10; i < 15; ++i) {
+        rec.evt.neuron_id = static_cast<uint32_t>(i);
+        CHECK(ring.try_push(rec), "回绕后应可写入");
+    }
+    uint32_t expect = 5;
+    bool in_order = true;
+    while (ring.try_pop(rec)) {
+        if (rec.evt.neuron_id != expect) in_order = false;
+        expect = (expect == 7) ? 10 : expect + 1;
+    }
+    CHECK(in_order && expect == 15, "回绕后 FIFO 顺序应保持");
+
+    PASS("ShmSpikeRing");
+}
+
+// =============================================================================
+// 测试2: 分区器
+// =============================================================================
+void test_partitioner() {
+    printf("\n--- 测试2: 分区器 ---\n");
+
+    SimulationEngine engine;
+    build_test_brain(engine);
+    auto plan = partition_regions(engine, 2);
+
+    size_t replicated = 0;
+    for (int o : plan.owner) if (o == PartitionPlan::REPLICATED) replicated++;
+    printf("    2 分区: load=%.0f/%.0f  imbalance=%.2f  cut=%zu  复制=%zu\n",
+           plan.load[0], plan.load[1], plan.imbalance(), plan.cut_projections, replicated);
+
+    CHECK(replicated == 2, "VTA/LC 调质源应在每个分区复制");
+    CHECK(plan.load[0] > 0 && plan.load[1] > 0, "两个分区都应有负载");
+    CHECK(plan.imbalance() < 1.5f, "负载不均衡应 < 1.5");
+
+    auto single = partition_regions(engine, 1);
+    CHECK(single.cut_projections == 0, "单分区无割边");
+
+    PASS("分区器");
+}
+
+// =============================================================================
+// 测试3: 多进程分区运行 = 单进程
+// =============================================================================
+void test_partitioned_run() {
+    printf("\n--- 测试3: 多进程分区运行 ---\n");
+
+    SimulationEngine probe;
+    build_test_brain(probe);
+
+    auto ref = run_partitioned(build_test_brain, partition_regions(probe, 1), 400);
+    CHECK(ref.ok, "单进程运行应成功");
+
+    for (int np : {2, 3}) {
+        auto plan = partition_regions(probe, np);
+        auto res = run_partitioned(build_test_brain, plan, 400, 1.0f, 256);
+        CHECK(res.ok, "分区运行应成功");
+
+        uint64_t total = 0;
+        size_t mismatch = 0;
+        for (size_t r = 0; r < ref.region_events.size(); ++r) {
+            total += ref.region_events[r];
+            if (ref.region_events[r] != res.region_events[r]) mismatch++;
+        }
+        printf("    %d 进程: 事件=%llu  交换=%llu  不一致区域=%zu\n",
+               np, static_cast<unsigned long long>(total),
+               static_cast<unsigned long long>(res.exchanged), mismatch);
+        CHECK(total > 0, "应有脉冲事件");
+        CHECK(res.exchanged > 0, "应有跨分区脉冲");
+        CHECK(mismatch == 0, "分区运行每区域事件数应与单进程一致");
+    }
+
+    PASS("多进程分区运行");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+    printf("  分区运行需要 POSIX fork, 跳过\n");
+    return 0;
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 多进程分区仿真测试\n");
+    printf("============================================\n");
+
+    test_ring();
+    test_partitioner();
+    test_partitioned_run();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
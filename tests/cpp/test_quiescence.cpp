@@ -0,0 +1,304 @@
+/**
+ * 悟韵 (WuYun) 静息区域跳过测试
+ *
+ * 测试项:
+ *   1. NeuronPopulation::relax 解析补齐 = 逐步无输入积分 (含恒定电流)
+ *   2. 引擎静息跳过 vs 逐步: 各区域发放数在容差内, 静息区域确有跳过
+ *      (V1 处于 NREM 睡眠, 下行态抑制按恒定电流解析处理)
+ *   3. 执行掩码: 启用区域与只含这些区域的脑逐位一致, 冻结区域状态不变
+ *   4. 执行掩码 + 调质广播: 冻结的源不被采集, 冻结的区域不接收广播
+ */
+
+#include "engine/simulation_engine.h"
+#include "region/cortical_region.h"
+#include "region/subcortical/thalamic_relay.h"
+#include "region/subcortical/periaqueductal_gray.h"
+#include "region/limbic/amygdala.h"
+#include "region/neuromod/vta_da.h"
+#include "core/population.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+// =============================================================================
+// 测试1: 阈下弛豫解析解
+// =============================================================================
+void test_relax() {
+    printf("\n--- 测试1: 阈下弛豫解析补齐 ---\n");
+
+    for (float i_const : {0.0f, -8.0f}) {
+        // 双区室 L2/3 锥体: 先用阈下电流推离静息
+        NeuronPopulation stepped(20, L23_PYRAMIDAL_PARAMS());
+        for (int t = 0; t < 30; ++t) {
+            for (size_t i = 0; i < stepped.size(); ++i) {
+                stepped.inject_basal(i, 0.2f * static_cast<float>(i));
+                stepped.inject_apical(i, 0.3f * static_cast<float>(i));
+            }
+            stepped.step(t);
+        }
+        NeuronPopulation relaxed = stepped;
+        CHECK(stepped.quiescent(i_const), "撤去输入后应判定为静息");
+
+        const int32_t n = 300;
+        for (int t = 0; t < n; ++t) {
+            if (i_const != 0.0f) {
+                for (size_t i = 0; i < stepped.size(); ++i) stepped.inject_basal(i, i_const);
+            }
+            stepped.step(30 + t);
+        }
+        relaxed.relax(n, 1.0f, i_const);
+
+        float max_dv = 0.0f, max_dw = 0.0f, max_da = 0.0f;
+        for (size_t i = 0; i < stepped.size(); ++i) {
+            max_dv = std::max(max_dv, std::abs(stepped.v_soma()[i]   - relaxed.v_soma()[i]));
+            max_dw = std::max(max_dw, std::abs(stepped.w_adapt()[i]  - relaxed.w_adapt()[i]));
+            max_da = std::max(max_da, std::abs(stepped.v_apical()[i] - relaxed.v_apical()[i]));
+        }
+        printf("    I=%.0f  %d 步: |ΔV_s|=%.2e  |Δw|=%.2e  |ΔV_a|=%.2e\n",
+               i_const, n, max_dv, max_dw, max_da);
+        CHECK(max_dv < 1e-3f && max_dw < 1e-3f && max_da < 1e-3f,
+              "解析补齐应与逐步积分一致");
+    }
+
+    PASS("阈下弛豫解析补齐");
+}
+
+// =============================================================================
+// 测试2: 引擎静息跳过
+// =============================================================================
+
+// LGN → V1 (NREM 睡眠) → Amygdala → PAG, 间歇视觉刺激
+static void build_brain(SimulationEngine& engine) {
+    ThalamicConfig lgn;
+    lgn.name = "LGN"; lgn.n_relay = 40; lgn.n_trn = 10;
+    engine.add_region(std::make_unique<ThalamicRelay>(lgn));
+
+    ColumnConfig c;
+    c.n_l4_stellate = 30; c.n_l23_pyramidal = 60; c.n_l5_pyramidal = 30; c.n_l6_pyramidal = 20;
+    c.n_pv_basket = 10; c.n_sst_martinotti = 6; c.n_vip = 4;
+    auto v1 = std::make_unique<CorticalRegion>("V1", c);
+    v1->set_sleep_mode(true);
+    engine.add_region(std::move(v1));
+
+    engine.add_region(std::make_unique<Amygdala>(AmygdalaConfig{}));
+    engine.add_region(std::make_unique<PeriaqueductalGray>(PAGConfig{}));
+
+    engine.add_projection("LGN", "V1", 2);
+    engine.add_projection("LGN", "Amygdala", 2);
+    engine.add_projection("Amygdala", "PAG", 1);
+}
+
+void test_engine_skipping() {
+    printf("\n--- 测试2: 引擎静息跳过 ---\n");
+
+    SimulationEngine ref, fast;
+    build_brain(ref);
+    build_brain(fast);
+    fast.set_quiescence_skipping(true);
+
+    const size_t n_regions = ref.num_regions();
+    std::vector<size_t> spikes_ref(n_regions, 0), spikes_fast(n_regions, 0);
+    for (int t = 0; t < 4000; ++t) {
+        if (t % 1000 < 30) {
+            std::vector<float> visual(40, 40.0f);
+            ref.find_region("LGN")->inject_external(visual);
+            fast.find_region("LGN")->inject_external(visual);
+        }
+        if (t % 1000 >= 500 && t % 1000 < 520) {
+            // 直接注入 La: 唤醒来自外部注入而非脉冲到达
+            std::vector<float> threat(50, 40.0f);
+            ref.find_region("Amygdala")->inject_external(threat);
+            fast.find_region("Amygdala")->inject_external(threat);
+        }
+        ref.step();
+        fast.step();
+        for (size_t r = 0; r < n_regions; ++r) {
+            for (auto f : ref.region(r).fired())  spikes_ref[r] += f;
+            for (auto f : fast.region(r).fired()) spikes_fast[r] += f;
+        }
+    }
+    fast.set_quiescence_skipping(false);
+
+    bool close = true;
+    for (size_t r = 0; r < n_regions; ++r) {
+        const auto& reg = fast.region(r);
+        double diff = std::abs(static_cast<double>(spikes_ref[r]) - static_cast<double>(spikes_fast[r]));
+        if (diff > 0.05 * static_cast<double>(spikes_ref[r]) + 5.0) close = false;
+        printf("    %-9s 发放 %6zu / %6zu   跳过 %5llu 步\n", reg.name().c_str(),
+               spikes_ref[r], spikes_fast[r],
+               static_cast<unsigned long long>(reg.skipped_total()));
+    }
+
+    auto* pag_ref  = dynamic_cast<PeriaqueductalGray*>(ref.find_region("PAG"));
+    auto* pag_fast = dynamic_cast<PeriaqueductalGray*>(fast.find_region("PAG"));
+    float max_dv = 0.0f;
+    for (size_t i = 0; i < pag_ref->dlpag().size(); ++i) {
+        max_dv = std::max(max_dv, std::abs(pag_ref->dlpag().v_soma()[i] - pag_fast->dlpag().v_soma()[i]));
+    }
+    printf("    PAG 补齐后 |ΔV|=%.3f mV\n", max_dv);
+
+    CHECK(spikes_ref[0] > 0 && spikes_ref[1] > 0 && spikes_ref[2] > 0, "LGN/V1/Amygdala 应有发放");
+    CHECK(fast.find_region("V1")->skipped_total() > 0, "睡眠 V1 应有跳过步");
+    CHECK(fast.find_region("Amygdala")->skipped_total() > 0, "Amygdala 应有跳过步");
+    CHECK(fast.find_region("PAG")->skipped_total() > 0, "PAG 应有跳过步");
+    CHECK(fast.find_region("LGN")->skipped_total() == 0, "未实现静息判定的区域不跳过");
+    CHECK(close, "各区域发放数应在容差内一致");
+    CHECK(max_dv < 0.5f, "补齐后膜电位应接近逐步结果");
+
+    PASS("引擎静息跳过");
+}
+
+// =============================================================================
+// 测试3: 执行掩码
+// =============================================================================
+
+void test_execution_mask() {
+    printf("\n--- 测试3: 执行掩码 ---\n");
+
+    // 参照: 只有 LGN → V1
+    SimulationEngine ref, masked;
+    {
+        ThalamicConfig lgn;
+        lgn.name = "LGN"; lgn.n_relay = 40; lgn.n_trn = 10;
+        ref.add_region(std::make_unique<ThalamicRelay>(lgn));
+        ColumnConfig c;
+        c.n_l4_stellate = 30; c.n_l23_pyramidal = 60; c.n_l5_pyramidal = 30; c.n_l6_pyramidal = 20;
+        c.n_pv_basket = 10; c.n_sst_martinotti = 6; c.n_vip = 4;
+        auto v1 = std::make_unique<CorticalRegion>("V1", c);
+        v1->set_sleep_mode(true);
+        ref.add_region(std::move(v1));
+        ref.add_projection("LGN", "V1", 2);
+    }
+    build_brain(masked);
+    masked.define_mask("visual", {"LGN", "V1"});
+    CHECK(!masked.use_mask("undefined"), "未定义掩码应返回 false");
+    CHECK(masked.use_mask("visual") && masked.active_mask() == "visual", "切换到 visual 掩码");
+
+    auto* amyg = dynamic_cast<Amygdala*>(masked.find_region("Amygdala"));
+    auto* pag  = dynamic_cast<PeriaqueductalGray*>(masked.find_region("PAG"));
+    // 冻结前先让杏仁核带电: 注入不会被处理 (区域不 step)
+    std::vector<float> threat(50, 40.0f);
+    amyg->inject_external(threat);
+    std::vector<float> pag_v0 = pag->dlpag().v_soma();
+
+    size_t v1_ref = 0, v1_masked = 0, frozen_spikes = 0;
+    bool identical = true;
+    for (int t = 0; t < 600; ++t) {
+        if (t % 200 < 30) {
+            std::vector<float> visual(40, 40.0f);
+            ref.find_region("LGN")->inject_external(visual);
+            masked.find_region("LGN")->inject_external(visual);
+        }
+        ref.step();
+        masked.step();
+        for (size_t r = 0; r < 2; ++r) {
+            if (ref.region(r).fired() != masked.region(r).fired()) identical = false;
+        }
+        for (auto f : ref.find_region("V1")->fired())    v1_ref += f;
+        for (auto f : masked.find_region("V1")->fired()) v1_masked += f;
+        for (auto f : amyg->fired()) frozen_spikes += f;
+    }
+    printf("    V1 发放 参照 %zu / 掩码 %zu, 冻结区发放 %zu\n", v1_ref, v1_masked, frozen_spikes);
+
+    CHECK(v1_ref > 0, "V1 应有发放");
+    CHECK(identical, "启用区域应与只含这些区域的脑逐位一致");
+    CHECK(frozen_spikes == 0, "冻结的 Amygdala 不应发放");
+    CHECK(pag->dlpag().v_soma() == pag_v0, "冻结的 PAG 膜电位应保持不变");
+
+    // 恢复全脑: 冻结区域继续推进
+    masked.clear_mask();
+    CHECK(masked.active_mask().empty(), "清除掩码");
+    size_t thawed = 0;
+    for (int t = 0; t < 50; ++t) {
+        if (t < 20) amyg->inject_external(threat);
+        masked.step();
+        for (auto f : amyg->fired()) thawed += f;
+    }
+    printf("    解冻后 Amygdala 发放 %zu\n", thawed);
+    CHECK(thawed > 0, "解冻后 Amygdala 应恢复计算");
+
+    PASS("执行掩码");
+}
+
+// =============================================================================
+// 测试4: 执行掩码下的调质广播
+// =============================================================================
+
+void test_mask_neuromod() {
+    printf("\n--- 测试4: 执行掩码下的调质广播 ---\n");
+
+    // 两个 DA 源 (tonic 不同), 后注册者在全脑时覆盖前者
+    SimulationEngine engine;
+    VTAConfig va; va.name = "VTA_a"; va.tonic_rate = 0.3f;
+    VTAConfig vb; vb.name = "VTA_b"; vb.tonic_rate = 0.8f;
+    engine.add_region(std::make_unique<VTA_DA>(va));
+    engine.add_region(std::make_unique<VTA_DA>(vb));
+    ThalamicConfig a; a.name = "A"; a.n_relay = 20; a.n_trn = 5;
+    ThalamicConfig b; b.name = "B"; b.n_relay = 20; b.n_trn = 5;
+    engine.add_region(std::make_unique<ThalamicRelay>(a));
+    engine.add_region(std::make_unique<ThalamicRelay>(b));
+    engine.register_neuromod_source("VTA_a", SimulationEngine::NeuromodType::DA);
+    engine.register_neuromod_source("VTA_b", SimulationEngine::NeuromodType::DA);
+
+    engine.run(10);
+    float da_full = engine.global_neuromod().da;
+    float b_da0   = engine.find_region("B")->neuromod().tonic().da;
+    printf("    全脑: 全局 DA %.3f, B tonic DA %.3f\n", da_full, b_da0);
+    CHECK(std::fabs(da_full - 0.8f) < 1e-3f, "全脑时后注册的 VTA_b 决定全局 DA");
+
+    // 冻结 VTA_b 与 B
+    engine.define_mask("a_only", {"VTA_a", "A"});
+    engine.use_mask("a_only");
+    engine.run(10);
+    float da_masked = engine.global_neuromod().da;
+    printf("    掩码: 全局 DA %.3f, A %.3f, B %.3f\n", da_masked,
+           engine.find_region("A")->neuromod().tonic().da,
+           engine.find_region("B")->neuromod().tonic().da);
+    CHECK(std::fabs(da_masked - 0.3f) < 1e-3f, "冻结的 VTA_b 不应参与采集");
+    CHECK(std::fabs(engine.find_region("A")->neuromod().tonic().da - 0.3f) < 1e-3f,
+          "启用区域接收广播");
+    CHECK(engine.find_region("B")->neuromod().tonic().da == b_da0,
+          "冻结区域的调质状态应保持不变");
+
+    PASS("执行掩码下的调质广播");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 静息区域跳过测试\n");
+    printf("============================================\n");
+
+    test_relax();
+    test_engine_skipping();
+    test_execution_mask();
+    test_mask_neuromod();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
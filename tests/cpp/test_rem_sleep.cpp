@@ -9,6 +9,7 @@
  *   5. Hippocampus REM theta (6Hz振荡 + 创造性重组)
  *   6. 完整睡眠周期: NREM(SWR) → REM(theta) → NREM交替
  *   7. 全脑NREM→REM: 皮层从慢波切换到去同步化
+ *   8. 睡眠随机流按实例独立: 先后构造 / 并发线程运行逐位相同
  */
 
 #include "engine/sleep_cycle.h"
@@ -18,7 +19,9 @@
 #include "engine/simulation_engine.h"
 
 #include <cstdio>
+#include <algorithm>
 #include <cmath>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -413,6 +416,80 @@ static void test_full_brain_nrem_rem() {
 // =============================================================================
 // Main
 // =============================================================================
+// =============================================================================
+// Test 8: 睡眠随机流按实例独立 (REM 噪声 / PGO / SWR / theta)
+// =============================================================================
+static double sum_v(const NeuronPopulation& pop) {
+    double s = 0.0;
+    for (float v : pop.v_soma()) s += v;
+    return s;
+}
+
+// 一个实例完整运行的轨迹: 皮层 REM + PGO, 海马 SWR → REM theta, PGO 触发序列
+static std::vector<double> sleep_noise_trace(const std::string& ctx_name) {
+    std::vector<double> trace;
+
+    ColumnConfig cc;
+    cc.n_l4_stellate = 30; cc.n_l23_pyramidal = 60;
+    cc.n_l5_pyramidal = 30; cc.n_l6_pyramidal = 20;
+    cc.n_pv_basket = 8; cc.n_sst_martinotti = 5; cc.n_vip = 3;
+    CorticalRegion ctx(ctx_name, cc);
+    ctx.set_rem_mode(true);
+    for (int t = 0; t < 60; ++t) {
+        if (t % 3 == 0) ctx.inject_pgo_wave(25.0f);
+        ctx.step(t);
+        trace.push_back(sum_v(ctx.column().l23()));
+    }
+
+    HippocampusConfig hc;
+    Hippocampus hipp(hc);
+    hipp.enable_sleep_replay();
+    for (int t = 0; t < 60; ++t) {
+        hipp.step(t);
+        trace.push_back(sum_v(hipp.ca3()));
+    }
+    hipp.enable_rem_theta();
+    for (int t = 60; t < 120; ++t) {
+        hipp.step(t);
+        trace.push_back(sum_v(hipp.ca1()));
+    }
+
+    SleepCycleConfig sc;
+    sc.nrem_duration = 10; sc.min_nrem_duration = 5;
+    sc.rem_duration = 300; sc.rem_pgo_prob = 0.05f;
+    SleepCycleManager mgr(sc);
+    mgr.enter_sleep();
+    for (int i = 0; i < 300; ++i) {
+        mgr.step();
+        trace.push_back(mgr.pgo_active() ? 1.0 : 0.0);
+    }
+    return trace;
+}
+
+static void test_instance_rng_streams() {
+    printf("\n--- 测试8: 睡眠随机流按实例独立 ---\n");
+    printf("    原理: 每个区域/管理器持有自己的随机流 (配置种子), 无函数静态共享状态\n");
+
+    auto ref = sleep_noise_trace("V1");
+    auto again = sleep_noise_trace("V1");
+    TEST_ASSERT(again == ref, "先后构造的同配置实例轨迹应相同");
+
+    std::vector<double> a, b;
+    std::thread ta([&] { a = sleep_noise_trace("V1"); });
+    std::thread tb([&] { b = sleep_noise_trace("V1"); });
+    ta.join();
+    tb.join();
+    TEST_ASSERT(a == ref && b == ref, "并发线程运行的实例轨迹应与单独运行相同");
+
+    auto other = sleep_noise_trace("dlPFC");
+    TEST_ASSERT(!std::equal(other.begin(), other.begin() + 60, ref.begin()),
+                "同配置不同名皮层区域的 REM 噪声流应不同");
+
+    printf("    %zu 个采样点, 顺序/并发逐位一致\n", ref.size());
+    printf("  [PASS] 睡眠随机流按实例独立\n");
+    g_pass++;
+}
+
 int main() {
 #ifdef _WIN32
     SetConsoleOutputCP(65001);
@@ -429,6 +506,7 @@ int main() {
     test_hippocampal_rem_theta();
     test_full_sleep_cycle();
     test_full_brain_nrem_rem();
+    test_instance_rng_streams();
 
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
@@ -9,6 +9,7 @@
  *   5. 听觉 onset 检测: 新音比持续音产生更强响应
  *   6. 听觉端到端: spectrum→MGN→A1 spike传播
  *   7. 多模态并行: 视觉+听觉同时输入→分别激活V1和A1
+ *   8. 编码器噪声流按实例独立 (视觉 + 听觉): 先后构造 / 并发线程逐位相同
  */
 
 #include "engine/sensory_input.h"
@@ -19,6 +20,7 @@
 #include <cstdio>
 #include <cassert>
 #include <numeric>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -361,6 +363,47 @@ static void test_multimodal() {
 // =============================================================================
 // Main
 // =============================================================================
+// =============================================================================
+// Test 8: 编码器噪声流按实例独立
+// =============================================================================
+static std::vector<float> encoder_noise_trace() {
+    VisualInput vis;
+    AuditoryInput aud;
+    std::vector<float> pixels(vis.n_pixels(), 0.5f);
+    std::vector<float> spectrum(aud.n_freq_bands(), 0.3f);
+    std::vector<float> trace;
+    for (int f = 0; f < 50; ++f) {
+        auto v = vis.encode(pixels);
+        auto a = aud.encode(spectrum);
+        trace.insert(trace.end(), v.begin(), v.end());
+        trace.insert(trace.end(), a.begin(), a.end());
+    }
+    return trace;
+}
+
+static void test_encoder_noise_streams() {
+    printf("\n--- 测试8: 编码器噪声流按实例独立 ---\n");
+
+    auto ref = encoder_noise_trace();
+    TEST_ASSERT(encoder_noise_trace() == ref, "先后构造的编码器噪声序列应相同");
+
+    std::vector<float> a, b;
+    std::thread ta([&] { a = encoder_noise_trace(); });
+    std::thread tb([&] { b = encoder_noise_trace(); });
+    ta.join();
+    tb.join();
+    TEST_ASSERT(a == ref && b == ref, "并发线程中的编码器噪声序列应与单独运行相同");
+
+    AuditoryInputConfig other;
+    other.noise_seed = 777;
+    AuditoryInput aud_a, aud_b(other);
+    std::vector<float> spectrum(aud_a.n_freq_bands(), 0.3f);
+    TEST_ASSERT(aud_a.encode(spectrum) != aud_b.encode(spectrum), "不同 noise_seed → 不同噪声");
+
+    printf("  [PASS] 编码器噪声流按实例独立\n");
+    g_pass++;
+}
+
 int main() {
 #ifdef _WIN32
     SetConsoleOutputCP(65001);
@@ -378,6 +421,7 @@ int main() {
     test_auditory_onset();
     test_auditory_e2e();
     test_multimodal();
+    test_encoder_noise_streams();
 
     printf("\n============================================\n");
     printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
@@ -0,0 +1,235 @@
+/**
+ * 悟韵 (WuYun) 流式脉冲栅格测试
+ *
+ * 测试项:
+ *   1. 逐步运行录制: 读回与逐步回调记录的 (t, id) 完全一致; 随机时间窗 read/count
+ *   2. 区域过滤 + 窗口运行 (线程池并发 capture): 每区域脉冲数与剖析计数一致
+ *   3. 未正常关闭的文件: 无索引时扫描块头重建, 截断的尾块丢弃
+ */
+
+#include "engine/spike_raster.h"
+#include "engine/simulation_engine.h"
+#include "region/cortical_region.h"
+#include "region/subcortical/thalamic_relay.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+// LGN → V1 → V2, 间歇视觉驱动 (有静默段, 覆盖空记录)
+static void build_small_brain(SimulationEngine& engine) {
+    auto lgn_cfg = ThalamicConfig{};
+    lgn_cfg.name = "LGN"; lgn_cfg.n_relay = 50; lgn_cfg.n_trn = 15;
+    engine.add_region(std::make_unique<ThalamicRelay>(lgn_cfg));
+
+    ColumnConfig c;
+    c.n_l4_stellate = 30; c.n_l23_pyramidal = 60; c.n_l5_pyramidal = 30; c.n_l6_pyramidal = 20;
+    c.n_pv_basket = 10; c.n_sst_martinotti = 6; c.n_vip = 4;
+    engine.add_region(std::make_unique<CorticalRegion>("V1", c));
+    engine.add_region(std::make_unique<CorticalRegion>("V2", c));
+    engine.add_projection("LGN", "V1", 2);
+    engine.add_projection("V1", "V2", 2);
+
+    auto* lgn = engine.find_region("LGN");
+    engine.register_clock("stimulus", 1, [lgn](int32_t t, float) {
+        if ((t / 100) % 2 == 0) lgn->inject_external(std::vector<float>(50, 35.0f));
+    });
+}
+
+struct Truth {
+    std::vector<std::vector<int32_t>>  times;
+    std::vector<std::vector<uint32_t>> ids;
+};
+
+// =============================================================================
+// 测试1: 逐步录制 + 随机访问
+// =============================================================================
+void test_roundtrip() {
+    printf("\n--- 测试1: 逐步录制 + 随机访问 ---\n");
+    const std::string path = "test_spike_raster.wyr";
+    SimulationEngine engine(16);
+    build_small_brain(engine);
+    engine.run(7);   // 录制不从 t=0 开始
+
+    Truth truth;
+    truth.times.resize(engine.num_regions());
+    truth.ids.resize(engine.num_regions());
+    engine.set_callback([&](int32_t t, SimulationEngine& e) {
+        for (size_t i = 0; i < e.num_regions(); ++i) {
+            const auto& f = e.region(i).fired();
+            for (size_t j = 0; j < f.size(); ++j) {
+                if (f[j]) { truth.times[i].push_back(t); truth.ids[i].push_back(static_cast<uint32_t>(j)); }
+            }
+        }
+    });
+
+    SpikeRasterWriter writer;
+    CHECK(writer.open(path, engine, 64), "打开写端");
+    engine.set_spike_recorder(&writer);
+    engine.run(1000);
+    engine.set_spike_recorder(nullptr);
+    CHECK(writer.close(), "关闭写端");
+
+    size_t total = 0;
+    for (const auto& v : truth.times) total += v.size();
+    printf("  %llu spikes, %llu chunks, %llu bytes (%.2f B/spike)\n",
+           static_cast<unsigned long long>(writer.spikes()),
+           static_cast<unsigned long long>(writer.chunks()),
+           static_cast<unsigned long long>(writer.bytes_written()),
+           static_cast<double>(writer.bytes_written()) / static_cast<double>(total));
+    CHECK(writer.spikes() == total && total > 0, "写出脉冲数");
+    CHECK(writer.bytes_written() < total * 2, "增量/varint 压缩 (< 2 字节/脉冲)");
+
+    SpikeRasterReader reader;
+    CHECK(reader.open(path), "打开读端");
+    CHECK(reader.indexed() && reader.num_chunks() == 16, "索引: 1000 步 / 64 = 16 块");
+    CHECK(reader.t_begin() == 7 && reader.t_end() == 1007, "时间范围");
+    CHECK(reader.num_regions() == 3 && reader.find_region("V2") == 2, "区域表");
+    CHECK(reader.region_size(0) == engine.region(0).n_neurons(), "区域神经元数");
+
+    for (size_t r = 0; r < reader.num_regions(); ++r) {
+        std::vector<int32_t> t;
+        std::vector<uint32_t> id;
+        reader.read(r, reader.t_begin(), reader.t_end(), t, id);
+        CHECK(t == truth.times[r] && id == truth.ids[r], "全程读回与逐步记录一致");
+    }
+
+    std::mt19937 rng(3);
+    for (int k = 0; k < 50; ++k) {
+        size_t r = rng() % 3;
+        int32_t a = static_cast<int32_t>(rng() % 1100);
+        int32_t b = a + static_cast<int32_t>(rng() % 300);
+        std::vector<int32_t> t;
+        std::vector<uint32_t> id;
+        size_t n = reader.read(r, a, b, t, id);
+        size_t expect = 0;
+        for (int32_t tt : truth.times[r]) expect += tt >= a && tt < b;
+        CHECK(n == expect && t.size() == expect, "随机时间窗 read");
+        CHECK(reader.count(r, a, b) == expect, "随机时间窗 count");
+        CHECK(t.empty() || (t.front() >= a && t.back() < b), "时间窗边界");
+    }
+    reader.close();
+    std::remove(path.c_str());
+    PASS("逐步录制 + 随机访问");
+}
+
+// =============================================================================
+// 测试2: 区域过滤 + 窗口运行
+// =============================================================================
+void test_windowed_filtered() {
+    printf("\n--- 测试2: 区域过滤 + 窗口运行 (线程池) ---\n");
+    const std::string path = "test_spike_raster_win.wyr";
+    SimulationEngine engine(16);
+    build_small_brain(engine);
+    engine.use_worker_pool(2);
+    engine.profiler().enable();
+
+    SpikeRasterWriter writer;
+    CHECK(writer.open(path, engine, 50, {"V2", "LGN", "nonexistent"}), "打开写端 (过滤)");
+    engine.set_spike_recorder(&writer);
+    engine.run_windowed(600, 1.0f, 2);
+    CHECK(writer.close(), "关闭写端");
+
+    SpikeRasterReader reader;
+    CHECK(reader.open(path), "打开读端");
+    CHECK(reader.num_regions() == 2 && reader.region_name(0) == "LGN" && reader.region_name(1) == "V2",
+          "只录制所选区域 (按引擎顺序)");
+    CHECK(reader.t_end() == 600, "窗口运行覆盖全部步");
+#ifdef WUYUN_PROFILE
+    uint64_t lgn = reader.count(0, 0, 600), v2 = reader.count(1, 0, 600);
+    printf("  LGN %llu / V2 %llu spikes\n", static_cast<unsigned long long>(lgn),
+           static_cast<unsigned long long>(v2));
+    CHECK(lgn == engine.profiler().region(0).spikes_out && lgn > 0, "LGN 脉冲数与剖析一致");
+    CHECK(v2 == engine.profiler().region(2).spikes_out, "V2 脉冲数与剖析一致");
+#endif
+    reader.close();
+    std::remove(path.c_str());
+    PASS("区域过滤 + 窗口运行");
+}
+
+// =============================================================================
+// 测试3: 未正常关闭的文件
+// =============================================================================
+void test_unindexed() {
+    printf("\n--- 测试3: 无索引文件重建 ---\n");
+    const std::string path = "test_spike_raster_cut.wyr";
+    SimulationEngine engine(16);
+    build_small_brain(engine);
+    SpikeRasterWriter writer;
+    CHECK(writer.open(path, engine, 100), "打开写端");
+    engine.set_spike_recorder(&writer);
+    engine.run(500);
+    CHECK(writer.close(), "关闭写端");
+
+    std::vector<int32_t> t_full;
+    std::vector<uint32_t> id_full;
+    {
+        SpikeRasterReader full;
+        CHECK(full.open(path), "打开完整文件");
+        full.read(1, 0, 400, t_full, id_full);
+    }
+
+    // 去掉索引并截断最后一块的一半, 模拟进程中途退出
+    std::vector<char> bytes;
+    {
+        std::ifstream f(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+    size_t index_bytes = 4 + 4 + 5 * 16 + 8 + 4;
+    bytes.resize(bytes.size() - index_bytes - 20);
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    SpikeRasterReader reader;
+    CHECK(reader.open(path), "打开无索引文件");
+    CHECK(!reader.indexed() && reader.num_chunks() == 4, "扫描重建 4 个完整块, 丢弃截断块");
+    std::vector<int32_t> t;
+    std::vector<uint32_t> id;
+    reader.read(1, 0, 1000, t, id);
+    CHECK(t == t_full && id == id_full, "完整块内容不变");
+    reader.close();
+    std::remove(path.c_str());
+    PASS("无索引文件重建");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 流式脉冲栅格测试\n");
+    printf("============================================\n");
+
+    test_roundtrip();
+    test_windowed_filtered();
+    test_unindexed();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * 悟韵 (WuYun) 合成脑生成器测试
+ *
+ * 测试项:
+ *   1. 拓扑: 区域数/类型比例/神经元总数, 环形骨架保证投射数 ≥ 区域数
+ *   2. 确定性: 同配置同种子 → 同拓扑同发放率
+ *   3. 大群体构造: 几何跳跃采样下 2 × 20000 神经元秒级构造, 可步进
+ *   4. 校准: 非基底节区域增益被调整, 基底节保持 1, 发放率有限
+ */
+
+#include "engine/synthetic_brain.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+static SyntheticBrainConfig small_config() {
+    SyntheticBrainConfig c;
+    c.n_regions = 8;
+    c.neurons_per_region = 400;
+    return c;
+}
+
+// =============================================================================
+// 测试1: 拓扑
+// =============================================================================
+void test_topology() {
+    printf("\n--- 测试1: 拓扑 ---\n");
+
+    auto c = small_config();
+    c.size_spread = 0.25f;
+    SyntheticBrain brain(c);
+    printf("  %s\n", brain.summary().c_str());
+
+    CHECK(brain.engine().num_regions() == 8, "应有 8 个区域");
+    size_t n_ctx = 0, n_thal = 0, n_bg = 0, total = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        auto k = brain.region_kind(i);
+        if (k == SyntheticBrain::RegionKind::CORTICAL) ++n_ctx;
+        else if (k == SyntheticBrain::RegionKind::THALAMIC) ++n_thal;
+        else ++n_bg;
+        size_t n = brain.engine().region(i).n_neurons();
+        CHECK(n >= 250 && n <= 550, "区域规模应在 N × [1-s, 1+s] 附近");
+        total += n;
+    }
+    CHECK(n_thal == 2 && n_bg == 1 && n_ctx == 5, "类型比例: 2 丘脑 / 1 基底节 / 5 皮层");
+    CHECK(total == brain.total_neurons(), "神经元总数应等于各区域之和");
+    CHECK(brain.num_projections() >= 8, "环形骨架: 投射数应 ≥ 区域数");
+    PASS("区域类型/规模/投射数");
+}
+
+// =============================================================================
+// 测试2: 确定性
+// =============================================================================
+void test_determinism() {
+    printf("\n--- 测试2: 确定性 ---\n");
+
+    auto c = small_config();
+    SyntheticBrain a(c), b(c);
+    CHECK(a.num_projections() == b.num_projections(), "同种子投射数应相同");
+    auto ra = a.measure_rates(100);
+    auto rb = b.measure_rates(100);
+    for (size_t i = 0; i < ra.size(); ++i) {
+        CHECK(a.engine().region(i).n_neurons() == b.engine().region(i).n_neurons(), "同种子区域规模应相同");
+        CHECK(ra[i] == rb[i], "同种子发放率应逐位相同");
+    }
+    float sum = 0.0f;
+    for (float r : ra) sum += r;
+    printf("  区域平均发放率 %.2f Hz\n", sum / ra.size());
+    CHECK(sum > 0.0f, "背景驱动下应有发放");
+    PASS("同种子 → 同拓扑同轨迹");
+}
+
+// =============================================================================
+// 测试3: 大群体构造
+// =============================================================================
+void test_large_build() {
+    printf("\n--- 测试3: 大群体构造 ---\n");
+
+    SyntheticBrainConfig c;
+    c.n_regions = 2;
+    c.neurons_per_region = 20000;
+    c.frac_thalamic = 0.5f;
+    c.frac_bg = 0.0f;
+    auto t0 = std::chrono::steady_clock::now();
+    SyntheticBrain brain(c);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    printf("  %s, 构造 %.0f ms\n", brain.summary().c_str(), ms);
+
+    CHECK(brain.total_neurons() == 40000, "应有 40000 个神经元");
+    CHECK(ms < 30000.0, "几何跳跃采样下构造应为秒级");
+    auto rates = brain.measure_rates(5);
+    CHECK(rates.size() == 2 && std::isfinite(rates[0]) && std::isfinite(rates[1]), "大脑应可步进");
+    PASS("2 × 20000 神经元构造 + 步进");
+}
+
+// =============================================================================
+// 测试4: 校准
+// =============================================================================
+void test_calibrate() {
+    printf("\n--- 测试4: 驱动校准 ---\n");
+
+    auto c = small_config();
+    SyntheticBrain brain(c);
+    const float target = c.target_rate_hz;
+    auto before = brain.measure_rates(100);
+    auto rates = brain.calibrate(4, 100);
+    CHECK(rates.size() == 8 && before.size() == 8, "应返回每区域发放率");
+
+    // 非基底节区域: 与目标的总距离应缩小 (增益调反方向时会变大)
+    float dist_before = 0.0f, dist_after = 0.0f;
+    for (size_t i = 0; i < rates.size(); ++i) {
+        printf("  %-6s %6.2f → %6.2f Hz (目标 %.1f)  gain %.2f\n",
+               brain.engine().region(i).name().c_str(), before[i], rates[i], target,
+               brain.drive_gain(i));
+        CHECK(std::isfinite(rates[i]) && rates[i] >= 0.0f, "发放率应有限非负");
+        if (brain.region_kind(i) == SyntheticBrain::RegionKind::BG) {
+            CHECK(brain.drive_gain(i) == 1.0f, "基底节不参与校准");
+            continue;
+        }
+        dist_before += std::abs(before[i] - target);
+        dist_after  += std::abs(rates[i] - target);
+        // 逐区域: 距离不增 (已在目标 ±50% 内的区域允许在带内波动)
+        CHECK(std::abs(rates[i] - target) <= std::max(std::abs(before[i] - target), 0.5f * target),
+              "校准不应把区域推离目标");
+    }
+    printf("  非基底节 Σ|rate - target|: %.2f → %.2f Hz\n", dist_before, dist_after);
+    CHECK(dist_after < dist_before, "校准后发放率应更接近目标");
+    PASS("乘性校准");
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 合成脑生成器测试\n");
+    printf("============================================\n");
+
+    test_topology();
+    test_determinism();
+    test_large_build();
+    test_calibrate();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * 悟韵 (WuYun) 实时遥测环测试
+ *
+ * 测试项:
+ *   1. 写端/读端往返: 段头、区域名、帧内容; 环满覆盖与 lost 计数; 未知段 attach 失败
+ *   2. SimulationEngine 每 N 步发布: 每区域发放数与逐步回调统计一致 (单步与窗口运行)
+ *   3. 并发读者: 仿真运行中另一线程反复 attach/poll/detach, 收到的帧完整且连续或计入 lost
+ *   4. ClosedLoopAgent: 帧带奖励率、智能体步数、BG DA 与权重范数
+ */
+
+#include "core/telemetry.h"
+#include "engine/simulation_engine.h"
+#include "engine/closed_loop_agent.h"
+#include "engine/grid_world_env.h"
+#include "region/cortical_region.h"
+#include "region/subcortical/thalamic_relay.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+/** 每个测试独立段名 (并行 ctest 不冲突) */
+static std::string seg(const char* tag) {
+    return std::string("wuyun_test_tm_") + tag;
+}
+
+// LGN → V1, 持续视觉驱动
+static void build_small_brain(SimulationEngine& engine) {
+    auto lgn_cfg = ThalamicConfig{};
+    lgn_cfg.name = "LGN"; lgn_cfg.n_relay = 50; lgn_cfg.n_trn = 15;
+    engine.add_region(std::make_unique<ThalamicRelay>(lgn_cfg));
+
+    ColumnConfig c;
+    c.n_l4_stellate = 30; c.n_l23_pyramidal = 60; c.n_l5_pyramidal = 30; c.n_l6_pyramidal = 20;
+    c.n_pv_basket = 10; c.n_sst_martinotti = 6; c.n_vip = 4;
+    engine.add_region(std::make_unique<CorticalRegion>("V1", c));
+    engine.add_projection("LGN", "V1", 2);
+
+    auto* lgn = engine.find_region("LGN");
+    engine.register_clock("stimulus", 1, [lgn](int32_t, float) {
+        lgn->inject_external(std::vector<float>(50, 35.0f));
+    });
+}
+
+// =============================================================================
+// 测试1: 写端/读端往返
+// =============================================================================
+void test_roundtrip() {
+    printf("\n--- 测试1: 写端/读端往返 ---\n");
+    auto w = TelemetryWriter::create(seg("rt"), {"A", "B", "C"}, 10, 4);
+    CHECK(w != nullptr, "共享内存段应创建成功");
+
+    TelemetryReader early;
+    CHECK(early.attach(seg("rt")), "空环可 attach");
+    std::vector<TelemetryFrame> frames;
+    CHECK(early.poll(frames) == 0, "尚无帧");
+    TelemetryFrame tmp;
+    CHECK(!early.latest(tmp), "尚无最新帧");
+
+    for (int k = 0; k < 3; ++k) {
+        w->staging().step = 10 * (k + 1);
+        w->staging().spikes[1] = static_cast<uint32_t>(k);
+        w->publish();
+    }
+
+    TelemetryReader r;
+    CHECK(r.attach("/" + seg("rt")), "带前导 '/' 的名字同样可 attach");
+    CHECK(r.region_names().size() == 3 && r.region_names()[2] == "C", "区域名表");
+    CHECK(r.capacity() == 4 && r.publish_every() == 10, "段头参数");
+    frames.clear();
+    CHECK(r.poll(frames) == 3, "attach 后读到环中已有的 3 帧");
+    CHECK(frames[0].seq == 0 && frames[2].seq == 2 && frames[2].step == 30, "帧序号与内容");
+    CHECK(frames[1].spikes[1] == 1 && frames[0].n_regions == 3, "区域计数");
+    CHECK(std::isnan(frames[0].reward_rate), "无智能体时奖励字段为 NaN");
+
+    // 落后超过容量: 只拿到最后 4 帧, 其余计入 lost
+    for (int k = 3; k < 13; ++k) w->publish();
+    frames.clear();
+    CHECK(r.poll(frames) == 4, "环满后只保留最新 capacity 帧");
+    CHECK(frames.front().seq == 9 && frames.back().seq == 12, "保留的是最新帧");
+    CHECK(r.lost() == 6, "被覆盖的帧计入 lost");
+    CHECK(r.latest(tmp) && tmp.seq == 12, "latest 返回最新帧");
+
+    frames.clear();
+    CHECK(early.poll(frames) == 4 && early.lost() == 9, "另一读者独立计数");
+
+    w.reset();
+    TelemetryReader gone;
+    CHECK(!gone.attach(seg("rt")), "写端销毁后段被 unlink");
+    CHECK(!gone.attach(seg("nonexistent")), "未知段 attach 失败");
+    CHECK(r.latest(tmp), "已 attach 的读者映射在写端退出后仍可读");
+    r.detach();
+    CHECK(!r.attached(), "detach");
+    PASS("写端/读端往返");
+}
+
+// =============================================================================
+// 测试2: 引擎每 N 步发布
+// =============================================================================
+void test_engine_publish() {
+    printf("\n--- 测试2: 引擎每 N 步发布 ---\n");
+    SimulationEngine engine(16);
+    build_small_brain(engine);
+
+    // 对照: 回调逐步统计每区域发放数
+    std::vector<uint64_t> expect(engine.num_regions(), 0);
+    engine.set_callback([&](int32_t, SimulationEngine& e) {
+        for (size_t i = 0; i < e.num_regions(); ++i) {
+            for (uint8_t f : e.region(i).fired()) expect[i] += f != 0;
+        }
+    });
+
+    CHECK(engine.enable_telemetry(seg("eng"), 50, 64), "启用遥测");
+    TelemetryReader r;
+    CHECK(r.attach(seg("eng")), "attach 引擎段");
+    CHECK(r.region_names().size() == 2 && r.region_names()[1] == "V1", "区域名来自引擎");
+
+    engine.run(500);
+    std::vector<TelemetryFrame> frames;
+    CHECK(r.poll(frames) == 10, "500 步 / 每 50 步 = 10 帧");
+
+    std::vector<uint64_t> got(engine.num_regions(), 0);
+    bool steps_ok = true, latency_ok = true;
+    for (size_t k = 0; k < frames.size(); ++k) {
+        const auto& f = frames[k];
+        steps_ok = steps_ok && f.step == static_cast<int64_t>(50 * (k + 1)) && f.window_steps == 50;
+        latency_ok = latency_ok && f.step_us_mean > 0.0f && f.step_us_max >= f.step_us_mean;
+        for (size_t i = 0; i < got.size(); ++i) got[i] += f.spikes[i];
+    }
+    printf("  LGN %llu / V1 %llu spikes, %.1f us/step\n",
+           static_cast<unsigned long long>(got[0]), static_cast<unsigned long long>(got[1]),
+           frames.back().step_us_mean);
+    CHECK(steps_ok, "帧步号与窗口步数");
+    CHECK(latency_ok, "步耗时均值/最大值");
+    CHECK(got == expect && got[1] > 0, "每区域发放数与逐步统计一致");
+    CHECK(std::fabs(frames.back().ne - engine.global_neuromod().ne) < 1e-6f, "调质字段");
+
+    // 窗口运行: 每个窗口计一次, 仍按步数累计发布
+    engine.run_windowed(200, 1.0f, 2);
+    frames.clear();
+    CHECK(r.poll(frames) == 4 && frames.back().step == 700, "窗口运行同样发布");
+
+    engine.disable_telemetry();
+    engine.run(100);
+    CHECK(engine.telemetry() == nullptr, "关闭遥测");
+    PASS("引擎每 N 步发布");
+}
+
+// =============================================================================
+// 测试3: 并发读者
+// =============================================================================
+void test_concurrent_reader() {
+    printf("\n--- 测试3: 并发读者 attach/detach ---\n");
+    SimulationEngine engine(16);
+    build_small_brain(engine);
+    CHECK(engine.enable_telemetry(seg("cc"), 2, 8), "启用遥测 (小环, 高频)");
+
+    std::atomic<bool> done{false};
+    uint64_t received = 0, lost = 0, attaches = 0, bad = 0;
+    std::thread reader([&] {
+        std::vector<TelemetryFrame> frames;
+        while (!done.load()) {
+            TelemetryReader r;
+            if (!r.attach(seg("cc"))) continue;
+            ++attaches;
+            for (int i = 0; i < 20 && !done.load(); ++i) {
+                frames.clear();
+                r.poll(frames);
+                for (size_t k = 0; k < frames.size(); ++k) {
+                    const auto& f = frames[k];
+                    // 完整帧: 步号 = (seq+1)·every, 窗口步数不变
+                    if (f.step != static_cast<int64_t>(2 * (f.seq + 1)) || f.window_steps != 2) ++bad;
+                    if (k > 0 && f.seq <= frames[k - 1].seq) ++bad;
+                }
+                received += frames.size();
+                std::this_thread::yield();
+            }
+            lost += r.lost();
+            r.detach();
+        }
+    });
+
+    engine.run(2000);
+    done.store(true);
+    reader.join();
+    printf("  published %llu, received %llu, lost %llu, attaches %llu\n",
+           static_cast<unsigned long long>(engine.telemetry()->published()),
+           static_cast<unsigned long long>(received), static_cast<unsigned long long>(lost),
+           static_cast<unsigned long long>(attaches));
+    CHECK(engine.telemetry()->published() == 1000, "写端不受读者影响, 每 2 步一帧");
+    CHECK(attaches > 0 && received > 0, "读者 attach 并收到帧");
+    CHECK(bad == 0, "收到的帧均完整且有序");
+    PASS("并发读者 attach/detach");
+}
+
+// =============================================================================
+// 测试4: ClosedLoopAgent 字段
+// =============================================================================
+void test_agent() {
+    printf("\n--- 测试4: ClosedLoopAgent 遥测字段 ---\n");
+    AgentConfig cfg;
+    cfg.enable_replay = false;
+    ClosedLoopAgent agent(std::make_unique<GridWorldEnv>(GridWorldConfig{}), cfg);
+    CHECK(agent.enable_telemetry(seg("agent"), 100), "启用智能体遥测");
+
+    agent.run(40);
+    TelemetryReader r;
+    CHECK(r.attach(seg("agent")), "attach");
+    TelemetryFrame f;
+    CHECK(r.latest(f), "已有帧");
+    printf("  agent %lld steps, reward %.3f, BG DA %.3f |D1| %.2f |D2| %.2f\n",
+           static_cast<long long>(f.agent_steps), f.reward_rate, f.bg_da,
+           f.bg_w_d1_norm, f.bg_w_d2_norm);
+    CHECK(f.agent_steps > 0 && f.agent_steps <= 40, "智能体步数");
+    CHECK(std::isfinite(f.reward_rate) && std::isfinite(f.last_reward), "奖励字段已填");
+    CHECK(f.bg_w_d1_norm > 0.0f && f.bg_w_d2_norm > 0.0f && std::isfinite(f.bg_da), "BG 快照");
+    PASS("ClosedLoopAgent 遥测字段");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+    printf("  遥测环需要 POSIX 共享内存, 跳过\n");
+    return 0;
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 实时遥测环测试\n");
+    printf("============================================\n");
+
+    test_roundtrip();
+    test_engine_publish();
+    test_concurrent_reader();
+    test_agent();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
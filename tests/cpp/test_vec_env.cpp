@@ -0,0 +1,238 @@
+/**
+ * 悟韵 (WuYun) 批量环境测试
+ *
+ * 测试项:
+ *   1. observe_into: GridWorld (开放场地/各迷宫/不同视野) 与 MultiRoom 的无分配观测
+ *      与按 to_string() 地图逐格重建的参考观测一致, observe() 与之相同
+ *   2. VecEnv (GridWorld): N 个世界批量 step/observe 与逐个推进单个环境逐位一致
+ *   3. VecEnv (MultiRoom): 同上, 且单世界换种子重置一致, 观测矩阵缓冲复用
+ */
+
+#include "engine/vec_env.h"
+#include "engine/grid_world_env.h"
+#include "engine/multi_room_env.h"
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+struct VisualCodes {
+    float empty, food, danger, wall, agent;
+};
+
+// 参考观测: 从 to_string() 地图逐格查码 (界外 = 墙), 窗口中心 = agent
+static std::vector<float> reference_observe(const std::string& map, int radius,
+                                            const VisualCodes& v) {
+    std::vector<std::string> rows;
+    std::istringstream ss(map);
+    for (std::string line; std::getline(ss, line);) rows.push_back(line);
+    int ax = 0, ay = 0;
+    for (int y = 0; y < (int)rows.size(); ++y) {
+        auto p = rows[y].find('A');
+        if (p != std::string::npos) { ax = static_cast<int>(p); ay = y; }
+    }
+    std::vector<float> obs;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            int x = ax + dx, y = ay + dy;
+            char c = (y >= 0 && y < (int)rows.size() && x >= 0 && x < (int)rows[y].size())
+                   ? rows[y][x] : '#';
+            float val = v.empty;
+            if (c == 'A') val = v.agent;
+            else if (c == 'F') val = v.food;
+            else if (c == 'D') val = v.danger;
+            else if (c == '#') val = v.wall;
+            obs.push_back(val);
+        }
+    }
+    return obs;
+}
+
+// 随机连续位移 (与闭环智能体的 |d| ≤ 1 同量级)
+static void random_move(std::mt19937& rng, float& dx, float& dy) {
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    dx = u(rng);
+    dy = u(rng);
+}
+
+// =============================================================================
+// 测试1: observe_into 与参考观测一致
+// =============================================================================
+void test_observe_into() {
+    printf("\n--- 测试1: observe_into 与参考观测一致 ---\n");
+    std::mt19937 rng(7);
+    size_t checked = 0;
+
+    const MazeType mazes[] = {MazeType::OPEN_FIELD, MazeType::T_MAZE,
+                              MazeType::CORRIDOR, MazeType::SIMPLE_MAZE};
+    for (MazeType maze : mazes) {
+        for (int radius = 1; radius <= 3; ++radius) {
+            GridWorldConfig cfg;
+            cfg.maze_type = maze;
+            cfg.vision_radius = radius;
+            GridWorldEnv env(cfg);
+            VisualCodes v{cfg.vis_empty, cfg.vis_food, cfg.vis_danger, cfg.vis_wall, cfg.vis_agent};
+            std::vector<float> buf(env.vis_width() * env.vis_height());
+            for (int s = 0; s < 300; ++s) {
+                float dx, dy;
+                random_move(rng, dx, dy);
+                env.step(dx, dy);
+                env.observe_into(buf.data());
+                auto ref = reference_observe(env.grid_world().to_string(), radius, v);
+                CHECK(buf == ref, "GridWorld observe_into == 参考");
+                CHECK(env.observe() == buf, "GridWorld observe() == observe_into");
+                checked++;
+            }
+        }
+    }
+
+    MultiRoomConfig mcfg;
+    mcfg.n_rooms_x = 3;
+    mcfg.vision_radius = 3;
+    MultiRoomEnv menv(mcfg);
+    VisualCodes mv{mcfg.vis_empty, mcfg.vis_food, mcfg.vis_danger, mcfg.vis_wall, mcfg.vis_agent};
+    std::vector<float> mbuf(menv.vis_width() * menv.vis_height());
+    for (int s = 0; s < 1000; ++s) {
+        float dx, dy;
+        random_move(rng, dx, dy);
+        menv.step(dx, dy);
+        menv.observe_into(mbuf.data());
+        CHECK(mbuf == reference_observe(menv.to_string(), mcfg.vision_radius, mv),
+              "MultiRoom observe_into == 参考");
+        CHECK(menv.observe() == mbuf, "MultiRoom observe() == observe_into");
+        checked++;
+    }
+    printf("  %zu 次观测逐像素一致\n", checked);
+    PASS("observe_into 与参考观测一致");
+}
+
+// 批量与逐个推进对照: 同种子、同位移序列
+template <typename MakeSingle>
+static bool matches_singles(VecEnv& vec, MakeSingle make_single, uint32_t seed0, int steps,
+                            std::mt19937& rng, uint64_t& events) {
+    size_t n = vec.size();
+    std::vector<std::unique_ptr<Environment>> singles;
+    for (size_t i = 0; i < n; ++i) singles.push_back(make_single(seed0 + static_cast<uint32_t>(i)));
+
+    std::vector<float> dx(n), dy(n), one(vec.obs_size());
+    for (int s = 0; s < steps; ++s) {
+        for (size_t i = 0; i < n; ++i) random_move(rng, dx[i], dy[i]);
+        vec.step(dx, dy);
+        const auto& obs = vec.observe_all();
+        for (size_t i = 0; i < n; ++i) {
+            auto r = singles[i]->step(dx[i], dy[i]);
+            singles[i]->observe_into(one.data());
+            if (r.reward != vec.reward()[i] || r.pos_x != vec.pos_x()[i] || r.pos_y != vec.pos_y()[i]
+                || r.positive_event != (vec.positive()[i] != 0)
+                || r.negative_event != (vec.negative()[i] != 0)) return false;
+            for (size_t k = 0; k < one.size(); ++k) {
+                if (obs[i * vec.obs_size() + k] != one[k]) return false;
+            }
+        }
+    }
+    uint64_t pos = 0, neg = 0;
+    for (const auto& e : singles) { pos += e->positive_count(); neg += e->negative_count(); }
+    events = pos + neg;
+    return pos == vec.total_positive() && neg == vec.total_negative();
+}
+
+// =============================================================================
+// 测试2: VecEnv (GridWorld) 与逐个推进一致
+// =============================================================================
+void test_vec_grid_world() {
+    printf("\n--- 测试2: VecEnv (GridWorld) ---\n");
+    GridWorldConfig cfg;
+    cfg.seed = 100;
+    VecEnv vec = VecEnv::grid_world(8, cfg);
+    CHECK(vec.size() == 8 && vec.obs_size() == cfg.vision_pixels(), "尺寸");
+    CHECK(vec.pos_x()[0] == vec.env(0).pos_x(), "初始位置");
+
+    std::mt19937 rng(11);
+    uint64_t events = 0;
+    bool ok = matches_singles(vec, [&](uint32_t seed) -> std::unique_ptr<Environment> {
+        GridWorldConfig c = cfg;
+        c.seed = seed;
+        return std::make_unique<GridWorldEnv>(c);
+    }, cfg.seed, 500, rng, events);
+    printf("  8 世界 × 500 步, 食物/危险事件 %llu\n", static_cast<unsigned long long>(events));
+    CHECK(ok, "批量 step/observe 与单个环境逐位一致");
+    CHECK(events > 0, "覆盖食物/危险事件 (含重生)");
+    PASS("VecEnv (GridWorld)");
+}
+
+// =============================================================================
+// 测试3: VecEnv (MultiRoom) + 单世界重置
+// =============================================================================
+void test_vec_multi_room() {
+    printf("\n--- 测试3: VecEnv (MultiRoom) ---\n");
+    MultiRoomConfig cfg;
+    cfg.seed = 5;
+    VecEnv vec = VecEnv::multi_room(6, cfg);
+    const float* before = vec.observe_all().data();
+
+    std::mt19937 rng(13);
+    uint64_t events = 0;
+    auto make = [&](uint32_t seed) -> std::unique_ptr<Environment> {
+        MultiRoomConfig c = cfg;
+        c.seed = seed;
+        return std::make_unique<MultiRoomEnv>(c);
+    };
+    CHECK(matches_singles(vec, make, cfg.seed, 400, rng, events), "批量与单个环境逐位一致");
+    CHECK(vec.observe_all().data() == before, "观测矩阵缓冲复用 (无重新分配)");
+
+    // 单世界换种子重置
+    vec.reset(2, 999);
+    auto single = make(999);
+    std::vector<float> a(vec.obs_size());
+    single->observe_into(a.data());
+    const auto& obs = vec.observe_all();
+    CHECK(std::vector<float>(obs.begin() + 2 * vec.obs_size(), obs.begin() + 3 * vec.obs_size()) == a,
+          "reset(i, seed) 与新建环境观测一致");
+    CHECK(vec.pos_x()[2] == single->pos_x() && vec.env(2).step_count() == 0, "重置后位置/计数");
+
+    // 越界下标: 忽略, 其它世界不变
+    std::vector<float> snapshot = vec.observe_all();
+    vec.reset(vec.size(), 1);
+    CHECK(vec.observe_all() == snapshot, "越界 reset(i) 应被忽略");
+    printf("  6 世界 × 400 步, 事件 %llu\n", static_cast<unsigned long long>(events));
+    PASS("VecEnv (MultiRoom)");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 批量环境测试\n");
+    printf("============================================\n");
+
+    test_observe_into();
+    test_vec_grid_world();
+    test_vec_multi_room();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
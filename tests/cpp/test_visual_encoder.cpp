@@ -0,0 +1,290 @@
+/**
+ * 悟韵 (WuYun) 视觉编码器测试
+ *
+ * 测试项:
+ *   1. ELL 编码与冻结的逐连接参考内核 (vector<vector<RFConnection>>) 逐位一致
+ *      (默认 8×8、无 ON/OFF 分割、非整方格 LGN 数、32×32 视网膜)
+ *   2. 噪声: 实例自身的噪声流与参考序列一致, 两个实例互不干扰
+ *   3. encode_batch: 每帧独立噪声流 / 编码器自身流, 均与逐帧 encode_into 一致
+ *   4. 大视网膜 (32×32, 64×64): ELL 填充率与编码耗时
+ */
+
+#include "engine/sensory_input.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace wuyun;
+
+static int g_pass = 0, g_fail = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("  [FAIL] %s\n", msg); g_fail++; return; } \
+} while(0)
+
+#define PASS(msg) do { printf("  [PASS] %s\n", msg); g_pass++; } while(0)
+
+// =============================================================================
+// 参考内核: ELL 化之前的 VisualInput (逐神经元 vector<RFConnection>), 冻结副本
+// =============================================================================
+struct ReferenceVisual {
+    struct RFConnection {
+        size_t pixel_idx;
+        float  weight;
+    };
+    VisualInputConfig cfg;
+    std::vector<std::vector<RFConnection>> rf;
+    std::mt19937 noise_rng{12345};
+
+    explicit ReferenceVisual(const VisualInputConfig& c) : cfg(c) {
+        size_t n_lgn = cfg.n_lgn_neurons, w = cfg.input_width, h = cfg.input_height;
+        rf.resize(n_lgn);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+        size_t n_on = cfg.on_off_channels ? n_lgn / 2 : n_lgn;
+        size_t grid_side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(n_on))));
+        float step_x = static_cast<float>(w) / static_cast<float>(grid_side);
+        float step_y = static_cast<float>(h) / static_cast<float>(grid_side);
+        for (size_t i = 0; i < n_on; ++i) {
+            size_t gx = i % grid_side, gy = i / grid_side;
+            float cx = (static_cast<float>(gx) + 0.5f + jitter(rng)) * step_x;
+            float cy = (static_cast<float>(gy) + 0.5f + jitter(rng)) * step_y;
+            cx = std::clamp(cx, 0.0f, static_cast<float>(w) - 0.01f);
+            cy = std::clamp(cy, 0.0f, static_cast<float>(h) - 0.01f);
+            float r_c = cfg.center_radius, r_s = cfg.surround_radius;
+            for (size_t py = 0; py < h; ++py) {
+                for (size_t px = 0; px < w; ++px) {
+                    float dx = static_cast<float>(px) + 0.5f - cx;
+                    float dy = static_cast<float>(py) + 0.5f - cy;
+                    float dist = std::sqrt(dx * dx + dy * dy);
+                    float weight = 0.0f;
+                    if (dist <= r_c) {
+                        weight = cfg.center_weight * (1.0f - dist / r_c);
+                    } else if (dist <= r_s) {
+                        float norm = (dist - r_c) / (r_s - r_c);
+                        weight = -cfg.surround_weight * (1.0f - norm);
+                    }
+                    if (std::fabs(weight) > 0.01f) rf[i].push_back({py * w + px, weight});
+                }
+            }
+        }
+        if (cfg.on_off_channels) {
+            for (size_t i = n_on; i < n_lgn; ++i) {
+                size_t on_idx = (i - n_on) % n_on;
+                for (const auto& conn : rf[on_idx]) rf[i].push_back({conn.pixel_idx, -conn.weight});
+            }
+        }
+    }
+
+    std::vector<float> encode(const std::vector<float>& pixels) {
+        size_t n_lgn = cfg.n_lgn_neurons;
+        std::vector<float> currents(n_lgn, cfg.baseline);
+        if (pixels.size() < cfg.input_width * cfg.input_height) return currents;
+        for (size_t i = 0; i < n_lgn; ++i) {
+            float response = 0.0f;
+            for (const auto& conn : rf[i]) {
+                if (conn.pixel_idx < pixels.size()) response += conn.weight * pixels[conn.pixel_idx];
+            }
+            currents[i] += cfg.gain * std::max(0.0f, response);
+        }
+        if (cfg.noise_amp > 0.0f) {
+            std::uniform_real_distribution<float> noise(0.0f, cfg.noise_amp);
+            for (size_t i = 0; i < n_lgn; ++i) currents[i] += noise(noise_rng);
+        }
+        return currents;
+    }
+};
+
+static std::vector<float> random_frame(std::mt19937& rng, size_t n) {
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    std::vector<float> px(n);
+    for (auto& p : px) p = u(rng);
+    return px;
+}
+
+static VisualInputConfig make_cfg(size_t w, size_t h, size_t n_lgn, bool on_off, float noise) {
+    VisualInputConfig c;
+    c.input_width = w;
+    c.input_height = h;
+    c.n_lgn_neurons = n_lgn;
+    c.on_off_channels = on_off;
+    c.noise_amp = noise;
+    return c;
+}
+
+// =============================================================================
+// 测试1: ELL 编码与参考内核逐位一致 (无噪声)
+// =============================================================================
+void test_matches_reference() {
+    printf("\n--- 测试1: ELL 编码与参考内核逐位一致 ---\n");
+    const VisualInputConfig cfgs[] = {
+        make_cfg(8, 8, 50, true, 0.0f),
+        make_cfg(8, 8, 50, false, 0.0f),
+        make_cfg(5, 7, 37, true, 0.0f),
+        make_cfg(32, 32, 400, true, 0.0f),
+    };
+    std::mt19937 rng(3);
+    for (const auto& cfg : cfgs) {
+        VisualInput enc(cfg);
+        ReferenceVisual ref(cfg);
+        size_t conns = 0;
+        for (const auto& row : ref.rf) conns += row.size();
+        CHECK(enc.n_connections() == conns, "有效连接数与参考一致");
+        std::vector<float> out(enc.n_lgn());
+        for (int f = 0; f < 50; ++f) {
+            auto px = random_frame(rng, enc.n_pixels());
+            auto expect = ref.encode(px);
+            CHECK(enc.encode(px) == expect, "encode == 参考");
+            enc.encode_into(px.data(), out.data());
+            CHECK(out == expect, "encode_into == 参考");
+        }
+        CHECK(enc.encode(std::vector<float>(3, 1.0f)) == std::vector<float>(enc.n_lgn(), cfg.baseline),
+              "短输入 → 基线");
+        printf("  %zux%zu → %zu LGN: %zu 连接, ELL 宽 %zu\n", cfg.input_width, cfg.input_height,
+               cfg.n_lgn_neurons, enc.n_connections(), enc.rf_width());
+    }
+    PASS("ELL 编码与参考内核逐位一致");
+}
+
+// =============================================================================
+// 测试2: 实例噪声流
+// =============================================================================
+void test_noise_streams() {
+    printf("\n--- 测试2: 实例噪声流 ---\n");
+    VisualInputConfig cfg;  // 默认 noise_amp = 2, noise_seed = 12345
+    VisualInput a(cfg), b(cfg);
+    ReferenceVisual ref(cfg);
+    std::mt19937 rng(5);
+    for (int f = 0; f < 100; ++f) {
+        auto px = random_frame(rng, a.n_pixels());
+        auto expect = ref.encode(px);
+        CHECK(a.encode(px) == expect, "噪声序列与参考一致");
+    }
+    // b 未被 a 的 100 帧推进: 首帧与新参考首帧相同
+    ReferenceVisual ref2(cfg);
+    auto px = random_frame(rng, b.n_pixels());
+    CHECK(b.encode(px) == ref2.encode(px), "实例间噪声流独立");
+
+    VisualInputConfig other = cfg;
+    other.noise_seed = 777;
+    VisualInput c(other);
+    CHECK(c.encode(px) != ref.encode(px), "不同 noise_seed → 不同噪声");
+    PASS("实例噪声流");
+}
+
+// =============================================================================
+// 测试3: encode_batch 与逐帧编码一致
+// =============================================================================
+void test_encode_batch() {
+    printf("\n--- 测试3: encode_batch ---\n");
+    const size_t n_frames = 16;
+    VisualInputConfig cfg = make_cfg(11, 11, 98, true, 2.0f);
+    VisualInput batch(cfg);
+    const size_t n_pix = batch.n_pixels(), n_lgn = batch.n_lgn();
+
+    std::mt19937 rng(9);
+    std::vector<float> frames;
+    for (size_t f = 0; f < n_frames; ++f) {
+        auto px = random_frame(rng, n_pix);
+        frames.insert(frames.end(), px.begin(), px.end());
+    }
+
+    // 每帧独立噪声流 (各智能体一个)
+    std::vector<std::mt19937> streams, streams_ref;
+    for (size_t f = 0; f < n_frames; ++f) {
+        streams.emplace_back(1000 + static_cast<uint32_t>(f));
+        streams_ref.emplace_back(1000 + static_cast<uint32_t>(f));
+    }
+    std::vector<float> out(n_frames * n_lgn), one(n_lgn);
+    for (int rep = 0; rep < 3; ++rep) {
+        batch.encode_batch(frames.data(), n_frames, out.data(), streams.data());
+        for (size_t f = 0; f < n_frames; ++f) {
+            VisualInputConfig c = cfg;
+            c.noise_amp = 0.0f;
+            VisualInput quiet(c);
+            quiet.encode_into(frames.data() + f * n_pix, one.data());
+            std::uniform_real_distribution<float> noise(0.0f, cfg.noise_amp);
+            for (auto& v : one) v += noise(streams_ref[f]);
+            CHECK(std::equal(one.begin(), one.end(), out.begin() + f * n_lgn),
+                  "每帧噪声流: 批量 == 逐帧");
+        }
+    }
+
+    // nullptr: 依次取编码器自身的流 == 逐帧 encode_into
+    batch.encode_batch(frames.data(), n_frames, out.data());
+    VisualInput fresh(cfg);
+    for (size_t f = 0; f < n_frames; ++f) {
+        fresh.encode_into(frames.data() + f * n_pix, one.data());
+        CHECK(std::equal(one.begin(), one.end(), out.begin() + f * n_lgn),
+              "自身噪声流: 批量 == 逐帧");
+    }
+    printf("  %zu 帧 × %zu LGN, 3 轮独立流 + 1 轮自身流\n", n_frames, n_lgn);
+    PASS("encode_batch 与逐帧编码一致");
+}
+
+// =============================================================================
+// 测试4: 大视网膜
+// =============================================================================
+void test_large_retina() {
+    printf("\n--- 测试4: 大视网膜 ---\n");
+    using clock = std::chrono::steady_clock;
+    const size_t sides[] = {32, 64};
+    std::mt19937 rng(21);
+    for (size_t side : sides) {
+        VisualInputConfig cfg = make_cfg(side, side, side * side / 2, true, 2.0f);
+        VisualInput enc(cfg);
+        double fill = static_cast<double>(enc.n_connections())
+                    / static_cast<double>(enc.rf_width() * enc.n_lgn());
+        CHECK(fill > 0.5, "ELL 填充率 > 50% (行长有界)");
+        CHECK(enc.rf_width() < 64, "ELL 宽度与视网膜尺寸无关");
+
+        const size_t n_frames = 32;
+        std::vector<float> frames;
+        for (size_t f = 0; f < n_frames; ++f) {
+            auto px = random_frame(rng, enc.n_pixels());
+            frames.insert(frames.end(), px.begin(), px.end());
+        }
+        std::vector<float> out(n_frames * enc.n_lgn());
+        auto t0 = clock::now();
+        for (int rep = 0; rep < 10; ++rep) enc.encode_batch(frames.data(), n_frames, out.data());
+        double us = std::chrono::duration<double, std::micro>(clock::now() - t0).count()
+                  / (10.0 * n_frames);
+        bool finite = true;
+        for (float v : out) finite = finite && std::isfinite(v) && v >= cfg.baseline;
+        CHECK(finite, "输出有限且 ≥ 基线");
+        printf("  %zux%zu → %zu LGN: %zu 连接, ELL 宽 %zu, 填充率 %.2f, %.1f us/帧\n",
+               side, side, enc.n_lgn(), enc.n_connections(), enc.rf_width(), fill, us);
+    }
+    PASS("大视网膜");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);
+#endif
+    printf("============================================\n");
+    printf("  悟韵 (WuYun) 视觉编码器测试\n");
+    printf("============================================\n");
+
+    test_matches_reference();
+    test_noise_streams();
+    test_encode_batch();
+    test_large_retina();
+
+    printf("\n============================================\n");
+    printf("  结果: %d 通过, %d 失败, 共 %d 测试\n",
+           g_pass, g_fail, g_pass + g_fail);
+    printf("============================================\n");
+
+    return g_fail > 0 ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * diff_kernels — 快速路径 vs 参考实现的随机差分测试 + 并排计时
+ *
+ * 用法:
+ *   diff_kernels [--kernel population|synapse|bg_replay|all] [--a reference] [--b current]
+ *                [--seeds 10] [--seed0 1] [--steps 400] [--tol exact|close|stat] [--delays]
+ *                [--no-nmda] [--verbose] [--list]
+ *
+ *   --a/--b 为后端名 (--list 列出); 省略时按内核取默认对照 (reference 对 current/csr, stepwise 对 batch)
+ *   --delays 允许突触场景带异质延迟 (参考实现逐突触排队, 与延迟环求和顺序不同 → 宜配 --tol close)
+ *   --no-nmda 关闭 NMDA 共受体 (B(V) 查表会放大舍入差, 见 differential.h)
+ *   每个种子一个随机场景 (参数扰动、输入、连接、STP/NMDA), 任一种子失败则退出码 1
+ */
+
+#include "verify/differential.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace wuyun;
+
+static void usage() {
+    printf("usage: diff_kernels [--kernel population|synapse|bg_replay|all] [--a NAME] [--b NAME]\n"
+           "                    [--seeds 10] [--seed0 1] [--steps 400] [--tol exact|close|stat]\n"
+           "                    [--delays] [--no-nmda] [--verbose] [--list]\n");
+}
+
+static void list_backends() {
+    auto show = [](const char* kernel, const std::vector<std::pair<std::string, std::string>>& list) {
+        printf("%s:\n", kernel);
+        for (const auto& [name, desc] : list) printf("  %-10s %s\n", name.c_str(), desc.c_str());
+    };
+    show("population", population_backends());
+    show("synapse", synapse_backends());
+    show("bg_replay", bg_replay_backends());
+}
+
+int main(int argc, char* argv[]) {
+    std::string kernel = "all", a, b, tol_name = "exact";
+    int seeds = 10, steps = 400;
+    uint32_t seed0 = 1;
+    bool delays = false, nmda = true, verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto need = [&](const char* flag) -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", flag); std::exit(2); }
+            return argv[++i];
+        };
+        if      (arg == "--kernel")  kernel = need("--kernel");
+        else if (arg == "--a")       a = need("--a");
+        else if (arg == "--b")       b = need("--b");
+        else if (arg == "--seeds")   seeds = std::max(std::atoi(need("--seeds")), 1);
+        else if (arg == "--seed0")   seed0 = static_cast<uint32_t>(std::atoi(need("--seed0")));
+        else if (arg == "--steps")   steps = std::max(std::atoi(need("--steps")), 1);
+        else if (arg == "--tol")     tol_name = need("--tol");
+        else if (arg == "--delays")  delays = true;
+        else if (arg == "--no-nmda") nmda = false;
+        else if (arg == "--verbose") verbose = true;
+        else if (arg == "--list")    { list_backends(); return 0; }
+        else { usage(); return 2; }
+    }
+
+    DiffTolerance tol;
+    if      (tol_name == "exact") tol = DiffTolerance::exact();
+    else if (tol_name == "close") tol = DiffTolerance::close();
+    else if (tol_name == "stat")  tol = DiffTolerance::statistical();
+    else { usage(); return 2; }
+
+    std::vector<std::string> kernels;
+    if (kernel == "all") kernels = {"population", "synapse", "bg_replay"};
+    else kernels = {kernel};
+
+    int failed = 0;
+    for (const auto& k : kernels) {
+        std::string ka = a, kb = b;
+        if (ka.empty()) ka = k == "bg_replay" ? "stepwise" : "reference";
+        if (kb.empty()) kb = k == "population" ? "current" : k == "synapse" ? "csr" : "batch";
+
+        int pass = 0;
+        double ns_a = 0.0, ns_b = 0.0, worst_state = 0.0, worst_ks = 0.0;
+        for (int s = 0; s < seeds; ++s) {
+            DiffScenario sc = random_scenario(seed0 + static_cast<uint32_t>(s));
+            sc.steps = steps;
+            if (!delays) sc.max_delay = 1;
+            if (!nmda) sc.nmda = false;
+            DiffReport r = run_differential(k, ka, kb, sc, tol);
+            if (verbose || !r.passed) printf("  %s\n", r.summary().c_str());
+            if (r.passed) ++pass;
+            ns_a += r.ns_per_step_a;
+            ns_b += r.ns_per_step_b;
+            worst_state = std::max(worst_state, r.max_abs_state);
+            worst_ks = std::max({worst_ks, r.rate_ks, r.isi_ks});
+            if (!r.failure.empty() && r.failure.rfind("unknown", 0) == 0) break;
+        }
+        failed += seeds - pass;
+        printf("%-10s %s vs %s [%s]: %d/%d seeds pass, worst state |d| %.3g, worst KS %.3f, "
+               "%.0f vs %.0f ns/step (%.2fx)\n",
+               k.c_str(), ka.c_str(), kb.c_str(), tol_name.c_str(), pass, seeds, worst_state, worst_ks,
+               ns_a / seeds, ns_b / seeds, ns_b > 0.0 ? ns_a / ns_b : 0.0);
+    }
+    return failed > 0 ? 1 : 0;
+}
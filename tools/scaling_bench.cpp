@@ -0,0 +1,210 @@
+/**
+ * scaling_bench — 合成脑强/弱扩展基准 (neurons·steps/s vs 线程数)
+ *
+ * 用 SyntheticBrain 生成指定规模的脑, 在不同线程数下用常驻线程池推进:
+ *   strong  总规模固定 (regions × neurons), 线程数递增; 效率 = T1 / (T × Tn)
+ *   weak    每线程的区域数固定 (regions 为每线程区域数), 总规模随线程数增长;
+ *           效率 = 吞吐(n) / (n × 吞吐(1))
+ *
+ * 每个线程数重新构造同一种子的脑 (拓扑与驱动相同), 预热后计时 steps 步。
+ * 计时含 SyntheticBrain::step (背景驱动注入 + 引擎一步) 与每步 O(N) 的发放计数。
+ *
+ * 用法:
+ *   scaling_bench [--mode strong|weak|both] [--threads 1,2,4] [--regions 16]
+ *                 [--neurons 10000] [--steps 200] [--warmup 50] [--density 0.2]
+ *                 [--calibrate ROUNDS] [--no-pin] [--seed 1] [--json out.json]
+ *
+ *   --threads     逗号分隔的线程数列表 (默认 1, 2, 4, ... 至硬件线程数)
+ *   --calibrate   计时前按 target 5 Hz 校准驱动的轮数 (默认 0 = 不校准;
+ *                 大脑上每轮 ~250 步, 代价可观)
+ */
+
+#include "engine/synthetic_brain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wuyun;
+using Clock = std::chrono::steady_clock;
+
+struct ScalingOptions {
+    std::string mode = "both";
+    std::vector<int> threads;
+    size_t  regions   = 16;
+    size_t  neurons   = 10000;
+    int32_t steps     = 200;
+    int32_t warmup    = 50;
+    float   density   = 0.2f;
+    int     calibrate = 0;
+    bool    pin       = true;
+    uint32_t seed     = 1;
+    std::string json_path;
+};
+
+struct ScalingPoint {
+    std::string mode;
+    int     threads = 1;
+    size_t  regions = 0;
+    size_t  neurons = 0;        // 总神经元数
+    size_t  projections = 0;
+    double  build_ms = 0.0;
+    double  ms_per_step = 0.0;
+    double  neuron_steps_per_sec = 0.0;
+    double  mean_rate_hz = 0.0;
+    double  efficiency = 1.0;
+};
+
+static ScalingPoint run_point(const ScalingOptions& opt, const std::string& mode,
+                              int n_threads, size_t n_regions) {
+    SyntheticBrainConfig c;
+    c.n_regions          = n_regions;
+    c.neurons_per_region = opt.neurons;
+    c.projection_density = opt.density;
+    c.seed               = opt.seed;
+
+    ScalingPoint p;
+    p.mode    = mode;
+    p.threads = n_threads;
+    p.regions = n_regions;
+
+    auto t0 = Clock::now();
+    SyntheticBrain brain(c);
+    p.build_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    p.neurons     = brain.total_neurons();
+    p.projections = brain.num_projections();
+
+    brain.engine().use_worker_pool(n_threads, 1000, opt.pin);
+    if (opt.calibrate > 0) brain.calibrate(opt.calibrate, 200);
+    brain.run(opt.warmup);
+    brain.engine().rebalance_worker_pool();
+
+    auto t1 = Clock::now();
+    auto rates = brain.measure_rates(opt.steps);
+    double sec = std::chrono::duration<double>(Clock::now() - t1).count();
+
+    p.ms_per_step = sec * 1000.0 / opt.steps;
+    p.neuron_steps_per_sec = sec > 0.0 ? static_cast<double>(p.neurons) * opt.steps / sec : 0.0;
+    double weighted = 0.0;
+    for (size_t i = 0; i < rates.size(); ++i)
+        weighted += static_cast<double>(rates[i]) * brain.engine().region(i).n_neurons();
+    p.mean_rate_hz = p.neurons > 0 ? weighted / p.neurons : 0.0;
+    return p;
+}
+
+static void print_point(const ScalingPoint& p) {
+    printf("%-7s %7d %8zu %10zu %8zu %10.0f %11.3f %14.3e %8.2f %7.1f%%\n", p.mode.c_str(), p.threads,
+           p.regions, p.neurons, p.projections, p.build_ms, p.ms_per_step, p.neuron_steps_per_sec,
+           p.mean_rate_hz, p.efficiency * 100.0);
+    fflush(stdout);
+}
+
+static std::vector<ScalingPoint> run_series(const ScalingOptions& opt, const std::string& mode) {
+    std::vector<ScalingPoint> out;
+    for (int t : opt.threads) {
+        size_t R = (mode == "weak") ? opt.regions * static_cast<size_t>(t) : opt.regions;
+        ScalingPoint p = run_point(opt, mode, t, R);
+        if (!out.empty()) {
+            const ScalingPoint& base = out.front();
+            double per_thread = base.neuron_steps_per_sec / base.threads;
+            p.efficiency = per_thread > 0.0 ? p.neuron_steps_per_sec / (per_thread * p.threads) : 0.0;
+        }
+        print_point(p);
+        out.push_back(p);
+    }
+    return out;
+}
+
+static std::string to_json(const std::vector<ScalingPoint>& pts, const ScalingOptions& opt) {
+    std::ostringstream os;
+    os.precision(6);
+    os << "{\n  \"schema\": 1,\n  \"neurons_per_region\": " << opt.neurons
+       << ", \"steps\": " << opt.steps << ", \"density\": " << opt.density
+       << ", \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n  \"points\": [\n";
+    for (size_t i = 0; i < pts.size(); ++i) {
+        const auto& p = pts[i];
+        os << "    {\"mode\": \"" << p.mode << "\", \"threads\": " << p.threads
+           << ", \"regions\": " << p.regions << ", \"neurons\": " << p.neurons
+           << ", \"projections\": " << p.projections << ", \"build_ms\": " << p.build_ms
+           << ", \"ms_per_step\": " << p.ms_per_step
+           << ", \"neuron_steps_per_sec\": " << p.neuron_steps_per_sec
+           << ", \"mean_rate_hz\": " << p.mean_rate_hz << ", \"efficiency\": " << p.efficiency << "}"
+           << (i + 1 < pts.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    return os.str();
+}
+
+static std::vector<int> parse_threads(const char* s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) {
+        int t = std::atoi(tok.c_str());
+        if (t > 0) out.push_back(t);
+    }
+    return out;
+}
+
+static void usage() {
+    printf("usage: scaling_bench [--mode strong|weak|both] [--threads 1,2,4] [--regions 16]\n"
+           "                     [--neurons 10000] [--steps 200] [--warmup 50] [--density 0.2]\n"
+           "                     [--calibrate ROUNDS] [--no-pin] [--seed 1] [--json out.json]\n");
+}
+
+int main(int argc, char* argv[]) {
+    ScalingOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto need = [&](const char* flag) -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", flag); std::exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--mode")      opt.mode = need("--mode");
+        else if (a == "--threads")   opt.threads = parse_threads(need("--threads"));
+        else if (a == "--regions")   opt.regions = std::max(std::atoi(need("--regions")), 1);
+        else if (a == "--neurons")   opt.neurons = std::max(std::atoi(need("--neurons")), 16);
+        else if (a == "--steps")     opt.steps = std::max(std::atoi(need("--steps")), 1);
+        else if (a == "--warmup")    opt.warmup = std::max(std::atoi(need("--warmup")), 0);
+        else if (a == "--density")   opt.density = static_cast<float>(std::atof(need("--density")));
+        else if (a == "--calibrate") opt.calibrate = std::max(std::atoi(need("--calibrate")), 0);
+        else if (a == "--no-pin")    opt.pin = false;
+        else if (a == "--seed")      opt.seed = static_cast<uint32_t>(std::atoi(need("--seed")));
+        else if (a == "--json")      opt.json_path = need("--json");
+        else { usage(); return (a == "--help" || a == "-h") ? 0 : 2; }
+    }
+    if (opt.mode != "strong" && opt.mode != "weak" && opt.mode != "both") { usage(); return 2; }
+    if (opt.threads.empty()) {
+        int hw = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+        for (int t = 1; t < hw; t *= 2) opt.threads.push_back(t);
+        opt.threads.push_back(hw);
+    }
+    std::sort(opt.threads.begin(), opt.threads.end());
+    opt.threads.erase(std::unique(opt.threads.begin(), opt.threads.end()), opt.threads.end());
+
+    printf("=== WuYun scaling benchmark (%zu neurons/region, %d steps, %u hardware threads) ===\n",
+           opt.neurons, opt.steps, std::thread::hardware_concurrency());
+    printf("%-7s %7s %8s %10s %8s %10s %11s %14s %8s %8s\n", "mode", "threads", "regions", "neurons",
+           "proj", "build(ms)", "ms/step", "neuron-step/s", "rate(Hz)", "eff");
+
+    std::vector<ScalingPoint> all;
+    for (const char* mode : {"strong", "weak"}) {
+        if (opt.mode != "both" && opt.mode != mode) continue;
+        auto pts = run_series(opt, mode);
+        all.insert(all.end(), pts.begin(), pts.end());
+    }
+
+    if (!opt.json_path.empty()) {
+        std::ofstream f(opt.json_path);
+        f << to_json(all, opt);
+        if (!f) { fprintf(stderr, "cannot write %s\n", opt.json_path.c_str()); return 2; }
+        printf("\nwrote %s\n", opt.json_path.c_str());
+    }
+    return 0;
+}
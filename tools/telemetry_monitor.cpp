@@ -0,0 +1,125 @@
+/**
+ * telemetry_monitor — attach 到运行中仿真的实时遥测环 (见 core/telemetry.h)
+ *
+ * 用法:
+ *   telemetry_monitor NAME [--once] [--interval 200] [--idle 10] [--top 5] [--from-latest]
+ *
+ *   NAME           SimulationEngine::enable_telemetry / ClosedLoopAgent::enable_telemetry 的段名
+ *   --once         打印最新一帧后退出
+ *   --interval     轮询间隔 (ms)
+ *   --idle         连续这么多秒无新帧即退出 (0 = 一直等); 段尚未创建时同样等待
+ *   --top          每帧列出发放最多的前 K 个区域
+ *   --from-latest  跳过环中已有的旧帧, 只看 attach 之后发布的
+ *
+ * 只读映射, 随时 Ctrl-C 退出, 不影响仿真进程。
+ */
+
+#include "core/telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wuyun;
+
+static void usage() {
+    printf("usage: telemetry_monitor NAME [--once] [--interval 200] [--idle 10] [--top 5] "
+           "[--from-latest]\n");
+}
+
+static void print_frame(const TelemetryFrame& f, const std::vector<std::string>& names, int top) {
+    uint64_t total = 0;
+    std::vector<size_t> order;
+    for (size_t i = 0; i < f.n_regions; ++i) {
+        total += f.spikes[i];
+        order.push_back(i);
+    }
+    size_t k = std::min(order.size(), static_cast<size_t>(std::max(top, 0)));
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(),
+                      [&](size_t a, size_t b) { return f.spikes[a] > f.spikes[b]; });
+
+    printf("#%-6llu t=%-8lld %7.1fs  %8.1f us/step (max %8.1f)  spikes %-8llu "
+           "DA %.3f NE %.3f 5HT %.3f ACh %.3f",
+           static_cast<unsigned long long>(f.seq), static_cast<long long>(f.step), f.wall_s,
+           f.step_us_mean, f.step_us_max, static_cast<unsigned long long>(total),
+           f.da, f.ne, f.sht, f.ach);
+    if (!std::isnan(f.reward_rate)) {
+        printf("  | agent %lld  reward %+.3f  BG DA %.3f |D1| %.2f |D2| %.2f",
+               static_cast<long long>(f.agent_steps), f.reward_rate, f.bg_da,
+               f.bg_w_d1_norm, f.bg_w_d2_norm);
+    }
+    printf("\n");
+    for (size_t j = 0; j < k && f.spikes[order[j]] > 0; ++j) {
+        size_t r = order[j];
+        printf("        %-16s %u\n", r < names.size() ? names[r].c_str() : "?", f.spikes[r]);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string name;
+    bool once = false, from_latest = false;
+    int interval_ms = 200, idle_s = 10, top = 5;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto need = [&](const char* flag) -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", flag); std::exit(2); }
+            return argv[++i];
+        };
+        if      (arg == "--once")        once = true;
+        else if (arg == "--from-latest") from_latest = true;
+        else if (arg == "--interval")    interval_ms = std::max(std::atoi(need("--interval")), 1);
+        else if (arg == "--idle")        idle_s = std::max(std::atoi(need("--idle")), 0);
+        else if (arg == "--top")         top = std::atoi(need("--top"));
+        else if (!arg.empty() && arg[0] != '-' && name.empty()) name = arg;
+        else { usage(); return 2; }
+    }
+    if (name.empty()) { usage(); return 2; }
+
+    using clock = std::chrono::steady_clock;
+    auto last_activity = clock::now();
+    auto idle_expired = [&] {
+        return idle_s > 0 && clock::now() - last_activity > std::chrono::seconds(idle_s);
+    };
+    auto nap = [&] { std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms)); };
+
+    TelemetryReader reader;
+    while (!reader.attach(name)) {
+        if (once || idle_expired()) {
+            fprintf(stderr, "telemetry segment '%s' not found\n", name.c_str());
+            return 1;
+        }
+        nap();
+    }
+    printf("attached '%s': %zu regions, capacity %u frames, every %u steps\n", name.c_str(),
+           reader.region_names().size(), reader.capacity(), reader.publish_every());
+
+    if (once) {
+        TelemetryFrame f;
+        if (!reader.latest(f)) { printf("(no frames yet)\n"); return 0; }
+        print_frame(f, reader.region_names(), top);
+        return 0;
+    }
+
+    if (from_latest) reader.skip_to_latest();
+    std::vector<TelemetryFrame> frames;
+    uint64_t lost_reported = 0;
+    while (!idle_expired()) {
+        frames.clear();
+        if (reader.poll(frames) > 0) last_activity = clock::now();
+        for (const auto& f : frames) print_frame(f, reader.region_names(), top);
+        if (reader.lost() != lost_reported) {
+            printf("  (%llu frames overwritten before read)\n",
+                   static_cast<unsigned long long>(reader.lost() - lost_reported));
+            lost_reported = reader.lost();
+        }
+        fflush(stdout);
+        nap();
+    }
+    printf("no new frames for %d s, detaching\n", idle_s);
+    return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * trace_replay — 外部输入录制/回放 (纯脑基准)
+ *
+ * 用法:
+ *   trace_replay record out.wyit [--steps 200] [--scale 1] [--seed 42] [--no-replay]
+ *       在 GridWorld 中运行 ClosedLoopAgent, 录制全部外部注入
+ *   trace_replay replay in.wyit [--reps 3] [--threads N] [--profile trace.json]
+ *       每轮新建同规模的脑 (brain_scale 取自 trace meta), 按 trace 驱动;
+ *       报告 ms/step 中位数与发放总数 (A/B 对比时两边应一致)
+ *   trace_replay info in.wyit
+ *
+ * 计时只含 InputTraceReplayer::run (输入注入 + engine.step), 不含构脑。
+ * --no-replay 关闭清醒 SWR 回放 (引擎外的 BG 批核不在 trace 中, 关闭后回放逐位复现原运行)。
+ */
+
+#include "engine/closed_loop_agent.h"
+#include "engine/grid_world_env.h"
+#include "engine/input_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wuyun;
+using Clock = std::chrono::steady_clock;
+
+static void usage() {
+    printf("usage: trace_replay record out.wyit [--steps 200] [--scale 1] [--seed 42] [--no-replay]\n"
+           "       trace_replay replay in.wyit [--reps 3] [--threads N] [--profile trace.json]\n"
+           "       trace_replay info in.wyit\n");
+}
+
+/** meta 中 "key=value" 的整数值 */
+static int meta_int(const std::string& meta, const std::string& key, int fallback) {
+    auto pos = meta.find(key + "=");
+    if (pos == std::string::npos) return fallback;
+    return std::atoi(meta.c_str() + pos + key.size() + 1);
+}
+
+static std::unique_ptr<ClosedLoopAgent> make_agent(int scale, uint32_t seed, bool replay) {
+    GridWorldConfig world;
+    world.seed = seed;
+    AgentConfig cfg;
+    cfg.brain_scale = scale;
+    cfg.enable_replay = replay;
+    return std::make_unique<ClosedLoopAgent>(std::make_unique<GridWorldEnv>(world), cfg);
+}
+
+static int cmd_record(const std::string& path, int steps, int scale, uint32_t seed, bool replay) {
+    auto agent = make_agent(scale, seed, replay);
+    InputTrace trace;
+    // 回放只需要 brain_scale 与 replay 开关来重建同结构的脑; 种子仅作记录
+    trace.begin(agent->brain(), "brain_scale=" + std::to_string(scale) + " seed=" + std::to_string(seed) +
+                                " replay=" + std::to_string(replay ? 1 : 0));
+    agent->set_input_trace(&trace);
+    auto t0 = Clock::now();
+    agent->run(steps);
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    agent->set_input_trace(nullptr);
+
+    if (!trace.save(path)) {
+        fprintf(stderr, "cannot write %s\n", path.c_str());
+        return 2;
+    }
+    printf("recorded %d agent steps (%.2f s, food rate %.3f) → %s\n", steps, sec, agent->food_rate(steps),
+           path.c_str());
+    printf("  %llu brain steps, %zu records, %.1f KiB (%.0f B/step)\n",
+           static_cast<unsigned long long>(trace.num_steps()), trace.num_records(), trace.bytes() / 1024.0,
+           trace.num_steps() ? static_cast<double>(trace.bytes()) / trace.num_steps() : 0.0);
+    return 0;
+}
+
+static int cmd_replay(const std::string& path, int reps, int threads, const std::string& profile_path) {
+    InputTrace trace;
+    std::string err;
+    if (!trace.load(path, &err)) {
+        fprintf(stderr, "cannot read trace %s: %s\n", path.c_str(), err.c_str());
+        return 2;
+    }
+    int scale = meta_int(trace.meta(), "brain_scale", 1);
+    bool replay = meta_int(trace.meta(), "replay", 1) != 0;
+    printf("trace %s: %llu steps, %zu records [%s]\n", path.c_str(),
+           static_cast<unsigned long long>(trace.num_steps()), trace.num_records(), trace.meta().c_str());
+
+    std::vector<double> ms_per_step;
+    uint64_t spikes_first = 0;
+    bool consistent = true;
+    for (int r = 0; r < reps; ++r) {
+        auto agent = make_agent(scale, 42, replay);
+        SimulationEngine& eng = agent->brain();
+        std::string why;
+        if (!trace.matches(eng, &why)) {
+            fprintf(stderr, "trace does not match brain_scale=%d: %s\n", scale, why.c_str());
+            return 2;
+        }
+        if (threads > 0) eng.use_worker_pool(threads);
+        uint64_t spikes = 0;
+        eng.set_callback([&spikes](int32_t, SimulationEngine& e) {
+            for (size_t i = 0; i < e.num_regions(); ++i)
+                for (uint8_t f : e.region(i).fired()) spikes += f;
+        });
+        bool profile = !profile_path.empty() && r + 1 == reps;
+        if (profile) eng.profiler().enable();
+
+        InputTraceReplayer replayer(trace, eng);
+        auto t0 = Clock::now();
+        uint64_t n = replayer.run();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (!replayer.ok()) {
+            fprintf(stderr, "replay stopped after %llu steps: %s\n",
+                    static_cast<unsigned long long>(n), replayer.error().c_str());
+            return 2;
+        }
+        ms_per_step.push_back(n ? ms / static_cast<double>(n) : 0.0);
+        printf("  rep %d: %llu steps, %.3f ms/step, %llu spikes\n", r + 1, static_cast<unsigned long long>(n),
+               ms_per_step.back(), static_cast<unsigned long long>(spikes));
+        if (r == 0) spikes_first = spikes;
+        else if (spikes != spikes_first) consistent = false;
+
+        if (profile) {
+            printf("%s", eng.profiler().summary().c_str());
+            if (!eng.profiler().write_chrome_trace(profile_path))
+                fprintf(stderr, "cannot write %s\n", profile_path.c_str());
+        }
+    }
+    std::sort(ms_per_step.begin(), ms_per_step.end());
+    printf("median %.3f ms/step, min %.3f ms/step%s\n", ms_per_step[ms_per_step.size() / 2],
+           ms_per_step.front(), consistent ? "" : "  (WARNING: spike counts differ between reps)");
+    return consistent ? 0 : 1;
+}
+
+static int cmd_info(const std::string& path) {
+    InputTrace trace;
+    std::string err;
+    if (!trace.load(path, &err)) {
+        fprintf(stderr, "cannot read trace %s: %s\n", path.c_str(), err.c_str());
+        return 2;
+    }
+    printf("%s: %zu regions, %llu steps, %zu records, %.1f KiB [%s]\n", path.c_str(), trace.num_regions(),
+           static_cast<unsigned long long>(trace.num_steps()), trace.num_records(), trace.bytes() / 1024.0,
+           trace.meta().c_str());
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) { usage(); return 2; }
+    std::string cmd = argv[1], path = argv[2];
+    int steps = 200, scale = 1, reps = 3, threads = 0;
+    uint32_t seed = 42;
+    bool replay = true;
+    std::string profile_path;
+    for (int i = 3; i < argc; ++i) {
+        std::string a = argv[i];
+        auto need = [&](const char* flag) -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", flag); std::exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--steps")     steps = std::max(std::atoi(need("--steps")), 1);
+        else if (a == "--scale")     scale = std::max(std::atoi(need("--scale")), 1);
+        else if (a == "--seed")      seed = static_cast<uint32_t>(std::atoi(need("--seed")));
+        else if (a == "--no-replay") replay = false;
+        else if (a == "--reps")      reps = std::max(std::atoi(need("--reps")), 1);
+        else if (a == "--threads")   threads = std::max(std::atoi(need("--threads")), 0);
+        else if (a == "--profile")   profile_path = need("--profile");
+        else { usage(); return 2; }
+    }
+
+    if (cmd == "record") return cmd_record(path, steps, scale, seed, replay);
+    if (cmd == "replay") return cmd_replay(path, reps, threads, profile_path);
+    if (cmd == "info")   return cmd_info(path);
+    usage();
+    return 2;
+}
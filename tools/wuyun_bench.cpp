@@ -0,0 +1,643 @@
+/**
+ * wuyun_bench — 分层性能基准 + JSON 输出 + 基线回归比较
+ *
+ * 层级 (名称前缀, 可用 --filter 子串选择):
+ *   kernel/   NeuronPopulation step, SynapseGroup deliver+compute, STDP, DA-STDP
+ *   region/   CorticalRegion, BasalGanglia (DA-STDP 开), Hippocampus, Cerebellum
+ *   engine/   ClosedLoopAgent::build_brain 的完整脑 (brain_scale 1/3/10) 单步
+ *   e2e/      agent_step 吞吐, GA 单代耗时
+ *
+ * 计时: 每项先预热, 再跑 reps 轮, 每轮 iters 次; 报告每次迭代耗时的中位数/最小值 (us)。
+ *   输入模式预先生成 (循环使用), 随机数生成不计入计时。
+ *
+ * 用法:
+ *   wuyun_bench [--quick] [--filter S] [--reps N] [--json out.json]
+ *               [--compare baseline.json] [--threshold 0.15]
+ *
+ *   --quick       缩短迭代数 (CI 冒烟)
+ *   --json        写机器可读结果 (可直接作为之后 --compare 的基线)
+ *   --compare     与基线逐项比较中位数; 变慢超过 threshold 判为回归, 进程返回 1
+ *   --absolute    比较原始耗时 (默认比较主机归一化的比值)
+ *
+ * 主机归一化: 启动时先跑一段固定的参照负载 (不调用项目代码, 见 calibrate_host),
+ *   每项的 ratio = median_us / calib_us。--compare 默认比较 ratio, 基线可在别的机器上
+ *   生成; JSON 的 host 段记录生成基线的 CPU/线程数/编译器。参照负载只能抵消整体快慢,
+ *   微架构差异 (缓存大小、向量宽度) 仍会让个别项偏移, 门限应留有余量。
+ */
+
+#include "core/types.h"
+#include "core/population.h"
+#include "core/synapse_group.h"
+#include "plasticity/da_stdp.h"
+#include "region/cortical_region.h"
+#include "region/subcortical/basal_ganglia.h"
+#include "region/subcortical/cerebellum.h"
+#include "region/limbic/hippocampus.h"
+#include "engine/closed_loop_agent.h"
+#include "engine/grid_world_env.h"
+#include "genome/evolution.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wuyun;
+using Clock = std::chrono::steady_clock;
+
+// =============================================================================
+// 框架
+// =============================================================================
+
+struct BenchOptions {
+    bool        quick = false;
+    int         reps  = 5;
+    std::string filter;
+    std::string json_path;
+    std::string compare_path;
+    double      threshold = 0.15;
+    bool        absolute  = false;   // --compare 比较原始耗时而非 ratio
+};
+
+struct BenchResult {
+    std::string name;
+    std::string layer;
+    int         iters = 0;
+    int         reps  = 0;
+    double      median_us = 0.0;   // 每次迭代
+    double      min_us    = 0.0;
+    std::string unit;              // 一次迭代是什么 ("step", "agent_step", "generation")
+    std::vector<std::pair<std::string, double>> extra;
+};
+
+struct Bench {
+    std::string name;
+    std::string unit;
+    int iters;        // 完整模式
+    int quick_iters;  // --quick
+    /** 建立状态, 返回一次迭代的函数; extra 可写入规模等附加信息 */
+    std::function<std::function<void()>(std::vector<std::pair<std::string, double>>& extra)> setup;
+};
+
+static std::string layer_of(const std::string& name) {
+    return name.substr(0, name.find('/'));
+}
+
+static BenchResult run_bench(const Bench& b, const BenchOptions& opt) {
+    BenchResult r;
+    r.name  = b.name;
+    r.layer = layer_of(b.name);
+    r.unit  = b.unit;
+    r.iters = std::max(opt.quick ? b.quick_iters : b.iters, 1);
+    r.reps  = opt.quick ? std::min(opt.reps, 3) : opt.reps;
+    if (b.iters == 1) r.reps = std::min(r.reps, 3);   // 秒级的单次迭代 (GA 一代)
+
+    auto step = b.setup(r.extra);
+    for (int i = 0; i < r.iters / 10; ++i) step();   // 预热
+
+    std::vector<double> per_iter;
+    for (int rep = 0; rep < r.reps; ++rep) {
+        auto t0 = Clock::now();
+        for (int i = 0; i < r.iters; ++i) step();
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+        per_iter.push_back(us / r.iters);
+    }
+    std::sort(per_iter.begin(), per_iter.end());
+    r.median_us = per_iter[per_iter.size() / 2];
+    r.min_us    = per_iter.front();
+    return r;
+}
+
+// =============================================================================
+// 主机校准
+// =============================================================================
+
+/**
+ * 固定参照负载: 两个 4 MB 数组的流式乘加 (访存) + 一条 xorshift 依赖链 (整数延迟),
+ * 约 10 ms。不调用项目代码, 项目改动不会影响它; 返回每轮耗时中位数 (us)。
+ */
+static double calibrate_host(int reps) {
+    std::vector<float> a(1u << 20, 1.0f), b(1u << 20, 0.5f);
+    volatile uint64_t sink = 0;
+    std::vector<double> per_rep;
+    for (int rep = -1; rep < reps; ++rep) {   // rep = -1: 预热
+        auto t0 = Clock::now();
+        for (int pass = 0; pass < 8; ++pass) {
+            for (size_t i = 0; i < a.size(); ++i) a[i] = a[i] * 0.999f + b[i];
+        }
+        uint64_t x = 88172645463325252ull;
+        for (int i = 0; i < (1 << 22); ++i) { x ^= x << 13; x ^= x >> 7; x ^= x << 17; }
+        sink = sink + x + static_cast<uint64_t>(a[static_cast<size_t>(rep + 1)]);
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+        if (rep >= 0) per_rep.push_back(us);
+    }
+    std::sort(per_rep.begin(), per_rep.end());
+    return per_rep[per_rep.size() / 2];
+}
+
+/** CPU 型号 (Linux: /proc/cpuinfo; 其它平台 "unknown") */
+static std::string host_cpu() {
+    std::ifstream f("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t c = line.find(':');
+            if (c != std::string::npos) return line.substr(line.find_first_not_of(' ', c + 1));
+        }
+    }
+    return "unknown";
+}
+
+static std::string host_compiler() {
+#if defined(__clang__)
+    return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+/** 预生成的随机发放模式 (循环使用) */
+static std::vector<std::vector<uint8_t>> make_fire_patterns(size_t n, float p, size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    std::vector<std::vector<uint8_t>> pats(count, std::vector<uint8_t>(n, 0));
+    for (auto& pat : pats)
+        for (auto& f : pat) f = (u(rng) < p) ? 1 : 0;
+    return pats;
+}
+
+/** 预生成的随机注入电流 (稀疏) */
+static std::vector<std::vector<float>> make_current_patterns(size_t n, float p, float amp,
+                                                             size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    std::vector<std::vector<float>> pats(count, std::vector<float>(n, 0.0f));
+    for (auto& pat : pats)
+        for (auto& c : pat) c = (u(rng) < p) ? amp * (0.5f + u(rng)) : 0.0f;
+    return pats;
+}
+
+/** 随机稀疏连接 (每个 pre 固定出度) */
+static std::unique_ptr<SynapseGroup> make_synapses(size_t n_pre, size_t n_post, size_t fanout, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> post_dist(0, static_cast<int32_t>(n_post - 1));
+    size_t n_syn = n_pre * fanout;
+    std::vector<int32_t> pre(n_syn), post(n_syn), delays(n_syn, 1);
+    std::vector<float> w(n_syn, 0.5f);
+    for (size_t i = 0; i < n_pre; ++i) {
+        for (size_t s = 0; s < fanout; ++s) {
+            pre[i * fanout + s]  = static_cast<int32_t>(i);
+            post[i * fanout + s] = post_dist(rng);
+        }
+    }
+    return std::make_unique<SynapseGroup>(n_pre, n_post, pre, post, w, delays, AMPA_PARAMS);
+}
+
+static constexpr size_t N_PATTERNS = 64;
+
+// =============================================================================
+// kernel/
+// =============================================================================
+
+static Bench bench_population(size_t n, int iters) {
+    return {"kernel/population/n=" + std::to_string(n), "step", iters, std::max(iters / 10, 1),
+        [n](auto& extra) {
+            auto pop  = std::make_shared<NeuronPopulation>(n, L23_PYRAMIDAL_PARAMS());
+            auto pats = std::make_shared<std::vector<std::vector<float>>>(
+                make_current_patterns(n, 0.3f, 12.0f, N_PATTERNS, 42));
+            extra.push_back({"neurons", static_cast<double>(n)});
+            return [pop, pats, t = 0]() mutable {
+                const auto& cur = (*pats)[t % N_PATTERNS];
+                for (size_t i = 0; i < cur.size(); ++i)
+                    if (cur[i] != 0.0f) pop->inject_basal(i, cur[i]);
+                pop->step(t++);
+            };
+        }};
+}
+
+static Bench bench_synapse(size_t n_pre, size_t n_post, size_t fanout, int iters) {
+    return {"kernel/synapse/pre=" + std::to_string(n_pre) + ",fanout=" + std::to_string(fanout),
+        "step", iters, std::max(iters / 10, 1),
+        [=](auto& extra) {
+            std::shared_ptr<SynapseGroup> sg = make_synapses(n_pre, n_post, fanout, 123);
+            auto pats  = std::make_shared<std::vector<std::vector<uint8_t>>>(
+                make_fire_patterns(n_pre, 0.05f, N_PATTERNS, 7));
+            auto types = std::make_shared<std::vector<int8_t>>(n_pre, 0);
+            auto v     = std::make_shared<std::vector<float>>(n_post, -65.0f);
+            extra.push_back({"synapses", static_cast<double>(n_pre * fanout)});
+            return [sg, pats, types, v, t = 0]() mutable {
+                sg->deliver_spikes((*pats)[t++ % N_PATTERNS], *types);
+                sg->step_and_compute(*v);
+            };
+        }};
+}
+
+static Bench bench_stdp(size_t n_pre, size_t n_post, size_t fanout, int iters) {
+    return {"kernel/stdp/pre=" + std::to_string(n_pre) + ",fanout=" + std::to_string(fanout),
+        "step", iters, std::max(iters / 10, 1),
+        [=](auto& extra) {
+            std::shared_ptr<SynapseGroup> sg = make_synapses(n_pre, n_post, fanout, 321);
+            sg->enable_stdp(STDPParams{});
+            auto pre  = std::make_shared<std::vector<std::vector<uint8_t>>>(
+                make_fire_patterns(n_pre, 0.05f, N_PATTERNS, 11));
+            auto post = std::make_shared<std::vector<std::vector<uint8_t>>>(
+                make_fire_patterns(n_post, 0.05f, N_PATTERNS, 13));
+            extra.push_back({"synapses", static_cast<double>(n_pre * fanout)});
+            return [sg, pre, post, t = 0]() mutable {
+                sg->apply_stdp((*pre)[t % N_PATTERNS], (*post)[t % N_PATTERNS], t);
+                ++t;
+            };
+        }};
+}
+
+static Bench bench_da_stdp(size_t n_neurons, size_t n_syn, int iters) {
+    return {"kernel/da_stdp/syn=" + std::to_string(n_syn), "step", iters, std::max(iters / 10, 1),
+        [=](auto& extra) {
+            struct State {
+                DASTDPProcessor proc;
+                std::vector<float> w;
+                std::vector<int32_t> pre_ids, post_ids;
+                std::vector<std::vector<float>> pre_t, post_t;
+                State(size_t n_syn) : proc(n_syn, DASTDPParams{}), w(n_syn, 0.5f),
+                                      pre_ids(n_syn), post_ids(n_syn) {}
+            };
+            auto s = std::make_shared<State>(n_syn);
+            std::mt19937 rng(456);
+            std::uniform_int_distribution<int32_t> nd(0, static_cast<int32_t>(n_neurons - 1));
+            std::uniform_real_distribution<float> td(0.0f, 100.0f);
+            for (size_t k = 0; k < n_syn; ++k) { s->pre_ids[k] = nd(rng); s->post_ids[k] = nd(rng); }
+            s->pre_t.assign(N_PATTERNS, std::vector<float>(n_neurons));
+            s->post_t.assign(N_PATTERNS, std::vector<float>(n_neurons));
+            for (size_t p = 0; p < N_PATTERNS; ++p) {
+                for (size_t i = 0; i < n_neurons; ++i) { s->pre_t[p][i] = td(rng); s->post_t[p][i] = td(rng); }
+            }
+            extra.push_back({"synapses", static_cast<double>(n_syn)});
+            return [s, t = 0]() mutable {
+                size_t p = t % N_PATTERNS;
+                s->proc.update_traces(s->pre_t[p].data(), s->post_t[p].data(),
+                                      s->pre_ids.data(), s->post_ids.data());
+                s->proc.apply_da_modulation(s->w.data(), (t % 10 == 0) ? 0.5f : 0.0f);
+                ++t;
+            };
+        }};
+}
+
+// =============================================================================
+// region/
+// =============================================================================
+
+/** 区域单步: 稀疏外部电流注入 + step */
+static Bench bench_region(const std::string& name, std::function<std::shared_ptr<BrainRegion>()> make,
+                          float p, float amp, int iters) {
+    return {"region/" + name, "step", iters, std::max(iters / 10, 1),
+        [=](auto& extra) {
+            std::shared_ptr<BrainRegion> region = make();
+            auto pats = std::make_shared<std::vector<std::vector<float>>>(
+                make_current_patterns(region->n_neurons(), p, amp, N_PATTERNS, 99));
+            extra.push_back({"neurons", static_cast<double>(region->n_neurons())});
+            return [region, pats, t = 0]() mutable {
+                region->inject_external((*pats)[t % N_PATTERNS]);
+                region->step(t++);
+            };
+        }};
+}
+
+/** BG: 皮层脉冲事件驱动 (经 DA-STDP 输入映射) + 周期性 DA 奖励 */
+static Bench bench_basal_ganglia(int iters) {
+    return {"region/basal_ganglia/da_stdp", "step", iters, std::max(iters / 10, 1),
+        [](auto& extra) {
+            BasalGangliaConfig cfg;
+            cfg.da_stdp_enabled = true;
+            auto bg = std::make_shared<BasalGanglia>(cfg);
+            constexpr uint32_t CTX = 7;
+            auto evts = std::make_shared<std::vector<std::vector<SpikeEvent>>>(N_PATTERNS);
+            std::mt19937 rng(5);
+            std::uniform_int_distribution<uint32_t> nd(0, 199);
+            for (auto& step_evts : *evts) {
+                for (int k = 0; k < 12; ++k) {
+                    SpikeEvent e{};
+                    e.region_id = CTX;
+                    e.neuron_id = nd(rng);
+                    step_evts.push_back(e);
+                }
+            }
+            extra.push_back({"neurons", static_cast<double>(bg->n_neurons())});
+            return [bg, evts, t = 0]() mutable {
+                bg->receive_spikes((*evts)[t % N_PATTERNS]);
+                bg->set_da_level((t % 50 == 0) ? 0.8f : 0.3f);
+                bg->step(t++);
+            };
+        }};
+}
+
+// =============================================================================
+// engine/ + e2e/
+// =============================================================================
+
+static AgentConfig bench_agent_config(int scale) {
+    AgentConfig cfg;
+    cfg.brain_scale = scale;
+    return cfg;
+}
+
+static Bench bench_engine(int scale, int iters) {
+    return {"engine/brain_step/scale=" + std::to_string(scale), "step", iters, std::max(iters / 10, 1),
+        [scale](auto& extra) {
+            auto t0 = Clock::now();
+            auto agent = std::make_shared<ClosedLoopAgent>(
+                std::make_unique<GridWorldEnv>(GridWorldConfig{}), bench_agent_config(scale));
+            double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            SimulationEngine& eng = agent->brain();
+            size_t n = 0;
+            for (size_t i = 0; i < eng.num_regions(); ++i) n += eng.region(i).n_neurons();
+            extra.push_back({"neurons", static_cast<double>(n)});
+            extra.push_back({"regions", static_cast<double>(eng.num_regions())});
+            extra.push_back({"build_ms", build_ms});
+
+            BrainRegion* lgn = eng.find_region("LGN");
+            auto pats = std::make_shared<std::vector<std::vector<float>>>(
+                make_current_patterns(lgn ? lgn->n_neurons() : 0, 0.3f, 30.0f, N_PATTERNS, 17));
+            return [agent, lgn, pats, t = 0]() mutable {
+                if (lgn) lgn->inject_external((*pats)[t++ % N_PATTERNS]);
+                agent->brain().step();
+            };
+        }};
+}
+
+static Bench bench_agent(int iters) {
+    return {"e2e/agent_step/scale=1", "agent_step", iters, std::max(iters / 10, 1),
+        [](auto& extra) {
+            auto agent = std::make_shared<ClosedLoopAgent>(
+                std::make_unique<GridWorldEnv>(GridWorldConfig{}), bench_agent_config(1));
+            extra.push_back({"brain_steps_per_action",
+                             static_cast<double>(AgentConfig{}.brain_steps_per_action)});
+            return [agent]() { agent->agent_step(); };
+        }};
+}
+
+static Bench bench_ga_generation(size_t pop, size_t eval_steps) {
+    return {"e2e/ga_generation/pop=" + std::to_string(pop) + ",steps=" + std::to_string(eval_steps),
+        "generation", 1, 1,
+        [=](auto& extra) {
+            EvolutionConfig ecfg;
+            ecfg.population_size = pop;
+            ecfg.n_generations   = 1;
+            ecfg.eval_steps      = eval_steps;
+            ecfg.eval_seeds      = {42};
+            extra.push_back({"population", static_cast<double>(pop)});
+            extra.push_back({"eval_steps", static_cast<double>(eval_steps)});
+            return [ecfg]() {
+                EvolutionEngine ga(ecfg);
+                ga.run();
+            };
+        }};
+}
+
+static std::vector<Bench> all_benches(bool quick) {
+    std::vector<Bench> b;
+    b.push_back(bench_population(1000, 2000));
+    b.push_back(bench_population(10000, 500));
+    b.push_back(bench_population(100000, 50));
+    b.push_back(bench_synapse(1000, 1000, 100, 2000));
+    b.push_back(bench_synapse(10000, 10000, 100, 200));
+    b.push_back(bench_stdp(1000, 1000, 100, 1000));
+    b.push_back(bench_stdp(10000, 10000, 100, 100));
+    b.push_back(bench_da_stdp(1000, 10000, 2000));
+    b.push_back(bench_da_stdp(10000, 100000, 200));
+
+    b.push_back(bench_region("cortical/default",
+        [] { return std::make_shared<CorticalRegion>("V1", ColumnConfig{}); }, 0.2f, 20.0f, 2000));
+    b.push_back(bench_basal_ganglia(2000));
+    b.push_back(bench_region("hippocampus/default",
+        [] { return std::make_shared<Hippocampus>(HippocampusConfig{}); }, 0.2f, 25.0f, 2000));
+    b.push_back(bench_region("cerebellum/default",
+        [] { return std::make_shared<Cerebellum>(CerebellumConfig{}); }, 0.2f, 25.0f, 2000));
+
+    b.push_back(bench_engine(1, 1000));
+    b.push_back(bench_engine(3, 500));
+    b.push_back(bench_engine(10, 200));
+
+    b.push_back(bench_agent(300));
+    b.push_back(bench_ga_generation(quick ? 4 : 8, quick ? 100 : 300));
+    return b;
+}
+
+// =============================================================================
+// JSON
+// =============================================================================
+
+static std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static std::string to_json(const std::vector<BenchResult>& results, const BenchOptions& opt,
+                           double calib_us) {
+    std::ostringstream os;
+    os.precision(6);
+    os << "{\n  \"schema\": 2,\n  \"quick\": " << (opt.quick ? "true" : "false") << ",\n";
+    os << "  \"build\": {\"openmp\": "
+#ifdef WUYUN_OPENMP
+       << "true"
+#else
+       << "false"
+#endif
+       << ", \"profile\": "
+#ifdef WUYUN_PROFILE
+       << "true"
+#else
+       << "false"
+#endif
+       << "},\n";
+    os << "  \"host\": {\"cpu\": \"" << json_escape(host_cpu()) << "\", \"threads\": "
+       << std::thread::hardware_concurrency() << ", \"compiler\": \"" << json_escape(host_compiler())
+       << "\"},\n";
+    os << "  \"calib_us\": " << calib_us << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << "    {\"name\": \"" << json_escape(r.name) << "\", \"layer\": \"" << r.layer
+           << "\", \"unit\": \"" << r.unit << "\", \"iters\": " << r.iters << ", \"reps\": " << r.reps
+           << ", \"median_us\": " << r.median_us << ", \"min_us\": " << r.min_us
+           << ", \"per_sec\": " << (r.median_us > 0 ? 1e6 / r.median_us : 0.0)
+           << ", \"ratio\": " << r.median_us / calib_us;
+        for (const auto& kv : r.extra) os << ", \"" << kv.first << "\": " << kv.second;
+        os << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    return os.str();
+}
+
+struct Baseline {
+    std::map<std::string, double> median_us;   // name → median_us
+    bool        quick    = false;
+    double      calib_us = 0.0;                // schema 1 无此项 (只能比较原始耗时)
+    std::string cpu;
+};
+
+/** 读基线: 每项的 name → median_us, 以及 calib_us / host.cpu (本工具自己写出的格式) */
+static bool read_baseline(const std::string& path, Baseline& base) {
+    std::ifstream f(path);
+    if (!f) return false;
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string s = ss.str();
+    base.quick = s.find("\"quick\": true") != std::string::npos;
+
+    const std::string key_calib = "\"calib_us\": ", key_cpu = "\"cpu\": \"";
+    size_t c = s.find(key_calib);
+    if (c != std::string::npos) base.calib_us = std::strtod(s.c_str() + c + key_calib.size(), nullptr);
+    c = s.find(key_cpu);
+    if (c != std::string::npos) {
+        c += key_cpu.size();
+        base.cpu = s.substr(c, s.find('"', c) - c);
+    }
+    auto& out = base.median_us;
+
+    const std::string key_name = "\"name\": \"", key_med = "\"median_us\": ";
+    size_t pos = 0;
+    while ((pos = s.find(key_name, pos)) != std::string::npos) {
+        pos += key_name.size();
+        size_t end = s.find('"', pos);
+        if (end == std::string::npos) return false;
+        std::string name = s.substr(pos, end - pos);
+        size_t m = s.find(key_med, end);
+        size_t next = s.find(key_name, end);
+        if (m == std::string::npos || (next != std::string::npos && m > next)) return false;
+        out[name] = std::strtod(s.c_str() + m + key_med.size(), nullptr);
+        pos = end;
+    }
+    return true;
+}
+
+/** @return 回归项数 */
+static int compare(const std::vector<BenchResult>& results, const BenchOptions& opt, double calib_us) {
+    Baseline base;
+    if (!read_baseline(opt.compare_path, base)) {
+        fprintf(stderr, "cannot read baseline %s\n", opt.compare_path.c_str());
+        return -1;
+    }
+    if (base.quick != opt.quick) {
+        printf("note: baseline quick=%d, current quick=%d (iteration counts differ)\n",
+               base.quick ? 1 : 0, opt.quick ? 1 : 0);
+    }
+
+    // 归一化: 基线耗时按两台主机参照负载之比换算到本机
+    double scale = 1.0;
+    bool normalized = !opt.absolute && base.calib_us > 0.0 && calib_us > 0.0;
+    if (normalized) {
+        scale = calib_us / base.calib_us;
+        printf("\nhost-normalized: calib base %.1f us (%s), now %.1f us (%s), scale %.3f\n",
+               base.calib_us, base.cpu.empty() ? "unknown" : base.cpu.c_str(), calib_us,
+               host_cpu().c_str(), scale);
+    } else {
+        printf("\nabsolute timings%s\n", opt.absolute ? "" :
+               " (baseline has no calib_us; only meaningful on the machine that wrote it)");
+    }
+
+    int regressions = 0;
+    printf("\n%-44s %12s %12s %9s  %s\n", "benchmark", normalized ? "base(us)*s" : "base(us)",
+           "now(us)", "delta", "status");
+    for (const auto& r : results) {
+        auto it = base.median_us.find(r.name);
+        if (it == base.median_us.end() || it->second <= 0.0) {
+            printf("%-44s %12s %12.3f %9s  new\n", r.name.c_str(), "-", r.median_us, "-");
+            continue;
+        }
+        double expect = it->second * scale;
+        double delta = r.median_us / expect - 1.0;
+        const char* status = "ok";
+        if (delta > opt.threshold) { status = "REGRESSION"; ++regressions; }
+        else if (delta < -opt.threshold) status = "faster";
+        printf("%-44s %12.3f %12.3f %+8.1f%%  %s\n", r.name.c_str(), expect, r.median_us,
+               delta * 100.0, status);
+    }
+    printf("\n%d regression(s) beyond %.0f%%\n", regressions, opt.threshold * 100.0);
+    return regressions;
+}
+
+// =============================================================================
+// main
+// =============================================================================
+
+static void usage() {
+    printf("usage: wuyun_bench [--quick] [--filter S] [--reps N] [--json out.json]\n"
+           "                   [--compare baseline.json] [--threshold 0.15] [--absolute] [--list]\n");
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    bool list_only = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto need = [&](const char* flag) -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", flag); std::exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--quick")     opt.quick = true;
+        else if (a == "--filter")    opt.filter = need("--filter");
+        else if (a == "--reps")      opt.reps = std::max(std::atoi(need("--reps")), 1);
+        else if (a == "--json")      opt.json_path = need("--json");
+        else if (a == "--compare")   opt.compare_path = need("--compare");
+        else if (a == "--threshold") opt.threshold = std::atof(need("--threshold"));
+        else if (a == "--absolute")  opt.absolute = true;
+        else if (a == "--list")      list_only = true;
+        else { usage(); return (a == "--help" || a == "-h") ? 0 : 2; }
+    }
+
+    std::vector<Bench> benches;
+    for (auto& b : all_benches(opt.quick)) {
+        if (opt.filter.empty() || b.name.find(opt.filter) != std::string::npos)
+            benches.push_back(std::move(b));
+    }
+    if (list_only) {
+        for (const auto& b : benches) printf("%s\n", b.name.c_str());
+        return 0;
+    }
+
+    printf("=== WuYun benchmark (%s, %zu benchmarks) ===\n", opt.quick ? "quick" : "full", benches.size());
+    double calib_us = calibrate_host(opt.quick ? 3 : 7);
+    printf("host: %s, %u threads, calib %.1f us\n", host_cpu().c_str(),
+           std::thread::hardware_concurrency(), calib_us);
+    printf("%-44s %10s %12s %12s %12s\n", "benchmark", "iters", "median(us)", "min(us)", "per_sec");
+
+    std::vector<BenchResult> results;
+    for (const auto& b : benches) {
+        // GA 进化会打印每代进度; 结果行在其后输出
+        BenchResult r = run_bench(b, opt);
+        printf("%-44s %10d %12.3f %12.3f %12.1f\n", r.name.c_str(), r.iters, r.median_us, r.min_us,
+               r.median_us > 0 ? 1e6 / r.median_us : 0.0);
+        fflush(stdout);
+        results.push_back(std::move(r));
+    }
+
+    if (!opt.json_path.empty()) {
+        std::ofstream f(opt.json_path);
+        f << to_json(results, opt, calib_us);
+        if (!f) { fprintf(stderr, "cannot write %s\n", opt.json_path.c_str()); return 2; }
+        printf("\nwrote %s\n", opt.json_path.c_str());
+    }
+
+    if (!opt.compare_path.empty()) {
+        int reg = compare(results, opt, calib_us);
+        if (reg < 0) return 2;
+        return reg > 0 ? 1 : 0;
+    }
+    return 0;
+}